@@ -217,6 +217,11 @@ private:
                     std::cout << "close" << std::endl;
                     socket_.close();
                     mc_.notify_closed();
+                },
+                // only if set_publish_payload_streaming_threshold() is set
+                [&](am::event::publish_header_received const& /*ev*/) {
+                },
+                [&](am::event::publish_payload_received const& /*ev*/) {
                 }
             },
             ev
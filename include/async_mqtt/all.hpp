@@ -23,6 +23,8 @@
 #include <async_mqtt/protocol/event/event_variant.hpp>
 #include <async_mqtt/protocol/event/packet_id_released.hpp>
 #include <async_mqtt/protocol/event/packet_received.hpp>
+#include <async_mqtt/protocol/event/publish_header_received.hpp>
+#include <async_mqtt/protocol/event/publish_payload_received.hpp>
 #include <async_mqtt/protocol/event/send.hpp>
 #include <async_mqtt/protocol/event/timer.hpp>
 #include <async_mqtt/protocol/packet/control_packet_type.hpp>
@@ -680,12 +680,39 @@ public:
      * If true, then concatenate multiple packets' const buffer sequence
      * when send() is called before the previous send() is not completed.
      * Otherwise, send packet one by one.
+     * On the WebSocket layer (ws, wss), the concatenated packets are sent as one binary frame.
      * \n This function should be called before async_start() call.
      * @note By default bulk write mode is false (disabled)
      * @param val if true, enable bulk write mode, otherwise disable it.
      */
     void set_bulk_write(bool val);
 
+    /**
+     * @brief Set contiguous write threshold.
+     * If the size of the data to write is less than or equal to `val`,
+     * then the data is copied into one contiguous buffer that is reused by the stream,
+     * and written at once. Otherwise, the const buffer sequence of the packet is written
+     * without copy. If bulk write mode is enabled, the total size of the concatenated packets is compared.
+     * \n This function should be called before async_start() call.
+     * @note By default contiguous write threshold is 0 (disabled)
+     * @param val threshold in bytes. 0 means disabled.
+     */
+    void set_contiguous_write_threshold(std::size_t val);
+
+    /**
+     * @brief Set zerocopy write threshold.
+     * If the size of the packet to write is greater than or equal to `val`,
+     * then the packet is sent with MSG_ZEROCOPY. The kernel sends the packet buffers
+     * without copying them to the socket buffer. The packet is held until the kernel
+     * notifies the completion via the error queue of the socket.
+     * It is applied only to the TCP socket (protocol::mqtt) on Linux. Packets in bulk write mode are not applied.
+     * Zerocopy is effective for large payloads (e.g. several hundreds of KB or more).
+     * \n This function should be called before async_start() call.
+     * @note By default zerocopy write threshold is 0 (disabled)
+     * @param val threshold in bytes. 0 means disabled.
+     */
+    void set_zerocopy_write_threshold(std::size_t val);
+
     /**
      * @brief Set read buffer size.
      * If bulk read is enabled, the `val` parameter specifies the size of the internal
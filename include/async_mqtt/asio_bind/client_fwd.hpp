@@ -26,6 +26,11 @@ namespace async_mqtt {
  *    @li @ref protocol::mqtts
  *    @li @ref protocol::ws
  *    @li @ref protocol::wss
+ *    @li @ref protocol::mqtt_uds
+ *    @li @ref protocol::mqtt_shm
+ *    @li @ref protocol::mqtts_ktls
+ *    @li @ref protocol::wss_ktls
+ *    @li @ref protocol::mqtt_inproc
  *
  * @tparam Version       MQTT protocol version.
  * @tparam NextLayer     Just next layer for basic_endpoint. mqtt, mqtts, ws, and wss are predefined.
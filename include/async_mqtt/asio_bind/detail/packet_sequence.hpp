@@ -0,0 +1,66 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_DETAIL_PACKET_SEQUENCE_HPP)
+#define ASYNC_MQTT_ASIO_BIND_DETAIL_PACKET_SEQUENCE_HPP
+
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include <async_mqtt/util/move.hpp>
+#include <async_mqtt/protocol/packet/packet_variant.hpp>
+
+namespace async_mqtt::detail {
+
+namespace as = boost::asio;
+
+/**
+ * @brief Packets that are written to the stream by one gather write.
+ *        It provides the same interface as a packet for stream::async_write_packet().
+ */
+template <std::size_t PacketIdBytes>
+class basic_packet_sequence {
+public:
+    void push_back(basic_packet_variant<PacketIdBytes> packet) {
+        size_ += packet.size();
+        packets_.push_back(force_move(packet));
+    }
+
+    bool empty() const {
+        return packets_.empty();
+    }
+
+    /**
+     * @brief Get the total size of the packets
+     * @return size
+     */
+    std::size_t size() const {
+        return size_;
+    }
+
+    /**
+     * @brief Create const buffer sequence that concatenates all packets.
+     *        it is for boost asio APIs
+     * @return const buffer sequence
+     */
+    std::vector<as::const_buffer> const_buffer_sequence() const {
+        std::vector<as::const_buffer> ret;
+        for (auto const& packet : packets_) {
+            auto cbs = packet.const_buffer_sequence();
+            ret.insert(ret.end(), cbs.begin(), cbs.end());
+        }
+        return ret;
+    }
+
+private:
+    std::vector<basic_packet_variant<PacketIdBytes>> packets_;
+    std::size_t size_ = 0;
+};
+
+} // namespace async_mqtt::detail
+
+#endif // ASYNC_MQTT_ASIO_BIND_DETAIL_PACKET_SEQUENCE_HPP
@@ -0,0 +1,267 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_DETAIL_ZEROCOPY_SENDER_HPP)
+#define ASYNC_MQTT_ASIO_BIND_DETAIL_ZEROCOPY_SENDER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <type_traits>
+
+#include <boost/asio.hpp>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <linux/errqueue.h>
+#endif // defined(__linux__)
+
+#include <async_mqtt/protocol/error.hpp>
+#include <async_mqtt/util/move.hpp>
+#include <async_mqtt/util/log.hpp>
+
+namespace async_mqtt::detail {
+
+namespace as = boost::asio;
+
+template <typename T>
+struct is_tcp_socket : std::false_type {};
+
+template <typename Executor>
+struct is_tcp_socket<as::basic_stream_socket<as::ip::tcp, Executor>> : std::true_type {};
+
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+inline constexpr bool zerocopy_supported = true;
+#else  // defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+inline constexpr bool zerocopy_supported = false;
+#endif // defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+
+/**
+ * @brief MSG_ZEROCOPY sender of the TCP socket
+ * The kernel refers the user memory after sendmsg() returns.
+ * The lifetime of the sent data is held until the completion notification
+ * is received from the error queue of the socket.
+ * Each successful sendmsg() call has an id that is incremented from 0.
+ * The notification contains the range of the finished ids.
+ */
+class zerocopy_sender {
+public:
+    /**
+     * @brief enable SO_ZEROCOPY on the socket
+     * @param fd socket
+     * @return true if the socket is ready for zerocopy send
+     */
+    bool setup(int fd) {
+        if (fd_ == fd) return enabled_;
+        reset();
+        fd_ = fd;
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+        int one = 1;
+        enabled_ = ::setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+        if (!enabled_) {
+            ASYNC_MQTT_LOG("mqtt_impl", warning)
+                << "SO_ZEROCOPY is not available. fallback to copy. errno:" << errno;
+        }
+#endif // defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+        return enabled_;
+    }
+
+    /**
+     * @brief send the bytes
+     * @param cbs  buffers to send
+     * @param skip already sent bytes in cbs
+     * @param ec   as::error::would_block if the socket buffer is full
+     * @return sent bytes
+     */
+    template <typename ConstBufferSequence>
+    std::size_t send(ConstBufferSequence const& cbs, std::size_t skip, error_code& ec) {
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+        static constexpr std::size_t max_iov = 64;
+        ::iovec iov[max_iov];
+        std::size_t num = 0;
+        for (
+            auto it = as::buffer_sequence_begin(cbs), end = as::buffer_sequence_end(cbs);
+            it != end && num != max_iov;
+            ++it
+        ) {
+            as::const_buffer cb{*it};
+            if (skip >= cb.size()) {
+                skip -= cb.size();
+                continue;
+            }
+            cb += skip;
+            skip = 0;
+            iov[num].iov_base = const_cast<void*>(cb.data());
+            iov[num].iov_len = cb.size();
+            ++num;
+        }
+        ::msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = num;
+        while (true) {
+            auto size = ::sendmsg(fd_, &msg, MSG_ZEROCOPY | MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (size >= 0) {
+                ++next_id_;
+                ec = error_code{};
+                return static_cast<std::size_t>(size);
+            }
+            if (errno == EINTR) continue;
+            if (errno == ENOBUFS) {
+                // the limit of the pinned pages (optmem_max) is exceeded. send with copy
+                size = ::sendmsg(fd_, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+                if (size >= 0) {
+                    ec = error_code{};
+                    return static_cast<std::size_t>(size);
+                }
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                ec = as::error::would_block;
+            }
+            else {
+                ec = error_code{errno, boost::system::system_category()};
+            }
+            return 0;
+        }
+#else  // defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+        (void)cbs;
+        (void)skip;
+        ec = as::error::operation_not_supported;
+        return 0;
+#endif // defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    }
+
+    /**
+     * @brief hold the lifetime until all the sends so far are notified
+     * @param life lifetime of the sent data
+     */
+    void hold(std::shared_ptr<void> life) {
+        if (done_ == next_id_) return;
+        holds_.push_back(hold_entry{next_id_, force_move(life)});
+    }
+
+    /**
+     * @brief receive the notifications from the error queue and release the finished lifetimes
+     * @param woken true if it is called because the socket is ready for wait_error.
+     *              If no notification is received and the socket still has an error,
+     *              the socket is broken and the waiting is not repeated.
+     * @return true if any lifetime is still held
+     */
+    bool reap(bool woken = false) {
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+        bool received = false;
+        while (!holds_.empty()) {
+            char control[CMSG_SPACE(sizeof(::sock_extended_err)) + 64];
+            ::msghdr msg{};
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            if (::recvmsg(fd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    ASYNC_MQTT_LOG("mqtt_impl", warning)
+                        << "zerocopy notification receive error. errno:" << errno;
+                    failed_ = true;
+                }
+                else if (woken && !received) {
+                    // the error queue is empty but the socket is ready for wait_error,
+                    // it means the socket has an error
+                    ::pollfd pfd{fd_, 0, 0};
+                    if (::poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLERR)) {
+                        failed_ = true;
+                    }
+                }
+                break;
+            }
+            received = true;
+            for (auto cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+                if (
+                    !(cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) &&
+                    !(cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)
+                ) {
+                    continue;
+                }
+                ::sock_extended_err see;
+                std::memcpy(&see, CMSG_DATA(cm), sizeof(see));
+                if (see.ee_errno != 0 || see.ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+                if ((see.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) && !copied_reported_) {
+                    copied_reported_ = true;
+                    ASYNC_MQTT_LOG("mqtt_impl", info)
+                        << "zerocopy send is copied by the kernel (e.g. loopback)";
+                }
+                finish(see.ee_info, see.ee_data);
+            }
+        }
+#else  // defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+        (void)woken;
+#endif // defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+        return !holds_.empty();
+    }
+
+    /**
+     * @brief check the notifications should be waited for
+     * @return true if any lifetime is held and the socket is not broken.
+     *         If the socket is broken, the lifetimes are released by reset() on close.
+     */
+    bool pending() const {
+        return !holds_.empty() && !failed_;
+    }
+
+    /**
+     * @brief release all lifetimes and forget the socket
+     * It is called when the socket is closed.
+     */
+    void reset() {
+        holds_.clear();
+        finished_.clear();
+        next_id_ = 0;
+        done_ = 0;
+        fd_ = -1;
+        enabled_ = false;
+        failed_ = false;
+    }
+
+private:
+    void finish(std::uint32_t lo, std::uint32_t hi) {
+        // extend 32bit ids to 64bit based on the oldest unfinished id
+        auto base = static_cast<std::uint32_t>(done_);
+        std::uint64_t first = done_ + static_cast<std::uint32_t>(lo - base);
+        std::uint64_t last = done_ + static_cast<std::uint32_t>(hi - base) + 1;
+        finished_.emplace(first, last);
+        // notifications could be out of order
+        while (!finished_.empty() && finished_.begin()->first <= done_) {
+            done_ = std::max(done_, finished_.begin()->second);
+            finished_.erase(finished_.begin());
+        }
+        while (!holds_.empty() && holds_.front().end <= done_) {
+            holds_.pop_front();
+        }
+    }
+
+    struct hold_entry {
+        std::uint64_t end;
+        std::shared_ptr<void> life;
+    };
+
+    int fd_ = -1;
+    bool enabled_ = false;
+    bool failed_ = false;
+    bool copied_reported_ = false;
+    std::uint64_t next_id_ = 0;
+    // all ids less than done_ are finished
+    std::uint64_t done_ = 0;
+    std::multimap<std::uint64_t, std::uint64_t> finished_;
+    std::deque<hold_entry> holds_;
+};
+
+} // namespace async_mqtt::detail
+
+#endif // ASYNC_MQTT_ASIO_BIND_DETAIL_ZEROCOPY_SENDER_HPP
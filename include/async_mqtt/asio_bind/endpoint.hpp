@@ -8,6 +8,7 @@
 #define ASYNC_MQTT_ASIO_BIND_ENDPOINT_HPP
 
 #include <set>
+#include <vector>
 #include <boost/asio/any_io_executor.hpp>
 
 #include <async_mqtt/asio_bind/detail/endpoint_impl_fwd.hpp>
@@ -15,6 +16,7 @@
 #include <async_mqtt/asio_bind/filter.hpp>
 #include <async_mqtt/protocol/packet/packet_variant.hpp>
 #include <async_mqtt/protocol/packet/store_packet_variant.hpp>
+#include <async_mqtt/util/topic_alias_send.hpp>
 
 namespace async_mqtt {
 
@@ -173,6 +175,19 @@ public:
      */
     void set_auto_map_topic_alias_send(bool val);
 
+    /**
+     * @brief Set the policy of the automatic mapping of topic aliases.
+     *
+     * lru maps every topic and overwrites the least recently used (LRU) alias.
+     * frequency maps only the frequently sent topics.
+     * \n This function should be called before calling `async_send()`.
+     *
+     * @note The default policy is topic_alias_send_policy::lru.
+     *
+     * @param policy The policy that is used when automatic mapping is enabled.
+     */
+    void set_auto_map_topic_alias_send_policy(topic_alias_send_policy policy);
+
     /**
      * @brief Enable or disable automatic replacement of topics with corresponding topic aliases
      *        when sending PUBLISH packets.
@@ -241,12 +256,39 @@ public:
      * If true, then concatenate multiple packets' const buffer sequence
      * when async_send() is called before the previous async_send() is not completed.
      * Otherwise, send packet one by one.
+     * On the WebSocket layer (ws, wss), the concatenated packets are sent as one binary frame.
      * \n This function should be called before async_send() call.
      * @note By default bulk write mode is false (disabled)
      * @param val if true, enable bulk write mode, otherwise disable it.
      */
     void set_bulk_write(bool val);
 
+    /**
+     * @brief Set contiguous write threshold.
+     * If the size of the data to write is less than or equal to `val`,
+     * then the data is copied into one contiguous buffer that is reused by the stream,
+     * and written at once. Otherwise, the const buffer sequence of the packet is written
+     * without copy. If bulk write mode is enabled, the total size of the concatenated packets is compared.
+     * \n This function should be called before async_send() call.
+     * @note By default contiguous write threshold is 0 (disabled)
+     * @param val threshold in bytes. 0 means disabled.
+     */
+    void set_contiguous_write_threshold(std::size_t val);
+
+    /**
+     * @brief Set zerocopy write threshold.
+     * If the size of the packet to write is greater than or equal to `val`,
+     * then the packet is sent with MSG_ZEROCOPY. The kernel sends the packet buffers
+     * without copying them to the socket buffer. The packet is held until the kernel
+     * notifies the completion via the error queue of the socket.
+     * It is applied only to the TCP socket (protocol::mqtt) on Linux. Packets in bulk write mode are not applied.
+     * Zerocopy is effective for large payloads (e.g. several hundreds of KB or more).
+     * \n This function should be called before async_send() call.
+     * @note By default zerocopy write threshold is 0 (disabled)
+     * @param val threshold in bytes. 0 means disabled.
+     */
+    void set_zerocopy_write_threshold(std::size_t val);
+
     /**
      * @brief Set the read buffer size.
      * If bulk read is enabled, the `val` parameter specifies the size of the internal streambuf.
@@ -257,6 +299,30 @@ public:
      */
     void set_read_buffer_size(std::size_t val);
 
+    /**
+     * @brief Set the threshold for streaming reception of PUBLISH packet payloads.
+     * If the remaining length of a received PUBLISH packet is greater than `val`,
+     * the payload is not stored in memory as a whole. The PUBLISH packet that has an empty payload
+     * is passed by async_recv() or async_recv_some(), then the payload is received chunk by chunk
+     * by async_recv_publish_payload().
+     * If auto_pub_response is enabled, PUBACK/PUBREC is sent after the whole payload is received.
+     * \n This function should be called before async_recv() call.
+     * @note By default the threshold is 0 (disabled)
+     * @param val threshold in bytes. 0 means disabled.
+     */
+    void set_publish_payload_streaming_threshold(std::size_t val);
+
+    /**
+     * @brief Set the maximum variable header size of the streamed PUBLISH packet.
+     * The variable header (topic name, packet identifier and properties) of the streamed
+     * PUBLISH packet is stored in memory. If it is greater than `val`, the packet is treated
+     * as packet_too_large error.
+     * \n This function should be called before async_recv() call.
+     * @note By default the maximum size is 131072 (128KiB)
+     * @param val maximum size in bytes.
+     */
+    void set_publish_header_max_size(std::size_t val);
+
 
     // async functions
 
@@ -431,6 +497,58 @@ public:
         CompletionToken&& token = as::default_completion_token_t<executor_type>{}
     );
 
+    /**
+     * @brief send packets
+     *        All packets are checked in one pass, and the packets that pass the check are
+     *        written to the underlying layer by one gather write.
+     *        users can call async_send() before the previous async_send()'s CompletionToken is invoked
+     * @param packets packets to send. The packets are processed in order.
+     * @param token see Signature
+     * @return deduced by token
+     *
+     * ### Completion Token
+     * @li <a href="https://www.boost.org/doc/html/boost_asio/overview/composition/token_adapters.html">Default Completion Token</a> is supported
+     *
+     * #### Signature
+     * void(@ref error_code, std::size_t)
+     *
+     * ##### error_code and std::size_t
+     * std::size_t is the number of packets from the beginning of `packets` that passed the check.
+     * @li If an error occurs while checking a packet for sending,
+     *     @ref disconnect_reason_code is set.
+     *     The packet and the rest of the packets are not sent, and their packet_ids are released.
+     *     The packets before the error packet are sent.
+     * @li If no error occurs during checking the packets for sending,
+     *     but an error occurs at an underlying layer while sending the packets,
+     *     underlying error is set. e.g. system, asio, beast, ...
+     *     The packet_ids that are not stored for resending are released.
+     *     std::size_t is 0 because the packets are written by one gather write and
+     *     none of them is known to be written.
+     * @li If no error occurs but at least one PUBLISH packet is enqueued due to receive_maximum,
+     *     @ref mqtt_error::packet_enqueued is set. It is not an error. The enqueued packets are
+     *     counted in std::size_t, and they are sent when the peer releases the packet_ids.
+     * @li If there are no errors during sending the packets,
+     *     <a href="https://www.boost.org/libs/system/doc/html/system.html#ref_errc">errc::success</a> is set.
+     *
+     * ### Per-Operation Cancellation
+     *
+     *  This asynchronous operation supports cancellation for the following
+     *  [boost::asio::cancellation_type](https://www.boost.org/doc/html/boost_asio/reference/cancellation_type.html) values:
+     *  @li cancellation_type::terminal
+     *  @li cancellation_type::partial
+     *
+     * if they are also supported by the NextLayer type's async_read_some and async_write_some operation.
+     */
+    template <
+        typename Packet,
+        typename CompletionToken = as::default_completion_token_t<executor_type>
+    >
+    auto
+    async_send(
+        std::vector<Packet> packets,
+        CompletionToken&& token = as::default_completion_token_t<executor_type>{}
+    );
+
     /**
      * @brief receive packet
      * @param token see Signature
@@ -549,6 +667,182 @@ public:
         CompletionToken&& token = as::default_completion_token_t<executor_type>{}
     );
 
+    /**
+     * @brief receive all packets that can be decoded from the read buffer
+     *        If the read buffer doesn't contain any complete packet, then read from the underlying layer
+     *        until at least one packet is received.
+     *        Compared with async_recv(), the completion handler is invoked once per read
+     *        instead of once per packet.
+     * @param token see Signature
+     * @return deduced by token
+     *
+     * ### Completion Token
+     * @li <a href="https://www.boost.org/doc/html/boost_asio/overview/composition/token_adapters.html">Default Completion Token</a> is supported
+     *
+     * #### Signature
+     * void(@ref error_code, std::vector<@ref packet_variant_type>)
+     *
+     * ##### error_code and packet_variant_type
+     * @li If an error occurs at an underlying layer while receiving packets,
+     *     underlying error is set. e.g. system, asio, beast, ...
+     *     If some packets have been decoded before the error, they are passed with
+     *     <a href="https://www.boost.org/libs/system/doc/html/system.html#ref_errc">errc::success</a> first,
+     *     and the error is reported by the next async_recv_some() or async_recv() call.
+     *     On cancellation, the decoded packets are passed with the error.
+     * @li If there are no errors during receiving packets,
+     *     <a href="https://www.boost.org/libs/system/doc/html/system.html#ref_errc">errc::success</a> is set.
+     *     std::vector<@ref packet_variant_type> contains at least one @ref basic_packet_variant.
+     *
+     * ### Per-Operation Cancellation
+     *
+     *  This asynchronous operation supports cancellation for the following
+     *  [boost::asio::cancellation_type](https://www.boost.org/doc/html/boost_asio/reference/cancellation_type.html) values:
+     *  @li cancellation_type::terminal
+     *  @li cancellation_type::partial
+     *
+     * if they are also supported by the NextLayer type's async_read_some and async_write_some operation.
+     */
+    template <
+        typename CompletionToken = as::default_completion_token_t<executor_type>
+    >
+    auto
+    async_recv_some(
+        CompletionToken&& token = as::default_completion_token_t<executor_type>{}
+    );
+
+    /**
+     * @brief receive all packets that can be decoded from the read buffer
+     *        Only the packets that type is contained in types are passed.
+     *        If no packets are passed, then next receiving starts automatically.
+     *        if receive error happenes, then token would be invoked.
+     * @param types target control_packet_types
+     * @param token see Signature
+     * @return deduced by token
+     *
+     * ### Completion Token
+     * @li <a href="https://www.boost.org/doc/html/boost_asio/overview/composition/token_adapters.html">Default Completion Token</a> is supported
+     *
+     * #### Signature
+     * void(@ref error_code, std::vector<@ref packet_variant_type>)
+     *
+     * ##### error_code and packet_variant_type
+     * @li If an error occurs at an underlying layer while receiving packets,
+     *     underlying error is set. e.g. system, asio, beast, ...
+     *     If some packets have been decoded before the error, they are passed with
+     *     <a href="https://www.boost.org/libs/system/doc/html/system.html#ref_errc">errc::success</a> first,
+     *     and the error is reported by the next async_recv_some() or async_recv() call.
+     *     On cancellation, the decoded packets are passed with the error.
+     * @li If there are no errors during receiving packets,
+     *     <a href="https://www.boost.org/libs/system/doc/html/system.html#ref_errc">errc::success</a> is set.
+     *     std::vector<@ref packet_variant_type> contains at least one @ref basic_packet_variant.
+     *
+     * ### Per-Operation Cancellation
+     *
+     *  This asynchronous operation supports cancellation for the following
+     *  [boost::asio::cancellation_type](https://www.boost.org/doc/html/boost_asio/reference/cancellation_type.html) values:
+     *  @li cancellation_type::terminal
+     *  @li cancellation_type::partial
+     *
+     * if they are also supported by the NextLayer type's async_read_some and async_write_some operation.
+     */
+    template <
+        typename CompletionToken = as::default_completion_token_t<executor_type>
+    >
+    auto
+    async_recv_some(
+        std::set<control_packet_type> types,
+        CompletionToken&& token = as::default_completion_token_t<executor_type>{}
+    );
+
+    /**
+     * @brief receive all packets that can be decoded from the read buffer
+     *        Only the packets that are matched with fil and types are passed.
+     *        If no packets are passed, then next receiving starts automatically.
+     *        if receive error happenes, then token would be invoked.
+     * @param fil  if `match` then matched types are targets. if `except` then not matched types are targets.
+     * @param types target control_packet_types
+     * @param token see Signature
+     * @return deduced by token
+     *
+     * ### Completion Token
+     * @li <a href="https://www.boost.org/doc/html/boost_asio/overview/composition/token_adapters.html">Default Completion Token</a> is supported
+     *
+     * #### Signature
+     * void(@ref error_code, std::vector<@ref packet_variant_type>)
+     *
+     * ##### error_code and packet_variant_type
+     * @li If an error occurs at an underlying layer while receiving packets,
+     *     underlying error is set. e.g. system, asio, beast, ...
+     *     If some packets have been decoded before the error, they are passed with
+     *     <a href="https://www.boost.org/libs/system/doc/html/system.html#ref_errc">errc::success</a> first,
+     *     and the error is reported by the next async_recv_some() or async_recv() call.
+     *     On cancellation, the decoded packets are passed with the error.
+     * @li If there are no errors during receiving packets,
+     *     <a href="https://www.boost.org/libs/system/doc/html/system.html#ref_errc">errc::success</a> is set.
+     *     std::vector<@ref packet_variant_type> contains at least one @ref basic_packet_variant.
+     *
+     * ### Per-Operation Cancellation
+     *
+     *  This asynchronous operation supports cancellation for the following
+     *  [boost::asio::cancellation_type](https://www.boost.org/doc/html/boost_asio/reference/cancellation_type.html) values:
+     *  @li cancellation_type::terminal
+     *  @li cancellation_type::partial
+     *
+     * if they are also supported by the NextLayer type's async_read_some and async_write_some operation.
+     */
+    template <
+        typename CompletionToken = as::default_completion_token_t<executor_type>
+    >
+    auto
+    async_recv_some(
+        filter fil,
+        std::set<control_packet_type> types,
+        CompletionToken&& token = as::default_completion_token_t<executor_type>{}
+    );
+
+    /**
+     * @brief receive a part of the streamed PUBLISH packet payload
+     *        If @ref set_publish_payload_streaming_threshold() is set, async_recv() and async_recv_some()
+     *        pass the PUBLISH packet that has an empty payload when the packet is larger than the threshold.
+     *        Then call this function repeatedly until @ref get_publish_payload_rest() returns 0.
+     *        The underlying layer is read only while this function is called, so the sender is
+     *        flow controlled by the TCP window.
+     *        If async_recv() or async_recv_some() is called instead, the rest of the payload is skipped.
+     * @param token see Signature
+     * @return deduced by token
+     *
+     * ### Completion Token
+     * @li <a href="https://www.boost.org/doc/html/boost_asio/overview/composition/token_adapters.html">Default Completion Token</a> is supported
+     *
+     * #### Signature
+     * void(@ref error_code, @ref buffer)
+     *
+     * ##### error_code and buffer
+     * @li If an error occurs at an underlying layer while receiving the payload,
+     *     underlying error is set. e.g. system, asio, beast, ...
+     * @li If no streamed PUBLISH packet payload is remaining,
+     *     <a href="https://www.boost.org/libs/system/doc/html/system.html#ref_errc">errc::operation_not_permitted</a> is set.
+     * @li If there are no errors,
+     *     <a href="https://www.boost.org/libs/system/doc/html/system.html#ref_errc">errc::success</a> is set.
+     *     @ref buffer contains the part of the payload.
+     *
+     * ### Per-Operation Cancellation
+     *
+     *  This asynchronous operation supports cancellation for the following
+     *  [boost::asio::cancellation_type](https://www.boost.org/doc/html/boost_asio/reference/cancellation_type.html) values:
+     *  @li cancellation_type::terminal
+     *  @li cancellation_type::partial
+     *
+     * if they are also supported by the NextLayer type's async_read_some and async_write_some operation.
+     */
+    template <
+        typename CompletionToken = as::default_completion_token_t<executor_type>
+    >
+    auto
+    async_recv_publish_payload(
+        CompletionToken&& token = as::default_completion_token_t<executor_type>{}
+    );
+
     /**
      * @brief close the underlying connection
      * @param token see Signature
@@ -725,6 +1019,21 @@ public:
      */
     protocol_version get_protocol_version() const;
 
+    /**
+     * @brief Get the payload size of the streamed PUBLISH packet that is not received yet
+     * @return The number of payload bytes that are not received yet.
+     *         If no PUBLISH packet payload is being streamed, returns 0.
+     */
+    std::size_t get_publish_payload_rest() const;
+
+    /**
+     * @brief Get the receive maximum vacancy for sending PUBLISH (QoS1, QoS2) packets.
+     *        It should be called on the endpoint's strand.
+     * @return If there is no limit, returns std::nullopt; otherwise, returns the current
+     *         number of PUBLISH (QoS1, QoS2) packets that can be sent.
+     */
+    std::optional<std::size_t> get_receive_maximum_vacancy_for_send() const;
+
     /**
      * @brief Get MQTT PUBLISH packet processing status
      * @param pid packet_id corresponding to the publish packet.
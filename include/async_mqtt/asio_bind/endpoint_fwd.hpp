@@ -25,6 +25,11 @@ namespace async_mqtt {
  *    @li @ref protocol::mqtts
  *    @li @ref protocol::ws
  *    @li @ref protocol::wss
+ *    @li @ref protocol::mqtt_uds
+ *    @li @ref protocol::mqtt_shm
+ *    @li @ref protocol::mqtts_ktls
+ *    @li @ref protocol::wss_ktls
+ *    @li @ref protocol::mqtt_inproc
  *
  * @tparam Role          role for packet sendable checking
  * @tparam PacketIdBytes MQTT spec is 2. You can use `endpoint` for that.
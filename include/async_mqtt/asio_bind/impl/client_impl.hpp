@@ -75,6 +75,8 @@ public:
     void set_pingresp_recv_timeout(std::chrono::milliseconds duration);
     void set_close_delay_after_disconnect_sent(std::chrono::milliseconds duration);
     void set_bulk_write(bool val);
+    void set_contiguous_write_threshold(std::size_t val);
+    void set_zerocopy_write_threshold(std::size_t val);
     void set_read_buffer_size(std::size_t val);
 
     std::optional<packet_id_type> acquire_unique_packet_id();
@@ -127,6 +127,20 @@ client_impl<Version, NextLayer>::set_bulk_write(bool val) {
     ep_.set_bulk_write(val);
 }
 
+template <protocol_version Version, typename NextLayer>
+inline
+void
+client_impl<Version, NextLayer>::set_contiguous_write_threshold(std::size_t val) {
+    ep_.set_contiguous_write_threshold(val);
+}
+
+template <protocol_version Version, typename NextLayer>
+inline
+void
+client_impl<Version, NextLayer>::set_zerocopy_write_threshold(std::size_t val) {
+    ep_.set_zerocopy_write_threshold(val);
+}
+
 template <protocol_version Version, typename NextLayer>
 inline
 void
@@ -282,6 +296,22 @@ client<Version, NextLayer>::set_bulk_write(bool val) {
     impl_->set_bulk_write(val);
 }
 
+template <protocol_version Version, typename NextLayer>
+inline
+void
+client<Version, NextLayer>::set_contiguous_write_threshold(std::size_t val) {
+    BOOST_ASSERT(impl_);
+    impl_->set_contiguous_write_threshold(val);
+}
+
+template <protocol_version Version, typename NextLayer>
+inline
+void
+client<Version, NextLayer>::set_zerocopy_write_threshold(std::size_t val) {
+    BOOST_ASSERT(impl_);
+    impl_->set_zerocopy_write_threshold(val);
+}
+
 template <protocol_version Version, typename NextLayer>
 inline
 void
@@ -74,11 +74,16 @@ public:
     void set_auto_pub_response(bool val);
     void set_auto_ping_response(bool val);
     void set_auto_map_topic_alias_send(bool val);
+    void set_auto_map_topic_alias_send_policy(topic_alias_send_policy policy);
     void set_auto_replace_topic_alias_send(bool val);
     void set_pingresp_recv_timeout(std::chrono::milliseconds duration);
     void set_close_delay_after_disconnect_sent(std::chrono::milliseconds duration);
     void set_bulk_write(bool val);
+    void set_contiguous_write_threshold(std::size_t val);
+    void set_zerocopy_write_threshold(std::size_t val);
     void set_read_buffer_size(std::size_t val);
+    void set_publish_payload_streaming_threshold(std::size_t val);
+    void set_publish_header_max_size(std::size_t val);
 
     // async funcs
     static void
@@ -125,6 +130,24 @@ public:
         > handler
     );
 
+    static void
+    async_recv_some(
+        this_type_sp impl,
+        std::optional<filter> fil,
+        std::set<control_packet_type> types,
+        as::any_completion_handler<
+            void(error_code, std::vector<packet_variant_type>)
+        > handler
+    );
+
+    static void
+    async_recv_publish_payload(
+        this_type_sp impl,
+        as::any_completion_handler<
+            void(error_code, buffer)
+        > handler
+    );
+
     static void
     async_get_stored_packets(
         this_type_sp impl,
@@ -163,6 +186,8 @@ public:
     );
     std::vector<basic_store_packet_variant<PacketIdBytes>> get_stored_packets() const;
     protocol_version get_protocol_version() const;
+    std::size_t get_publish_payload_rest() const;
+    std::optional<std::size_t> get_receive_maximum_vacancy_for_send() const;
     bool is_publish_processing(typename basic_packet_id_type<PacketIdBytes>::type pid) const;
     void regulate_for_store(
         v5::basic_publish_packet<PacketIdBytes>& packet,
@@ -208,7 +233,9 @@ private: // compose operation impl
     struct register_packet_id_op;
     struct release_packet_id_op;
     template <typename Packet> struct send_op;
-    struct recv_op;
+    template <typename Packet> struct send_packets_op;
+    enum class recv_kind { one, some, publish_payload };
+    template <recv_kind Kind> struct recv_op;
     struct close_op;
     struct restore_packets_op;
     struct get_stored_packets_op;
@@ -242,6 +269,18 @@ private:
         CompletionToken&& token = as::default_completion_token_t<executor_type>{}
     );
 
+    template <
+        typename Packet,
+        typename CompletionToken = as::default_completion_token_t<executor_type>
+    >
+    static
+    auto
+    async_send(
+        this_type_sp impl,
+        std::vector<Packet> packets,
+        CompletionToken&& token = as::default_completion_token_t<executor_type>{}
+    );
+
     template <
         typename CompletionToken = as::default_completion_token_t<executor_type>
     >
@@ -333,6 +372,8 @@ private:
     };
     close_status status_{close_status::closed};
     std::deque<basic_event_variant<PacketIdBytes>> recv_events_;
+    // the error that is decided after the packets passed by async_recv_some()
+    std::optional<error_code> recv_some_error_;
 };
 
 } // namespace async_mqtt::detail
@@ -54,6 +54,15 @@ basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::set_auto_map_topic_alias_se
     con_.set_auto_map_topic_alias_send(val);
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::set_auto_map_topic_alias_send_policy(
+    topic_alias_send_policy policy
+) {
+    con_.set_auto_map_topic_alias_send_policy(policy);
+}
+
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void
@@ -86,6 +95,20 @@ basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::set_bulk_write(bool val) {
     stream_.set_bulk_write(val);
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::set_contiguous_write_threshold(std::size_t val) {
+    stream_.set_contiguous_write_threshold(val);
+}
+
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::set_zerocopy_write_threshold(std::size_t val) {
+    stream_.set_zerocopy_write_threshold(val);
+}
+
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void
@@ -93,6 +116,20 @@ basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::set_read_buffer_size(std::s
     read_buffer_size_ = val;
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::set_publish_payload_streaming_threshold(std::size_t val) {
+    con_.set_publish_payload_streaming_threshold(val);
+}
+
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::set_publish_header_max_size(std::size_t val) {
+    con_.set_publish_header_max_size(val);
+}
+
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 std::set<typename basic_packet_id_type<PacketIdBytes>::type>
@@ -118,6 +155,20 @@ basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::get_protocol_version() cons
     return con_.get_protocol_version();
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+std::size_t
+basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::get_publish_payload_rest() const {
+    return con_.get_publish_payload_rest();
+}
+
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+std::optional<std::size_t>
+basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::get_receive_maximum_vacancy_for_send() const {
+    return con_.get_receive_maximum_vacancy_for_send();
+}
+
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 bool
@@ -571,6 +622,20 @@ basic_endpoint<Role, PacketIdBytes, NextLayer>::set_auto_map_topic_alias_send(bo
     impl_->set_auto_map_topic_alias_send(val);
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint<Role, PacketIdBytes, NextLayer>::set_auto_map_topic_alias_send_policy(
+    topic_alias_send_policy policy
+) {
+    ASYNC_MQTT_LOG("mqtt_api", info)
+        << ASYNC_MQTT_ADD_VALUE(address, this)
+        << "set_auto_map_topic_alias_send_policy policy:"
+        << (policy == topic_alias_send_policy::lru ? "lru" : "frequency");
+    BOOST_ASSERT(impl_);
+    impl_->set_auto_map_topic_alias_send_policy(policy);
+}
+
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void
@@ -610,6 +675,22 @@ basic_endpoint<Role, PacketIdBytes, NextLayer>::set_bulk_write(bool val) {
     impl_->set_bulk_write(val);
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint<Role, PacketIdBytes, NextLayer>::set_contiguous_write_threshold(std::size_t val) {
+    BOOST_ASSERT(impl_);
+    impl_->set_contiguous_write_threshold(val);
+}
+
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint<Role, PacketIdBytes, NextLayer>::set_zerocopy_write_threshold(std::size_t val) {
+    BOOST_ASSERT(impl_);
+    impl_->set_zerocopy_write_threshold(val);
+}
+
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void
@@ -618,6 +699,28 @@ basic_endpoint<Role, PacketIdBytes, NextLayer>::set_read_buffer_size(std::size_t
     impl_->set_read_buffer_size(val);
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint<Role, PacketIdBytes, NextLayer>::set_publish_payload_streaming_threshold(std::size_t val) {
+    ASYNC_MQTT_LOG("mqtt_api", info)
+        << ASYNC_MQTT_ADD_VALUE(address, this)
+        << "set_publish_payload_streaming_threshold val:" << val;
+    BOOST_ASSERT(impl_);
+    impl_->set_publish_payload_streaming_threshold(val);
+}
+
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint<Role, PacketIdBytes, NextLayer>::set_publish_header_max_size(std::size_t val) {
+    ASYNC_MQTT_LOG("mqtt_api", info)
+        << ASYNC_MQTT_ADD_VALUE(address, this)
+        << "set_publish_header_max_size val:" << val;
+    BOOST_ASSERT(impl_);
+    impl_->set_publish_header_max_size(val);
+}
+
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 std::set<typename basic_packet_id_type<PacketIdBytes>::type>
@@ -657,6 +760,22 @@ basic_endpoint<Role, PacketIdBytes, NextLayer>::get_protocol_version() const {
     return protocol_version;
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+std::size_t
+basic_endpoint<Role, PacketIdBytes, NextLayer>::get_publish_payload_rest() const {
+    BOOST_ASSERT(impl_);
+    return impl_->get_publish_payload_rest();
+}
+
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+std::optional<std::size_t>
+basic_endpoint<Role, PacketIdBytes, NextLayer>::get_receive_maximum_vacancy_for_send() const {
+    BOOST_ASSERT(impl_);
+    return impl_->get_receive_maximum_vacancy_for_send();
+}
+
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 bool
@@ -114,6 +114,137 @@ basic_endpoint<Role, PacketIdBytes, NextLayer>::async_recv(
         );
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+template <typename CompletionToken>
+auto
+basic_endpoint<Role, PacketIdBytes, NextLayer>::async_recv_some(
+    CompletionToken&& token
+) {
+    ASYNC_MQTT_LOG("mqtt_api", info)
+        << ASYNC_MQTT_ADD_VALUE(address, this)
+        << "recv_some";
+    BOOST_ASSERT(impl_);
+    return
+        as::async_initiate<
+            CompletionToken,
+            void(error_code, std::vector<packet_variant_type>)
+        >(
+            [](
+                auto handler,
+                std::shared_ptr<impl_type> impl
+            ) {
+                impl_type::async_recv_some(
+                    force_move(impl),
+                    std::nullopt,
+                    std::set<control_packet_type>{},
+                    force_move(handler)
+                );
+            },
+            token,
+            impl_
+        );
+}
+
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+template <typename CompletionToken>
+auto
+basic_endpoint<Role, PacketIdBytes, NextLayer>::async_recv_some(
+    std::set<control_packet_type> types,
+    CompletionToken&& token
+) {
+    ASYNC_MQTT_LOG("mqtt_api", info)
+        << ASYNC_MQTT_ADD_VALUE(address, this)
+        << "recv_some";
+    BOOST_ASSERT(impl_);
+    return
+        as::async_initiate<
+            CompletionToken,
+            void(error_code, std::vector<packet_variant_type>)
+        >(
+            [](
+                auto handler,
+                std::shared_ptr<impl_type> impl,
+                std::set<control_packet_type> types
+            ) {
+                impl_type::async_recv_some(
+                    force_move(impl),
+                    filter::match,
+                    force_move(types),
+                    force_move(handler)
+                );
+            },
+            token,
+            impl_,
+            force_move(types)
+        );
+}
+
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+template <typename CompletionToken>
+auto
+basic_endpoint<Role, PacketIdBytes, NextLayer>::async_recv_some(
+    filter fil,
+    std::set<control_packet_type> types,
+    CompletionToken&& token
+) {
+    ASYNC_MQTT_LOG("mqtt_api", info)
+        << ASYNC_MQTT_ADD_VALUE(address, this)
+        << "recv_some";
+    BOOST_ASSERT(impl_);
+    return
+        as::async_initiate<
+            CompletionToken,
+            void(error_code, std::vector<packet_variant_type>)
+        >(
+            [](
+                auto handler,
+                std::shared_ptr<impl_type> impl,
+                filter fil,
+                std::set<control_packet_type> types
+            ) {
+                impl_type::async_recv_some(
+                    force_move(impl),
+                    fil,
+                    force_move(types),
+                    force_move(handler)
+                );
+            },
+            token,
+            impl_,
+            fil,
+            force_move(types)
+        );
+}
+
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+template <typename CompletionToken>
+auto
+basic_endpoint<Role, PacketIdBytes, NextLayer>::async_recv_publish_payload(
+    CompletionToken&& token
+) {
+    ASYNC_MQTT_LOG("mqtt_api", info)
+        << ASYNC_MQTT_ADD_VALUE(address, this)
+        << "recv_publish_payload";
+    BOOST_ASSERT(impl_);
+    return
+        as::async_initiate<
+            CompletionToken,
+            void(error_code, buffer)
+        >(
+            [](
+                auto handler,
+                std::shared_ptr<impl_type> impl
+            ) {
+                impl_type::async_recv_publish_payload(
+                    force_move(impl),
+                    force_move(handler)
+                );
+            },
+            token,
+            impl_
+        );
+}
+
 } // namespace async_mqtt
 
 #if !defined(ASYNC_MQTT_SEPARATE_COMPILATION)
@@ -14,6 +14,7 @@
 namespace async_mqtt::detail {
 
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+template <typename basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::recv_kind Kind>
 struct basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::
 recv_op {
     this_type_sp ep;
@@ -21,6 +22,11 @@ recv_op {
     std::set<control_packet_type> types = {};
     std::optional<error_code> decided_error = std::nullopt;
     std::optional<basic_packet_variant<PacketIdBytes>> recv_packet = std::nullopt;
+    // used only if Kind is recv_kind::some
+    std::vector<basic_packet_variant<PacketIdBytes>> recv_packets = {};
+    bool publish_header = false;
+    // used only if Kind is recv_kind::publish_payload
+    std::optional<buffer> recv_payload = std::nullopt;
     bool try_resend_from_queue = false;
     bool disconnect_sent_just_before = false;
     enum { dispatch, check_buf, read_istream, process, read, finish_read, sent, closed, complete } state = dispatch;
@@ -57,6 +63,20 @@ recv_op {
                     recv_packet.emplace(force_move(ev.get()));
                     return true;
                 },
+                [&](async_mqtt::event::basic_publish_header_received<PacketIdBytes>&& ev) {
+                    BOOST_ASSERT(!recv_packet);
+                    recv_packet.emplace(force_move(ev.get()));
+                    publish_header = true;
+                    return true;
+                },
+                [&](async_mqtt::event::publish_payload_received&& ev) {
+                    if constexpr (Kind == recv_kind::publish_payload) {
+                        BOOST_ASSERT(!recv_payload);
+                        recv_payload.emplace(force_move(ev.get()));
+                    }
+                    // otherwise, the rest of the payload is skipped
+                    return true;
+                },
                 [&](async_mqtt::event::timer&& ev) {
                     switch (ev.get_kind()) {
                     case timer_kind::pingreq_send:
@@ -128,10 +148,7 @@ recv_op {
                 << "recv error:" << ec.message();
             if (ec == as::error::operation_aborted) {
                 // on cancel, not close the connection
-                self.complete(
-                    ec,
-                    force_move(recv_packet)
-                );
+                complete_op(self, ec);
             }
             else {
                 state = complete;
@@ -154,6 +171,31 @@ recv_op {
             );
         } break;
         case check_buf: {
+            if (a_ep.recv_some_error_) {
+                // report the error that is decided after the packets passed by async_recv_some()
+                state = complete;
+                decided_error.emplace(*a_ep.recv_some_error_);
+                a_ep.recv_some_error_.reset();
+                as::dispatch(
+                    a_ep.get_executor(),
+                    force_move(self)
+                );
+                return;
+            }
+            if constexpr (Kind == recv_kind::publish_payload) {
+                if (a_ep.con_.get_publish_payload_rest() == 0) {
+                    // no streamed PUBLISH packet payload is remaining
+                    state = complete;
+                    decided_error.emplace(
+                        errc::make_error_code(errc::operation_not_permitted)
+                    );
+                    as::dispatch(
+                        a_ep.get_executor(),
+                        force_move(self)
+                    );
+                    return;
+                }
+            }
             if (a_ep.read_buf_.size() == 0) {
                 // read required
                 state = read;
@@ -192,34 +234,95 @@ recv_op {
         } break;
         case process: {
             // The last event of events_ must be event_received or error
-            bool sent_or_closed = false;
-            while (!a_ep.recv_events_.empty()) {
-                if (!process_one_event(self)) {
-                    sent_or_closed = true;
-                    break;
+            while (true) {
+                while (!a_ep.recv_events_.empty()) {
+                    if (!process_one_event(self)) {
+                        // sent or closed
+                        return;
+                    }
                 }
-            }
-            if (!sent_or_closed) {
-                // exit the above loop by break;
-                if (!decided_error && !recv_packet) {
-                    // QoS2 already received
-                    state = check_buf;
+                if constexpr (Kind == recv_kind::some) {
+                    if (decided_error) {
+                        // the packet decoded with the error in the same batch is also passed
+                        if (recv_packet) {
+                            if (is_target(recv_packet->type())) {
+                                recv_packets.push_back(force_move(*recv_packet));
+                            }
+                            recv_packet.reset();
+                        }
+                        state = complete;
+                        as::dispatch(
+                            a_ep.get_executor(),
+                            force_move(self)
+                        );
+                        return;
+                    }
+                    if (recv_packet) {
+                        bool target = is_target(recv_packet->type());
+                        if (target) {
+                            recv_packets.push_back(force_move(*recv_packet));
+                        }
+                        recv_packet.reset();
+                        if (publish_header) {
+                            publish_header = false;
+                            if (target) {
+                                // the payload is received by async_recv_publish_payload()
+                                state = complete;
+                                as::dispatch(
+                                    a_ep.get_executor(),
+                                    force_move(self)
+                                );
+                                return;
+                            }
+                        }
+                    }
+                    // decode the rest of the read buffer without completing
+                    if (a_ep.read_buf_.size() != 0) {
+                        auto events{a_ep.con_.recv(a_ep.is_)};
+                        std::move(events.begin(), events.end(), std::back_inserter(a_ep.recv_events_));
+                    }
+                    if (a_ep.recv_events_.empty()) {
+                        // no more complete packet in the read buffer
+                        state = recv_packets.empty() ? read : complete;
+                        as::dispatch(
+                            a_ep.get_executor(),
+                            force_move(self)
+                        );
+                        return;
+                    }
+                }
+                else if constexpr (Kind == recv_kind::publish_payload) {
+                    if (!decided_error && !recv_payload) {
+                        // the payload of QoS2 already received packet
+                        state = check_buf;
+                    }
+                    else {
+                        state = complete;
+                    }
                     as::dispatch(
                         a_ep.get_executor(),
                         force_move(self)
                     );
+                    return;
                 }
                 else {
-                    // either packet_received or error
-                    BOOST_ASSERT(
-                        (decided_error && !recv_packet) ||
-                        (!decided_error && recv_packet)
-                    );
-                    state = complete; // all events processed
+                    if (!decided_error && !recv_packet) {
+                        // QoS2 already received or skipped payload
+                        state = check_buf;
+                    }
+                    else {
+                        // either packet_received or error
+                        BOOST_ASSERT(
+                            (decided_error && !recv_packet) ||
+                            (!decided_error && recv_packet)
+                        );
+                        state = complete; // all events processed
+                    }
                     as::dispatch(
                         a_ep.get_executor(),
                         force_move(self)
                     );
+                    return;
                 }
             }
         } break;
@@ -259,18 +362,12 @@ recv_op {
         } break;
         case complete: {
             if (decided_error) {
-                self.complete(
-                    *decided_error,
-                    std::nullopt
-                );
+                complete_op(self, *decided_error);
             }
             else {
-                BOOST_ASSERT(recv_packet);
-                if (fil) {
-                    auto type = recv_packet->type();
-                    if ((*fil == filter::match  && types.find(type) == types.end()) ||
-                        (*fil == filter::except && types.find(type) != types.end())
-                    ) {
+                if constexpr (Kind == recv_kind::one) {
+                    BOOST_ASSERT(recv_packet);
+                    if (!is_target(recv_packet->type())) {
                         // read the next packet
                         state = check_buf;
                         recv_packet.reset();
@@ -284,10 +381,7 @@ recv_op {
                 if (try_resend_from_queue) {
                     send_publish_from_queue();
                 }
-                self.complete(
-                    error_code{},
-                    force_move(recv_packet)
-                );
+                complete_op(self, error_code{});
             }
         } break;
         default:
@@ -296,6 +390,33 @@ recv_op {
         }
     }
 
+    bool is_target(control_packet_type type) const {
+        if (!fil) return true;
+        if (*fil == filter::match) return types.find(type) != types.end();
+        return types.find(type) == types.end();
+    }
+
+    template <typename Self>
+    void complete_op(Self& self, error_code ec) {
+        if constexpr (Kind == recv_kind::some) {
+            if (ec && ec != as::error::operation_aborted && !recv_packets.empty()) {
+                // packets decoded before the error are passed first,
+                // and the error is reported by the next async_recv_some()
+                ep->recv_some_error_.emplace(ec);
+                ec = error_code{};
+            }
+            self.complete(ec, force_move(recv_packets));
+        }
+        else if constexpr (Kind == recv_kind::publish_payload) {
+            if (ec) recv_payload.reset();
+            self.complete(ec, recv_payload ? force_move(*recv_payload) : buffer{});
+        }
+        else {
+            if (ec && ec != as::error::operation_aborted) recv_packet.reset();
+            self.complete(ec, force_move(recv_packet));
+        }
+    }
+
     void send_publish_from_queue() {
         if (ep->status_ != close_status::open) return;
         auto vacancy_opt = ep->con_.get_receive_maximum_vacancy_for_send();
@@ -337,7 +458,36 @@ async_recv(
         >,
         void(error_code, std::optional<packet_variant_type>)
     >(
-        recv_op{
+        recv_op<recv_kind::one>{
+            force_move(impl),
+            fil,
+            force_move(types)
+        },
+        handler,
+        exe
+    );
+}
+
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::
+async_recv_some(
+    this_type_sp impl,
+    std::optional<filter> fil,
+    std::set<control_packet_type> types,
+    as::any_completion_handler<
+        void(error_code, std::vector<packet_variant_type>)
+    > handler
+) {
+    auto exe = impl->get_executor();
+    as::async_compose<
+        as::any_completion_handler<
+            void(error_code, std::vector<packet_variant_type>)
+        >,
+        void(error_code, std::vector<packet_variant_type>)
+    >(
+        recv_op<recv_kind::some>{
             force_move(impl),
             fil,
             force_move(types)
@@ -347,6 +497,31 @@ async_recv(
     );
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::
+async_recv_publish_payload(
+    this_type_sp impl,
+    as::any_completion_handler<
+        void(error_code, buffer)
+    > handler
+) {
+    auto exe = impl->get_executor();
+    as::async_compose<
+        as::any_completion_handler<
+            void(error_code, buffer)
+        >,
+        void(error_code, buffer)
+    >(
+        recv_op<recv_kind::publish_payload>{
+            force_move(impl)
+        },
+        handler,
+        exe
+    );
+}
+
 } // namespace async_mqtt::detail
 
 #include <async_mqtt/asio_bind/impl/endpoint_instantiate.hpp>
@@ -9,6 +9,7 @@
 
 #include <async_mqtt/asio_bind/endpoint.hpp>
 #include <async_mqtt/asio_bind/impl/endpoint_impl.hpp>
+#include <async_mqtt/asio_bind/detail/packet_sequence.hpp>
 #include <async_mqtt/protocol/event/timer.hpp>
 #include <async_mqtt/protocol/event/close.hpp>
 #include <async_mqtt/protocol/event/packet_received.hpp>
@@ -217,6 +218,268 @@ send_op {
     }
 };
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+template <typename Packet>
+struct basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::
+send_packets_op {
+    this_type_sp ep;
+    std::vector<Packet> packets;
+    std::optional<error_code> decided_error = std::nullopt;
+    // the number of packets from the beginning that are passed the sending check
+    std::size_t accepted = 0;
+    // true if at least one PUBLISH packet is enqueued due to receive_maximum
+    bool enqueued = false;
+    basic_packet_sequence<PacketIdBytes> sequence = {};
+    std::vector<typename basic_packet_id_type<PacketIdBytes>::type> release_pids_if_send_error = {};
+    bool close_requested = false;
+    bool disconnect_sent_just_before = false;
+    enum { dispatch, write, sent, close, complete } state = dispatch;
+
+    // returns false if the rest of the packets shouldn't be processed
+    bool process_events(
+        Packet& packet,
+        std::vector<basic_event_variant<PacketIdBytes>> events
+    ) {
+        auto& a_ep{*ep};
+        bool ret = true;
+        for (auto& event : events) {
+            std::visit(
+                overload{
+                    [&](error_code ec) {
+                        if (ec == disconnect_reason_code::receive_maximum_exceeded) {
+                            if (auto* p = get_v5_publish(packet)) {
+                                auto success = a_ep.register_packet_id(p->packet_id());
+                                if (success) {
+                                    a_ep.enqueue_publish(*p);
+                                    enqueued = true;
+                                    return;
+                                }
+                                BOOST_ASSERT(false);
+                            }
+                        }
+                        decided_error.emplace(ec);
+                        ret = false;
+                    },
+                    [&](async_mqtt::event::timer ev) {
+                        switch (ev.get_kind()) {
+                        case timer_kind::pingreq_send:
+                            switch (ev.get_op()) {
+                            case timer_op::reset:
+                                reset_pingreq_send_timer(ep, ev.get_ms());
+                                break;
+                            case timer_op::cancel:
+                                cancel_pingreq_send_timer(ep);
+                                break;
+                            default:
+                                BOOST_ASSERT(false);
+                                break;
+                            }
+                            break;
+                        case timer_kind::pingreq_recv:
+                            switch (ev.get_op()) {
+                            case timer_op::reset:
+                                reset_pingreq_recv_timer(ep, ev.get_ms());
+                                break;
+                            case timer_op::cancel:
+                                cancel_pingreq_recv_timer(ep);
+                                break;
+                            default:
+                                BOOST_ASSERT(false);
+                                break;
+                            }
+                            break;
+                        case timer_kind::pingresp_recv:
+                            switch (ev.get_op()) {
+                            case timer_op::reset:
+                                reset_pingresp_recv_timer(ep, ev.get_ms());
+                                break;
+                            case timer_op::cancel:
+                                cancel_pingresp_recv_timer(ep);
+                                break;
+                            default:
+                                BOOST_ASSERT(false);
+                                break;
+                            }
+                            break;
+                        }
+                    },
+                    [&](async_mqtt::event::basic_packet_id_released<PacketIdBytes> ev) {
+                        a_ep.notify_release_pid(ev.get());
+                    },
+                    [&](async_mqtt::event::basic_send<PacketIdBytes> ev) {
+                        disconnect_sent_just_before = ev.get().type() == control_packet_type::disconnect;
+                        if (auto pid_opt = ev.get_release_packet_id_if_send_error()) {
+                            release_pids_if_send_error.push_back(*pid_opt);
+                        }
+                        sequence.push_back(force_move(ev.get()));
+                    },
+                    [&](async_mqtt::event::close) {
+                        close_requested = true;
+                        ret = false;
+                    },
+                    [&](auto const&) {
+                        BOOST_ASSERT(false);
+                    }
+                },
+                force_move(event)
+            );
+        }
+        return ret;
+    }
+
+    static v5::basic_publish_packet<PacketIdBytes>* get_v5_publish(Packet& packet) {
+        if constexpr (std::is_same_v<Packet, v5::basic_publish_packet<PacketIdBytes>>) {
+            return &packet;
+        }
+        else if constexpr (std::is_same_v<Packet, basic_packet_variant<PacketIdBytes>>) {
+            return packet.template get_if<v5::basic_publish_packet<PacketIdBytes>>();
+        }
+        else {
+            return nullptr;
+        }
+    }
+
+    void release_packet_id(typename basic_packet_id_type<PacketIdBytes>::type packet_id) {
+        auto& a_ep{*ep};
+        for (auto& event : a_ep.con_.release_packet_id(packet_id)) {
+            if (auto* ev = std::get_if<async_mqtt::event::basic_packet_id_released<PacketIdBytes>>(&event)) {
+                a_ep.notify_release_pid(ev->get());
+            }
+        }
+    }
+
+    // release packet_ids of the packets that are not processed
+    void release_rest_packet_ids(std::size_t from) {
+        auto release =
+            [&](auto const& actual_packet) {
+                using packet_type = std::decay_t<decltype(actual_packet)>;
+                if constexpr(own_packet_id<packet_type>()) {
+                    auto packet_id = actual_packet.packet_id();
+                    if (packet_id != 0) release_packet_id(packet_id);
+                }
+            };
+        for (auto i = from; i < packets.size(); ++i) {
+            if constexpr (
+                std::is_same_v<Packet, basic_packet_variant<PacketIdBytes>> ||
+                std::is_same_v<Packet, basic_store_packet_variant<PacketIdBytes>>
+            ) {
+                packets[i].visit(release);
+            }
+            else {
+                release(packets[i]);
+            }
+        }
+    }
+
+    template <typename Self>
+    void operator()(
+        Self& self,
+        error_code ec = error_code{},
+        std::size_t /*bytes_transferred*/ = 0
+    ) {
+        auto& a_ep{*ep};
+        if (ec) {
+            ASYNC_MQTT_LOG("mqtt_impl", info)
+                << ASYNC_MQTT_ADD_VALUE(address, &a_ep)
+                << "send packets error:" << ec.message();
+            for (auto pid : release_pids_if_send_error) {
+                release_packet_id(pid);
+            }
+            // The packets are written by one gather write,
+            // so none of them is known to be written.
+            self.complete(ec, 0);
+            return;
+        }
+
+        switch (state) {
+        case dispatch: {
+            state = write;
+            as::dispatch(
+                a_ep.get_executor(),
+                force_move(self)
+            );
+        } break;
+        case write: {
+            // check all packets in one pass
+            for (; accepted != packets.size(); ++accepted) {
+                auto& packet{packets[accepted]};
+                if (!process_events(packet, a_ep.con_.send(packet))) {
+                    if (decided_error) {
+                        // the packet_id of the error packet has already been released
+                        release_rest_packet_ids(accepted + 1);
+                    }
+                    else {
+                        // close is requested just after sending the packet
+                        ++accepted;
+                        release_rest_packet_ids(accepted);
+                    }
+                    break;
+                }
+            }
+            if (sequence.empty()) {
+                state = close_requested ? close : complete;
+                as::dispatch(
+                    a_ep.get_executor(),
+                    force_move(self)
+                );
+            }
+            else {
+                state = sent;
+                a_ep.stream_.async_write_packet(
+                    force_move(sequence),
+                    force_move(self)
+                );
+            }
+        } break;
+        case sent: {
+            if (close_requested) {
+                state = close;
+                if (disconnect_sent_just_before &&
+                    a_ep.duration_close_by_disconnect_ != std::chrono::milliseconds::zero()
+                ) {
+                    a_ep.tim_close_by_disconnect_.expires_after(a_ep.duration_close_by_disconnect_);
+                    a_ep.tim_close_by_disconnect_.async_wait(
+                        force_move(self)
+                    );
+                }
+                else {
+                    as::post(
+                        a_ep.get_executor(),
+                        force_move(self)
+                    );
+                }
+            }
+            else {
+                state = complete;
+                as::dispatch(
+                    a_ep.get_executor(),
+                    force_move(self)
+                );
+            }
+        } break;
+        case close: {
+            state = complete;
+            auto ep_copy{ep};
+            async_close(
+                force_move(ep_copy),
+                force_move(self)
+            );
+        } break;
+        case complete: {
+            if (decided_error) {
+                self.complete(*decided_error, accepted);
+            }
+            else if (enqueued) {
+                self.complete(make_error_code(mqtt_error::packet_enqueued), accepted);
+            }
+            else {
+                self.complete(ec, accepted);
+            }
+        } break;
+        }
+    }
+};
+
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
 template <typename Packet, typename CompletionToken>
 auto
@@ -268,6 +531,30 @@ basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::async_send(
         );
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+template <typename Packet, typename CompletionToken>
+auto
+basic_endpoint_impl<Role, PacketIdBytes, NextLayer>::async_send(
+    this_type_sp impl,
+    std::vector<Packet> packets,
+    CompletionToken&& token
+) {
+    BOOST_ASSERT(impl);
+    auto exe = impl->get_executor();
+    return
+        as::async_compose<
+            CompletionToken,
+            void(error_code, std::size_t)
+        >(
+            send_packets_op<Packet>{
+                force_move(impl),
+                force_move(packets)
+            },
+            token,
+            exe
+        );
+}
+
 } // namespace detail
 
 template <role Role, std::size_t PacketIdBytes, typename NextLayer>
@@ -289,6 +576,25 @@ basic_endpoint<Role, PacketIdBytes, NextLayer>::async_send(
         );
 }
 
+template <role Role, std::size_t PacketIdBytes, typename NextLayer>
+template <typename Packet, typename CompletionToken>
+auto
+basic_endpoint<Role, PacketIdBytes, NextLayer>::async_send(
+    std::vector<Packet> packets,
+    CompletionToken&& token
+) {
+    ASYNC_MQTT_LOG("mqtt_api", info)
+        << ASYNC_MQTT_ADD_VALUE(address, this)
+        << "send packets:" << packets.size();
+    BOOST_ASSERT(impl_);
+    return
+        impl_type::async_send(
+            impl_,
+            force_move(packets),
+            std::forward<CompletionToken>(token)
+        );
+}
+
 } // namespace async_mqtt
 
 #endif // ASYNC_MQTT_ASIO_BIND_IMPL_ENDPOINT_SEND_HPP
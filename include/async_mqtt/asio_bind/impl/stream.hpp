@@ -120,6 +120,14 @@ public:
         impl_->set_bulk_write(val);
     }
 
+    void set_contiguous_write_threshold(std::size_t val) {
+        impl_->set_contiguous_write_threshold(val);
+    }
+
+    void set_zerocopy_write_threshold(std::size_t val) {
+        impl_->set_zerocopy_write_threshold(val);
+    }
+
     template <typename Executor1>
     struct rebind_executor {
         using other = stream<
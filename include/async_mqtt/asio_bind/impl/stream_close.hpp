@@ -54,6 +54,7 @@ struct stream_impl<NextLayer>::stream_close_op {
             BOOST_ASSERT(state == complete);
             a_strm.storing_cbs_.clear();
             a_strm.sending_cbs_.clear();
+            a_strm.zc_.reset();
             self.complete(ec);
         }
     }
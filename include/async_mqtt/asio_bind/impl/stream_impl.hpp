@@ -10,10 +10,13 @@
 #include <utility>
 #include <type_traits>
 #include <deque>
+#include <vector>
 
 #include <boost/asio/async_result.hpp>
+#include <boost/asio/buffer.hpp>
 
 #include <async_mqtt/asio_bind/detail/stream_layer.hpp>
+#include <async_mqtt/asio_bind/detail/zerocopy_sender.hpp>
 #include <async_mqtt/asio_bind/stream_customize.hpp>
 #include <async_mqtt/asio_bind/impl/stream_fwd.hpp>
 #include <async_mqtt/protocol/error.hpp>
@@ -89,6 +92,15 @@ public:
 
     void set_bulk_write(bool val) {
         bulk_write_ = val;
+        set_bulk_write(nl_, val);
+    }
+
+    void set_contiguous_write_threshold(std::size_t val) {
+        contiguous_write_threshold_ = val;
+    }
+
+    void set_zerocopy_write_threshold(std::size_t val) {
+        zerocopy_write_threshold_ = val;
     }
 
     template <typename Executor1>
@@ -109,8 +121,71 @@ private:
         }
     }
 
+    template <typename Layer>
+    static void set_bulk_write(Layer& layer, bool val) {
+        if constexpr (has_next_layer<Layer>::value) {
+            set_bulk_write(layer.next_layer(), val);
+        }
+        if constexpr(has_set_bulk_write<Layer>::value) {
+            layer_customize<Layer>::set_bulk_write(layer, val);
+        }
+    }
+
     void init_read();
 
+    // write_queue_ guarantees that only one write uses contiguous_buf_ at a time
+    template <typename ConstBufferSequence>
+    as::const_buffer to_contiguous(ConstBufferSequence const& cbs, std::size_t size) {
+        contiguous_buf_.resize(size);
+        as::buffer_copy(as::buffer(contiguous_buf_), cbs);
+        return as::buffer(contiguous_buf_);
+    }
+
+    // zerocopy is applied only to the TCP socket that is the next layer.
+    // on other layers, the bytes are copied or transformed before sending.
+    bool use_zerocopy(std::size_t size) {
+        if constexpr (
+            zerocopy_supported &&
+            is_tcp_socket<next_layer_type>::value
+        ) {
+            if (zerocopy_write_threshold_ == 0 || size < zerocopy_write_threshold_) return false;
+            return zc_.setup(nl_.native_handle());
+        }
+        else {
+            (void)size;
+            return false;
+        }
+    }
+
+    // the error queue is watched while the lifetimes are held.
+    // the wait is started before reap() in order not to miss the notification.
+    static void zerocopy_reap(this_type_sp const& sp) {
+        if constexpr (
+            zerocopy_supported &&
+            is_tcp_socket<next_layer_type>::value
+        ) {
+            if (!sp->zc_waiting_ && sp->zc_.pending()) {
+                sp->zc_waiting_ = true;
+                sp->nl_.async_wait(
+                    as::socket_base::wait_error,
+                    [wp = std::weak_ptr<this_type>{sp}](error_code const& ec) {
+                        auto sp = wp.lock();
+                        if (!sp) return;
+                        sp->zc_waiting_ = false;
+                        // canceled by close, or the wait itself is failed. the wait is not repeated
+                        if (ec) return;
+                        sp->zc_.reap(true);
+                        zerocopy_reap(sp);
+                    }
+                );
+            }
+            sp->zc_.reap();
+        }
+        else {
+            (void)sp;
+        }
+    }
+
     void parse_packet();
 
     template <
@@ -149,6 +224,11 @@ private:
     std::vector<as::const_buffer> storing_cbs_;
     std::vector<as::const_buffer> sending_cbs_;
     bool bulk_write_ = false;
+    std::size_t contiguous_write_threshold_ = 0;
+    std::vector<char> contiguous_buf_;
+    std::size_t zerocopy_write_threshold_ = 0;
+    zerocopy_sender zc_;
+    bool zc_waiting_ = false;
 };
 
 } // namespace async_mqtt::detail
@@ -24,7 +24,8 @@ struct stream_impl<NextLayer>::stream_write_packet_op {
     std::shared_ptr<stream_type> strm;
     std::shared_ptr<Packet> packet;
     std::size_t size = packet->size();
-    enum { dispatch, post, write, bulk_write, complete } state = dispatch;
+    std::size_t written = 0;
+    enum { dispatch, post, write, bulk_write, zerocopy_write, complete } state = dispatch;
 
     template <typename Self>
     void operator()(
@@ -59,19 +60,23 @@ struct stream_impl<NextLayer>::stream_write_packet_op {
             if (a_strm.lowest_layer().is_open()) {
                 state = complete;
                 auto& a_packet{*packet};
-                if constexpr (
-                    has_async_write<next_layer_type>::value) {
-                    layer_customize<next_layer_type>::async_write(
-                        a_strm.nl_,
-                        a_packet.const_buffer_sequence(),
-                        force_move(self)
+                if (a_strm.use_zerocopy(size)) {
+                    state = zerocopy_write;
+                    zerocopy_write_impl(self);
+                }
+                else if (size <= a_strm.contiguous_write_threshold_) {
+                    // small packet is copied into one buffer to avoid many tiny writes
+                    async_write_impl(
+                        a_strm,
+                        a_strm.to_contiguous(a_packet.const_buffer_sequence(), size),
+                        self
                     );
                 }
                 else {
-                    async_write(
-                        a_strm.nl_,
+                    async_write_impl(
+                        a_strm,
                         a_packet.const_buffer_sequence(),
-                        force_move(self)
+                        self
                     );
                 }
             }
@@ -104,19 +109,19 @@ struct stream_impl<NextLayer>::stream_write_packet_op {
                 }
                 else {
                     a_strm.sending_cbs_ = force_move(a_strm.storing_cbs_);
-                    if constexpr (
-                        has_async_write<next_layer_type>::value) {
-                        layer_customize<next_layer_type>::async_write(
-                            a_strm.nl_,
-                            a_strm.sending_cbs_,
-                            force_move(self)
+                    auto total_size = as::buffer_size(a_strm.sending_cbs_);
+                    if (total_size <= a_strm.contiguous_write_threshold_) {
+                        async_write_impl(
+                            a_strm,
+                            a_strm.to_contiguous(a_strm.sending_cbs_, total_size),
+                            self
                         );
                     }
                     else {
-                        async_write(
-                            a_strm.nl_,
+                        async_write_impl(
+                            a_strm,
                             a_strm.sending_cbs_,
-                            force_move(self)
+                            self
                         );
                     }
                 }
@@ -139,6 +144,78 @@ struct stream_impl<NextLayer>::stream_write_packet_op {
         }
     }
 
+    // MSG_ZEROCOPY is used. the packet is held by the stream until the kernel finishes sending
+    template <typename Self>
+    void zerocopy_write_impl(Self& self) {
+        auto& a_strm{*strm};
+        while (written != size) {
+            error_code ec;
+            written += a_strm.zc_.send(packet->const_buffer_sequence(), written, ec);
+            if (ec == as::error::would_block) {
+                a_strm.nl_.async_wait(
+                    as::socket_base::wait_write,
+                    force_move(self)
+                );
+                return;
+            }
+            if (ec) {
+                // the bytes that are sent before the error could still be referred by the kernel
+                a_strm.zc_.hold(packet);
+                stream_type::zerocopy_reap(strm);
+                state = complete;
+                (*this)(self, ec, written);
+                return;
+            }
+        }
+        a_strm.zc_.hold(packet);
+        stream_type::zerocopy_reap(strm);
+        state = complete;
+        (*this)(self, error_code{}, size);
+    }
+
+    template <typename Self>
+    void operator()(
+        Self& self,
+        error_code ec
+    ) {
+        BOOST_ASSERT(state == zerocopy_write);
+        if (ec) {
+            if (written != 0) {
+                // the bytes that are sent before the wait could still be referred by the kernel
+                auto& a_strm{*strm};
+                a_strm.zc_.hold(packet);
+                stream_type::zerocopy_reap(strm);
+            }
+            state = complete;
+            (*this)(self, ec, written);
+            return;
+        }
+        zerocopy_write_impl(self);
+    }
+
+    template <typename ConstBufferSequence, typename Self>
+    static void async_write_impl(
+        stream_type& a_strm,
+        ConstBufferSequence const& cbs,
+        Self& self
+    ) {
+        if constexpr (
+            has_async_write<next_layer_type>::value) {
+            layer_customize<next_layer_type>::async_write(
+                a_strm.nl_,
+                cbs,
+                force_move(self)
+            );
+        }
+        else {
+            async_write(
+                a_strm.nl_,
+                cbs,
+                force_move(self)
+            );
+        }
+    }
+
     template <typename Self>
     void operator()(
         Self& self,
@@ -0,0 +1,302 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_INPROC_STREAM_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_INPROC_STREAM_HPP
+
+#include <memory>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/stream_customize.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/inproc_stream.hpp>
+#include <async_mqtt/util/log.hpp>
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+namespace detail {
+
+template <typename Self>
+struct inproc_read_completion : inproc_completion {
+    inproc_read_completion(Self&& self, as::any_io_executor exe)
+        :self{force_move(self)},
+         exe{force_move(exe)}
+    {}
+
+    void complete(error_code const& ec) override {
+        as::post(
+            exe,
+            [self = force_move(self), ec]() mutable {
+                self(ec);
+            }
+        );
+    }
+
+    Self self;
+    as::any_io_executor exe;
+};
+
+template <typename Self>
+struct inproc_write_completion : inproc_completion {
+    inproc_write_completion(Self&& self, as::any_io_executor exe, std::size_t size)
+        :self{force_move(self)},
+         exe{force_move(exe)},
+         size{size}
+    {}
+
+    void complete(error_code const& ec) override {
+        as::post(
+            exe,
+            [self = force_move(self), ec, size = ec ? 0 : size]() mutable {
+                self(ec, size);
+            }
+        );
+    }
+
+    Self self;
+    as::any_io_executor exe;
+    std::size_t size;
+};
+
+} // namespace detail
+
+/**
+ * @brief customization class template specialization for inproc_stream
+ *
+ * @see
+ *   <a href="../../customize.html">Layor customize</a>
+ */
+template <>
+struct layer_customize<inproc_stream> {
+
+    // async_handshake
+
+    template <
+        typename CompletionToken
+    >
+    static auto
+    async_handshake(
+        inproc_stream& stream,
+        inproc_stream& peer,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code)
+        > (
+            [&stream, &peer](auto& self) {
+                ASYNC_MQTT_LOG("mqtt_impl", info)
+                    << "inproc connect";
+                stream.connect(peer);
+                self.complete(error_code{});
+            },
+            token,
+            stream
+        );
+    }
+
+    // async_read_some
+
+    template <
+        typename MutableBufferSequence,
+        typename CompletionToken
+    >
+    static auto
+    async_read_some(
+        inproc_stream& stream,
+        MutableBufferSequence const& buffers,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec, std::size_t size)
+        > (
+            async_read_some_impl<MutableBufferSequence>{
+                stream.rx_,
+                stream.get_executor(),
+                buffers
+            },
+            token,
+            stream
+        );
+    }
+
+    template <typename MutableBufferSequence>
+    struct async_read_some_impl {
+        std::shared_ptr<detail::inproc_pipe> rx;
+        as::any_io_executor exe;
+        MutableBufferSequence buffers;
+        enum { dispatch, read } state = dispatch;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code const& ec = error_code{}
+        ) {
+            if (state == dispatch) {
+                state = read;
+                auto exe_copy{exe};
+                as::dispatch(
+                    exe_copy,
+                    force_move(self)
+                );
+                return;
+            }
+            if (ec) {
+                self.complete(ec, 0);
+                return;
+            }
+            if (!rx) {
+                self.complete(as::error::not_connected, 0);
+                return;
+            }
+            if (as::buffer_size(buffers) == 0) {
+                self.complete(error_code{}, 0);
+                return;
+            }
+            if (auto size = rx->pop(buffers)) {
+                self.complete(error_code{}, size);
+                return;
+            }
+            if (rx->closed()) {
+                self.complete(as::error::eof, 0);
+                return;
+            }
+            // wait until the peer writes
+            // this op is moved to the completion, members must not be accessed after here
+            auto a_rx{rx};
+            auto a_exe{exe};
+            std::unique_ptr<detail::inproc_completion> reader{
+                new detail::inproc_read_completion<Self>{force_move(self), force_move(a_exe)}
+            };
+            if (!a_rx->wait(reader)) {
+                // written or closed during the preparation, retry
+                reader->complete(error_code{});
+            }
+        }
+    };
+
+    // async_write
+
+    template <
+        typename ConstBufferSequence,
+        typename CompletionToken
+    >
+    static auto
+    async_write(
+        inproc_stream& stream,
+        ConstBufferSequence const& cbs,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec, std::size_t size)
+        > (
+            async_write_impl<ConstBufferSequence>{
+                stream.tx_,
+                stream.get_executor(),
+                cbs
+            },
+            token,
+            stream
+        );
+    }
+
+    template <typename ConstBufferSequence>
+    struct async_write_impl {
+        std::shared_ptr<detail::inproc_pipe> tx;
+        as::any_io_executor exe;
+        ConstBufferSequence cbs;
+        enum { dispatch, write, complete } state = dispatch;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code const& ec = error_code{},
+            std::size_t size = 0
+        ) {
+            if (state == dispatch) {
+                state = write;
+                auto exe_copy{exe};
+                as::dispatch(
+                    exe_copy,
+                    force_move(self)
+                );
+                return;
+            }
+            if (state == complete) {
+                self.complete(ec, size);
+                return;
+            }
+            if (!tx) {
+                self.complete(as::error::not_connected, 0);
+                return;
+            }
+            state = complete;
+            std::vector<as::const_buffer> bufs;
+            std::size_t total = 0;
+            for (
+                auto it = as::buffer_sequence_begin(cbs), end = as::buffer_sequence_end(cbs);
+                it != end;
+                ++it
+            ) {
+                as::const_buffer cb{*it};
+                if (cb.size() == 0) continue;
+                total += cb.size();
+                bufs.push_back(cb);
+            }
+            if (total == 0) {
+                self.complete(error_code{}, 0);
+                return;
+            }
+            // this op is moved to the completion, members must not be accessed after here
+            auto a_tx{tx};
+            auto a_exe{exe};
+            std::unique_ptr<detail::inproc_completion> comp{
+                new detail::inproc_write_completion<Self>{
+                    force_move(self),
+                    force_move(a_exe),
+                    total
+                }
+            };
+            if (!a_tx->push(force_move(bufs), comp)) {
+                comp->complete(as::error::broken_pipe);
+            }
+        }
+    };
+
+    // async_close
+
+    template <
+        typename CompletionToken
+    >
+    static auto
+    async_close(
+        inproc_stream& stream,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec)
+        > (
+            [&stream](auto& self) {
+                ASYNC_MQTT_LOG("mqtt_impl", info)
+                    << "inproc close";
+                stream.close();
+                self.complete(error_code{});
+            },
+            token,
+            stream
+        );
+    }
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_INPROC_STREAM_HPP
@@ -0,0 +1,194 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_KTLS_STREAM_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_KTLS_STREAM_HPP
+
+#include <string>
+#include <string_view>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/stream_customize.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/ktls_stream.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/customized_basic_stream.hpp>
+#include <async_mqtt/util/log.hpp>
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+/**
+ * @brief customization class template specialization for ktls_stream
+ *
+ * @see
+ *   <a href="../../customize.html">Layor customize</a>
+ */
+template <>
+struct layer_customize<ktls_stream> {
+
+    // async_handshake
+
+    template <
+        typename CompletionToken
+    >
+    static auto
+    async_handshake(
+        ktls_stream& stream,
+        std::string_view host,
+        std::string_view port,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code)
+        > (
+            handshake_op{
+                stream,
+                host,
+                port
+            },
+            token,
+            stream.next_layer()
+        );
+    }
+
+    struct handshake_op {
+        handshake_op(
+            ktls_stream& stream,
+            std::string_view host,
+            std::string_view port
+        ):stream{stream},
+          host{host},
+          port{port}
+        {}
+
+        ktls_stream& stream;
+        std::string host;
+        std::string port;
+        enum { under, handshake, complete } state = under;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code const& ec = error_code{}
+        ) {
+            switch (state) {
+            case under: {
+                state = handshake;
+                auto& a_stream{stream};
+                auto a_host{host};
+                auto a_port{port};
+                layer_customize<ktls_stream::next_layer_type>::async_handshake(
+                    a_stream.next_layer(),
+                    a_host,
+                    a_port,
+                    force_move(self)
+                );
+            } break;
+            case handshake: {
+                state = complete;
+                if (ec) {
+                    self.complete(ec);
+                    return;
+                }
+                auto& a_stream{stream};
+                a_stream.async_handshake(
+                    as::ssl::stream_base::client,
+                    force_move(self)
+                );
+            } break;
+            default:
+                BOOST_ASSERT(state == complete);
+                self.complete(ec);
+                break;
+            }
+        }
+    };
+
+    // async_write
+
+    template <
+        typename ConstBufferSequence,
+        typename CompletionToken
+    >
+    static auto
+    async_write(
+        ktls_stream& stream,
+        ConstBufferSequence const& cbs,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec, std::size_t size)
+        > (
+            async_write_impl<ConstBufferSequence>{
+                stream,
+                cbs
+            },
+            token,
+            stream.next_layer()
+        );
+    }
+
+    template <typename ConstBufferSequence>
+    struct async_write_impl {
+        ktls_stream& stream;
+        ConstBufferSequence cbs;
+
+        template <typename Self>
+        void operator()(
+            Self& self
+        ) {
+            auto& a_stream{stream};
+            if (a_stream.ktls_send()) {
+                // the kernel encrypts the records. same as the plain TCP socket
+                as::async_write(
+                    a_stream.next_layer(),
+                    cbs,
+                    force_move(self)
+                );
+            }
+            else {
+                as::async_write(
+                    a_stream,
+                    cbs,
+                    force_move(self)
+                );
+            }
+        }
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code const& ec,
+            std::size_t size
+        ) {
+            self.complete(ec, size);
+        }
+    };
+
+    // async_close
+
+    template <
+        typename CompletionToken
+    >
+    static auto
+    async_close(
+        ktls_stream& stream,
+        CompletionToken&& token
+    ) {
+        ASYNC_MQTT_LOG("mqtt_impl", info)
+            << "kTLS shutdown";
+        return stream.async_shutdown(
+            std::forward<CompletionToken>(token)
+        );
+    }
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_KTLS_STREAM_HPP
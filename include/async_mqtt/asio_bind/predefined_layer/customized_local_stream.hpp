@@ -0,0 +1,128 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_LOCAL_STREAM_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_LOCAL_STREAM_HPP
+
+#include <string>
+#include <string_view>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/stream_customize.hpp>
+#include <async_mqtt/util/log.hpp>
+#include <async_mqtt/util/move.hpp>
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+/**
+ * @brief customization class template specialization for Unix domain stream socket
+ *
+ * @see
+ *   <a href="../../customize.html">Layor customize</a>
+ */
+template <typename Executor>
+struct layer_customize<as::basic_stream_socket<as::local::stream_protocol, Executor>> {
+    template <
+        typename CompletionToken
+    >
+    static auto
+    async_handshake(
+        as::basic_stream_socket<as::local::stream_protocol, Executor>& stream,
+        std::string_view path,
+        CompletionToken&& token
+    ) {
+        return
+            as::async_compose<
+                CompletionToken,
+            void(error_code)
+        >(
+            handshake_op{
+                stream,
+                path
+            },
+            token,
+            stream
+        );
+    }
+
+    struct handshake_op {
+        handshake_op(
+            as::basic_stream_socket<as::local::stream_protocol, Executor>& stream,
+            std::string_view path
+        ):stream{stream},
+          path{path}
+        {}
+
+        as::basic_stream_socket<as::local::stream_protocol, Executor>& stream;
+        std::string path;
+        enum { dispatch, connect, complete } state = dispatch;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code const& ec = error_code{}
+        ) {
+            if (state == dispatch) {
+                state = connect;
+                auto& a_stream{stream};
+                as::dispatch(
+                    a_stream.get_executor(),
+                    force_move(self)
+                );
+                return;
+            }
+            if (state == connect) {
+                state = complete;
+                auto& a_stream{stream};
+                a_stream.async_connect(
+                    as::local::stream_protocol::endpoint{path},
+                    force_move(self)
+                );
+            }
+            else {
+                BOOST_ASSERT(state == complete);
+                self.complete(ec);
+            }
+        }
+    };
+
+    template <
+        typename CompletionToken
+    >
+    static auto
+    async_close(
+        as::basic_stream_socket<as::local::stream_protocol, Executor>& stream,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec)
+        > (
+            [&stream](auto& self) {
+                error_code ec;
+                if (stream.is_open()) {
+                    ASYNC_MQTT_LOG("mqtt_impl", info)
+                        << "UDS close";
+                    stream.close(ec);
+                }
+                else {
+                    ASYNC_MQTT_LOG("mqtt_impl", info)
+                        << "UDS already closed";
+                }
+                self.complete(ec);
+            },
+            token,
+            stream
+        );
+    }
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_LOCAL_STREAM_HPP
@@ -0,0 +1,344 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_SHM_STREAM_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_SHM_STREAM_HPP
+
+#include <string>
+#include <string_view>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/stream_customize.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/shm_stream.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/customized_local_stream.hpp>
+#include <async_mqtt/util/log.hpp>
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+/**
+ * @brief customization class template specialization for shm_stream
+ *
+ * @see
+ *   <a href="../../customize.html">Layor customize</a>
+ */
+template <>
+struct layer_customize<shm_stream> {
+
+    // async_handshake
+
+    template <
+        typename CompletionToken
+    >
+    static auto
+    async_handshake(
+        shm_stream& stream,
+        std::string_view path,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code)
+        > (
+            handshake_op{
+                stream,
+                path
+            },
+            token,
+            stream
+        );
+    }
+
+    struct handshake_op {
+        handshake_op(
+            shm_stream& stream,
+            std::string_view path
+        ):stream{stream},
+          path{path}
+        {}
+
+        shm_stream& stream;
+        std::string path;
+        enum { connect, create, complete } state = connect;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code const& ec = error_code{}
+        ) {
+            if (state == connect) {
+                state = create;
+                auto& a_stream{stream};
+                layer_customize<shm_stream::next_layer_type>::async_handshake(
+                    a_stream.next_layer(),
+                    path,
+                    force_move(self)
+                );
+                return;
+            }
+            BOOST_ASSERT(state == create);
+            state = complete;
+            if (ec) {
+                self.complete(ec);
+                return;
+            }
+            self.complete(stream.create_channel());
+        }
+    };
+
+    // async_read_some
+
+    template <
+        typename MutableBufferSequence,
+        typename CompletionToken
+    >
+    static auto
+    async_read_some(
+        shm_stream& stream,
+        MutableBufferSequence const& buffers,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec, std::size_t size)
+        > (
+            async_read_some_impl<MutableBufferSequence>{
+                stream,
+                buffers
+            },
+            token,
+            stream
+        );
+    }
+
+    template <typename MutableBufferSequence>
+    struct async_read_some_impl {
+        shm_stream& stream;
+        MutableBufferSequence buffers;
+        enum { dispatch, read, wait } state = dispatch;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code const& ec = error_code{},
+            std::size_t /* size */ = 0
+        ) {
+            if (state == dispatch) {
+                state = read;
+                auto& a_stream{stream};
+                as::dispatch(
+                    a_stream.get_executor(),
+                    force_move(self)
+                );
+                return;
+            }
+            if (state == wait) {
+                if (ec) {
+                    self.complete(ec, 0);
+                    return;
+                }
+                state = read;
+            }
+            if (!stream.addr_) {
+                self.complete(as::error::not_connected, 0);
+                return;
+            }
+            if (stream.closed_) {
+                self.complete(as::error::operation_aborted, 0);
+                return;
+            }
+            if (as::buffer_size(buffers) == 0) {
+                self.complete(error_code{}, 0);
+                return;
+            }
+            auto& rx{*stream.rx_};
+            while (true) {
+                std::size_t total = 0;
+                for (
+                    auto it = as::buffer_sequence_begin(buffers), end = as::buffer_sequence_end(buffers);
+                    it != end;
+                    ++it
+                ) {
+                    as::mutable_buffer mb{*it};
+                    auto size = rx.read(stream.capacity_, static_cast<char*>(mb.data()), mb.size());
+                    total += size;
+                    if (size != mb.size()) break;
+                }
+                if (total != 0) {
+                    // the peer might wait for space
+                    shm_stream::wake_peer(rx.writer_waiting, stream.peer_space_efd_);
+                    self.complete(error_code{}, total);
+                    return;
+                }
+                if (rx.closed.load(std::memory_order_acquire)) {
+                    self.complete(as::error::eof, 0);
+                    return;
+                }
+                if (
+                    shm_stream::prepare_wait(
+                        rx.reader_waiting,
+                        [&] {
+                            return !rx.empty() || rx.closed.load(std::memory_order_acquire);
+                        }
+                    )
+                ) {
+                    break;
+                }
+            }
+            // wait until the peer writes
+            state = wait;
+            auto& a_stream{stream};
+            a_stream.data_efd_.async_read_some(
+                as::buffer(&a_stream.data_efd_value_, sizeof(a_stream.data_efd_value_)),
+                force_move(self)
+            );
+        }
+    };
+
+    // async_write
+
+    template <
+        typename ConstBufferSequence,
+        typename CompletionToken
+    >
+    static auto
+    async_write(
+        shm_stream& stream,
+        ConstBufferSequence const& cbs,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec, std::size_t size)
+        > (
+            async_write_impl<ConstBufferSequence>{
+                stream,
+                cbs
+            },
+            token,
+            stream
+        );
+    }
+
+    template <typename ConstBufferSequence>
+    struct async_write_impl {
+        shm_stream& stream;
+        ConstBufferSequence cbs;
+        std::size_t written = 0;
+        enum { dispatch, write, wait } state = dispatch;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code const& ec = error_code{},
+            std::size_t /* size */ = 0
+        ) {
+            if (state == dispatch) {
+                state = write;
+                auto& a_stream{stream};
+                as::dispatch(
+                    a_stream.get_executor(),
+                    force_move(self)
+                );
+                return;
+            }
+            if (state == wait) {
+                if (ec) {
+                    self.complete(ec, written);
+                    return;
+                }
+                state = write;
+            }
+            if (!stream.addr_) {
+                self.complete(as::error::not_connected, written);
+                return;
+            }
+            if (stream.closed_) {
+                self.complete(as::error::operation_aborted, written);
+                return;
+            }
+            auto& tx{*stream.tx_};
+            while (true) {
+                if (tx.closed.load(std::memory_order_acquire)) {
+                    self.complete(as::error::broken_pipe, written);
+                    return;
+                }
+                auto skip = written;
+                bool full = false;
+                for (
+                    auto it = as::buffer_sequence_begin(cbs), end = as::buffer_sequence_end(cbs);
+                    it != end && !full;
+                    ++it
+                ) {
+                    as::const_buffer cb{*it};
+                    if (skip >= cb.size()) {
+                        skip -= cb.size();
+                        continue;
+                    }
+                    cb += skip;
+                    skip = 0;
+                    auto size = tx.write(stream.capacity_, static_cast<char const*>(cb.data()), cb.size());
+                    written += size;
+                    full = size != cb.size();
+                }
+                // the peer might wait for data
+                shm_stream::wake_peer(tx.reader_waiting, stream.peer_data_efd_);
+                if (!full) {
+                    self.complete(error_code{}, written);
+                    return;
+                }
+                if (
+                    shm_stream::prepare_wait(
+                        tx.writer_waiting,
+                        [&] {
+                            return !tx.full(stream.capacity_) || tx.closed.load(std::memory_order_acquire);
+                        }
+                    )
+                ) {
+                    break;
+                }
+            }
+            // wait until the peer reads
+            state = wait;
+            auto& a_stream{stream};
+            a_stream.space_efd_.async_read_some(
+                as::buffer(&a_stream.space_efd_value_, sizeof(a_stream.space_efd_value_)),
+                force_move(self)
+            );
+        }
+    };
+
+    // async_close
+
+    template <
+        typename CompletionToken
+    >
+    static auto
+    async_close(
+        shm_stream& stream,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec)
+        > (
+            [&stream](auto& self) {
+                ASYNC_MQTT_LOG("mqtt_impl", info)
+                    << "shared memory close";
+                stream.close_channel();
+                self.complete(error_code{});
+            },
+            token,
+            stream
+        );
+    }
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_SHM_STREAM_HPP
@@ -0,0 +1,381 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_URING_STREAM_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_URING_STREAM_HPP
+
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/stream_customize.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/uring_stream.hpp>
+#include <async_mqtt/util/log.hpp>
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+namespace detail {
+
+template <typename Self>
+struct uring_write_completion : uring_completion {
+    uring_write_completion(
+        Self&& self,
+        as::any_io_executor exe,
+        uring_context& ctx,
+        std::optional<std::uint16_t> buf_index
+    ):self{force_move(self)},
+      exe{force_move(exe)},
+      ctx{ctx},
+      buf_index{buf_index}
+    {}
+
+    void on_cqe(std::int32_t res, std::uint32_t flags) override {
+        if (flags & IORING_CQE_F_NOTIF) {
+            // zerocopy send finished referring to the buffer
+            if (buf_index) ctx.release_write_buffer(*buf_index);
+            return;
+        }
+        // if IORING_CQE_F_MORE is set, the notification follows
+        if (buf_index && !(flags & IORING_CQE_F_MORE)) ctx.release_write_buffer(*buf_index);
+        as::post(
+            exe,
+            [self = force_move(self), res]() mutable {
+                if (res < 0) {
+                    self(error_code{-res, boost::system::system_category()}, 0);
+                }
+                else {
+                    self(error_code{}, static_cast<std::size_t>(res));
+                }
+            }
+        );
+    }
+
+    void abandon() override {
+        // destroy the operation on its executor
+        as::post(
+            exe,
+            [p = std::unique_ptr<uring_write_completion>(this)] {}
+        );
+    }
+
+    Self self;
+    as::any_io_executor exe;
+    uring_context& ctx;
+    std::optional<std::uint16_t> buf_index;
+    std::vector<iovec> iovs;
+    msghdr msg{};
+};
+
+} // namespace detail
+
+/**
+ * @brief customization class template specialization for uring_stream
+ *
+ * @see
+ *   <a href="../../customize.html">Layor customize</a>
+ */
+template <typename NextLayer>
+struct layer_customize<uring_stream<NextLayer>> {
+
+    // async_handshake
+
+    template <
+        typename CompletionToken
+    >
+    static auto
+    async_handshake(
+        uring_stream<NextLayer>& stream,
+        std::string_view host,
+        std::string_view port,
+        CompletionToken&& token
+    ) {
+        stream.reset();
+        return layer_customize<NextLayer>::async_handshake(
+            stream.next_layer(),
+            host,
+            port,
+            std::forward<CompletionToken>(token)
+        );
+    }
+
+    // async_read_some
+
+    template <
+        typename MutableBufferSequence,
+        typename CompletionToken
+    >
+    static auto
+    async_read_some(
+        uring_stream<NextLayer>& stream,
+        MutableBufferSequence const& buffers,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec, std::size_t size)
+        > (
+            async_read_some_impl<MutableBufferSequence>{
+                stream,
+                buffers
+            },
+            token,
+            stream
+        );
+    }
+
+    template <typename MutableBufferSequence>
+    struct async_read_some_impl {
+        uring_stream<NextLayer>& stream;
+        MutableBufferSequence buffers;
+        enum { dispatch, read, wait } state = dispatch;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code const& /* ec */ = error_code{}
+        ) {
+            if (state == dispatch) {
+                state = read;
+                auto& a_stream{stream};
+                as::dispatch(
+                    a_stream.get_executor(),
+                    force_move(self)
+                );
+                return;
+            }
+
+            auto& st{stream.state()};
+            if (state == wait && !st.notified) {
+                // the timer is cancelled by the caller
+                self.complete(as::error::operation_aborted, 0);
+                return;
+            }
+            state = read;
+            if (as::buffer_size(buffers) == 0) {
+                self.complete(error_code{}, 0);
+                return;
+            }
+            if (!st.chunks.empty()) {
+                auto size = st.consume(buffers);
+                self.complete(error_code{}, size);
+                return;
+            }
+            if (st.recv_ec) {
+                self.complete(st.recv_ec, 0);
+                return;
+            }
+            if (st.closed || st.fd == -1) {
+                self.complete(as::error::operation_aborted, 0);
+                return;
+            }
+
+            // wait until data is received
+            st.arm(st.fd);
+            state = wait;
+            st.notified = false;
+            st.tim.expires_at(as::steady_timer::time_point::max());
+            st.tim.async_wait(force_move(self));
+        }
+    };
+
+    // async_write
+
+    template <
+        typename ConstBufferSequence,
+        typename CompletionToken
+    >
+    static auto
+    async_write(
+        uring_stream<NextLayer>& stream,
+        ConstBufferSequence const& cbs,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec, std::size_t size)
+        > (
+            async_write_impl<ConstBufferSequence>{
+                stream,
+                cbs
+            },
+            token,
+            stream
+        );
+    }
+
+    template <typename ConstBufferSequence>
+    struct async_write_impl {
+        uring_stream<NextLayer>& stream;
+        ConstBufferSequence cbs;
+        std::size_t total = 0;
+        std::size_t written = 0;
+        enum { dispatch, write, complete } state = dispatch;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code const& ec = error_code{},
+            std::size_t size = 0
+        ) {
+            if (state == dispatch) {
+                state = write;
+                total = as::buffer_size(cbs);
+                auto& a_stream{stream};
+                as::dispatch(
+                    a_stream.get_executor(),
+                    force_move(self)
+                );
+                return;
+            }
+            if (state == complete) {
+                written += size;
+                if (ec) {
+                    self.complete(ec, written);
+                    return;
+                }
+            }
+            if (written == total) {
+                self.complete(error_code{}, written);
+                return;
+            }
+            auto& st{stream.state()};
+            if (st.closed || st.fd == -1) {
+                self.complete(as::error::operation_aborted, written);
+                return;
+            }
+            state = complete;
+            auto& ctx{st.ctx};
+            auto fd{st.fd};
+            auto rest = total - written;
+            if (rest <= ctx.write_buf_size()) {
+                if (auto index = ctx.acquire_write_buffer()) {
+                    // copy to the preallocated buffer
+                    auto* p = ctx.write_buffer(*index);
+                    auto buf = as::buffer(p, rest);
+                    for_each_rest(
+                        [&](as::const_buffer cb) {
+                            as::buffer_copy(buf, cb);
+                            buf += cb.size();
+                        }
+                    );
+                    ctx.submit(
+                        new detail::uring_write_completion<Self>{
+                            force_move(self),
+                            st.exe,
+                            ctx,
+                            index
+                        },
+                        [&](io_uring_sqe& sqe) {
+                            sqe.fd = fd;
+                            sqe.addr = reinterpret_cast<std::uint64_t>(p);
+                            sqe.len = static_cast<std::uint32_t>(rest);
+                            sqe.msg_flags = MSG_NOSIGNAL;
+                            if (ctx.fixed_write_buffers()) {
+                                // zerocopy_write is set. plain send doesn't accept fixed buffers,
+                                // and write_fixed can't suppress SIGPIPE.
+                                sqe.opcode = IORING_OP_SEND_ZC;
+                                sqe.ioprio = IORING_RECVSEND_FIXED_BUF;
+                                sqe.buf_index = *index;
+                            }
+                            else {
+                                sqe.opcode = IORING_OP_SEND;
+                            }
+                        }
+                    );
+                    return;
+                }
+            }
+
+            // gather write without copy
+            std::vector<iovec> iovs;
+            for_each_rest(
+                [&](as::const_buffer cb) {
+                    if (iovs.size() == IOV_MAX) return;
+                    iovs.push_back(iovec{const_cast<void*>(cb.data()), cb.size()});
+                }
+            );
+            // this op is moved to the completion, members must not be accessed after here
+            auto* comp = new detail::uring_write_completion<Self>{
+                force_move(self),
+                st.exe,
+                ctx,
+                std::nullopt
+            };
+            comp->iovs = force_move(iovs);
+            comp->msg.msg_iov = comp->iovs.data();
+            comp->msg.msg_iovlen = comp->iovs.size();
+            ctx.submit(
+                comp,
+                [&](io_uring_sqe& sqe) {
+                    sqe.opcode = IORING_OP_SENDMSG;
+                    sqe.fd = fd;
+                    sqe.addr = reinterpret_cast<std::uint64_t>(&comp->msg);
+                    sqe.len = 1;
+                    sqe.msg_flags = MSG_NOSIGNAL;
+                }
+            );
+        }
+
+        // call f with the buffers that are not written yet
+        template <typename Func>
+        void for_each_rest(Func const& f) const {
+            auto skip = written;
+            for (
+                auto it = as::buffer_sequence_begin(cbs), end = as::buffer_sequence_end(cbs);
+                it != end;
+                ++it
+            ) {
+                as::const_buffer cb{*it};
+                if (skip >= cb.size()) {
+                    skip -= cb.size();
+                    continue;
+                }
+                cb += skip;
+                skip = 0;
+                f(cb);
+            }
+        }
+    };
+
+    // async_close
+
+    template <
+        typename CompletionToken
+    >
+    static auto
+    async_close(
+        uring_stream<NextLayer>& stream,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code const& ec)
+        > (
+            [&stream](auto& self) {
+                ASYNC_MQTT_LOG("mqtt_impl", info)
+                    << "io_uring close";
+                auto& st{stream.state()};
+                st.close(st.fd);
+                self.complete(error_code{});
+            },
+            token,
+            stream
+        );
+    }
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_URING_STREAM_HPP
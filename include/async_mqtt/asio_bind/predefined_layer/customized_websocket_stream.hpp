@@ -7,11 +7,17 @@
 #if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_WEBSOCKET_STREAM_HPP)
 #define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_CUSTOMIZED_WEBSOCKET_STREAM_HPP
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include <boost/asio.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/websocket/stream.hpp>
 #include <boost/beast/http/field.hpp>
 #include <async_mqtt/asio_bind/stream_customize.hpp>
 #include <async_mqtt/util/log.hpp>
+#include <async_mqtt/util/move.hpp>
 
 /// @file
 
@@ -22,6 +28,73 @@ namespace bs = boost::beast;
 
 static constexpr auto ws_shutdown_timeout = std::chrono::seconds(3);
 
+namespace detail {
+
+/**
+ * @brief pool of the buffers that receive the discarded messages while closing WebSocket
+ * The buffers are shared by all WebSocket streams in the process.
+ * A buffer is returned to the pool when the last shared_ptr is released.
+ * The buffer that grows over max_capacity is not returned.
+ */
+class ws_read_buffer_pool {
+public:
+    static constexpr std::size_t max_count = 64;
+    static constexpr std::size_t max_capacity = 64 * 1024;
+
+    /**
+     * @brief get the cleared buffer
+     * @return buffer
+     */
+    static std::shared_ptr<bs::flat_buffer> acquire() {
+        auto& pool{instance()};
+        std::unique_ptr<bs::flat_buffer> buf;
+        {
+            std::lock_guard<std::mutex> g{pool.mtx_};
+            if (!pool.bufs_.empty()) {
+                buf = force_move(pool.bufs_.back());
+                pool.bufs_.pop_back();
+            }
+        }
+        if (!buf) buf = std::make_unique<bs::flat_buffer>();
+        return std::shared_ptr<bs::flat_buffer>(
+            buf.release(),
+            [](bs::flat_buffer* p) {
+                release(std::unique_ptr<bs::flat_buffer>(p));
+            }
+        );
+    }
+
+    /**
+     * @brief get the number of the pooled buffers
+     * @return the number of the pooled buffers
+     */
+    static std::size_t size() {
+        auto& pool{instance()};
+        std::lock_guard<std::mutex> g{pool.mtx_};
+        return pool.bufs_.size();
+    }
+
+private:
+    static void release(std::unique_ptr<bs::flat_buffer> buf) {
+        if (buf->capacity() > max_capacity) return;
+        buf->clear();
+        auto& pool{instance()};
+        std::lock_guard<std::mutex> g{pool.mtx_};
+        if (pool.bufs_.size() == max_count) return;
+        pool.bufs_.push_back(force_move(buf));
+    }
+
+    static ws_read_buffer_pool& instance() {
+        static ws_read_buffer_pool pool;
+        return pool;
+    }
+
+    std::mutex mtx_;
+    std::vector<std::unique_ptr<bs::flat_buffer>> bufs_;
+};
+
+} // namespace detail
+
 /**
  * @brief customization class template specialization for boost::beast::websocket::stream
  *
@@ -44,6 +117,19 @@ struct layer_customize<bs::websocket::stream<NextLayer>> {
         );
     }
 
+    // set_bulk_write
+
+    static void set_bulk_write(bs::websocket::stream<NextLayer>& stream, bool val) {
+        // Beast splits a message into write_buffer_bytes (4096 by default) frames
+        // and writes them one by one if auto_fragment is true.
+        // When bulk_write is enabled, the queued MQTT packets are written by one
+        // async_write, and they are packed into one binary frame.
+        // MQTT over WebSocket allows a frame that contains multiple MQTT packets.
+        // A large frame is also read directly into the endpoint's read buffer by Beast.
+        // Otherwise, Beast's default is kept.
+        stream.auto_fragment(!val);
+    }
+
     // async_handshake
 
     template <
@@ -245,6 +331,8 @@ struct layer_customize<bs::websocket::stream<NextLayer>> {
 
     struct async_close_impl {
         bs::websocket::stream<NextLayer>& stream;
+        // the received messages are discarded. the pooled buffer is used until the close frame is received.
+        std::shared_ptr<bs::flat_buffer> buffer = nullptr;
         enum {
             close,
             read,
@@ -300,13 +388,12 @@ struct layer_customize<bs::websocket::stream<NextLayer>> {
             }
             else {
                 state = read;
-                auto buffer = std::make_shared<bs::flat_buffer>();
-                stream.async_read(
-                    *buffer,
-                    as::consign(
-                        force_move(self),
-                        buffer
-                    )
+                buffer = detail::ws_read_buffer_pool::acquire();
+                auto& a_stream{stream};
+                auto& a_buffer{*buffer};
+                a_stream.async_read(
+                    a_buffer,
+                    force_move(self)
                 );
             }
         }
@@ -330,13 +417,12 @@ struct layer_customize<bs::websocket::stream<NextLayer>> {
                 self.complete(ec);
             }
             else {
-                auto buffer = std::make_shared<bs::flat_buffer>();
-                stream.async_read(
-                    *buffer,
-                    as::consign(
-                        force_move(self),
-                        buffer
-                    )
+                buffer->clear();
+                auto& a_stream{stream};
+                auto& a_buffer{*buffer};
+                a_stream.async_read(
+                    a_buffer,
+                    force_move(self)
                 );
             }
         }
@@ -0,0 +1,61 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_INPROC_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_INPROC_HPP
+
+#include <async_mqtt/asio_bind/predefined_layer/customized_inproc_stream.hpp>
+
+namespace async_mqtt {
+
+namespace protocol {
+
+/**
+ * @brief Type alias of in-process layer
+ * It connects the client and the broker in the same process without system calls.
+ * @code
+ * auto sep = std::make_shared<am::endpoint<am::role::server, am::protocol::mqtt_inproc>>(
+ *     am::protocol_version::undetermined,
+ *     as::make_strand(broker_ioc.get_executor())
+ * );
+ * auto cep = am::endpoint<am::role::client, am::protocol::mqtt_inproc>{
+ *     am::protocol_version::v5,
+ *     as::make_strand(client_ioc.get_executor())
+ * };
+ * // connect before the server endpoint starts reading
+ * cep.next_layer().connect(sep->next_layer());
+ * sep->underlying_accepted();
+ * brk.handle_accept(epv_type{sep});
+ * @endcode
+ */
+using mqtt_inproc = inproc_stream;
+
+/**
+ * @brief connect in-process layer to the peer
+ * The peer must not be used during the handshake.
+ * @param layer  in-process layer
+ * @param peer   peer in-process layer to connect
+ * @param token  completion token. signature is void(error_code)
+ * @return deduced by token
+ *
+ */
+template <
+    typename CompletionToken = as::default_completion_token_t<
+        inproc_stream::executor_type
+    >
+>
+auto
+async_underlying_handshake(
+    inproc_stream& layer,
+    inproc_stream& peer,
+    CompletionToken&& token = as::default_completion_token_t<inproc_stream::executor_type>{}
+);
+
+} // namespace protocol
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_INPROC_HPP
@@ -0,0 +1,277 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_INPROC_STREAM_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_INPROC_STREAM_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/stream_customize.hpp>
+#include <async_mqtt/protocol/error.hpp>
+#include <async_mqtt/util/move.hpp>
+
+/// @file
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+namespace detail {
+
+struct inproc_completion {
+    virtual ~inproc_completion() = default;
+    // called without the lock of inproc_pipe. it could be called from any thread.
+    virtual void complete(error_code const& ec) = 0;
+};
+
+/**
+ * @brief one direction of in-process channel
+ * The written bytes are copied into the pipe like the send buffer of a socket.
+ * The write completes when all of its bytes are copied, so the writer doesn't wait for the reader
+ * as long as the pipe has room. If the pipe is full, the rest of the write waits until the reader
+ * makes room.
+ */
+class inproc_pipe {
+public:
+    explicit inproc_pipe(std::size_t capacity)
+        :capacity_{std::max<std::size_t>(capacity, 1)}
+    {}
+
+    // returns false if the pipe is closed. in this case, comp is not moved
+    bool push(
+        std::vector<as::const_buffer> cbs,
+        std::unique_ptr<inproc_completion>& comp
+    ) {
+        std::unique_ptr<inproc_completion> reader;
+        std::unique_ptr<inproc_completion> writer;
+        {
+            std::lock_guard<std::mutex> g{mtx_};
+            if (closed_) return false;
+            // the caller serializes the writes
+            BOOST_ASSERT(!writer_);
+            write_cbs_ = force_move(cbs);
+            write_index_ = 0;
+            writer_ = force_move(comp);
+            if (fill_locked()) writer = force_move(writer_);
+            if (size_ != 0) reader = force_move(reader_);
+        }
+        if (writer) writer->complete(error_code{});
+        if (reader) reader->complete(error_code{});
+        return true;
+    }
+
+    // copy the written bytes to the buffers. returns 0 if no bytes are available
+    template <typename MutableBufferSequence>
+    std::size_t pop(MutableBufferSequence const& buffers) {
+        std::unique_ptr<inproc_completion> writer;
+        std::size_t total = 0;
+        {
+            std::lock_guard<std::mutex> g{mtx_};
+            for (
+                auto it = as::buffer_sequence_begin(buffers), end = as::buffer_sequence_end(buffers);
+                it != end && !chunks_.empty();
+                ++it
+            ) {
+                as::mutable_buffer mb{*it};
+                while (mb.size() != 0 && !chunks_.empty()) {
+                    auto& c = chunks_.front();
+                    auto size = std::min(mb.size(), c.size() - offset_);
+                    std::memcpy(mb.data(), c.data() + offset_, size);
+                    mb += size;
+                    offset_ += size;
+                    total += size;
+                    if (offset_ == c.size()) {
+                        chunks_.pop_front();
+                        offset_ = 0;
+                    }
+                }
+            }
+            size_ -= total;
+            // the room is made, continue the waiting write
+            if (writer_ && !closed_ && fill_locked()) writer = force_move(writer_);
+        }
+        if (writer) writer->complete(error_code{});
+        return total;
+    }
+
+    // register the reader that is notified when bytes are written or the pipe is closed.
+    // returns false if the reader doesn't need to wait. in this case, reader is not moved
+    bool wait(std::unique_ptr<inproc_completion>& reader) {
+        std::lock_guard<std::mutex> g{mtx_};
+        if (closed_ || size_ != 0) return false;
+        BOOST_ASSERT(!reader_);
+        reader_ = force_move(reader);
+        return true;
+    }
+
+    bool closed() const {
+        std::lock_guard<std::mutex> g{mtx_};
+        return closed_;
+    }
+
+    /**
+     * @brief close the pipe
+     * The bytes that are already in the pipe can be read after closing.
+     * @param reader_ec error_code that is passed to the waiting reader
+     * @param writer_ec error_code that is passed to the unfinished write
+     */
+    void close(error_code const& reader_ec, error_code const& writer_ec) {
+        std::unique_ptr<inproc_completion> reader;
+        std::unique_ptr<inproc_completion> writer;
+        {
+            std::lock_guard<std::mutex> g{mtx_};
+            closed_ = true;
+            reader = force_move(reader_);
+            writer = force_move(writer_);
+            write_cbs_.clear();
+        }
+        if (reader) reader->complete(reader_ec);
+        if (writer) writer->complete(writer_ec);
+    }
+
+private:
+    // copy the waiting write to the pipe as far as it has room.
+    // returns true if all bytes of the write are copied
+    bool fill_locked() {
+        std::size_t rest = 0;
+        for (auto i = write_index_; i != write_cbs_.size(); ++i) {
+            rest += write_cbs_[i].size();
+        }
+        auto size = std::min(rest, capacity_ - size_);
+        if (size != 0) {
+            std::vector<char> c(size);
+            auto mb = as::buffer(c);
+            while (mb.size() != 0) {
+                auto& cb = write_cbs_[write_index_];
+                auto copied = as::buffer_copy(mb, cb);
+                mb += copied;
+                cb += copied;
+                if (cb.size() == 0) ++write_index_;
+            }
+            chunks_.push_back(force_move(c));
+            size_ += size;
+        }
+        if (write_index_ != write_cbs_.size()) return false;
+        write_cbs_.clear();
+        return true;
+    }
+
+    mutable std::mutex mtx_;
+    std::size_t const capacity_;
+    // bytes in the pipe
+    std::deque<std::vector<char>> chunks_;
+    std::size_t offset_ = 0;
+    std::size_t size_ = 0;
+    // write that waits for the room
+    std::vector<as::const_buffer> write_cbs_;
+    std::size_t write_index_ = 0;
+    std::unique_ptr<inproc_completion> writer_;
+    std::unique_ptr<inproc_completion> reader_;
+    bool closed_ = false;
+};
+
+} // namespace detail
+
+/**
+ * @brief in-process stream
+ *
+ * Two inproc_streams are connected by connect() and transfer bytes between them
+ * without system calls. Each direction has a buffer like the socket's one.
+ * The write operation completes when all of its bytes are copied into the buffer,
+ * so it doesn't wait for the peer's read unless the buffer is full.
+ * It is useful for the client and the broker that are in the same process.
+ *
+ * The connected streams could use different executors (threads).
+ *
+ * #### Thread Safety
+ * @li Distinct objects: Safe
+ * @li Shared objects: Unsafe
+ *
+ */
+class inproc_stream {
+public:
+    using executor_type = as::any_io_executor;
+
+    /**
+     * @brief constructor
+     * @param exe executor that is used for completion handlers
+     */
+    explicit inproc_stream(as::any_io_executor exe)
+        :exe_{force_move(exe)}
+    {}
+
+    inproc_stream(inproc_stream&&) = default;
+    inproc_stream(inproc_stream const&) = delete;
+    inproc_stream& operator=(inproc_stream&&) = delete;
+    inproc_stream& operator=(inproc_stream const&) = delete;
+
+    ~inproc_stream() {
+        close();
+    }
+
+    /**
+     * @brief executor getter
+     * @return executor
+     */
+    executor_type get_executor() const {
+        return exe_;
+    }
+
+    /**
+     * @brief the default size of the buffer of each direction
+     */
+    static constexpr std::size_t default_buffer_size = 256 * 1024;
+
+    /**
+     * @brief connect to the peer
+     * The peer must not be used by other threads during this call.
+     * @param peer        peer inproc_stream
+     * @param buffer_size the size of the buffer of each direction
+     */
+    void connect(inproc_stream& peer, std::size_t buffer_size = default_buffer_size) {
+        close();
+        peer.close();
+        rx_ = std::make_shared<detail::inproc_pipe>(buffer_size);
+        tx_ = std::make_shared<detail::inproc_pipe>(buffer_size);
+        peer.rx_ = tx_;
+        peer.tx_ = rx_;
+    }
+
+    /**
+     * @brief check the stream is connected
+     * @return true if connected and not closed
+     */
+    bool is_open() const {
+        return rx_ && !rx_->closed() && !tx_->closed();
+    }
+
+    /**
+     * @brief close the stream
+     * The peer's read gets eof.
+     */
+    void close() {
+        if (tx_) tx_->close(as::error::eof, as::error::operation_aborted);
+        if (rx_) rx_->close(as::error::operation_aborted, as::error::broken_pipe);
+    }
+
+private:
+    friend struct layer_customize<inproc_stream>;
+
+    as::any_io_executor exe_;
+    std::shared_ptr<detail::inproc_pipe> rx_;
+    std::shared_ptr<detail::inproc_pipe> tx_;
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_INPROC_STREAM_HPP
@@ -0,0 +1,582 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_KTLS_STREAM_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_KTLS_STREAM_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <memory>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+
+#include <async_mqtt/asio_bind/predefined_layer/mqtt.hpp>
+#include <async_mqtt/protocol/error.hpp>
+#include <async_mqtt/util/move.hpp>
+#include <async_mqtt/util/log.hpp>
+
+/// @file
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+/**
+ * @brief TLS stream that can offload the record encryption to the kernel (kTLS)
+ *
+ * OpenSSL does the handshake directly on the socket, not via the memory BIO
+ * of as::ssl::stream. OpenSSL 3 enables kTLS after the handshake if the kernel
+ * supports the negotiated cipher (Linux `tls` ULP).
+ * If the send direction is offloaded, async_write_some() writes to the TCP socket
+ * directly, same as protocol::mqtt. The kernel encrypts the records.
+ * Otherwise, the records are encrypted by OpenSSL in the user space (fallback).
+ * The receive direction always uses SSL_read(). If the receive direction is offloaded,
+ * SSL_read() gets the decrypted bytes from the kernel.
+ *
+ * The certificate, verify mode and verify callback are taken from as::ssl::context.
+ * The same context as protocol::mqtts can be used.
+ *
+ * Unlike as::ssl::stream, the stream can be reused after async_close().
+ *
+ * #### Thread Safety
+ * @li Distinct objects: Safe
+ * @li Shared objects: Unsafe
+ *
+ */
+class ktls_stream {
+public:
+    using next_layer_type = protocol::mqtt;
+    using lowest_layer_type = next_layer_type;
+    using executor_type = next_layer_type::executor_type;
+    using native_handle_type = SSL*;
+
+    /**
+     * @brief constructor
+     * @param exe executor
+     * @param ctx TLS context. it must be alive while the stream is used.
+     */
+    ktls_stream(as::any_io_executor exe, as::ssl::context& ctx)
+        :nl_{force_move(exe)},
+         ctx_{ctx.native_handle()}
+    {
+        ::SSL_CTX_up_ref(ctx_);
+    }
+
+    ktls_stream(ktls_stream&& other) noexcept
+        :nl_{force_move(other.nl_)},
+         ctx_{std::exchange(other.ctx_, nullptr)},
+         ssl_{std::exchange(other.ssl_, nullptr)},
+         ktls_send_{other.ktls_send_},
+         ktls_recv_{other.ktls_recv_}
+    {}
+
+    ktls_stream(ktls_stream const&) = delete;
+    ktls_stream& operator=(ktls_stream&&) = delete;
+    ktls_stream& operator=(ktls_stream const&) = delete;
+
+    ~ktls_stream() {
+        if (ssl_) ::SSL_free(ssl_);
+        if (ctx_) ::SSL_CTX_free(ctx_);
+    }
+
+    /**
+     * @brief executor getter
+     * @return executor
+     */
+    executor_type get_executor() {
+        return nl_.get_executor();
+    }
+
+    /**
+     * @brief next_layer getter
+     * @return const reference of the next_layer
+     */
+    next_layer_type const& next_layer() const {
+        return nl_;
+    }
+
+    /**
+     * @brief next_layer getter
+     * @return reference of the next_layer
+     */
+    next_layer_type& next_layer() {
+        return nl_;
+    }
+
+    /**
+     * @brief lowest_layer getter
+     * @return reference of the lowest_layer
+     */
+    lowest_layer_type& lowest_layer() {
+        return nl_;
+    }
+
+    /**
+     * @brief get OpenSSL's SSL object
+     * It is valid after async_handshake() is called.
+     * @return SSL object
+     */
+    native_handle_type native_handle() {
+        return ssl_;
+    }
+
+    /**
+     * @brief check the send direction is offloaded to the kernel
+     * @return true if offloaded
+     */
+    bool ktls_send() const {
+        return ktls_send_;
+    }
+
+    /**
+     * @brief check the receive direction is offloaded to the kernel
+     * @return true if offloaded
+     */
+    bool ktls_recv() const {
+        return ktls_recv_;
+    }
+
+    /**
+     * @brief TLS handshake on the connected TCP socket
+     * @param type  as::ssl::stream_base::client or as::ssl::stream_base::server
+     * @param token completion token. signature is void(error_code)
+     * @return deduced by token
+     */
+    template <typename CompletionToken>
+    auto async_handshake(
+        as::ssl::stream_base::handshake_type type,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code)
+        > (
+            handshake_op{*this, type},
+            token,
+            nl_
+        );
+    }
+
+    /**
+     * @brief read some decrypted bytes
+     * @param buffers buffers to store the bytes. only the first non empty buffer is used.
+     * @param token   completion token. signature is void(error_code, std::size_t)
+     * @return deduced by token
+     */
+    template <typename MutableBufferSequence, typename CompletionToken>
+    auto async_read_some(
+        MutableBufferSequence const& buffers,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code, std::size_t)
+        > (
+            read_some_op<MutableBufferSequence>{*this, buffers},
+            token,
+            nl_
+        );
+    }
+
+    /**
+     * @brief write some bytes
+     * @param buffers buffers to write
+     * @param token   completion token. signature is void(error_code, std::size_t)
+     * @return deduced by token
+     */
+    template <typename ConstBufferSequence, typename CompletionToken>
+    auto async_write_some(
+        ConstBufferSequence const& buffers,
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code, std::size_t)
+        > (
+            write_some_op<ConstBufferSequence>{*this, buffers},
+            token,
+            nl_
+        );
+    }
+
+    /**
+     * @brief send close_notify
+     * It doesn't wait for the close_notify from the peer.
+     * @param ec always success. if the socket is not writable, close_notify is not sent.
+     */
+    void shutdown(error_code& ec) {
+        if (ssl_ && ::SSL_is_init_finished(ssl_)) {
+            ::SSL_shutdown(ssl_);
+            ::ERR_clear_error();
+        }
+        ec = error_code{};
+    }
+
+    /**
+     * @brief send close_notify
+     * It doesn't wait for the close_notify from the peer.
+     * @param token completion token. signature is void(error_code)
+     * @return deduced by token
+     */
+    template <typename CompletionToken>
+    auto async_shutdown(
+        CompletionToken&& token
+    ) {
+        return as::async_compose<
+            CompletionToken,
+            void(error_code)
+        > (
+            shutdown_op{*this},
+            token,
+            nl_
+        );
+    }
+
+private:
+    // the record size of TLS
+    static constexpr std::size_t max_record_size = 16 * 1024;
+
+    error_code setup(as::ssl::stream_base::handshake_type type) {
+        if (ssl_) ::SSL_free(ssl_);
+        ktls_send_ = false;
+        ktls_recv_ = false;
+        ssl_ = ::SSL_new(ctx_);
+        if (!ssl_) {
+            return error_code{static_cast<int>(::ERR_get_error()), as::error::get_ssl_category()};
+        }
+#if defined(SSL_OP_ENABLE_KTLS)
+        ::SSL_set_options(ssl_, SSL_OP_ENABLE_KTLS);
+#endif // defined(SSL_OP_ENABLE_KTLS)
+        ::SSL_set_mode(ssl_, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+        // read the header and the body of the record by one recv() in the fallback mode
+        ::SSL_set_read_ahead(ssl_, 1);
+        error_code ec;
+        nl_.non_blocking(true, ec);
+        if (ec) return ec;
+        if (::SSL_set_fd(ssl_, static_cast<int>(nl_.native_handle())) != 1) {
+            return error_code{static_cast<int>(::ERR_get_error()), as::error::get_ssl_category()};
+        }
+        if (type == as::ssl::stream_base::client) {
+            ::SSL_set_connect_state(ssl_);
+        }
+        else {
+            ::SSL_set_accept_state(ssl_);
+        }
+        return error_code{};
+    }
+
+    void check_ktls() {
+#if defined(SSL_OP_ENABLE_KTLS)
+        ktls_send_ = BIO_get_ktls_send(::SSL_get_wbio(ssl_));
+        ktls_recv_ = BIO_get_ktls_recv(::SSL_get_rbio(ssl_));
+#endif // defined(SSL_OP_ENABLE_KTLS)
+        ASYNC_MQTT_LOG("mqtt_impl", info)
+            << "TLS handshake finished."
+            << " cipher:" << ::SSL_get_cipher_name(ssl_)
+            << " ktls_send:" << ktls_send_
+            << " ktls_recv:" << ktls_recv_;
+    }
+
+    enum class next_action { complete, wait_read, wait_write };
+
+    // convert the result of SSL_xxx() to the action.
+    next_action handle_result(int ret, error_code& ec) {
+        auto err = ::SSL_get_error(ssl_, ret);
+        switch (err) {
+        case SSL_ERROR_WANT_READ:
+            return next_action::wait_read;
+        case SSL_ERROR_WANT_WRITE:
+            return next_action::wait_write;
+        case SSL_ERROR_ZERO_RETURN:
+            ec = as::error::eof;
+            break;
+        case SSL_ERROR_SYSCALL:
+            if (errno == 0) {
+                ec = as::ssl::error::stream_truncated;
+            }
+            else {
+                ec = error_code{errno, boost::system::system_category()};
+            }
+            break;
+        default: {
+            auto code = ::ERR_get_error();
+#if defined(SSL_R_UNEXPECTED_EOF_WHILE_READING)
+            if (ERR_GET_REASON(code) == SSL_R_UNEXPECTED_EOF_WHILE_READING) {
+                ec = as::ssl::error::stream_truncated;
+                break;
+            }
+#endif // defined(SSL_R_UNEXPECTED_EOF_WHILE_READING)
+            ec = error_code{static_cast<int>(code), as::error::get_ssl_category()};
+        } break;
+        }
+        ::ERR_clear_error();
+        return next_action::complete;
+    }
+
+    // the completion in the initiating function is posted.
+    // it avoids the deep recursion of as::async_write() if OpenSSL completes synchronously.
+    template <typename Self>
+    void complete(bool waited, Self& self, error_code const& ec, std::size_t size) {
+        if (waited) {
+            self.complete(ec, size);
+            return;
+        }
+        as::post(
+            nl_.get_executor(),
+            as::append(
+                force_move(self),
+                ec,
+                size
+            )
+        );
+    }
+
+    template <typename Self>
+    void wait(next_action act, Self& self) {
+        nl_.async_wait(
+            act == next_action::wait_read ? as::socket_base::wait_read
+                                          : as::socket_base::wait_write,
+            force_move(self)
+        );
+    }
+
+    struct handshake_op {
+        ktls_stream& strm;
+        as::ssl::stream_base::handshake_type type;
+        enum { setup, handshake } state = setup;
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code ec = error_code{}
+        ) {
+            if (ec) {
+                self.complete(ec);
+                return;
+            }
+            if (state == setup) {
+                state = handshake;
+                ec = strm.setup(type);
+                if (ec) {
+                    self.complete(ec);
+                    return;
+                }
+            }
+            ::ERR_clear_error();
+            auto ret = ::SSL_do_handshake(strm.ssl_);
+            if (ret == 1) {
+                strm.check_ktls();
+                self.complete(error_code{});
+                return;
+            }
+            auto act = strm.handle_result(ret, ec);
+            if (act == next_action::complete) {
+                self.complete(ec);
+                return;
+            }
+            auto& a_strm{strm};
+            a_strm.wait(act, self);
+        }
+    };
+
+    struct shutdown_op {
+        ktls_stream& strm;
+
+        template <typename Self>
+        void operator()(
+            Self& self
+        ) {
+            auto& a_strm{strm};
+            error_code ec;
+            a_strm.shutdown(ec);
+            as::post(
+                a_strm.nl_.get_executor(),
+                as::append(
+                    force_move(self),
+                    ec
+                )
+            );
+        }
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code ec
+        ) {
+            self.complete(ec);
+        }
+    };
+
+    template <typename MutableBufferSequence>
+    struct read_some_op {
+        ktls_stream& strm;
+        MutableBufferSequence buffers;
+        bool waited = false;
+
+        template <typename Self>
+        void operator()(
+            Self& self
+        ) {
+            auto& a_strm{strm};
+            if (!a_strm.ssl_) {
+                a_strm.complete(waited, self, as::error::not_connected, 0);
+                return;
+            }
+            read(self);
+        }
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code ec
+        ) {
+            waited = true;
+            if (ec) {
+                self.complete(ec, 0);
+                return;
+            }
+            read(self);
+        }
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code ec,
+            std::size_t size
+        ) {
+            self.complete(ec, size);
+        }
+
+        template <typename Self>
+        void read(Self& self) {
+            auto& a_strm{strm};
+            as::mutable_buffer mb;
+            for (
+                auto it = as::buffer_sequence_begin(buffers), end = as::buffer_sequence_end(buffers);
+                it != end;
+                ++it
+            ) {
+                mb = *it;
+                if (mb.size() != 0) break;
+            }
+            if (mb.size() == 0) {
+                a_strm.complete(waited, self, error_code{}, 0);
+                return;
+            }
+            ::ERR_clear_error();
+            auto ret = ::SSL_read(
+                a_strm.ssl_,
+                mb.data(),
+                static_cast<int>(std::min(mb.size(), std::size_t(INT_MAX)))
+            );
+            if (ret > 0) {
+                a_strm.complete(waited, self, error_code{}, static_cast<std::size_t>(ret));
+                return;
+            }
+            error_code ec;
+            auto act = a_strm.handle_result(ret, ec);
+            if (act == next_action::complete) {
+                a_strm.complete(waited, self, ec, 0);
+                return;
+            }
+            a_strm.wait(act, self);
+        }
+    };
+
+    template <typename ConstBufferSequence>
+    struct write_some_op {
+        ktls_stream& strm;
+        ConstBufferSequence buffers;
+        bool waited = false;
+
+        template <typename Self>
+        void operator()(
+            Self& self
+        ) {
+            auto& a_strm{strm};
+            if (!a_strm.ssl_) {
+                a_strm.complete(waited, self, as::error::not_connected, 0);
+                return;
+            }
+            if (a_strm.ktls_send_) {
+                // the kernel encrypts the records
+                a_strm.nl_.async_write_some(
+                    buffers,
+                    force_move(self)
+                );
+                return;
+            }
+            // small buffers are concatenated in order to avoid tiny records.
+            // OpenSSL requires the same bytes on retry. they are kept in wbuf_
+            auto size = std::min(as::buffer_size(buffers), max_record_size);
+            if (size == 0) {
+                a_strm.complete(waited, self, error_code{}, 0);
+                return;
+            }
+            a_strm.wbuf_.resize(size);
+            as::buffer_copy(as::buffer(a_strm.wbuf_), buffers);
+            write(self);
+        }
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code ec
+        ) {
+            waited = true;
+            if (ec) {
+                self.complete(ec, 0);
+                return;
+            }
+            write(self);
+        }
+
+        template <typename Self>
+        void operator()(
+            Self& self,
+            error_code ec,
+            std::size_t size
+        ) {
+            self.complete(ec, size);
+        }
+
+        template <typename Self>
+        void write(Self& self) {
+            auto& a_strm{strm};
+            ::ERR_clear_error();
+            auto ret = ::SSL_write(
+                a_strm.ssl_,
+                a_strm.wbuf_.data(),
+                static_cast<int>(a_strm.wbuf_.size())
+            );
+            if (ret > 0) {
+                a_strm.complete(waited, self, error_code{}, static_cast<std::size_t>(ret));
+                return;
+            }
+            error_code ec;
+            auto act = a_strm.handle_result(ret, ec);
+            if (act == next_action::complete) {
+                a_strm.complete(waited, self, ec, 0);
+                return;
+            }
+            a_strm.wait(act, self);
+        }
+    };
+
+    next_layer_type nl_;
+    SSL_CTX* ctx_ = nullptr;
+    SSL* ssl_ = nullptr;
+    bool ktls_send_ = false;
+    bool ktls_recv_ = false;
+    std::vector<char> wbuf_;
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_KTLS_STREAM_HPP
@@ -0,0 +1,38 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_MQTTS_KTLS_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_MQTTS_KTLS_HPP
+
+#include <async_mqtt/asio_bind/predefined_layer/customized_ktls_stream.hpp>
+
+namespace async_mqtt {
+
+namespace protocol {
+
+/**
+ * @brief Type alias of TLS layer that offloads the record encryption to the kernel (kTLS)
+ * If kTLS is not available, OpenSSL encrypts the records in the user space.
+ * The constructor arguments and async_underlying_handshake() are the same as protocol::mqtts.
+ * The server calls ktls_stream::async_handshake(as::ssl::stream_base::server, token)
+ * after the TCP socket is accepted.
+ * @code
+ * as::ssl::context ctx{as::ssl::context::tlsv12};
+ * auto ep = am::endpoint<am::role::client, am::protocol::mqtts_ktls>{
+ *     am::protocol_version::v5,
+ *     ioc.get_executor(),
+ *     ctx
+ * };
+ * co_await ep.async_underlying_handshake("broker.example.com", "8883", as::use_awaitable);
+ * @endcode
+ */
+using mqtts_ktls = ktls_stream;
+
+} // namespace protocol
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_MQTTS_KTLS_HPP
@@ -0,0 +1,35 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_SHM_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_SHM_HPP
+
+#include <async_mqtt/asio_bind/predefined_layer/customized_shm_stream.hpp>
+
+namespace async_mqtt {
+
+namespace protocol {
+
+/**
+ * @brief Type alias of shared memory layer
+ * The client passes the socket file path of the broker to async_underlying_handshake().
+ * The shared memory is created by the client and passed to the broker via the Unix domain socket.
+ * @code
+ * auto ep = am::endpoint<am::role::client, am::protocol::mqtt_shm>{
+ *     am::protocol_version::v5,
+ *     ioc.get_executor()
+ * };
+ * co_await ep.async_underlying_handshake("/tmp/async_mqtt_broker_shm.sock", as::use_awaitable);
+ * @endcode
+ * The server accepts the next layer and then calls shm_stream::async_accept().
+ */
+using mqtt_shm = shm_stream;
+
+} // namespace protocol
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_SHM_HPP
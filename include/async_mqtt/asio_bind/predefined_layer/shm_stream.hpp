@@ -0,0 +1,523 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_SHM_STREAM_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_SHM_STREAM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/stream_customize.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/uds.hpp>
+#include <async_mqtt/protocol/error.hpp>
+#include <async_mqtt/util/move.hpp>
+
+/// @file
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+namespace detail {
+
+/**
+ * @brief single producer single consumer byte ring on the shared memory
+ * The data area follows the header.
+ * The peer process can rewrite the header at any time, so the functions take the capacity
+ * that is validated by the caller, and never trust the counters beyond the capacity.
+ */
+struct shm_ring {
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+    // total bytes that are written. updated by the writer
+    alignas(64) std::atomic<std::uint64_t> head;
+    // total bytes that are read. updated by the reader
+    alignas(64) std::atomic<std::uint64_t> tail;
+    // the reader waits for data
+    alignas(64) std::atomic<std::uint32_t> reader_waiting;
+    // the writer waits for space
+    std::atomic<std::uint32_t> writer_waiting;
+    std::atomic<std::uint32_t> closed;
+    std::uint32_t capacity; // power of two
+
+    static constexpr std::size_t header_size() {
+        return (sizeof(shm_ring) + 63) & ~std::size_t(63);
+    }
+
+    static constexpr std::uint32_t min_capacity = 4096;
+    static constexpr std::uint32_t max_capacity = std::uint32_t(1) << 30;
+
+    static constexpr bool valid_capacity(std::uint64_t cap) {
+        return cap >= min_capacity && cap <= max_capacity && (cap & (cap - 1)) == 0;
+    }
+
+    char* data() {
+        return reinterpret_cast<char*>(this) + header_size();
+    }
+
+    void init(std::uint32_t cap) {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        reader_waiting.store(0, std::memory_order_relaxed);
+        writer_waiting.store(0, std::memory_order_relaxed);
+        closed.store(0, std::memory_order_relaxed);
+        capacity = cap;
+    }
+
+    // writer side. returns written bytes
+    std::size_t write(std::uint32_t cap, char const* p, std::size_t size) {
+        auto h = head.load(std::memory_order_relaxed);
+        auto t = tail.load(std::memory_order_acquire);
+        auto space = cap - used(cap, h, t);
+        size = std::min(size, space);
+        if (size == 0) return 0;
+        auto pos = static_cast<std::size_t>(h & (cap - 1));
+        auto first = std::min(size, cap - pos);
+        std::memcpy(data() + pos, p, first);
+        std::memcpy(data(), p + first, size - first);
+        head.store(h + size, std::memory_order_release);
+        return size;
+    }
+
+    // reader side. returns read bytes
+    std::size_t read(std::uint32_t cap, char* p, std::size_t size) {
+        auto t = tail.load(std::memory_order_relaxed);
+        auto h = head.load(std::memory_order_acquire);
+        size = std::min(size, used(cap, h, t));
+        if (size == 0) return 0;
+        auto pos = static_cast<std::size_t>(t & (cap - 1));
+        auto first = std::min(size, cap - pos);
+        std::memcpy(p, data() + pos, first);
+        std::memcpy(p + first, data(), size - first);
+        tail.store(t + size, std::memory_order_release);
+        return size;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    bool full(std::uint32_t cap) const {
+        return
+            used(
+                cap,
+                head.load(std::memory_order_acquire),
+                tail.load(std::memory_order_acquire)
+            ) == cap;
+    }
+
+private:
+    // the broken counters are treated as no data for the reader and no space for the writer
+    static std::size_t used(std::uint32_t cap, std::uint64_t h, std::uint64_t t) {
+        return static_cast<std::size_t>(std::min<std::uint64_t>(h - t, cap));
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief shared memory layer
+ *
+ * Two processes on the same host exchange bytes via the shared memory.
+ * The shared memory has two single producer single consumer rings. One is for each direction.
+ * Bytes are copied to the ring and from the ring by the processes, the kernel doesn't copy them.
+ * When the peer waits for data or space, it is woken up by eventfd.
+ * Each side has two eventfds, one is for waiting data and the other is for waiting space.
+ *
+ * The next layer is Unix domain socket that is used for passing the shared memory and eventfds,
+ * and closing.
+ * The client connects to the socket file path by async_handshake().
+ * The server accepts the next layer and then calls async_accept().
+ *
+ * Linux only.
+ *
+ * #### Thread Safety
+ * @li Distinct objects: Safe
+ * @li Shared objects: Unsafe
+ *
+ */
+class shm_stream {
+public:
+    using next_layer_type = protocol::mqtt_uds;
+    using executor_type = next_layer_type::executor_type;
+
+    /**
+     * @brief constructor
+     * @param exe       executor
+     * @param ring_size size of each ring in bytes. It is rounded up to power of two (4 KiB to 1 GiB).
+     *                  It is used when the client creates the shared memory.
+     */
+    explicit shm_stream(as::any_io_executor exe, std::size_t ring_size = 1024 * 1024)
+        :nl_{exe},
+         data_efd_{exe},
+         space_efd_{exe},
+         ring_size_{ring_size}
+    {}
+
+    shm_stream(shm_stream&&) = delete;
+    shm_stream(shm_stream const&) = delete;
+    shm_stream& operator=(shm_stream&&) = delete;
+    shm_stream& operator=(shm_stream const&) = delete;
+
+    ~shm_stream() {
+        release();
+    }
+
+    /**
+     * @brief executor getter
+     * @return executor
+     */
+    executor_type get_executor() {
+        return nl_.get_executor();
+    }
+
+    /**
+     * @brief next_layer getter
+     * @return const reference of the next_layer
+     */
+    next_layer_type const& next_layer() const {
+        return nl_;
+    }
+
+    /**
+     * @brief next_layer getter
+     * @return reference of the next_layer
+     */
+    next_layer_type& next_layer() {
+        return nl_;
+    }
+
+    /**
+     * @brief receive the shared memory from the client on the accepted next layer
+     * @param token  completion token. signature is void(error_code)
+     * @return deduced by token
+     */
+    template <
+        typename CompletionToken = as::default_completion_token_t<executor_type>
+    >
+    auto
+    async_accept(
+        CompletionToken&& token = as::default_completion_token_t<executor_type>{}
+    );
+
+private:
+    friend struct layer_customize<shm_stream>;
+
+    // memfd and eventfds
+    static constexpr std::size_t num_of_fds = 5;
+
+    struct accept_op;
+
+    // client side. create the shared memory and eventfds and send them to the server
+    error_code create_channel() {
+        release();
+        std::size_t cap = detail::shm_ring::min_capacity;
+        while (cap < ring_size_ && cap < detail::shm_ring::max_capacity) cap <<= 1;
+        map_size_ = (detail::shm_ring::header_size() + cap) * 2;
+
+        int memfd = ::memfd_create("async_mqtt_shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (memfd == -1) return errno_code();
+        // client data, client space, server data, server space
+        int efds[4];
+        for (auto& efd : efds) efd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        auto ec =
+            [&] {
+                for (auto efd : efds) {
+                    if (efd == -1) return errno_code();
+                }
+                if (::ftruncate(memfd, static_cast<off_t>(map_size_)) == -1) return errno_code();
+                // the server requires the seals, so the size is fixed while it maps the memory
+                if (::fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == -1) {
+                    return errno_code();
+                }
+                if (auto ec = map(memfd)) return ec;
+                for (std::size_t i = 0; i != 2; ++i) {
+                    auto* p = static_cast<char*>(addr_) + (map_size_ / 2) * i;
+                    (new (p) detail::shm_ring)->init(static_cast<std::uint32_t>(cap));
+                }
+                int fds[num_of_fds] = {memfd, efds[0], efds[1], efds[2], efds[3]};
+                return send_fds(fds);
+            } ();
+        if (!ec) {
+            data_efd_.assign(efds[0]);
+            space_efd_.assign(efds[1]);
+            peer_data_efd_ = efds[2];
+            peer_space_efd_ = efds[3];
+            tx_ = &ring(0);
+            rx_ = &ring(1);
+            capacity_ = static_cast<std::uint32_t>(cap);
+        }
+        else {
+            for (auto efd : efds) {
+                if (efd != -1) ::close(efd);
+            }
+        }
+        ::close(memfd);
+        return ec;
+    }
+
+    // server side. receive the shared memory and eventfds from the client
+    error_code receive_channel() {
+        release();
+        char dummy;
+        iovec iov{&dummy, 1};
+        alignas(cmsghdr) char cbuf[CMSG_SPACE(sizeof(int) * num_of_fds)];
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = cbuf;
+        msg.msg_controllen = sizeof(cbuf);
+        auto size = ::recvmsg(nl_.native_handle(), &msg, MSG_CMSG_CLOEXEC | MSG_DONTWAIT);
+        if (size == -1) return errno_code();
+        if (size == 0) return as::error::eof;
+        auto* cmsg = CMSG_FIRSTHDR(&msg);
+        if (!cmsg ||
+            cmsg->cmsg_level != SOL_SOCKET ||
+            cmsg->cmsg_type != SCM_RIGHTS ||
+            cmsg->cmsg_len != CMSG_LEN(sizeof(int) * num_of_fds)) {
+            return make_error_code(as::error::invalid_argument);
+        }
+        int fds[num_of_fds];
+        std::memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+        auto ec =
+            [&]() -> error_code {
+                // the client must not be able to shrink the memory while it is mapped,
+                // otherwise the access causes SIGBUS
+                auto seals = ::fcntl(fds[0], F_GET_SEALS);
+                if (seals == -1) return errno_code();
+                if ((seals & (F_SEAL_SHRINK | F_SEAL_GROW)) != (F_SEAL_SHRINK | F_SEAL_GROW)) {
+                    return make_error_code(as::error::invalid_argument);
+                }
+                struct stat st;
+                if (::fstat(fds[0], &st) == -1) return errno_code();
+                if (!S_ISREG(st.st_mode) || st.st_size <= 0) {
+                    return make_error_code(as::error::invalid_argument);
+                }
+                auto size = static_cast<std::uint64_t>(st.st_size);
+                if (size % 2 != 0 || size / 2 <= detail::shm_ring::header_size()) {
+                    return make_error_code(as::error::invalid_argument);
+                }
+                auto cap = size / 2 - detail::shm_ring::header_size();
+                if (!detail::shm_ring::valid_capacity(cap)) {
+                    return make_error_code(as::error::invalid_argument);
+                }
+                map_size_ = static_cast<std::size_t>(size);
+                if (auto ec = map(fds[0])) return ec;
+                // the capacity in the header is checked once, and the private copy is used after that
+                for (std::size_t i = 0; i != 2; ++i) {
+                    if (ring(i).capacity != cap) {
+                        ::munmap(addr_, map_size_);
+                        addr_ = nullptr;
+                        return make_error_code(as::error::invalid_argument);
+                    }
+                }
+                capacity_ = static_cast<std::uint32_t>(cap);
+                return error_code{};
+            } ();
+        ::close(fds[0]);
+        if (ec) {
+            for (std::size_t i = 1; i != num_of_fds; ++i) ::close(fds[i]);
+            return ec;
+        }
+        data_efd_.assign(fds[3]);
+        space_efd_.assign(fds[4]);
+        peer_data_efd_ = fds[1];
+        peer_space_efd_ = fds[2];
+        tx_ = &ring(1);
+        rx_ = &ring(0);
+        return error_code{};
+    }
+
+    error_code map(int memfd) {
+        auto* p = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+        if (p == MAP_FAILED) return errno_code();
+        addr_ = p;
+        return error_code{};
+    }
+
+    error_code send_fds(int const (&fds)[num_of_fds]) {
+        char dummy = 0;
+        iovec iov{&dummy, 1};
+        alignas(cmsghdr) char cbuf[CMSG_SPACE(sizeof(fds))];
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = cbuf;
+        msg.msg_controllen = sizeof(cbuf);
+        auto* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+        std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+        if (::sendmsg(nl_.native_handle(), &msg, MSG_NOSIGNAL) == -1) return errno_code();
+        return error_code{};
+    }
+
+    detail::shm_ring& ring(std::size_t index) {
+        return *reinterpret_cast<detail::shm_ring*>(
+            static_cast<char*>(addr_) + (map_size_ / 2) * index
+        );
+    }
+
+    // wake up the peer if it waits for the flag
+    static void wake_peer(std::atomic<std::uint32_t>& waiting, int efd) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) &&
+            waiting.exchange(0, std::memory_order_acq_rel)) {
+            notify(efd);
+        }
+    }
+
+    static void notify(int efd) {
+        std::uint64_t one = 1;
+        [[maybe_unused]] auto r = ::write(efd, &one, sizeof(one));
+    }
+
+    // set the waiting flag. returns false if the condition has already been satisfied
+    template <typename Pred>
+    static bool prepare_wait(std::atomic<std::uint32_t>& waiting, Pred const& ready) {
+        waiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ready()) {
+            waiting.store(0, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    bool is_connected() const {
+        return addr_ != nullptr && !closed_;
+    }
+
+    // mark the rings closed and wake up the peer
+    void close_channel() {
+        if (!is_connected()) return;
+        closed_ = true;
+        tx_->closed.store(1, std::memory_order_release);
+        rx_->closed.store(1, std::memory_order_release);
+        notify(peer_data_efd_);
+        notify(peer_space_efd_);
+        error_code ec;
+        data_efd_.cancel(ec);
+        space_efd_.cancel(ec);
+    }
+
+    void release() {
+        close_channel();
+        error_code ec;
+        data_efd_.close(ec);
+        space_efd_.close(ec);
+        for (auto* efd : {&peer_data_efd_, &peer_space_efd_}) {
+            if (*efd != -1) {
+                ::close(*efd);
+                *efd = -1;
+            }
+        }
+        if (addr_) {
+            ::munmap(addr_, map_size_);
+            addr_ = nullptr;
+        }
+        tx_ = nullptr;
+        rx_ = nullptr;
+        capacity_ = 0;
+        closed_ = false;
+    }
+
+    static error_code errno_code() {
+        return error_code{errno, boost::system::system_category()};
+    }
+
+    next_layer_type nl_;
+    // read the counter in order to wait. it works with edge triggered reactor
+    as::posix::stream_descriptor data_efd_;
+    as::posix::stream_descriptor space_efd_;
+    std::uint64_t data_efd_value_ = 0;
+    std::uint64_t space_efd_value_ = 0;
+    char peek_byte_ = 0;
+    int peer_data_efd_ = -1;
+    int peer_space_efd_ = -1;
+    std::size_t ring_size_;
+    void* addr_ = nullptr;
+    std::size_t map_size_ = 0;
+    // capacity of each ring. the value in the shared memory is not used after the validation
+    std::uint32_t capacity_ = 0;
+    detail::shm_ring* tx_ = nullptr;
+    detail::shm_ring* rx_ = nullptr;
+    bool closed_ = false;
+};
+
+struct shm_stream::accept_op {
+    shm_stream& stream;
+    enum { dispatch, wait, complete } state = dispatch;
+
+    template <typename Self>
+    void operator()(
+        Self& self,
+        error_code const& ec = error_code{},
+        std::size_t /* size */ = 0
+    ) {
+        if (state == dispatch) {
+            state = wait;
+            auto& a_stream{stream};
+            as::dispatch(
+                a_stream.get_executor(),
+                force_move(self)
+            );
+            return;
+        }
+        if (state == wait) {
+            // wait until the client sends the shared memory
+            // peek is used instead of async_wait. it doesn't miss the data that has already arrived
+            state = complete;
+            auto& a_stream{stream};
+            a_stream.nl_.async_receive(
+                as::buffer(&a_stream.peek_byte_, 1),
+                as::socket_base::message_peek,
+                force_move(self)
+            );
+            return;
+        }
+        BOOST_ASSERT(state == complete);
+        if (ec) {
+            self.complete(ec);
+            return;
+        }
+        self.complete(stream.receive_channel());
+    }
+};
+
+template <typename CompletionToken>
+auto
+shm_stream::async_accept(
+    CompletionToken&& token
+) {
+    return as::async_compose<
+        CompletionToken,
+        void(error_code)
+    > (
+        accept_op{*this},
+        token,
+        *this
+    );
+}
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_SHM_STREAM_HPP
@@ -0,0 +1,53 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_UDS_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_UDS_HPP
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/predefined_layer/customized_local_stream.hpp>
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+namespace protocol {
+
+/**
+ * @brief Type alias of Boost.Asio Unix domain stream socket
+ * It is suitable for the client that is located on the same host as the broker.
+ * TCP/IP processing is skipped.
+ *
+ */
+using mqtt_uds = as::basic_stream_socket<as::local::stream_protocol, as::any_io_executor>;
+
+/**
+ * @brief connect Unix domain socket layer
+ * @param layer  Unix domain socket layer
+ * @param path   socket file path to connect
+ * @param token  completion token. signature is void(error_code)
+ * @return deduced by token
+ *
+ */
+template <
+    typename Executor,
+    typename CompletionToken = as::default_completion_token_t<
+        Executor
+    >
+>
+auto
+async_underlying_handshake(
+    as::basic_stream_socket<as::local::stream_protocol, Executor>& layer,
+    std::string_view path,
+    CompletionToken&& token = as::default_completion_token_t<Executor>{}
+);
+
+} // namespace protocol
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_UDS_HPP
@@ -0,0 +1,36 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_URING_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_URING_HPP
+
+#include <async_mqtt/asio_bind/predefined_layer/mqtt.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/customized_uring_stream.hpp>
+
+namespace async_mqtt {
+
+namespace protocol {
+
+/**
+ * @brief Type alias of io_uring based TCP layer
+ * The first argument of the constructor is uring_context.
+ * The rest of arguments are passed to the TCP socket.
+ * @code
+ * am::uring_context uctx{ioc.get_executor()};
+ * auto ep = am::endpoint<am::role::client, am::protocol::mqtt_uring>{
+ *     am::protocol_version::v5,
+ *     uctx,
+ *     ioc.get_executor()
+ * };
+ * @endcode
+ */
+using mqtt_uring = uring_stream<mqtt>;
+
+} // namespace protocol
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_URING_HPP
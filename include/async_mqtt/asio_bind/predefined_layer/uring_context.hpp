@@ -0,0 +1,635 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_URING_CONTEXT_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_URING_CONTEXT_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/protocol/error.hpp>
+#include <async_mqtt/util/move.hpp>
+#include <async_mqtt/util/log.hpp>
+
+/// @file
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+namespace detail {
+
+/**
+ * @brief completion of io_uring submission
+ * on_cqe() is called on the uring_context's strand.
+ * If IORING_CQE_F_MORE is not set on the flags, the completion is deleted just after on_cqe() is called.
+ */
+struct uring_completion {
+    virtual ~uring_completion() = default;
+    virtual void on_cqe(std::int32_t res, std::uint32_t flags) = 0;
+
+    /**
+     * @brief delete the completion that is not completed when the uring_context is destroyed
+     * The completion that holds an operation should override it to delete itself on the
+     * operation's executor.
+     */
+    virtual void abandon() {
+        delete this;
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief io_uring instance shared by uring_stream layers
+ *
+ * It has the following resources:
+ * @li submission/completion queue
+ * @li provided buffer ring for multishot receive. The buffers are picked by the kernel
+ *     only when data arrives, so idle connections hold no receive buffer.
+ *     A consumed buffer is returned by updating the ring, no submission is required.
+ * @li preallocated buffers for small writes. The data is copied to them and sent by plain send.
+ *     If zerocopy_write is set, they are registered as fixed buffers and sent by zerocopy send,
+ *     so the kernel doesn't map the pages on each send. It is slower for MQTT sized packets
+ *     because each send has the extra notification completion.
+ *     If the registration is failed (e.g. RLIMIT_MEMLOCK), plain send is used.
+ *
+ * Completions are notified via eventfd that is watched on the executor passed to the constructor.
+ * The uring_context must outlive all uring_stream layers that use it.
+ *
+ * #### Requirements
+ * @li Linux 6.0 or later (multishot receive, provided buffer ring, zerocopy send, and cancel by fd)
+ *
+ * #### Thread Safety
+ * @li Distinct objects: Safe
+ * @li Shared objects: Safe
+ *
+ */
+class uring_context {
+public:
+    /**
+     * @brief constructor
+     * @param exe              executor that processes the completion queue
+     * @param entries          the number of submission queue entries
+     * @param recv_buf_size    the size of each receive buffer
+     * @param recv_buf_count   the number of receive buffers. It must be a power of 2 and not greater than 32768.
+     * @param write_buf_size   the size of each write buffer.
+     *                         The data that is larger than this size is written by sendmsg without copy.
+     * @param write_buf_count  the number of write buffers
+     * @param zerocopy_write   if true, the write buffers are registered as fixed buffers and
+     *                         sent by zerocopy send. Otherwise, they are sent by plain send.
+     * @throw system_error if io_uring setup is failed, or recv_buf_count is invalid
+     */
+    explicit uring_context(
+        as::any_io_executor exe,
+        unsigned entries = 4096,
+        std::uint32_t recv_buf_size = 4096,
+        std::uint16_t recv_buf_count = 4096,
+        std::uint32_t write_buf_size = 4096,
+        std::uint16_t write_buf_count = 1024,
+        bool zerocopy_write = false
+    );
+
+    ~uring_context();
+
+    uring_context(uring_context const&) = delete;
+    uring_context(uring_context&&) = delete;
+    uring_context& operator=(uring_context const&) = delete;
+    uring_context& operator=(uring_context&&) = delete;
+
+    /**
+     * @brief get executor that processes the completion queue
+     * @return executor
+     */
+    as::any_io_executor get_executor() const {
+        return strand_;
+    }
+
+    /**
+     * @brief stop processing the completion queue
+     * After the pending operations are completed, the wait on the executor is finished,
+     * so the io_context can return from run().
+     * Call it after all uring_streams that use this context are closed.
+     */
+    void close() {
+        as::dispatch(
+            strand_,
+            [this] {
+                stopped_ = true;
+                if (idle()) {
+                    error_code ec;
+                    event_desc_.cancel(ec);
+                }
+            }
+        );
+    }
+
+    /**
+     * @brief the size of each write buffer
+     * @return size
+     */
+    std::uint32_t write_buf_size() const {
+        return write_buf_size_;
+    }
+
+    // The following functions are for uring_stream
+
+    /**
+     * @brief submit an operation
+     * @param comp completion that is called when the operation is completed.
+     *             If nullptr, the completion is ignored.
+     * @param prep function that fills the submission queue entry
+     * @param immediate if true, the submission is passed to the kernel before returning.
+     *                  Otherwise, it is passed with other submissions later.
+     *                  If the submission queue is full, the submission is kept and passed
+     *                  when the kernel consumes the queue.
+     */
+    template <typename Prep>
+    void submit(detail::uring_completion* comp, Prep&& prep, bool immediate = false);
+
+    char const* recv_buffer(std::uint16_t bid) const {
+        return recv_bufs_.get() + std::size_t(bid) * recv_buf_size_;
+    }
+
+    /**
+     * @brief return the receive buffer to the kernel via the provided buffer ring
+     * @param bid buffer id
+     */
+    void return_recv_buffer(std::uint16_t bid);
+
+    /**
+     * @brief call the waiter when a receive buffer is returned
+     * @param waiter function that is called once
+     */
+    void wait_recv_buffer(std::function<void()> waiter);
+
+    std::optional<std::uint16_t> acquire_write_buffer();
+    void release_write_buffer(std::uint16_t index);
+    char* write_buffer(std::uint16_t index) {
+        return write_bufs_.get() + std::size_t(index) * write_buf_size_;
+    }
+
+    /**
+     * @brief check the write buffers are registered as fixed buffers for zerocopy send
+     * @return true if registered. The index of the write buffer is the fixed buffer index.
+     */
+    bool fixed_write_buffers() const {
+        return fixed_write_bufs_;
+    }
+
+    static constexpr std::uint16_t buffer_group_id = 0;
+
+private:
+    static int setup(unsigned entries, io_uring_params& p) {
+        return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+    }
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, nullptr, 0));
+    }
+    int reg(unsigned opcode, void const* arg, unsigned nr_args) {
+        return static_cast<int>(::syscall(__NR_io_uring_register, ring_fd_, opcode, arg, nr_args));
+    }
+    [[noreturn]] static void throw_errno() {
+        throw system_error(error_code{errno, boost::system::system_category()});
+    }
+
+    void release();
+
+    bool idle() {
+        std::lock_guard<std::mutex> g{mtx_};
+        return completions_.empty();
+    }
+
+    // call with mtx_ locked
+    io_uring_sqe* get_sqe();
+    void fill_sq_locked();
+    void flush_locked();
+    void post_flush_locked();
+    void buf_ring_add(std::uint16_t bid, std::uint16_t offset);
+    void buf_ring_advance(std::uint16_t count);
+
+    void async_wait_cqe();
+    void reap();
+
+    as::strand<as::any_io_executor> strand_;
+    int ring_fd_ = -1;
+    int event_fd_ = -1;
+    as::posix::stream_descriptor event_desc_;
+    std::uint64_t event_val_ = 0;
+    bool stopped_ = false;
+
+    // submission queue
+    void* sq_ptr_ = MAP_FAILED;
+    std::size_t sq_len_ = 0;
+    void* cq_ptr_ = MAP_FAILED;
+    std::size_t cq_len_ = 0;
+    io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t sqes_len_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_flags_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned sq_local_tail_ = 0;
+    unsigned to_submit_ = 0;
+    bool flush_posted_ = false;
+    // entries that are waiting for the room of the submission queue
+    std::deque<io_uring_sqe> pending_sqes_;
+
+    // completion queue
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    // provided buffer ring for receive
+    std::uint32_t recv_buf_size_;
+    std::unique_ptr<char[]> recv_bufs_;
+    std::deque<std::function<void()>> recv_buf_waiters_;
+    void* buf_ring_ = MAP_FAILED;
+    std::size_t buf_ring_len_ = 0;
+    std::uint16_t buf_ring_mask_ = 0;
+    std::uint16_t buf_ring_tail_ = 0;
+
+    // buffers for write
+    std::uint32_t write_buf_size_;
+    std::unique_ptr<char[]> write_bufs_;
+    std::vector<std::uint16_t> free_write_bufs_;
+    bool fixed_write_bufs_ = false;
+
+    // completions that are not finished yet
+    std::unordered_set<detail::uring_completion*> completions_;
+
+    std::mutex mtx_;
+};
+
+inline
+uring_context::uring_context(
+    as::any_io_executor exe,
+    unsigned entries,
+    std::uint32_t recv_buf_size,
+    std::uint16_t recv_buf_count,
+    std::uint32_t write_buf_size,
+    std::uint16_t write_buf_count,
+    bool zerocopy_write
+)
+    :strand_{as::make_strand(force_move(exe))},
+     event_desc_{strand_},
+     recv_buf_size_{recv_buf_size},
+     recv_bufs_{std::make_unique<char[]>(std::size_t(recv_buf_size) * recv_buf_count)},
+     write_buf_size_{write_buf_size},
+     write_bufs_{std::make_unique<char[]>(std::size_t(write_buf_size) * write_buf_count)}
+{
+    // destructor is not called if the constructor throws
+    struct cleanup {
+        ~cleanup() {
+            if (ctx) ctx->release();
+        }
+        uring_context* ctx;
+    } guard{this};
+
+    io_uring_params p;
+    std::memset(&p, 0, sizeof(p));
+    // multishot receive can generate many completions per submission
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = entries * 4;
+    ring_fd_ = setup(entries, p);
+    if (ring_fd_ < 0) throw_errno();
+
+    sq_len_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        sq_len_ = cq_len_ = std::max(sq_len_, cq_len_);
+    }
+    sq_ptr_ = ::mmap(nullptr, sq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED) throw_errno();
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        cq_ptr_ = sq_ptr_;
+    }
+    else {
+        cq_ptr_ = ::mmap(nullptr, cq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ptr_ == MAP_FAILED) throw_errno();
+    }
+    sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(
+        ::mmap(nullptr, sqes_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES)
+    );
+    if (sqes_ == MAP_FAILED) throw_errno();
+
+    auto sq = static_cast<char*>(sq_ptr_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sq_flags_ = reinterpret_cast<unsigned*>(sq + p.sq_off.flags);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sq_entries_ = p.sq_entries;
+    sq_local_tail_ = *sq_tail_;
+
+    auto cq = static_cast<char*>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+    // provided buffer ring for receive
+    if (recv_buf_count == 0 ||
+        recv_buf_count > 32768 ||
+        (recv_buf_count & (recv_buf_count - 1)) != 0) {
+        throw system_error(error_code{EINVAL, boost::system::system_category()});
+    }
+    buf_ring_len_ = std::size_t(recv_buf_count) * sizeof(io_uring_buf);
+    // the ring must be page aligned
+    buf_ring_ = ::mmap(nullptr, buf_ring_len_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf_ring_ == MAP_FAILED) throw_errno();
+    io_uring_buf_reg buf_reg;
+    std::memset(&buf_reg, 0, sizeof(buf_reg));
+    buf_reg.ring_addr = reinterpret_cast<std::uint64_t>(buf_ring_);
+    buf_reg.ring_entries = recv_buf_count;
+    buf_reg.bgid = buffer_group_id;
+    if (reg(IORING_REGISTER_PBUF_RING, &buf_reg, 1) < 0) throw_errno();
+    buf_ring_mask_ = std::uint16_t(recv_buf_count - 1);
+    for (std::uint16_t bid = 0; bid != recv_buf_count; ++bid) {
+        buf_ring_add(bid, bid);
+    }
+    buf_ring_advance(recv_buf_count);
+
+    // buffers for write
+    free_write_bufs_.reserve(write_buf_count);
+    for (std::uint16_t i = 0; i != write_buf_count; ++i) {
+        free_write_bufs_.push_back(std::uint16_t(write_buf_count - i - 1));
+    }
+    if (zerocopy_write) {
+        std::vector<iovec> iovs;
+        iovs.reserve(write_buf_count);
+        for (std::uint16_t i = 0; i != write_buf_count; ++i) {
+            iovs.push_back(iovec{write_buffer(i), write_buf_size_});
+        }
+        if (reg(IORING_REGISTER_BUFFERS, iovs.data(), unsigned(iovs.size())) == 0) {
+            fixed_write_bufs_ = true;
+        }
+        else {
+            ASYNC_MQTT_LOG("mqtt_impl", warning)
+                << "io_uring write buffers are not registered:" << std::strerror(errno);
+        }
+    }
+
+    // completion notification
+    event_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd_ < 0) throw_errno();
+    if (reg(IORING_REGISTER_EVENTFD, &event_fd_, 1) < 0) throw_errno();
+    event_desc_.assign(event_fd_);
+
+    guard.ctx = nullptr;
+    async_wait_cqe();
+}
+
+inline
+uring_context::~uring_context() {
+    release();
+}
+
+inline
+void uring_context::release() {
+    error_code ec;
+    if (event_desc_.is_open()) {
+        event_desc_.close(ec);
+    }
+    else if (event_fd_ >= 0) {
+        ::close(event_fd_);
+    }
+    event_fd_ = -1;
+    // closing ring_fd_ cancels all operations
+    if (ring_fd_ >= 0) ::close(ring_fd_);
+    ring_fd_ = -1;
+    if (sqes_ != MAP_FAILED) ::munmap(sqes_, sqes_len_);
+    sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) ::munmap(cq_ptr_, cq_len_);
+    cq_ptr_ = MAP_FAILED;
+    if (sq_ptr_ != MAP_FAILED) ::munmap(sq_ptr_, sq_len_);
+    sq_ptr_ = MAP_FAILED;
+    // the ring is unregistered by closing ring_fd_
+    if (buf_ring_ != MAP_FAILED) ::munmap(buf_ring_, buf_ring_len_);
+    buf_ring_ = MAP_FAILED;
+    // the operations held by the completions are destroyed on their executors
+    for (auto* comp : completions_) {
+        comp->abandon();
+    }
+    completions_.clear();
+}
+
+inline
+io_uring_sqe* uring_context::get_sqe() {
+    auto head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sq_local_tail_ - head >= sq_entries_) return nullptr;
+    auto index = sq_local_tail_ & sq_mask_;
+    auto* sqe = &sqes_[index];
+    sq_array_[index] = index;
+    ++sq_local_tail_;
+    return sqe;
+}
+
+inline
+void uring_context::fill_sq_locked() {
+    if (pending_sqes_.empty()) return;
+    while (!pending_sqes_.empty()) {
+        auto* sqe = get_sqe();
+        if (!sqe) break;
+        *sqe = pending_sqes_.front();
+        pending_sqes_.pop_front();
+        ++to_submit_;
+    }
+    __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+}
+
+inline
+void uring_context::flush_locked() {
+    fill_sq_locked();
+    while (to_submit_ != 0) {
+        auto ret = enter(to_submit_, 0, 0);
+        if (ret < 0) {
+            if (errno != EBUSY && errno != EAGAIN && errno != EINTR) {
+                ASYNC_MQTT_LOG("mqtt_impl", error)
+                    << "io_uring_enter error:" << std::strerror(errno);
+                return;
+            }
+            break;
+        }
+        if (ret == 0) break;
+        to_submit_ -= unsigned(ret);
+        // the consumed entries make room for the pending entries
+        fill_sq_locked();
+    }
+    // the kernel couldn't consume all entries, retry later
+    if (to_submit_ != 0 || !pending_sqes_.empty()) post_flush_locked();
+}
+
+inline
+void uring_context::post_flush_locked() {
+    if (flush_posted_) return;
+    flush_posted_ = true;
+    as::post(
+        strand_,
+        [this] {
+            std::lock_guard<std::mutex> g{mtx_};
+            flush_posted_ = false;
+            flush_locked();
+        }
+    );
+}
+
+template <typename Prep>
+inline
+void uring_context::submit(detail::uring_completion* comp, Prep&& prep, bool immediate) {
+    std::lock_guard<std::mutex> g{mtx_};
+    // the entry is prepared out of the queue, so it can wait for the room of the queue
+    // when the kernel doesn't consume the queue (EBUSY/EAGAIN).
+    pending_sqes_.emplace_back();
+    auto& sqe = pending_sqes_.back();
+    std::forward<Prep>(prep)(sqe);
+    sqe.user_data = reinterpret_cast<std::uint64_t>(comp);
+    if (comp) completions_.insert(comp);
+    fill_sq_locked();
+    if (!pending_sqes_.empty()) {
+        // submission queue is full
+        flush_locked();
+        return;
+    }
+    if (immediate) {
+        flush_locked();
+        return;
+    }
+    // submissions from many streams are passed to the kernel at once
+    post_flush_locked();
+}
+
+inline
+void uring_context::buf_ring_add(std::uint16_t bid, std::uint16_t offset) {
+    // The entries are addressed from the head of the ring instead of io_uring_buf_ring::bufs.
+    // In C++, __DECLARE_FLEX_ARRAY places bufs after a non zero size empty struct,
+    // so the offset of bufs doesn't match the kernel's one.
+    auto* bufs = static_cast<io_uring_buf*>(buf_ring_);
+    auto& buf = bufs[std::uint16_t(buf_ring_tail_ + offset) & buf_ring_mask_];
+    // resv of the first entry is the tail, so the fields are set one by one
+    buf.addr = reinterpret_cast<std::uint64_t>(recv_buffer(bid));
+    buf.len = recv_buf_size_;
+    buf.bid = bid;
+}
+
+inline
+void uring_context::buf_ring_advance(std::uint16_t count) {
+    buf_ring_tail_ = std::uint16_t(buf_ring_tail_ + count);
+    auto* tail = reinterpret_cast<std::uint16_t*>(
+        static_cast<char*>(buf_ring_) + offsetof(io_uring_buf_ring, tail)
+    );
+    // the kernel sees the entries before the tail
+    __atomic_store_n(tail, buf_ring_tail_, __ATOMIC_RELEASE);
+}
+
+inline
+void uring_context::return_recv_buffer(std::uint16_t bid) {
+    std::function<void()> waiter;
+    {
+        std::lock_guard<std::mutex> g{mtx_};
+        buf_ring_add(bid, 0);
+        buf_ring_advance(1);
+        if (!recv_buf_waiters_.empty()) {
+            waiter = force_move(recv_buf_waiters_.front());
+            recv_buf_waiters_.pop_front();
+        }
+    }
+    if (waiter) waiter();
+}
+
+inline
+void uring_context::wait_recv_buffer(std::function<void()> waiter) {
+    std::lock_guard<std::mutex> g{mtx_};
+    recv_buf_waiters_.push_back(force_move(waiter));
+}
+
+inline
+std::optional<std::uint16_t> uring_context::acquire_write_buffer() {
+    std::lock_guard<std::mutex> g{mtx_};
+    if (free_write_bufs_.empty()) return std::nullopt;
+    auto index = free_write_bufs_.back();
+    free_write_bufs_.pop_back();
+    return index;
+}
+
+inline
+void uring_context::release_write_buffer(std::uint16_t index) {
+    std::lock_guard<std::mutex> g{mtx_};
+    free_write_bufs_.push_back(index);
+}
+
+inline
+void uring_context::async_wait_cqe() {
+    event_desc_.async_read_some(
+        as::buffer(&event_val_, sizeof(event_val_)),
+        [this](error_code const& ec, std::size_t) {
+            if (ec == as::error::operation_aborted) return;
+            reap();
+            if (stopped_ && idle()) return;
+            async_wait_cqe();
+        }
+    );
+}
+
+inline
+void uring_context::reap() {
+    while (true) {
+        auto head = *cq_head_;
+        auto tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            std::lock_guard<std::mutex> g{mtx_};
+            if (__atomic_load_n(sq_flags_, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW) {
+                // move overflowed completions to the completion queue
+                enter(0, 0, IORING_ENTER_GETEVENTS);
+                continue;
+            }
+            break;
+        }
+        for (; head != tail; ++head) {
+            auto const& cqe = cqes_[head & cq_mask_];
+            auto* comp = reinterpret_cast<detail::uring_completion*>(cqe.user_data);
+            auto res = cqe.res;
+            auto flags = cqe.flags;
+            if (!comp) continue;
+            comp->on_cqe(res, flags);
+            if (!(flags & IORING_CQE_F_MORE)) {
+                {
+                    std::lock_guard<std::mutex> g{mtx_};
+                    completions_.erase(comp);
+                }
+                delete comp;
+            }
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+}
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_URING_CONTEXT_HPP
@@ -0,0 +1,303 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_URING_STREAM_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_URING_STREAM_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <memory>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/stream_customize.hpp>
+#include <async_mqtt/asio_bind/detail/stream_layer.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/uring_context.hpp>
+
+/// @file
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+namespace detail {
+
+class uring_stream_state : public std::enable_shared_from_this<uring_stream_state> {
+public:
+    uring_stream_state(uring_context& ctx, as::any_io_executor exe)
+        :ctx{ctx},
+         exe{exe},
+         tim{force_move(exe)}
+    {}
+
+    ~uring_stream_state() {
+        for (auto const& c : chunks) {
+            ctx.return_recv_buffer(c.bid);
+        }
+    }
+
+    // start multishot receive if it is not started yet
+    void arm(int fd) {
+        if (armed || closed) return;
+        armed = true;
+        ctx.submit(
+            new recv_completion{shared_from_this(), fd},
+            [&](io_uring_sqe& sqe) {
+                sqe.opcode = IORING_OP_RECV;
+                sqe.fd = fd;
+                sqe.ioprio = IORING_RECV_MULTISHOT;
+                sqe.flags = IOSQE_BUFFER_SELECT;
+                sqe.buf_group = uring_context::buffer_group_id;
+            }
+        );
+    }
+
+    // wake up the waiting read
+    void notify() {
+        notified = true;
+        tim.cancel();
+    }
+
+    void on_recv(int fd, std::int32_t res, std::uint32_t flags) {
+        if (!(flags & IORING_CQE_F_MORE)) armed = false;
+        if (flags & IORING_CQE_F_BUFFER) {
+            auto bid = static_cast<std::uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+            if (res > 0 && !closed) {
+                chunks.push_back(chunk{bid, static_cast<std::uint32_t>(res)});
+            }
+            else {
+                ctx.return_recv_buffer(bid);
+            }
+        }
+        if (closed) return;
+        if (res > 0) {
+            // multishot receive could be terminated by the kernel
+            arm(fd);
+            notify();
+        }
+        else if (res == 0) {
+            recv_ec = as::error::eof;
+            notify();
+        }
+        else if (res == -ENOBUFS) {
+            // all receive buffers are in use, retry when a buffer is returned
+            ctx.wait_recv_buffer(
+                [wp = weak_from_this(), fd] {
+                    if (auto sp = wp.lock()) {
+                        as::post(
+                            sp->exe,
+                            [sp, fd] {
+                                sp->arm(fd);
+                            }
+                        );
+                    }
+                }
+            );
+        }
+        else if (res != -ECANCELED) {
+            recv_ec = error_code{-res, boost::system::system_category()};
+            notify();
+        }
+    }
+
+    // copy received data to the buffers and return the receive buffers to the ring
+    template <typename MutableBufferSequence>
+    std::size_t consume(MutableBufferSequence const& buffers) {
+        std::size_t total = 0;
+        for (
+            auto it = as::buffer_sequence_begin(buffers), end = as::buffer_sequence_end(buffers);
+            it != end && !chunks.empty();
+            ++it
+        ) {
+            as::mutable_buffer mb{*it};
+            while (mb.size() != 0 && !chunks.empty()) {
+                auto& c = chunks.front();
+                auto size = std::min<std::size_t>(mb.size(), c.size - offset);
+                std::memcpy(mb.data(), ctx.recv_buffer(c.bid) + offset, size);
+                mb += size;
+                total += size;
+                offset += static_cast<std::uint32_t>(size);
+                if (offset == c.size) {
+                    ctx.return_recv_buffer(c.bid);
+                    chunks.pop_front();
+                    offset = 0;
+                }
+            }
+        }
+        return total;
+    }
+
+    void close(int fd) {
+        if (closed) return;
+        closed = true;
+        if (fd >= 0) {
+            // cancel the multishot receive and the writes on the fd.
+            // it must be submitted before the fd is closed.
+            ctx.submit(
+                nullptr,
+                [&](io_uring_sqe& sqe) {
+                    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+                    sqe.fd = fd;
+                    sqe.cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+                },
+                true
+            );
+        }
+        for (auto const& c : chunks) {
+            ctx.return_recv_buffer(c.bid);
+        }
+        chunks.clear();
+        offset = 0;
+        notify();
+    }
+
+    struct recv_completion : uring_completion {
+        recv_completion(std::shared_ptr<uring_stream_state> st, int fd)
+            :st{force_move(st)},
+             fd{fd}
+        {}
+
+        // called on the uring_context's strand. st->fd is owned by the stream's executor,
+        // so the fd that is captured on arm() is used.
+        void on_cqe(std::int32_t res, std::uint32_t flags) override {
+            auto& a_st{*st};
+            as::post(
+                a_st.exe,
+                [st = st, fd = fd, res, flags] {
+                    st->on_recv(fd, res, flags);
+                }
+            );
+        }
+
+        void abandon() override {
+            // the state is released on the stream's executor
+            auto& a_st{*st};
+            as::post(
+                a_st.exe,
+                [st = force_move(st)] {}
+            );
+            delete this;
+        }
+
+        std::shared_ptr<uring_stream_state> st;
+        int fd;
+    };
+
+    struct chunk {
+        std::uint16_t bid;
+        std::uint32_t size;
+    };
+
+    uring_context& ctx;
+    as::any_io_executor exe;
+    as::steady_timer tim;
+    std::deque<chunk> chunks;
+    std::uint32_t offset = 0;
+    int fd = -1;
+    bool armed = false;
+    bool notified = false;
+    bool closed = false;
+    error_code recv_ec;
+};
+
+} // namespace detail
+
+/**
+ * @brief io_uring based layer
+ *
+ * The layer reads and writes the lowest layer's socket via io_uring of uring_context
+ * instead of reactor (epoll).
+ * @li Receiving is done by multishot receive with the provided buffer ring.
+ *     One submission receives data repeatedly until the connection is closed.
+ * @li Small data is copied to the preallocated write buffer and sent by plain send.
+ *     If zerocopy_write of uring_context is set, zerocopy send with the fixed buffer is used.
+ * @li Large data is sent by sendmsg without copy.
+ *
+ * The next layer is used for connecting, accepting, and closing.
+ *
+ * @tparam NextLayer TCP socket
+ *
+ * #### Thread Safety
+ * @li Distinct objects: Safe
+ * @li Shared objects: Unsafe
+ *
+ */
+template <typename NextLayer>
+class uring_stream {
+public:
+    using next_layer_type = NextLayer;
+    using executor_type = typename next_layer_type::executor_type;
+
+    /**
+     * @brief constructor
+     * @param ctx  uring_context that is shared by uring_streams
+     * @param args arguments for the next layer's constructor
+     */
+    template <typename... Args>
+    explicit uring_stream(uring_context& ctx, Args&&... args)
+        :nl_{std::forward<Args>(args)...},
+         state_{std::make_shared<detail::uring_stream_state>(ctx, nl_.get_executor())}
+    {}
+
+    /**
+     * @brief executor getter
+     * @return executor
+     */
+    executor_type get_executor() {
+        return nl_.get_executor();
+    }
+
+    /**
+     * @brief next_layer getter
+     * @return const reference of the next_layer
+     */
+    next_layer_type const& next_layer() const {
+        return nl_;
+    }
+
+    /**
+     * @brief next_layer getter
+     * @return reference of the next_layer
+     */
+    next_layer_type& next_layer() {
+        return nl_;
+    }
+
+    /**
+     * @brief uring_context getter
+     * @return reference of the uring_context
+     */
+    uring_context& context() const {
+        return state_->ctx;
+    }
+
+private:
+    friend struct layer_customize<uring_stream<NextLayer>>;
+
+    detail::uring_stream_state& state() {
+        auto& lowest = detail::get_lowest_layer(nl_);
+        if (state_->fd == -1 && lowest.is_open()) {
+            state_->fd = lowest.native_handle();
+        }
+        return *state_;
+    }
+
+    // renew the state for reconnecting
+    void reset() {
+        if (state_->closed) {
+            state_ = std::make_shared<detail::uring_stream_state>(state_->ctx, nl_.get_executor());
+        }
+    }
+
+    next_layer_type nl_;
+    std::shared_ptr<detail::uring_stream_state> state_;
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_URING_STREAM_HPP
@@ -0,0 +1,62 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_WSS_KTLS_HPP)
+#define ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_WSS_KTLS_HPP
+
+#include <boost/beast/websocket/teardown.hpp>
+
+#include <async_mqtt/asio_bind/predefined_layer/mqtts_ktls.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/ws.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/customized_websocket_stream.hpp>
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+namespace bs = boost::beast;
+
+/**
+ * @brief websocket teardown of ktls_stream
+ * It is found by ADL from boost::beast::websocket::stream.
+ */
+inline
+void teardown(
+    bs::role_type,
+    ktls_stream& stream,
+    error_code& ec
+) {
+    stream.shutdown(ec);
+}
+
+/**
+ * @brief websocket async_teardown of ktls_stream
+ * It is found by ADL from boost::beast::websocket::stream.
+ */
+template <typename TeardownHandler>
+void async_teardown(
+    bs::role_type,
+    ktls_stream& stream,
+    TeardownHandler&& handler
+) {
+    stream.async_shutdown(
+        std::forward<TeardownHandler>(handler)
+    );
+}
+
+namespace protocol {
+
+/**
+ * @brief Type alias of boost::beast::websocket::stream of mqtts_ktls
+ * async_underlying_handshake function can be called with wss_ktls.
+ * The arguments are the same as protocol::wss.
+ */
+using wss_ktls = bs::websocket::stream<mqtts_ktls>;
+
+} // namespace protocol
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_ASIO_BIND_PREDEFINED_LAYER_WSS_KTLS_HPP
@@ -40,6 +40,19 @@ struct has_initialize<
     >
 > : std::true_type {};
 
+// set_bulk_write
+
+template <typename Layer, typename = void>
+struct has_set_bulk_write : std::false_type {};
+
+template <typename Layer>
+struct has_set_bulk_write<
+    Layer,
+    std::void_t<
+        decltype(layer_customize<Layer>::set_bulk_write(std::declval<Layer&>(), std::declval<bool>()))
+    >
+> : std::true_type {};
+
 // async_read_some
 
 template <typename Layer, typename = void>
@@ -16,6 +16,7 @@
 #include <async_mqtt/protocol/protocol_version.hpp>
 #include <async_mqtt/protocol/timer.hpp>
 #include <async_mqtt/protocol/packet/store_packet_variant.hpp>
+#include <async_mqtt/util/topic_alias_send.hpp>
 namespace async_mqtt {
 
 template <role Role, std::size_t PacketIdBytes>
@@ -85,6 +86,10 @@ public:
      *     Finally, @ref on_close() is called.
      * @li If a complete and valid packet is constructed, @ref on_receive() is called with
      *     the constructed packet.
+     * @li If @ref set_publish_payload_streaming_threshold() is set and a PUBLISH packet that has
+     *     the larger remaining length is received, @ref on_receive_publish_header() is called with
+     *     the PUBLISH packet that has an empty payload. Then @ref on_receive_publish_payload()
+     *     is called with the payload chunk for each following call.
      * @li If the packet_id becomes reusable, @ref on_packet_id_release() is called with
      *     the packet_id.
      * @li If a timer operation is required, @ref on_timer_op() is called.
@@ -223,6 +228,20 @@ public:
      */
     void set_auto_map_topic_alias_send(bool val);
 
+    /**
+     * @brief Set the policy of the automatic mapping of topic aliases.
+     *
+     * - @ref topic_alias_send_policy::lru maps every topic. If all topic aliases are in use,
+     *   the least recently used (LRU) alias is overwritten.
+     * - @ref topic_alias_send_policy::frequency maps only the frequently sent topics.
+     *   The topics that are sent rarely are sent without a topic alias, so they don't evict the hot topics.
+     *
+     * @note The default policy is @ref topic_alias_send_policy::lru.
+     *
+     * @param policy The policy that is used when automatic mapping is enabled.
+     */
+    void set_auto_map_topic_alias_send_policy(topic_alias_send_policy policy);
+
     /**
      * @brief Enable or disable automatic replacement of topics with corresponding topic aliases
      *        when sending PUBLISH packets.
@@ -247,6 +266,43 @@ public:
      */
     void set_pingresp_recv_timeout(std::chrono::milliseconds duration);
 
+    /**
+     * @brief Set the threshold for streaming reception of PUBLISH packet payloads.
+     *
+     * If the remaining length of a received PUBLISH packet is greater than `size`,
+     * the payload is not stored in one buffer. The PUBLISH packet without payload is notified by
+     * @ref on_receive_publish_header(), then the payload is notified chunk by chunk by
+     * @ref on_receive_publish_payload() as the bytes arrive.
+     * The automatic PUBACK/PUBREC is sent after the last chunk is received.
+     * The Keep Alive timer is reset for each chunk.
+     *
+     * @note By default, the threshold is 0 that means streaming is disabled.
+     *
+     * @param size The remaining length threshold in bytes. 0 means disabled.
+     */
+    void set_publish_payload_streaming_threshold(std::size_t size);
+
+    /**
+     * @brief Set the maximum variable header size of the streamed PUBLISH packet.
+     *
+     * The variable header (topic name, packet identifier and properties) of the streamed
+     * PUBLISH packet is stored in memory. If the size is greater than `size`,
+     * the packet is treated as packet_too_large error.
+     *
+     * @note By default, the maximum size is 131072 (128KiB).
+     *
+     * @param size The maximum variable header size in bytes.
+     */
+    void set_publish_header_max_size(std::size_t size);
+
+    /**
+     * @brief Get the payload size of the streamed PUBLISH packet that is not received yet.
+     *
+     * @return The number of payload bytes that are not received yet.
+     *         If no PUBLISH packet payload is being streamed, returns 0.
+     */
+    std::size_t get_publish_payload_rest() const;
+
     /**
      * @brief Acquire a unique packet_id.
      *
@@ -414,6 +470,37 @@ private:
         basic_packet_variant<PacketIdBytes> packet
     ) = 0;
 
+    /**
+     * @brief Handler for streamed PUBLISH packet header received notifications.
+     *
+     * This function is called instead of @ref on_receive() in
+     * @ref recv() **before the function returns** if the PUBLISH packet payload is streamed.
+     * See @ref set_publish_payload_streaming_threshold().
+     * The default implementation does nothing.
+     *
+     * @param packet       The PUBLISH packet that has an empty payload.
+     * @param payload_size The payload size that is notified by @ref on_receive_publish_payload().
+     */
+    virtual void on_receive_publish_header(
+        basic_packet_variant<PacketIdBytes> /*packet*/,
+        std::size_t /*payload_size*/
+    ) {}
+
+    /**
+     * @brief Handler for streamed PUBLISH packet payload received notifications.
+     *
+     * This function is called when a part of the streamed PUBLISH packet payload is received in
+     * @ref recv() **before the function returns**.
+     * The default implementation does nothing.
+     *
+     * @param chunk The part of the payload.
+     * @param last  `true` if the chunk is the last part of the payload.
+     */
+    virtual void on_receive_publish_payload(
+        buffer /*chunk*/,
+        bool /*last*/
+    ) {}
+
     /**
      * @brief Handler for timer operation requests.
      *
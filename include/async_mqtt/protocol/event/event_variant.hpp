@@ -15,6 +15,8 @@
 #include <async_mqtt/protocol/event/packet_received.hpp>
 #include <async_mqtt/protocol/event/timer.hpp>
 #include <async_mqtt/protocol/event/close.hpp>
+#include <async_mqtt/protocol/event/publish_header_received.hpp>
+#include <async_mqtt/protocol/event/publish_payload_received.hpp>
 
 namespace async_mqtt {
 
@@ -32,6 +34,8 @@ namespace async_mqtt {
  * @li @ref event::basic_packet_received<PacketIdBytes>
  * @li @ref event::timer
  * @li @ref event::close
+ * @li @ref event::basic_publish_header_received<PacketIdBytes>
+ * @li @ref event::publish_payload_received
  *
  * #### related functions
  * @li @ref is_error()
@@ -44,7 +48,9 @@ using basic_event_variant = std::variant<
     event::basic_packet_id_released<PacketIdBytes>,
     event::basic_packet_received<PacketIdBytes>,
     event::timer,
-    event::close
+    event::close,
+    event::basic_publish_header_received<PacketIdBytes>,
+    event::publish_payload_received
 >;
 
 /**
@@ -0,0 +1,89 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_PROTOCOL_EVENT_PUBLISH_HEADER_RECEIVED_HPP)
+#define ASYNC_MQTT_PROTOCOL_EVENT_PUBLISH_HEADER_RECEIVED_HPP
+
+#include <cstddef>
+
+#include <async_mqtt/protocol/packet/packet_variant.hpp>
+
+namespace async_mqtt::event {
+
+/**
+ * @brief Streamed PUBLISH packet header received event.
+ *
+ * This corresponds to @ref basic_connection::on_receive_publish_header().
+ *
+ * #### Thread Safety
+ *    @li Distinct objects: Safe
+ *    @li Shared objects: Unsafe
+ *
+ * @tparam PacketIdBytes The number of bytes used for the packet identifier.
+ *                       According to the MQTT specification, this is 2.
+ *                       You can use @ref event::publish_header_received for this.
+ */
+template <std::size_t PacketIdBytes>
+class basic_publish_header_received {
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param packet       The received PUBLISH packet that has an empty payload.
+     * @param payload_size The payload size that follows.
+     */
+    basic_publish_header_received(
+        basic_packet_variant<PacketIdBytes> packet,
+        std::size_t payload_size
+    )
+        : packet_{force_move(packet)},
+          payload_size_{payload_size} {}
+
+    /**
+     * @brief Get the received packet.
+     *
+     * @return A const reference to the received packet.
+     */
+    const basic_packet_variant<PacketIdBytes>& get() const {
+        return packet_;
+    }
+
+    /**
+     * @brief Get the received packet.
+     *
+     * @return A reference to the received packet.
+     */
+    basic_packet_variant<PacketIdBytes>& get() {
+        return packet_;
+    }
+
+    /**
+     * @brief Get the payload size.
+     *
+     * @return The payload size that is notified by @ref event::publish_payload_received.
+     */
+    std::size_t get_payload_size() const {
+        return payload_size_;
+    }
+
+private:
+    basic_packet_variant<PacketIdBytes> packet_;
+    std::size_t payload_size_;
+};
+
+/**
+ * @brief Type alias of @ref basic_publish_header_received (PacketIdBytes=2).
+ *        This is for typical usecase (e.g. MQTT client).
+ *
+ * #### Thread Safety
+ *    @li Distinct objects: Safe
+ *    @li Shared objects: Unsafe
+ */
+using publish_header_received = basic_publish_header_received<2>;
+
+} // namespace async_mqtt::event
+
+#endif // ASYNC_MQTT_PROTOCOL_EVENT_PUBLISH_HEADER_RECEIVED_HPP
@@ -0,0 +1,70 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_PROTOCOL_EVENT_PUBLISH_PAYLOAD_RECEIVED_HPP)
+#define ASYNC_MQTT_PROTOCOL_EVENT_PUBLISH_PAYLOAD_RECEIVED_HPP
+
+#include <async_mqtt/util/buffer.hpp>
+#include <async_mqtt/util/move.hpp>
+
+namespace async_mqtt::event {
+
+/**
+ * @brief Streamed PUBLISH packet payload received event.
+ *
+ * This corresponds to @ref basic_connection::on_receive_publish_payload().
+ *
+ * #### Thread Safety
+ *    @li Distinct objects: Safe
+ *    @li Shared objects: Unsafe
+ */
+class publish_payload_received {
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param chunk The part of the payload.
+     * @param last  `true` if the chunk is the last part of the payload.
+     */
+    publish_payload_received(buffer chunk, bool last)
+        : chunk_{force_move(chunk)},
+          last_{last} {}
+
+    /**
+     * @brief Get the part of the payload.
+     *
+     * @return A const reference to the part of the payload.
+     */
+    buffer const& get() const {
+        return chunk_;
+    }
+
+    /**
+     * @brief Get the part of the payload.
+     *
+     * @return A reference to the part of the payload.
+     */
+    buffer& get() {
+        return chunk_;
+    }
+
+    /**
+     * @brief Check whether the chunk is the last part of the payload.
+     *
+     * @return `true` if the chunk is the last part, otherwise `false`.
+     */
+    bool is_last() const {
+        return last_;
+    }
+
+private:
+    buffer chunk_;
+    bool last_;
+};
+
+} // namespace async_mqtt::event
+
+#endif // ASYNC_MQTT_PROTOCOL_EVENT_PUBLISH_PAYLOAD_RECEIVED_HPP
@@ -9,6 +9,7 @@
 
 #include <set>
 #include <deque>
+#include <string>
 
 #include <async_mqtt/protocol/error.hpp>
 #include <async_mqtt/util/topic_alias_send.hpp>
@@ -64,10 +65,18 @@ public:
 
     void set_auto_map_topic_alias_send(bool val);
 
+    void set_auto_map_topic_alias_send_policy(topic_alias_send_policy policy);
+
     void set_auto_replace_topic_alias_send(bool val);
 
     void set_pingresp_recv_timeout(std::chrono::milliseconds duration);
 
+    void set_publish_payload_streaming_threshold(std::size_t size);
+
+    void set_publish_header_max_size(std::size_t size);
+
+    std::size_t get_publish_payload_rest() const;
+
     std::optional<typename basic_packet_id_type<PacketIdBytes>::type> acquire_unique_packet_id();
 
     bool register_packet_id(typename basic_packet_id_type<PacketIdBytes>::type packet_id);
@@ -108,6 +117,12 @@ private:
     void
     process_recv_packet();
 
+    void
+    process_recv_publish_payload();
+
+    void
+    pingreq_recv_op();
+
     void
     initialize(bool is_client);
 
@@ -156,6 +171,7 @@ private:
     bool auto_ping_response_ = false;
 
     bool auto_map_topic_alias_send_ = false;
+    topic_alias_send_policy topic_alias_send_policy_ = topic_alias_send_policy::lru;
     bool auto_replace_topic_alias_send_ = false;
     std::optional<topic_alias_send> topic_alias_send_;
     std::optional<topic_alias_recv> topic_alias_recv_;
@@ -182,25 +198,55 @@ private:
     bool pingreq_recv_set_{false};
     bool pingresp_recv_set_{false};
 
+    // streamed PUBLISH payload
+    bool publish_payload_discard_{false};
+    std::optional<basic_pid_type> publish_payload_puback_;
+    std::optional<basic_pid_type> publish_payload_pubrec_;
+    std::optional<basic_pid_type> publish_payload_qos2_pid_;
+
     struct error_packet {
         error_packet(error_code ec)
             :ec{ec} {}
         error_packet(buffer packet)
-            :packet{force_move(packet)} {}
+            :packet_size{packet.size()}, packet{force_move(packet)} {}
+        // PUBLISH packet header, the payload is streamed
+        error_packet(buffer packet, std::size_t packet_size, std::size_t payload_size)
+            :packet_size{packet_size}, packet{force_move(packet)}, payload_size{payload_size} {}
 
         error_code ec;
+        std::size_t packet_size = 0;
         buffer packet;
+        std::optional<std::size_t> payload_size;
+    };
+
+    struct payload_chunk {
+        buffer chunk;
+        bool last;
     };
 
     class recv_packet_builder {
     public:
-        void recv(std::istream& is);
+        void recv(std::istream& is, protocol_version ver);
         error_packet& get();
         bool has_value() const;
+        payload_chunk& get_payload();
+        bool has_payload() const;
         void clear();
         void initialize();
+        void set_publish_payload_streaming_threshold(std::size_t size);
+        void set_publish_header_max_size(std::size_t size);
+        std::size_t publish_payload_rest() const;
     private:
-        enum class read_state{fixed_header, remaining_length, payload} read_state_ = read_state::fixed_header;
+        std::optional<std::size_t> publish_header_size(protocol_version ver) const;
+        void publish_header_built();
+
+        enum class read_state{
+            fixed_header,
+            remaining_length,
+            payload,
+            publish_header,
+            publish_payload
+        } read_state_ = read_state::fixed_header;
         std::size_t remaining_length_ = 0;
         std::size_t multiplier_ = 1;
         static_vector<char, 5> header_remaining_length_buf_;
@@ -208,6 +254,13 @@ private:
         std::size_t raw_buf_size_ = 0;
         char* raw_buf_ptr_ = nullptr;
         std::optional<error_packet> read_packet_;
+
+        std::size_t publish_payload_streaming_threshold_ = 0;
+        // topic name (up to 65535 bytes) and 64KiB properties
+        std::size_t publish_header_max_size_ = 128 * 1024;
+        std::string publish_header_buf_; // variable header of the streamed PUBLISH packet
+        std::size_t publish_payload_rest_ = 0;
+        std::optional<payload_chunk> read_payload_;
     };
 
     recv_packet_builder rpb_;
@@ -14,6 +14,7 @@
 #include <async_mqtt/protocol/impl/connection_impl.hpp>
 #include <async_mqtt/util/static_vector.hpp>
 #include <async_mqtt/util/shared_ptr_array.hpp>
+#include <async_mqtt/util/variable_bytes.hpp>
 #include <async_mqtt/util/inline.hpp>
 
 #if !defined(ASYNC_MQTT_SEPARATE_COMPILATION)
@@ -28,7 +29,7 @@ template <role Role, std::size_t PacketIdBytes>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void
 basic_connection_impl<Role, PacketIdBytes>::recv_packet_builder::
-recv(std::istream& is) {
+recv(std::istream& is, protocol_version ver) {
     BOOST_ASSERT(is);
     auto size = static_cast<std::size_t>(is.rdbuf()->in_avail());
     while (size != 0) {
@@ -53,6 +54,16 @@ recv(std::istream& is) {
                 remaining_length_ += (std::uint8_t(encoded_byte) & 0b0111'1111) * multiplier_;
                 multiplier_ *= 128;
                 if ((encoded_byte & 0b1000'0000) == 0) {
+                    if (publish_payload_streaming_threshold_ != 0 &&
+                        remaining_length_ > publish_payload_streaming_threshold_ &&
+                        ver != protocol_version::undetermined &&
+                        (std::uint8_t(header_remaining_length_buf_.front()) & 0b1111'0000) ==
+                        static_cast<std::uint8_t>(control_packet_type::publish)
+                    ) {
+                        // the payload is not stored, it is passed chunk by chunk
+                        read_state_ = read_state::publish_header;
+                        break;
+                    }
                     raw_buf_size_ = header_remaining_length_buf_.size() + remaining_length_;
                     raw_buf_ = make_shared_ptr_char_array(raw_buf_size_);
                     raw_buf_ptr_ = raw_buf_.get();
@@ -83,7 +94,7 @@ recv(std::istream& is) {
                     return;
                 }
             }
-            if (read_state_ != read_state::payload) {
+            if (read_state_ == read_state::remaining_length) {
                 return;
             }
         } break;
@@ -107,10 +118,134 @@ recv(std::istream& is) {
                 return;
             }
         } break;
+        case read_state::publish_header: {
+            while (true) {
+                auto header_size_opt = publish_header_size(ver);
+                if (!header_size_opt || *header_size_opt > remaining_length_) {
+                    BOOST_ASSERT(!read_packet_);
+                    read_packet_.emplace(make_error_code(disconnect_reason_code::malformed_packet));
+                    initialize();
+                    return;
+                }
+                // the variable header is stored in memory, so its size is limited
+                if (*header_size_opt > publish_header_max_size_) {
+                    BOOST_ASSERT(!read_packet_);
+                    read_packet_.emplace(make_error_code(disconnect_reason_code::packet_too_large));
+                    initialize();
+                    return;
+                }
+                if (*header_size_opt == publish_header_buf_.size()) {
+                    publish_header_built();
+                    return;
+                }
+                if (size == 0) return;
+                auto old_size = publish_header_buf_.size();
+                auto copy_size = std::min(size, *header_size_opt - old_size);
+                publish_header_buf_.resize(old_size + copy_size);
+                auto copied = is.readsome(
+                    publish_header_buf_.data() + old_size,
+                    static_cast<std::streamsize>(copy_size)
+                );
+                (void)copied;
+                BOOST_ASSERT(static_cast<std::size_t>(copied) == copy_size);
+                size -= copy_size;
+            }
+        } break;
+        case read_state::publish_payload: {
+            auto chunk_size = std::min(size, publish_payload_rest_);
+            auto chunk_buf = make_shared_ptr_char_array(chunk_size);
+            auto copied = is.readsome(chunk_buf.get(), static_cast<std::streamsize>(chunk_size));
+            (void)copied;
+            BOOST_ASSERT(static_cast<std::size_t>(copied) == chunk_size);
+            publish_payload_rest_ -= chunk_size;
+            auto ptr = chunk_buf.get();
+            BOOST_ASSERT(!read_payload_);
+            read_payload_.emplace(
+                payload_chunk{
+                    buffer{ptr, chunk_size, force_move(chunk_buf)},
+                    publish_payload_rest_ == 0
+                }
+            );
+            if (publish_payload_rest_ == 0) {
+                initialize();
+            }
+            return;
+        } break;
         }
     }
 }
 
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+std::optional<std::size_t>
+basic_connection_impl<Role, PacketIdBytes>::recv_packet_builder::
+publish_header_size(protocol_version ver) const {
+    // returns the variable header size that is known by the bytes received so far
+    auto const& vh = publish_header_buf_;
+    std::size_t size = 2; // topic name length
+    if (vh.size() < size) return size;
+    size += (std::size_t(std::uint8_t(vh[0])) << 8) | std::uint8_t(vh[1]);
+    auto qos_value = static_cast<qos>(
+        (std::uint8_t(header_remaining_length_buf_.front()) & 0b0000'0110) >> 1
+    );
+    if (qos_value == qos::at_least_once || qos_value == qos::exactly_once) {
+        size += PacketIdBytes;
+    }
+    else if (qos_value != qos::at_most_once) {
+        return std::nullopt;
+    }
+    if (ver == protocol_version::v5) {
+        // property length
+        std::size_t property_length = 0;
+        std::size_t multiplier = 1;
+        for (std::size_t i = 0; i != 4; ++i) {
+            if (vh.size() <= size) return size + 1;
+            auto encoded_byte = std::uint8_t(vh[size++]);
+            property_length += (encoded_byte & 0b0111'1111) * multiplier;
+            multiplier *= 128;
+            if ((encoded_byte & 0b1000'0000) == 0) {
+                return size + property_length;
+            }
+        }
+        return std::nullopt;
+    }
+    return size;
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection_impl<Role, PacketIdBytes>::recv_packet_builder::
+publish_header_built() {
+    // the PUBLISH packet that has the variable header and the empty payload
+    auto payload_size = remaining_length_ - publish_header_buf_.size();
+    auto packet_size = header_remaining_length_buf_.size() + remaining_length_;
+    auto rl = val_to_variable_bytes(static_cast<std::uint32_t>(publish_header_buf_.size()));
+    auto header_size = 1 + rl.size() + publish_header_buf_.size();
+    auto header_buf = make_shared_ptr_char_array(header_size);
+    auto it = header_buf.get();
+    *it++ = header_remaining_length_buf_.front();
+    it = std::copy(rl.begin(), rl.end(), it);
+    std::copy(publish_header_buf_.begin(), publish_header_buf_.end(), it);
+    auto ptr = header_buf.get();
+    BOOST_ASSERT(!read_packet_);
+    if (payload_size == 0) {
+        read_packet_.emplace(
+            buffer{ptr, header_size, force_move(header_buf)}
+        );
+        initialize();
+        return;
+    }
+    read_packet_.emplace(
+        buffer{ptr, header_size, force_move(header_buf)},
+        packet_size,
+        payload_size
+    );
+    initialize();
+    read_state_ = read_state::publish_payload;
+    publish_payload_rest_ = payload_size;
+}
+
 template <role Role, std::size_t PacketIdBytes>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 typename basic_connection_impl<Role, PacketIdBytes>::error_packet&
@@ -127,12 +262,29 @@ has_value() const {
     return read_packet_.has_value();
 }
 
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+typename basic_connection_impl<Role, PacketIdBytes>::payload_chunk&
+basic_connection_impl<Role, PacketIdBytes>::recv_packet_builder::
+get_payload() {
+    return *read_payload_;
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+bool
+basic_connection_impl<Role, PacketIdBytes>::recv_packet_builder::
+has_payload() const {
+    return read_payload_.has_value();
+}
+
 template <role Role, std::size_t PacketIdBytes>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void
 basic_connection_impl<Role, PacketIdBytes>::recv_packet_builder::
 clear() {
-    return read_packet_.reset();
+    read_packet_.reset();
+    read_payload_.reset();
 }
 
 template <role Role, std::size_t PacketIdBytes>
@@ -147,6 +299,32 @@ initialize() {
     raw_buf_.reset();
     raw_buf_size_ = 0;
     raw_buf_ptr_ = nullptr;
+    publish_header_buf_.clear();
+    publish_payload_rest_ = 0;
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection_impl<Role, PacketIdBytes>::recv_packet_builder::
+set_publish_payload_streaming_threshold(std::size_t size) {
+    publish_payload_streaming_threshold_ = size;
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection_impl<Role, PacketIdBytes>::recv_packet_builder::
+set_publish_header_max_size(std::size_t size) {
+    publish_header_max_size_ = size;
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+std::size_t
+basic_connection_impl<Role, PacketIdBytes>::recv_packet_builder::
+publish_payload_rest() const {
+    return publish_payload_rest_;
 }
 
 // public
@@ -169,7 +347,7 @@ ASYNC_MQTT_HEADER_ONLY_INLINE
 void
 basic_connection_impl<Role, PacketIdBytes>::
 recv(std::istream& is) {
-    rpb_.recv(is);
+    rpb_.recv(is, protocol_version_);
     return process_recv_packet();
 }
 
@@ -260,6 +438,18 @@ notify_closed() {
     topic_alias_send_ = std::nullopt;
     topic_alias_recv_ = std::nullopt;
 
+    if (rpb_.publish_payload_rest() != 0 && publish_payload_qos2_pid_) {
+        // the streamed QoS2 PUBLISH packet is not completely received
+        // so it is not treated as handled
+        qos2_publish_handled_.erase(*publish_payload_qos2_pid_);
+    }
+    rpb_.initialize();
+    rpb_.clear();
+    publish_payload_discard_ = false;
+    publish_payload_puback_.reset();
+    publish_payload_pubrec_.reset();
+    publish_payload_qos2_pid_.reset();
+
     for (auto packet_id : pid_suback_) {
         release_packet_id(packet_id);
     }
@@ -366,6 +556,15 @@ set_auto_map_topic_alias_send(bool val) {
     auto_map_topic_alias_send_ = val;
 }
 
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection_impl<Role, PacketIdBytes>::
+set_auto_map_topic_alias_send_policy(topic_alias_send_policy policy) {
+    topic_alias_send_policy_ = policy;
+    if (topic_alias_send_) topic_alias_send_->set_policy(policy);
+}
+
 template <role Role, std::size_t PacketIdBytes>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void
@@ -387,6 +586,30 @@ set_pingresp_recv_timeout(std::chrono::milliseconds duration) {
     }
 }
 
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection_impl<Role, PacketIdBytes>::
+set_publish_payload_streaming_threshold(std::size_t size) {
+    rpb_.set_publish_payload_streaming_threshold(size);
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection_impl<Role, PacketIdBytes>::
+set_publish_header_max_size(std::size_t size) {
+    rpb_.set_publish_header_max_size(size);
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+std::size_t
+basic_connection_impl<Role, PacketIdBytes>::
+get_publish_payload_rest() const {
+    return rpb_.publish_payload_rest();
+}
+
 template <role Role, std::size_t PacketIdBytes>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 std::optional<typename basic_packet_id_type<PacketIdBytes>::type>
@@ -575,12 +798,81 @@ send_stored() {
 // 2. ec, send_disconnect, close (packet error after connected
 // 3. ec, send_connack, close (packet error before connect)
 // 4. packet_received, [auto_res,] [pingreq_recv_reset]
+// 5. publish_header_received, [pingreq_recv_reset]
+// 6. publish_payload_received, [auto_res,] [pingreq_recv_reset]
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection_impl<Role, PacketIdBytes>::
+process_recv_publish_payload() {
+    auto pc = force_move(rpb_.get_payload());
+    rpb_.clear();
+    if (pc.last) {
+        if (publish_payload_puback_) {
+            if (protocol_version_ == protocol_version::v5) {
+                send(v5::basic_puback_packet<PacketIdBytes>(*publish_payload_puback_));
+            }
+            else {
+                send(v3_1_1::basic_puback_packet<PacketIdBytes>(*publish_payload_puback_));
+            }
+            publish_payload_puback_.reset();
+        }
+        if (publish_payload_pubrec_) {
+            if (protocol_version_ == protocol_version::v5) {
+                send(v5::basic_pubrec_packet<PacketIdBytes>(*publish_payload_pubrec_));
+            }
+            else {
+                send(v3_1_1::basic_pubrec_packet<PacketIdBytes>(*publish_payload_pubrec_));
+            }
+            publish_payload_pubrec_.reset();
+        }
+        publish_payload_qos2_pid_.reset();
+    }
+    pingreq_recv_op();
+    if (publish_payload_discard_) {
+        // QoS2 PUBLISH packet that has already been handled
+        if (pc.last) publish_payload_discard_ = false;
+        return;
+    }
+    con_.on_receive_publish_payload(force_move(pc.chunk), pc.last);
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection_impl<Role, PacketIdBytes>::
+pingreq_recv_op() {
+    if (pingreq_recv_timeout_ms_) {
+        if (status_ == connection_status::connecting ||
+            status_ == connection_status::connected
+        ) {
+            pingreq_recv_set_ = true;
+            con_.on_timer_op(
+                timer_op::reset,
+                timer_kind::pingreq_recv,
+                *pingreq_recv_timeout_ms_
+            );
+        }
+        else {
+            pingreq_recv_set_ = false;
+            con_.on_timer_op(
+                timer_op::cancel,
+                timer_kind::pingreq_recv
+            );
+        }
+    }
+}
 
 template <role Role, std::size_t PacketIdBytes>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void
 basic_connection_impl<Role, PacketIdBytes>::
 process_recv_packet() {
+    if (rpb_.has_payload()) {
+        process_recv_publish_payload();
+        return;
+    }
     if (rpb_.has_value()) {
         auto ep = force_move(rpb_.get());
         rpb_.clear();
@@ -591,9 +883,11 @@ process_recv_packet() {
             return;
         }
         auto& buf{ep.packet};
+        // the payload of the PUBLISH packet is received by the following recv() calls
+        bool streamed = ep.payload_size.has_value();
 
         // Checking maximum_packet_size
-        if (buf.size() > maximum_packet_size_recv_) {
+        if (ep.packet_size > maximum_packet_size_recv_) {
             // on v3.1.1 maximum_packet_size_recv_ is initialized as packet_size_no_limit
             BOOST_ASSERT(protocol_version_ == protocol_version::v5);
             send(
@@ -719,26 +1013,13 @@ process_recv_packet() {
         );
         if (!protocol_satisfied) return;
 
-        auto pingreq_recv_op =
-            [this] {
-                if (pingreq_recv_timeout_ms_) {
-                    if (status_ == connection_status::connecting ||
-                        status_ == connection_status::connected
-                    ) {
-                        pingreq_recv_set_ = true;
-                        con_.on_timer_op(
-                            timer_op::reset,
-                            timer_kind::pingreq_recv,
-                            *pingreq_recv_timeout_ms_
-                        );
-                    }
-                    else {
-                        pingreq_recv_set_ = false;
-                        con_.on_timer_op(
-                            timer_op::cancel,
-                            timer_kind::pingreq_recv
-                        );
-                    }
+        auto publish_recv_notify =
+            [&](auto& p) {
+                if (streamed) {
+                    con_.on_receive_publish_header(p, *ep.payload_size);
+                }
+                else {
+                    con_.on_receive(p);
                 }
             };
 
@@ -786,31 +1067,24 @@ process_recv_packet() {
                         pid_pubrec_.clear();
                         pid_pubcomp_.clear();
                     }
-                    for (auto const& prop : p.props()) {
-                        prop.visit(
-                            overload {
-                                [&](property::topic_alias_maximum const& p) {
-                                    if (p.val() > 0) {
-                                        topic_alias_send_.emplace(p.val());
-                                    }
-                                },
-                                [&](property::receive_maximum const& p) {
-                                    BOOST_ASSERT(p.val() != 0);
-                                    publish_send_max_.emplace(p.val());
-                                },
-                                [&](property::maximum_packet_size const& p) {
-                                    BOOST_ASSERT(p.val() != 0);
-                                    maximum_packet_size_send_ = p.val();
-                                },
-                                [&](property::session_expiry_interval const& p) {
-                                    if (p.val() != 0) {
-                                        need_store_ = true;
-                                    }
-                                },
-                                [](auto const&) {
-                                }
-                            }
-                        );
+                    auto const& props = p.props();
+                    if (auto tam = props.get<property::topic_alias_maximum>()) {
+                        if (tam->val() > 0) {
+                            topic_alias_send_.emplace(tam->val(), topic_alias_send_policy_);
+                        }
+                    }
+                    if (auto rm = props.get<property::receive_maximum>()) {
+                        BOOST_ASSERT(rm->val() != 0);
+                        publish_send_max_.emplace(rm->val());
+                    }
+                    if (auto mps = props.get<property::maximum_packet_size>()) {
+                        BOOST_ASSERT(mps->val() != 0);
+                        maximum_packet_size_send_ = mps->val();
+                    }
+                    if (auto sei = props.get<property::session_expiry_interval>()) {
+                        if (sei->val() != 0) {
+                            need_store_ = true;
+                        }
                     }
                     pingreq_recv_op();
                     con_.on_receive(p);
@@ -834,33 +1108,26 @@ process_recv_packet() {
                 [&](v5::connack_packet& p) {
                     if (p.code() == connect_reason_code::success) {
                         status_ = connection_status::connected;
-                         for (auto const& prop : p.props()) {
-                            prop.visit(
-                                overload {
-                                    [&](property::topic_alias_maximum const& p) {
-                                        if (p.val() > 0) {
-                                            topic_alias_send_.emplace(p.val());
-                                        }
-                                    },
-                                    [&](property::receive_maximum const& p) {
-                                        BOOST_ASSERT(p.val() != 0);
-                                        publish_send_max_.emplace(p.val());
-                                    },
-                                    [&](property::maximum_packet_size const& p) {
-                                        BOOST_ASSERT(p.val() != 0);
-                                        maximum_packet_size_send_ = p.val();
-                                    },
-                                    [&](property::server_keep_alive const& p) {
-                                        if constexpr (can_send_as_client(Role)) {
-                                            set_pingreq_send_interval(
-                                                std::chrono::seconds{p.val()}
-                                            );
-                                        }
-                                    },
-                                    [](auto const&) {
-                                    }
-                                }
-                            );
+                        auto const& props = p.props();
+                        if (auto tam = props.get<property::topic_alias_maximum>()) {
+                            if (tam->val() > 0) {
+                                topic_alias_send_.emplace(tam->val(), topic_alias_send_policy_);
+                            }
+                        }
+                        if (auto rm = props.get<property::receive_maximum>()) {
+                            BOOST_ASSERT(rm->val() != 0);
+                            publish_send_max_.emplace(rm->val());
+                        }
+                        if (auto mps = props.get<property::maximum_packet_size>()) {
+                            BOOST_ASSERT(mps->val() != 0);
+                            maximum_packet_size_send_ = mps->val();
+                        }
+                        if constexpr (can_send_as_client(Role)) {
+                            if (auto ska = props.get<property::server_keep_alive>()) {
+                                set_pingreq_send_interval(
+                                    std::chrono::seconds{ska->val()}
+                                );
+                            }
                         }
 
                         if (p.session_present()) {
@@ -880,24 +1147,31 @@ process_recv_packet() {
                     switch (p.opts().get_qos()) {
                     case qos::at_most_once:
                         pingreq_recv_op();
-                        con_.on_receive(p);
+                        publish_recv_notify(p);
                         break;
                     case qos::at_least_once: {
                         auto packet_id = p.packet_id();
                         if (auto_pub_response_ &&
                             status_ == connection_status::connected) {
-                            send(
-                                v3_1_1::basic_puback_packet<PacketIdBytes>(packet_id)
-                            );
+                            if (streamed) {
+                                // PUBACK is sent after the whole payload is received
+                                publish_payload_puback_.emplace(packet_id);
+                            }
+                            else {
+                                send(
+                                    v3_1_1::basic_puback_packet<PacketIdBytes>(packet_id)
+                                );
+                            }
                         }
                         pingreq_recv_op();
-                        con_.on_receive(p);
+                        publish_recv_notify(p);
                     } break;
                     case qos::exactly_once: {
                         auto packet_id = p.packet_id();
                         bool already_handled = false;
                         if (qos2_publish_handled_.find(packet_id) == qos2_publish_handled_.end()) {
                             qos2_publish_handled_.emplace(packet_id);
+                            if (streamed) publish_payload_qos2_pid_.emplace(packet_id);
                         }
                         else {
                             already_handled = true;
@@ -906,13 +1180,22 @@ process_recv_packet() {
                             (auto_pub_response_ ||
                              already_handled) // already_handled is true only if the pubrec packet
                         ) {                   // corresponding to the publish packet has already
-                            send(
-                                v3_1_1::basic_pubrec_packet<PacketIdBytes>(packet_id)
-                            );
+                            if (streamed) {
+                                // PUBREC is sent after the whole payload is received
+                                publish_payload_pubrec_.emplace(packet_id);
+                            }
+                            else {
+                                send(
+                                    v3_1_1::basic_pubrec_packet<PacketIdBytes>(packet_id)
+                                );
+                            }
                         }
                         pingreq_recv_op();
                         if (!already_handled) {
-                            con_.on_receive(p);
+                            publish_recv_notify(p);
+                        }
+                        else if (streamed) {
+                            publish_payload_discard_ = true;
                         }
                     } break;
                     default:
@@ -963,6 +1246,7 @@ process_recv_packet() {
 
                         if (qos2_publish_handled_.find(packet_id) == qos2_publish_handled_.end()) {
                             qos2_publish_handled_.emplace(packet_id);
+                            if (streamed) publish_payload_qos2_pid_.emplace(packet_id);
                         }
                         else {
                             already_handled = true;
@@ -1056,19 +1340,29 @@ process_recv_packet() {
                             topic_alias_recv_->insert_or_update(p.topic(), *ta_opt);
                         }
                     }
-                    if (puback_send) {
-                        send(
-                            v5::basic_puback_packet<PacketIdBytes>(packet_id)
-                        );
+                    if (streamed) {
+                        // PUBACK/PUBREC is sent after the whole payload is received
+                        if (puback_send) publish_payload_puback_.emplace(packet_id);
+                        if (pubrec_send) publish_payload_pubrec_.emplace(packet_id);
                     }
-                    if (pubrec_send) {
-                        send(
-                            v5::basic_pubrec_packet<PacketIdBytes>(packet_id)
-                        );
+                    else {
+                        if (puback_send) {
+                            send(
+                                v5::basic_puback_packet<PacketIdBytes>(packet_id)
+                            );
+                        }
+                        if (pubrec_send) {
+                            send(
+                                v5::basic_pubrec_packet<PacketIdBytes>(packet_id)
+                            );
+                        }
                     }
                     pingreq_recv_op();
                     if (!already_handled) {
-                        con_.on_receive(p);
+                        publish_recv_notify(p);
+                    }
+                    else if (streamed) {
+                        publish_payload_discard_ = true;
                     }
                 },
                 [&](v3_1_1::basic_puback_packet<PacketIdBytes>& p) {
@@ -1482,20 +1776,10 @@ ASYNC_MQTT_HEADER_ONLY_INLINE
 std::optional<topic_alias_type>
 basic_connection_impl<Role, PacketIdBytes>::
 get_topic_alias(properties const& props) {
-    std::optional<topic_alias_type> ta_opt;
-    for (auto const& prop : props) {
-        prop.visit(
-            overload {
-                [&](property::topic_alias const& p) {
-                    ta_opt.emplace(p.val());
-                },
-                [](auto const&) {
-                }
-            }
-        );
-        if (ta_opt) return ta_opt;
+    if (auto p = props.get<property::topic_alias>()) {
+        return p->val();
     }
-    return ta_opt;
+    return std::nullopt;
 }
 
 template <role Role, std::size_t PacketIdBytes>
@@ -1644,6 +1928,17 @@ set_auto_map_topic_alias_send(
     impl_->set_auto_map_topic_alias_send(val);
 }
 
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection<Role, PacketIdBytes>::
+set_auto_map_topic_alias_send_policy(
+    topic_alias_send_policy policy
+) {
+    BOOST_ASSERT(impl_);
+    impl_->set_auto_map_topic_alias_send_policy(policy);
+}
+
 template <role Role, std::size_t PacketIdBytes>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void
@@ -1666,6 +1961,33 @@ set_pingresp_recv_timeout(
     impl_->set_pingresp_recv_timeout(duration);
 }
 
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection<Role, PacketIdBytes>::
+set_publish_payload_streaming_threshold(std::size_t size) {
+    BOOST_ASSERT(impl_);
+    impl_->set_publish_payload_streaming_threshold(size);
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_connection<Role, PacketIdBytes>::
+set_publish_header_max_size(std::size_t size) {
+    BOOST_ASSERT(impl_);
+    impl_->set_publish_header_max_size(size);
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+std::size_t
+basic_connection<Role, PacketIdBytes>::
+get_publish_payload_rest() const {
+    BOOST_ASSERT(impl_);
+    return impl_->get_publish_payload_rest();
+}
+
 template <role Role, std::size_t PacketIdBytes>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 std::optional<typename basic_packet_id_type<PacketIdBytes>::type>
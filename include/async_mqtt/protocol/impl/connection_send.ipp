@@ -217,30 +217,24 @@ process_send_packet(
             pid_pubrec_.clear();
             pid_pubcomp_.clear();
         }
-        for (auto const& prop : actual_packet.props()) {
-            prop.visit(
-                overload {
-                    [&](property::topic_alias_maximum const& p) {
-                        if (p.val() != 0) {
-                            topic_alias_recv_.emplace(p.val());
-                        }
-                    },
-                    [&](property::receive_maximum const& p) {
-                        BOOST_ASSERT(p.val() != 0);
-                        publish_recv_max_.emplace(p.val());
-                    },
-                    [&](property::maximum_packet_size const& p) {
-                        BOOST_ASSERT(p.val() != 0);
-                        maximum_packet_size_recv_ = p.val();
-                    },
-                    [&](property::session_expiry_interval const& p) {
-                        if (p.val() != 0) {
-                            need_store_ = true;
-                        }
-                    },
-                    [](auto const&){}
-                }
-            );
+        auto const& props = actual_packet.props();
+        if (auto p = props.template get<property::topic_alias_maximum>()) {
+            if (p->val() != 0) {
+                topic_alias_recv_.emplace(p->val());
+            }
+        }
+        if (auto p = props.template get<property::receive_maximum>()) {
+            BOOST_ASSERT(p->val() != 0);
+            publish_recv_max_.emplace(p->val());
+        }
+        if (auto p = props.template get<property::maximum_packet_size>()) {
+            BOOST_ASSERT(p->val() != 0);
+            maximum_packet_size_recv_ = p->val();
+        }
+        if (auto p = props.template get<property::session_expiry_interval>()) {
+            if (p->val() != 0) {
+                need_store_ = true;
+            }
         }
     }
 
@@ -257,51 +251,45 @@ process_send_packet(
     if constexpr(std::is_same_v<v5::connack_packet, packet_type>) {
         if (actual_packet.code() == connect_reason_code::success) {
             status_ = connection_status::connected;
-            for (auto const& prop : actual_packet.props()) {
-                prop.visit(
-                    overload {
-                        [&](property::topic_alias_maximum const& p) {
-                            if (p.val() != 0) {
-                                topic_alias_recv_.emplace(p.val());
-                            }
-                        },
-                        [&](property::receive_maximum const& p) {
-                            BOOST_ASSERT(p.val() != 0);
-                            publish_recv_max_.emplace(p.val());
-                        },
-                        [&](property::maximum_packet_size const& p) {
-                            BOOST_ASSERT(p.val() != 0);
-                            maximum_packet_size_recv_ = p.val();
-                        },
-                        [&](property::server_keep_alive const& p) {
-                            auto val = p.val();
-                            if (val == 0) {
-                                if (pingreq_recv_set_) {
-                                    pingreq_recv_set_ = false;
-                                    con_.on_timer_op(
-                                        timer_op::cancel,
-                                        timer_kind::pingreq_recv
-                                    );
-                                }
-                                pingreq_recv_timeout_ms_.reset();
-                            }
-                            else {
-                                pingreq_recv_timeout_ms_.emplace(
-                                    std::chrono::milliseconds{
-                                        val * 1000 * 3 / 2
-                                    }
-                                );
-                                pingreq_recv_set_ = true;
-                                con_.on_timer_op(
-                                    timer_op::reset,
-                                    timer_kind::pingreq_recv,
-                                    *pingreq_recv_timeout_ms_
-                                );
-                            }
-                        },
-                        [](auto const&){}
+            auto const& props = actual_packet.props();
+            if (auto p = props.template get<property::topic_alias_maximum>()) {
+                if (p->val() != 0) {
+                    topic_alias_recv_.emplace(p->val());
+                }
+            }
+            if (auto p = props.template get<property::receive_maximum>()) {
+                BOOST_ASSERT(p->val() != 0);
+                publish_recv_max_.emplace(p->val());
+            }
+            if (auto p = props.template get<property::maximum_packet_size>()) {
+                BOOST_ASSERT(p->val() != 0);
+                maximum_packet_size_recv_ = p->val();
+            }
+            if (auto p = props.template get<property::server_keep_alive>()) {
+                auto val = p->val();
+                if (val == 0) {
+                    if (pingreq_recv_set_) {
+                        pingreq_recv_set_ = false;
+                        con_.on_timer_op(
+                            timer_op::cancel,
+                            timer_kind::pingreq_recv
+                        );
                     }
-                );
+                    pingreq_recv_timeout_ms_.reset();
+                }
+                else {
+                    pingreq_recv_timeout_ms_.emplace(
+                        std::chrono::milliseconds{
+                            val * 1000 * 3 / 2
+                        }
+                    );
+                    pingreq_recv_set_ = true;
+                    con_.on_timer_op(
+                        timer_op::reset,
+                        timer_kind::pingreq_recv,
+                        *pingreq_recv_timeout_ms_
+                    );
+                }
             }
         }
         else {
@@ -501,16 +489,17 @@ process_send_packet(
             else if (status_ == connection_status::connected) {
                 if (auto_map_topic_alias_send_) {
                     if (topic_alias_send_) {
-                        if (auto ta_opt = topic_alias_send_->find(actual_packet.topic())) {
-                            ASYNC_MQTT_LOG("mqtt_impl", trace)
-                                << "topia alias : " << actual_packet.topic() << " - " << *ta_opt
-                                << " is found." ;
-                            actual_packet.remove_topic_add_topic_alias(*ta_opt);
-                        }
-                        else {
-                            auto lru_ta = topic_alias_send_->get_lru_alias();
-                            topic_alias_send_->insert_or_update(actual_packet.topic(), lru_ta); // remap topic alias
-                            actual_packet.add_topic_alias(lru_ta);
+                        if (auto ta_opt = topic_alias_send_->auto_map(actual_packet.topic())) {
+                            auto [ta, mapped] = *ta_opt;
+                            if (mapped) {
+                                actual_packet.add_topic_alias(ta);
+                            }
+                            else {
+                                ASYNC_MQTT_LOG("mqtt_impl", trace)
+                                    << "topia alias : " << actual_packet.topic() << " - " << ta
+                                    << " is found." ;
+                                actual_packet.remove_topic_add_topic_alias(ta);
+                            }
                         }
                     }
                 }
@@ -13,6 +13,8 @@
 #include <async_mqtt/protocol/event/timer.hpp>
 #include <async_mqtt/protocol/event/packet_id_released.hpp>
 #include <async_mqtt/protocol/event/packet_received.hpp>
+#include <async_mqtt/protocol/event/publish_header_received.hpp>
+#include <async_mqtt/protocol/event/publish_payload_received.hpp>
 #include <async_mqtt/util/inline.hpp>
 
 namespace async_mqtt {
@@ -113,6 +115,30 @@ on_receive(
     events_.emplace_back(event::basic_packet_received<PacketIdBytes>{force_move(packet)});
 }
 
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_rv_connection<Role, PacketIdBytes>::
+on_receive_publish_header(
+    basic_packet_variant<PacketIdBytes> packet,
+    std::size_t payload_size
+) {
+    events_.emplace_back(
+        event::basic_publish_header_received<PacketIdBytes>{force_move(packet), payload_size}
+    );
+}
+
+template <role Role, std::size_t PacketIdBytes>
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void
+basic_rv_connection<Role, PacketIdBytes>::
+on_receive_publish_payload(
+    buffer chunk,
+    bool last
+) {
+    events_.emplace_back(event::publish_payload_received{force_move(chunk), last});
+}
+
 template <role Role, std::size_t PacketIdBytes>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void
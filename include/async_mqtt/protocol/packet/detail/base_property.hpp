@@ -7,8 +7,11 @@
 #if !defined(ASYNC_MQTT_PROTOCOL_PACKET_DETAIL_BASE_PROPERTY_HPP)
 #define ASYNC_MQTT_PROTOCOL_PACKET_DETAIL_BASE_PROPERTY_HPP
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <vector>
 
 #include <boost/asio/buffer.hpp>
@@ -44,19 +47,23 @@ enum class ostream_format {
 template <std::size_t N>
 struct n_bytes_property : private boost::totally_ordered<n_bytes_property<N>> {
     explicit n_bytes_property(property::id id, static_vector<char, N> const& buf)
-        : id_{id},
-          buf_{buf} // very small size copy
+        : id_{id}
     {
+        BOOST_ASSERT(buf.size() == N);
+        std::copy(buf.begin(), buf.end(), buf_.begin()); // very small size copy
     }
 
     template <typename It, typename End>
     explicit n_bytes_property(property::id id, It b, End e)
-        :id_{id}, buf_(b, e) {}
+        :id_{id} {
+        BOOST_ASSERT(std::distance(b, e) == static_cast<std::ptrdiff_t>(N));
+        std::copy(b, e, buf_.begin());
+    }
 
     explicit n_bytes_property(property::id id, buffer const& buf)
         :id_{id} {
         BOOST_ASSERT(buf.size() >= N);
-        buf_.insert(buf_.end(), (buf.begin(), std::next(buf.begin(), N)));
+        std::copy(buf.begin(), std::next(buf.begin(), N), buf_.begin());
     }
 
     /**
@@ -119,7 +126,8 @@ struct n_bytes_property : private boost::totally_ordered<n_bytes_property<N>> {
 
 protected:
     property::id id_;
-    static_vector<char, N> buf_;
+    // the value is always N bytes, so the size is not kept
+    std::array<char, N> buf_;
 };
 
 /**
@@ -127,9 +135,8 @@ protected:
  */
 struct binary_property : private boost::totally_ordered<binary_property> {
     explicit binary_property(property::id id, buffer buf)
-        :id_{id},
-         buf_{force_move(buf)},
-         length_(2) // size 2
+        :buf_{force_move(buf)},
+         id_{id}
     {
         error_code ec = check();
         if (ec) throw system_error{ec};
@@ -137,9 +144,8 @@ struct binary_property : private boost::totally_ordered<binary_property> {
     }
 
     binary_property(property::id id, buffer buf, error_code& ec)
-        :id_{id},
-         buf_{force_move(buf)},
-         length_(2) // size 2
+        :buf_{force_move(buf)},
+         id_{id}
     {
         ec = check();
         if (ec) return;
@@ -230,9 +236,10 @@ struct binary_property : private boost::totally_ordered<binary_property> {
         }
     }
 
-    property::id id_;
+    // members are ordered by size to minimize the padding
     buffer buf_;
-    static_vector<char, 2> length_;
+    std::array<char, 2> length_;
+    property::id id_;
 };
 
 /**
@@ -337,44 +344,6 @@ struct variable_property : private boost::totally_ordered<variable_property> {
     static_vector<char, 4> value_;
 };
 
-struct len_str {
-    explicit len_str(buffer b)
-        : buf{force_move(b)},
-          len{endian_static_vector(boost::numeric_cast<std::uint16_t>(buf.size()))}
-    {
-        error_code ec = check();
-        if (ec) throw system_error(ec);
-    }
-
-    explicit len_str(buffer b, error_code& ec)
-        : buf{force_move(b)},
-          len{endian_static_vector(boost::numeric_cast<std::uint16_t>(buf.size()))}
-    {
-        // inherit previous error for user_property
-        if (!ec) {
-            ec = check();
-        }
-    }
-
-    std::size_t size() const {
-        return len.size() + buf.size();
-    }
-
-    error_code check() const {
-        if (utf8string_check(buf)) {
-            return error_code{};
-        }
-        else {
-            return make_error_code(
-                disconnect_reason_code::malformed_packet
-            );
-        }
-    }
-
-    buffer buf;
-    static_vector<char, 2> len;
-};
-
 } // namespace async_mqtt::property::detail
 
 #endif // ASYNC_MQTT_PROTOCOL_PACKET_DETAIL_BASE_PROPERTY_HPP
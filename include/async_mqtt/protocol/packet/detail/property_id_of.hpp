@@ -0,0 +1,60 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_PROTOCOL_PACKET_DETAIL_PROPERTY_ID_OF_HPP)
+#define ASYNC_MQTT_PROTOCOL_PACKET_DETAIL_PROPERTY_ID_OF_HPP
+
+#include <type_traits>
+
+#include <async_mqtt/protocol/packet/property_id.hpp>
+#include <async_mqtt/protocol/packet/property.hpp>
+
+namespace async_mqtt::property::detail {
+
+template <typename T>
+struct always_false : std::false_type {};
+
+/**
+ * @brief Get property::id corresponding to the property type at compile time.
+ * @tparam Property property type
+ * @return property::id
+ */
+template <typename Property>
+constexpr property::id property_id_of() {
+    using p = std::decay_t<Property>;
+    if constexpr (std::is_same_v<p, payload_format_indicator>)               return id::payload_format_indicator;
+    else if constexpr (std::is_same_v<p, message_expiry_interval>)           return id::message_expiry_interval;
+    else if constexpr (std::is_same_v<p, content_type>)                      return id::content_type;
+    else if constexpr (std::is_same_v<p, response_topic>)                    return id::response_topic;
+    else if constexpr (std::is_same_v<p, correlation_data>)                  return id::correlation_data;
+    else if constexpr (std::is_same_v<p, subscription_identifier>)           return id::subscription_identifier;
+    else if constexpr (std::is_same_v<p, session_expiry_interval>)           return id::session_expiry_interval;
+    else if constexpr (std::is_same_v<p, assigned_client_identifier>)        return id::assigned_client_identifier;
+    else if constexpr (std::is_same_v<p, server_keep_alive>)                 return id::server_keep_alive;
+    else if constexpr (std::is_same_v<p, authentication_method>)             return id::authentication_method;
+    else if constexpr (std::is_same_v<p, authentication_data>)               return id::authentication_data;
+    else if constexpr (std::is_same_v<p, request_problem_information>)       return id::request_problem_information;
+    else if constexpr (std::is_same_v<p, will_delay_interval>)               return id::will_delay_interval;
+    else if constexpr (std::is_same_v<p, request_response_information>)      return id::request_response_information;
+    else if constexpr (std::is_same_v<p, response_information>)              return id::response_information;
+    else if constexpr (std::is_same_v<p, server_reference>)                  return id::server_reference;
+    else if constexpr (std::is_same_v<p, reason_string>)                     return id::reason_string;
+    else if constexpr (std::is_same_v<p, receive_maximum>)                   return id::receive_maximum;
+    else if constexpr (std::is_same_v<p, topic_alias_maximum>)               return id::topic_alias_maximum;
+    else if constexpr (std::is_same_v<p, topic_alias>)                       return id::topic_alias;
+    else if constexpr (std::is_same_v<p, maximum_qos>)                       return id::maximum_qos;
+    else if constexpr (std::is_same_v<p, retain_available>)                  return id::retain_available;
+    else if constexpr (std::is_same_v<p, user_property>)                     return id::user_property;
+    else if constexpr (std::is_same_v<p, maximum_packet_size>)               return id::maximum_packet_size;
+    else if constexpr (std::is_same_v<p, wildcard_subscription_available>)   return id::wildcard_subscription_available;
+    else if constexpr (std::is_same_v<p, subscription_identifier_available>) return id::subscription_identifier_available;
+    else if constexpr (std::is_same_v<p, shared_subscription_available>)     return id::shared_subscription_available;
+    else static_assert(always_false<p>::value, "Property is not an MQTT property type");
+}
+
+} // namespace async_mqtt::property::detail
+
+#endif // ASYNC_MQTT_PROTOCOL_PACKET_DETAIL_PROPERTY_ID_OF_HPP
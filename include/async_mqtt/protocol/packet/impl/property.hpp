@@ -422,17 +422,27 @@ retain_available::retain_available(It b, End e)
 inline
 user_property::user_property(std::string key, std::string val)
     : key_{buffer{force_move(key)}}, val_{buffer{force_move(val)}}
-{}
+{
+    endian_store(boost::numeric_cast<std::uint16_t>(key_.size()), key_len_.data());
+    endian_store(boost::numeric_cast<std::uint16_t>(val_.size()), val_len_.data());
+    if (!utf8string_check(key_) || !utf8string_check(val_)) {
+        throw system_error(
+            make_error_code(
+                disconnect_reason_code::malformed_packet
+            )
+        );
+    }
+}
 
 inline
 std::vector<as::const_buffer> user_property::const_buffer_sequence() const {
     std::vector<as::const_buffer> v;
     v.reserve(num_of_const_buffer_sequence());
     v.emplace_back(as::buffer(&id_, 1));
-    v.emplace_back(as::buffer(key_.len.data(), key_.len.size()));
-    v.emplace_back(as::buffer(key_.buf));
-    v.emplace_back(as::buffer(val_.len.data(), val_.len.size()));
-    v.emplace_back(as::buffer(val_.buf));
+    v.emplace_back(as::buffer(key_len_.data(), key_len_.size()));
+    v.emplace_back(as::buffer(key_));
+    v.emplace_back(as::buffer(val_len_.data(), val_len_.size()));
+    v.emplace_back(as::buffer(val_));
     return v;
 }
 
@@ -445,8 +455,8 @@ inline
 std::size_t user_property::size() const {
     return
         1 + // id_
-        key_.size() +
-        val_.size();
+        key_len_.size() + key_.size() +
+        val_len_.size() + val_.size();
 }
 
 inline
@@ -459,22 +469,22 @@ constexpr std::size_t user_property::num_of_const_buffer_sequence() {
 
 inline
 std::string user_property::key() const {
-    return std::string{key_.buf};
+    return std::string{key_};
 }
 
 inline
 std::string user_property::val() const {
-    return std::string{val_.buf};
+    return std::string{val_};
 }
 
 inline
 constexpr buffer const& user_property::key_as_buffer() const {
-    return key_.buf;
+    return key_;
 }
 
 inline
 constexpr buffer const& user_property::val_as_buffer() const {
-    return val_.buf;
+    return val_;
 }
 
 template <
@@ -483,15 +493,17 @@ template <
 >
 inline
 user_property::user_property(Buffer&& key, Buffer&& val, error_code& ec)
-    : key_{std::forward<Buffer>(key), ec}, val_{std::forward<Buffer>(val), ec}
+    : key_{std::forward<Buffer>(key)}, val_{std::forward<Buffer>(val)}
 {
-    if (key_.size() > 0xffff) {
+    if (key_.size() > 0xffff || val_.size() > 0xffff) {
         ec = make_error_code(
             disconnect_reason_code::malformed_packet
         );
         return;
     }
-    if (val_.size() > 0xffff) {
+    endian_store(static_cast<std::uint16_t>(key_.size()), key_len_.data());
+    endian_store(static_cast<std::uint16_t>(val_.size()), val_len_.data());
+    if (!utf8string_check(key_) || !utf8string_check(val_)) {
         ec = make_error_code(
             disconnect_reason_code::malformed_packet
         );
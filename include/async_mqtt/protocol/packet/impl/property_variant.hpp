@@ -7,12 +7,14 @@
 #if !defined(ASYNC_MQTT_PROTOCOL_PACKET_IMPL_PROPERTY_VARIANT_HPP)
 #define ASYNC_MQTT_PROTOCOL_PACKET_IMPL_PROPERTY_VARIANT_HPP
 
+#include <utility>
 #include <variant>
 
 #include <async_mqtt/util/overload.hpp>
 #include <async_mqtt/protocol/packet/property.hpp>
 #include <async_mqtt/protocol/packet/property_variant.hpp>
 #include <async_mqtt/protocol/packet/impl/validate_property.hpp>
+#include <async_mqtt/protocol/packet/detail/property_id_of.hpp>
 
 namespace async_mqtt {
 
@@ -81,6 +83,34 @@ decltype(auto) property_variant::get_if() const {
     return std::get_if<T>(&var_);
 }
 
+template <typename Property>
+inline
+Property const* properties::get() const {
+    constexpr auto id = property::detail::property_id_of<Property>();
+    constexpr auto pos = static_cast<std::size_t>(id);
+    if ((present_ & (std::uint64_t(1) << pos)) == 0) return nullptr;
+    if (first_[pos] != index_overflow) {
+        return props_[first_[pos]].template get_if<Property>();
+    }
+    for (auto const& prop : props_) {
+        if (auto p = prop.template get_if<Property>()) return p;
+    }
+    return nullptr;
+}
+
+template <typename Property>
+inline
+Property* properties::get() {
+    return const_cast<Property*>(std::as_const(*this).template get<Property>());
+}
+
+template <typename... Args>
+inline
+void properties::emplace_back(Args&&... args) {
+    props_.emplace_back(std::forward<Args>(args)...);
+    index(props_.size() - 1);
+}
+
 properties make_properties(buffer buf, property_location loc, error_code& ec);
 std::vector<as::const_buffer> const_buffer_sequence(properties const& props);
 std::size_t size(properties const& props);
@@ -55,6 +55,158 @@ std::size_t property_variant::size() const {
     );
 }
 
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::properties(std::initializer_list<property_variant> il)
+    :props_(il) {
+    reindex();
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::properties(container_type props)
+    :props_(force_move(props)) {
+    reindex();
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+bool properties::contains(property::id id) const {
+    auto pos = static_cast<std::size_t>(id);
+    if (pos >= id_table_size) return false;
+    return (present_ & (std::uint64_t(1) << pos)) != 0;
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::const_iterator properties::begin() const {
+    return props_.begin();
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::const_iterator properties::end() const {
+    return props_.end();
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::const_iterator properties::cbegin() const {
+    return props_.cbegin();
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::const_iterator properties::cend() const {
+    return props_.cend();
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::iterator properties::begin() {
+    return props_.begin();
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::iterator properties::end() {
+    return props_.end();
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::size_type properties::size() const {
+    return props_.size();
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+bool properties::empty() const {
+    return props_.empty();
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void properties::reserve(size_type n) {
+    props_.reserve(n);
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void properties::clear() {
+    props_.clear();
+    present_ = 0;
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void properties::push_back(property_variant prop) {
+    props_.push_back(force_move(prop));
+    index(props_.size() - 1);
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void properties::pop_back() {
+    BOOST_ASSERT(!props_.empty());
+    auto pos = static_cast<std::size_t>(props_.back().id());
+    props_.pop_back();
+    if (first_[pos] == props_.size()) {
+        // the last one was the first element of the id
+        present_ &= ~(std::uint64_t(1) << pos);
+    }
+    else if (first_[pos] == index_overflow) {
+        reindex();
+    }
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::iterator properties::insert(const_iterator pos, property_variant prop) {
+    auto it = props_.insert(pos, force_move(prop));
+    if (it + 1 == props_.end()) {
+        index(props_.size() - 1);
+    }
+    else {
+        // the following elements are shifted
+        reindex();
+    }
+    return it;
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::iterator properties::erase(const_iterator pos) {
+    auto it = props_.erase(pos);
+    reindex();
+    return it;
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::iterator properties::erase(const_iterator first, const_iterator last) {
+    auto it = props_.erase(first, last);
+    reindex();
+    return it;
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+properties::container_type const& properties::as_vector() const {
+    return props_;
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void properties::index(std::size_t pos) {
+    auto id = static_cast<std::size_t>(props_[pos].id());
+    BOOST_ASSERT(id < id_table_size);
+    auto bit = std::uint64_t(1) << id;
+    if ((present_ & bit) != 0) return; // not the first one
+    present_ |= bit;
+    first_[id] =
+        pos < index_overflow ? static_cast<std::uint8_t>(pos)
+                             : index_overflow;
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+void properties::reindex() {
+    present_ = 0;
+    for (std::size_t pos = 0; pos != props_.size(); ++pos) {
+        index(pos);
+    }
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+bool operator==(properties const& lhs, properties const& rhs) {
+    return lhs.props_ == rhs.props_;
+}
+
+ASYNC_MQTT_HEADER_ONLY_INLINE
+bool operator<(properties const& lhs, properties const& rhs) {
+    return lhs.props_ < rhs.props_;
+}
+
 ASYNC_MQTT_HEADER_ONLY_INLINE
 std::ostream& operator<<(std::ostream& o, properties const& props) {
     o << "[";
@@ -323,18 +323,8 @@ void basic_publish_packet<PacketIdBytes>::remove_topic_alias_add_topic(std::stri
 template <std::size_t PacketIdBytes>
 ASYNC_MQTT_HEADER_ONLY_INLINE
 void basic_publish_packet<PacketIdBytes>::update_message_expiry_interval(std::uint32_t val) {
-    bool updated = false;
-    for (auto& prop : props_) {
-        prop.visit(
-            overload {
-                [&](property::message_expiry_interval& p) {
-                    p = property::message_expiry_interval(val);
-                    updated = true;
-                },
-                [&](auto&){}
-                }
-        );
-        if (updated) return;
+    if (auto p = props_.template get<property::message_expiry_interval>()) {
+        *p = property::message_expiry_interval(val);
     }
 }
 
@@ -7,6 +7,7 @@
 #if !defined(ASYNC_MQTT_PROTOCOL_PACKET_PROPERTY_HPP)
 #define ASYNC_MQTT_PROTOCOL_PACKET_PROPERTY_HPP
 
+#include <array>
 #include <string>
 #include <vector>
 #include <memory>
@@ -1024,11 +1025,11 @@ public:
     constexpr buffer const& val_as_buffer() const;
 
     friend bool operator<(user_property const& lhs, user_property const& rhs) {
-        return std::tie(lhs.id_, lhs.key_.buf, lhs.val_.buf) < std::tie(rhs.id_, rhs.key_.buf, rhs.val_.buf);
+        return std::tie(lhs.id_, lhs.key_, lhs.val_) < std::tie(rhs.id_, rhs.key_, rhs.val_);
     }
 
     friend bool operator==(user_property const& lhs, user_property const& rhs) {
-        return std::tie(lhs.id_, lhs.key_.buf, lhs.val_.buf) == std::tie(rhs.id_, rhs.key_.buf, rhs.val_.buf);
+        return std::tie(lhs.id_, lhs.key_, lhs.val_) == std::tie(rhs.id_, rhs.key_, rhs.val_);
     }
 
 private:
@@ -1044,9 +1045,12 @@ private:
     explicit user_property(Buffer&& key, Buffer&& val, error_code& ec);
 
 private:
+    // members are ordered by size to minimize the padding
+    buffer key_;
+    buffer val_;
+    std::array<char, 2> key_len_;
+    std::array<char, 2> val_len_;
     property::id id_ = id::user_property;
-    detail::len_str key_;
-    detail::len_str val_;
 };
 
 /**
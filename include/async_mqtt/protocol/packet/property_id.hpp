@@ -20,7 +20,7 @@ namespace property {
  * \n See <a href="https://docs.oasis-open.org/mqtt/mqtt/v5.0/os/mqtt-v5.0-os.html#_Toc3901029"></a>
  *
  */
-enum class id {
+enum class id : std::uint8_t {
     payload_format_indicator          =  1, ///< Payload Format Indicator
     message_expiry_interval           =  2, ///< Message Expiry Interval
     content_type                      =  3, ///< Content Type
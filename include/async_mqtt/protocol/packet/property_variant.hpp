@@ -7,7 +7,13 @@
 #if !defined(ASYNC_MQTT_PROTOCOL_PACKET_PROPERTY_VARIANT_HPP)
 #define ASYNC_MQTT_PROTOCOL_PACKET_PROPERTY_VARIANT_HPP
 
+#include <array>
+#include <cstdint>
+#include <initializer_list>
 #include <variant>
+#include <vector>
+
+#include <boost/operators.hpp>
 
 #include <async_mqtt/util/overload.hpp>
 #include <async_mqtt/protocol/packet/property.hpp>
@@ -210,8 +216,129 @@ private:
 /**
  * @brief property variant collection type
  *
+ * The properties are kept in the wire order. In addition, the presence bitmap and
+ * the index of the first element are maintained per property::id, so the well-known
+ * property can be looked up by get() in O(1).
+ * The property::id of the element MUST NOT be changed via the non-const iterator.
+ *
+ * #### Thread Safety
+ * @li Distinct objects: Safe
+ * @li Shared objects: Unsafe
+ *
+ */
+class properties : private boost::totally_ordered<properties> {
+public:
+    using container_type = std::vector<property_variant>;
+    using value_type = container_type::value_type;
+    using size_type = container_type::size_type;
+    using iterator = container_type::iterator;
+    using const_iterator = container_type::const_iterator;
+
+    /**
+     * @brief constructor
+     */
+    properties() = default;
+
+    /**
+     * @brief constructor
+     * @param il property list
+     */
+    properties(std::initializer_list<property_variant> il);
+
+    /**
+     * @brief constructor
+     * @param props property vector
+     */
+    properties(container_type props);
+
+    /**
+     * @brief Get the first property of the type.
+     * @tparam Property property type e.g.) property::message_expiry_interval
+     * @return The pointer to the property. If not contained then return nullptr.
+     */
+    template <typename Property>
+    Property const* get() const;
+
+    /**
+     * @brief Get the first property of the type.
+     * @tparam Property property type e.g.) property::message_expiry_interval
+     * @return The pointer to the property. If not contained then return nullptr.
+     */
+    template <typename Property>
+    Property* get();
+
+    /**
+     * @brief Check the property is contained
+     * @param id property::id
+     * @return true if contained, otherwise false
+     */
+    bool contains(property::id id) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    iterator begin();
+    iterator end();
+
+    size_type size() const;
+    bool empty() const;
+    void reserve(size_type n);
+    void clear();
+
+    void push_back(property_variant prop);
+    template <typename... Args>
+    void emplace_back(Args&&... args);
+    void pop_back();
+    iterator insert(const_iterator pos, property_variant prop);
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    /**
+     * @brief Get the underlying container
+     * @return container of property_variant
+     */
+    container_type const& as_vector() const;
+
+    friend bool operator==(properties const& lhs, properties const& rhs);
+    friend bool operator<(properties const& lhs, properties const& rhs);
+
+private:
+    static constexpr std::size_t id_table_size =
+        static_cast<std::size_t>(property::id::shared_subscription_available) + 1;
+    static_assert(id_table_size <= 64, "property::id must fit in the presence bitmap");
+    static constexpr std::uint8_t index_overflow = 0xff;
+
+    void index(std::size_t pos);
+    void reindex();
+
+    container_type props_;
+    // bit n is set if the property::id n is contained
+    std::uint64_t present_ = 0;
+    // the index of the first element of the property::id
+    // index_overflow means the element is located beyond the table range
+    std::array<std::uint8_t, id_table_size> first_{};
+};
+
+/**
+ * @related properties
+ * @brief equal operator
+ * @param lhs compare target
+ * @param rhs compare target
+ * @return true if the lhs equal to the rhs, otherwise false.
+ *
+ */
+bool operator==(properties const& lhs, properties const& rhs);
+
+/**
+ * @related properties
+ * @brief less than operator
+ * @param lhs compare target
+ * @param rhs compare target
+ * @return true if the lhs less than the rhs, otherwise false.
+ *
  */
-using properties = std::vector<property_variant>;
+bool operator<(properties const& lhs, properties const& rhs);
 
 /*
  * @brief output to the stream
@@ -197,22 +197,10 @@ public:
         return visit(
             overload {
                 [] (v5::basic_publish_packet<PacketIdBytes> const& p) {
-                    std::uint32_t ret = 0;
-                    bool finish = false;
-                    for (auto const& prop : p.props()) {
-                        prop.visit(
-                            overload {
-                                [&](property::message_expiry_interval const& p) {
-                                    ret = p.val();
-                                    finish = true;
-                                },
-                                [](auto const&) {
-                                }
-                            }
-                        );
-                        if (finish) break;
+                    if (auto mei = p.props().template get<property::message_expiry_interval>()) {
+                        return mei->val();
                     }
-                    return ret;
+                    return std::uint32_t(0);
                 },
                 [] (auto const&) {
                     return std::uint32_t(0);
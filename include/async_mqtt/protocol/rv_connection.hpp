@@ -94,6 +94,9 @@ public:
      *     Finally, @ref event::close is added to the return vector.
      * @li If a complete and valid packet is constructed, @ref event::basic_packet_received is added to the return vector with
      *     the constructed packet.
+     * @li If the PUBLISH packet payload is streamed (see @ref set_publish_payload_streaming_threshold()),
+     *     @ref event::basic_publish_header_received is added to the return vector first, then
+     *     @ref event::publish_payload_received is added for each following call.
      * @li If the packet_id becomes reusable, @ref event::basic_packet_id_released is added to the return vector with
      *     the packet_id.
      * @li If a timer operation is required, @ref event::timer is added to the return vector.
@@ -199,6 +202,16 @@ private:
         basic_packet_variant<PacketIdBytes> packet
     ) override final;
 
+    void on_receive_publish_header(
+        basic_packet_variant<PacketIdBytes> packet,
+        std::size_t payload_size
+    ) override final;
+
+    void on_receive_publish_payload(
+        buffer chunk,
+        bool last
+    ) override final;
+
     void on_timer_op(
         timer_op op,
         timer_kind kind,
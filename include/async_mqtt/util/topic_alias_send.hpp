@@ -11,8 +11,12 @@
 #include <string_view>
 #include <unordered_map>
 #include <array>
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <optional>
+#include <utility>
 
 #include <boost/assert.hpp>
 #include <boost/multi_index_container.hpp>
@@ -28,10 +32,21 @@ namespace async_mqtt {
 
 namespace mi = boost::multi_index;
 
+/**
+ * @brief policy of the automatic topic alias mapping
+ */
+enum class topic_alias_send_policy {
+    lru,       ///< Map every topic. If all aliases are in use, the least recently used alias is remapped.
+    frequency, ///< Map only the frequently sent topics. The alias of the least frequently sent topic is remapped.
+};
+
 class topic_alias_send {
 public:
-    explicit topic_alias_send(topic_alias_type max)
-        :max_{max}, va_{min_, max_} {}
+    explicit topic_alias_send(
+        topic_alias_type max,
+        topic_alias_send_policy policy = topic_alias_send_policy::lru
+    )
+        :max_{max}, va_{min_, max_}, policy_{policy} {}
 
     void insert_or_update(std::string_view topic, topic_alias_type alias) {
         ASYNC_MQTT_LOG("mqtt_impl", trace)
@@ -52,6 +67,7 @@ public:
                 [&](entry& e) {
                     e.topic = std::string{topic};
                     e.tp = std::chrono::steady_clock::now();
+                    e.hits = 0;
                 },
                 [](auto&) { BOOST_ASSERT(false); }
             );
@@ -114,6 +130,101 @@ public:
             << "clear_topic_alias";
         aliases_.clear();
         va_.clear();
+        candidates_.clear();
+        sends_ = 0;
+    }
+
+    /**
+     * @brief set the policy of auto_map()
+     * @param policy policy
+     */
+    void set_policy(topic_alias_send_policy policy) {
+        policy_ = policy;
+    }
+
+    topic_alias_send_policy policy() const { return policy_; }
+
+    /**
+     * @brief decide the topic alias of the PUBLISH packet that is automatically mapped
+     *
+     * lru: If the topic is not mapped, it is mapped to the vacant alias or the least
+     * recently used alias.
+     *
+     * frequency: The sending count of the topic is counted. The topic that is not mapped is
+     * mapped only if it has been sent at least twice and more frequently than the least
+     * frequently sent mapped topic, or there is a vacant alias. The counts are halved
+     * periodically, so that the topics that become cold lose their aliases.
+     * The counts of the unmapped topics are kept by the hash value of the topic in a bounded
+     * table. A hash collision only merges the counts.
+     *
+     * @param topic topic name of the PUBLISH packet
+     * @return If the topic is already mapped, the alias and false. The topic name can be removed.
+     *         If the topic is newly mapped, the alias and true. Both the topic name and the alias
+     *         have to be sent.
+     *         std::nullopt if the topic is sent without the alias.
+     */
+    std::optional<std::pair<topic_alias_type, bool>> auto_map(std::string_view topic) {
+        BOOST_ASSERT(max_ > 0);
+        if (policy_ == topic_alias_send_policy::lru) {
+            if (auto ta_opt = find(topic)) return std::make_pair(*ta_opt, false);
+            auto alias = get_lru_alias();
+            insert_or_update(topic, alias); // remap topic alias
+            return std::make_pair(alias, true);
+        }
+
+        if (++sends_ >= aging_period()) age();
+
+        auto& topic_idx = aliases_.get<tag_topic_name>();
+        if (auto it = topic_idx.find(topic); it != topic_idx.end()) {
+            topic_idx.modify(
+                it,
+                [](entry& e) { ++e.hits; },
+                [](auto&) { BOOST_ASSERT(false); }
+            );
+            return std::make_pair(it->alias, false);
+        }
+
+        auto hash = std::hash<std::string_view>{}(topic);
+        auto cit = candidates_.find(hash);
+        if (cit == candidates_.end()) {
+            // The new topic is counted after the aging makes room.
+            if (candidates_.size() >= candidates_max()) return std::nullopt;
+            cit = candidates_.emplace(hash, 0).first;
+        }
+        auto hits = ++cit->second;
+        if (hits < min_hits_) return std::nullopt;
+
+        topic_alias_type alias;
+        std::optional<std::pair<std::size_t, std::uint64_t>> evicted;
+        if (auto alias_opt = va_.first_vacant()) {
+            alias = *alias_opt;
+        }
+        else {
+            auto& hits_idx = aliases_.get<tag_hits>();
+            auto coldest = hits_idx.begin();
+            // Equal counts don't replace, so that two topics don't take the alias in turn.
+            if (coldest->hits >= hits) return std::nullopt;
+            alias = coldest->alias;
+            evicted.emplace(std::hash<std::string_view>{}(coldest->topic), coldest->hits);
+        }
+        candidates_.erase(cit);
+        if (evicted && candidates_.size() < candidates_max()) {
+            candidates_.insert(*evicted);
+        }
+        ASYNC_MQTT_LOG("mqtt_impl", trace)
+            << ASYNC_MQTT_ADD_VALUE(address, this)
+            << "topic_alias_send frequency map"
+            << " topic:" << topic
+            << " alias:" << alias
+            << " hits:" << hits;
+        insert_or_update(topic, alias);
+        auto& alias_idx = aliases_.get<tag_alias>();
+        alias_idx.modify(
+            alias_idx.find(alias),
+            [&](entry& e) { e.hits = hits; },
+            [](auto&) { BOOST_ASSERT(false); }
+        );
+        return std::make_pair(alias, true);
     }
 
     topic_alias_type get_lru_alias() const {
@@ -128,7 +239,39 @@ public:
     topic_alias_type max() const { return max_; }
 
 private:
+    // number of the sends between the halvings of the counts
+    std::size_t aging_period() const {
+        return std::max<std::size_t>(std::size_t(max_) * 16, 256);
+    }
+
+    // maximum number of the counted topics that are not mapped
+    std::size_t candidates_max() const {
+        return std::min<std::size_t>(std::size_t(max_) * 4, 4096);
+    }
+
+    void age() {
+        sends_ = 0;
+        auto& idx = aliases_.get<tag_alias>();
+        for (auto it = idx.begin(); it != idx.end(); ++it) {
+            idx.modify(
+                it,
+                [](entry& e) { e.hits /= 2; },
+                [](auto&) { BOOST_ASSERT(false); }
+            );
+        }
+        for (auto it = candidates_.begin(); it != candidates_.end();) {
+            it->second /= 2;
+            if (it->second == 0) {
+                it = candidates_.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
     static constexpr topic_alias_type min_ = 1;
+    static constexpr std::uint64_t min_hits_ = 2;
     topic_alias_type max_;
 
     struct entry {
@@ -142,10 +285,12 @@ private:
         std::string topic;
         topic_alias_type alias;
         std::chrono::time_point<std::chrono::steady_clock> tp;
+        std::uint64_t hits = 0;
     };
     struct tag_tp {};
     struct tag_alias {};
     struct tag_topic_name {};
+    struct tag_hits {};
     using mi_topic_alias = mi::multi_index_container<
         entry,
         mi::indexed_by<
@@ -160,12 +305,20 @@ private:
             mi::ordered_non_unique<
                 mi::tag<tag_tp>,
                 mi::key<&entry::tp>
+            >,
+            mi::ordered_non_unique<
+                mi::tag<tag_hits>,
+                mi::key<&entry::hits>
             >
         >
     >;
 
     mi_topic_alias aliases_;
     value_allocator<topic_alias_type> va_;
+    topic_alias_send_policy policy_;
+    // sending counts of the unmapped topics by the hash value of the topic
+    std::unordered_map<std::size_t, std::uint64_t> candidates_;
+    std::size_t sends_ = 0;
 };
 
 } // namespace async_mqtt
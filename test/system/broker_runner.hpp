@@ -65,7 +65,8 @@ inline void kill_broker(pid_type pid) {
 struct broker_runner {
     broker_runner(
         std::string const& config = "st_broker.conf",
-        std::string const& auth = "st_auth.json"
+        std::string const& auth = "st_auth.json",
+        std::uint16_t port = 1883
     ) {
         if (!launch_broker_required()) return;
         auto level_opt =
@@ -143,7 +144,7 @@ struct broker_runner {
         {
             as::io_context ioc;
             as::ip::address address = boost::asio::ip::make_address("127.0.0.1");
-            as::ip::tcp::endpoint endpoint{address, 1883};
+            as::ip::tcp::endpoint endpoint{address, port};
             as::ip::tcp::socket s{ioc};
             std::function<void(boost::system::error_code const&)> f =
                 [&](boost::system::error_code const& ec) {
@@ -162,6 +163,54 @@ struct broker_runner {
             );
             ioc.run();
         }
+        // the additional brokers listen only on TCP
+        if (port != 1883) return;
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        {
+            as::io_context ioc;
+            as::local::stream_protocol::endpoint endpoint{"st_broker.sock"};
+            as::local::stream_protocol::socket s{ioc};
+            std::function<void(boost::system::error_code const&)> f =
+                [&](boost::system::error_code const& ec) {
+                    if (ec) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                        s = as::local::stream_protocol::socket{ioc};
+                        s.async_connect(
+                            endpoint,
+                            f
+                        );
+                    }
+                };
+            s.async_connect(
+                endpoint,
+                f
+            );
+            ioc.run();
+        }
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+        {
+            as::io_context ioc;
+            as::local::stream_protocol::endpoint endpoint{"st_broker_shm.sock"};
+            as::local::stream_protocol::socket s{ioc};
+            std::function<void(boost::system::error_code const&)> f =
+                [&](boost::system::error_code const& ec) {
+                    if (ec) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                        s = as::local::stream_protocol::socket{ioc};
+                        s.async_connect(
+                            endpoint,
+                            f
+                        );
+                    }
+                };
+            s.async_connect(
+                endpoint,
+                f
+            );
+            ioc.run();
+        }
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
 #if defined(ASYNC_MQTT_USE_TLS)
         {
             as::io_context ioc;
@@ -0,0 +1,198 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+#include "broker_runner.hpp"
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include <async_mqtt/all.hpp>
+
+BOOST_AUTO_TEST_SUITE(st_bridge)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+// The first node listens on 1883 and accepts br as a bridge user.
+// The bridge of the second node (1884) connects to the first node as br.
+
+using ep_t = am::endpoint<am::role::client, am::protocol::mqtt>;
+
+static constexpr std::string_view bridge_property_key = "async_mqtt_bridge";
+
+static am::properties bridge_props() {
+    return am::properties{
+        am::property::user_property{std::string{bridge_property_key}, "spoof"}
+    };
+}
+
+static bool has_bridge_property(am::properties const& props) {
+    for (auto const& prop : props) {
+        if (auto const* up = prop.get_if<am::property::user_property>()) {
+            if (up->key() == bridge_property_key) return true;
+        }
+    }
+    return false;
+}
+
+static void connect(
+    ep_t& ep,
+    std::string const& port,
+    std::string const& cid,
+    am::properties props = {}
+) {
+    {
+        auto [ec] = ep.async_underlying_handshake(
+            "127.0.0.1",
+            port,
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+    {
+        auto [ec] = ep.async_send(
+            am::v5::connect_packet{
+                true,   // clean_start
+                0, // keep_alive
+                cid,
+                std::nullopt, // will
+                "u1",
+                "passforu1",
+                am::force_move(props)
+            },
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+    {
+        auto [ec, pv] = ep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        auto const* p = pv.get_if<am::v5::connack_packet>();
+        BOOST_REQUIRE(p);
+        BOOST_TEST(p->code() == am::connect_reason_code::success);
+    }
+}
+
+static void subscribe(ep_t& ep, std::string const& topic_filter) {
+    {
+        auto pid = ep.async_acquire_unique_packet_id(as::use_future).get();
+        auto [ec] = ep.async_send(
+            am::v5::subscribe_packet{
+                pid,
+                { {topic_filter, am::qos::at_least_once} }
+            },
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+    {
+        auto [ec, pv] = ep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pv.get_if<am::v5::suback_packet>());
+    }
+    // wait until the bridge subscribes the topic filter on the first node
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+}
+
+static void publish(ep_t& ep, std::string const& topic, am::properties props = {}) {
+    auto pid = ep.async_acquire_unique_packet_id(as::use_future).get();
+    auto [ec] = ep.async_send(
+        am::v5::publish_packet{
+            pid,
+            topic,
+            "payload1",
+            am::qos::at_least_once,
+            am::force_move(props)
+        },
+        as::as_tuple(as::use_future)
+    ).get();
+    BOOST_TEST(!ec);
+}
+
+static void recv_publish(ep_t& ep, std::string const& topic) {
+    auto fut = ep.async_recv(as::as_tuple(as::use_future));
+    BOOST_REQUIRE(fut.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    auto [ec, pv] = fut.get();
+    BOOST_TEST(!ec);
+    auto const* p = pv.get_if<am::v5::publish_packet>();
+    BOOST_REQUIRE(p);
+    BOOST_TEST(p->topic() == topic);
+    BOOST_TEST(p->payload() == "payload1");
+    // the bridge property is not delivered to the clients
+    BOOST_TEST(!has_bridge_property(p->props()));
+}
+
+BOOST_AUTO_TEST_CASE(cross) {
+    broker_runner br1{"st_broker_bridge1.conf", "st_auth_bridge.json"};
+    broker_runner br2{"st_broker_bridge2.conf", "st_auth_bridge.json", 1884};
+    as::io_context ioc;
+    auto amep_pub = ep_t{am::protocol_version::v5, ioc.get_executor()};
+    auto amep_sub = ep_t{am::protocol_version::v5, ioc.get_executor()};
+    amep_pub.set_auto_pub_response(true);
+    amep_sub.set_auto_pub_response(true);
+
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+    auto on_finish = am::unique_scope_guard(
+        [&] {
+            guard.reset();
+            th.join();
+        }
+    );
+
+    connect(amep_sub, "1884", "sub1");
+    subscribe(amep_sub, "bridge/t");
+    connect(amep_pub, "1883", "pub1");
+    publish(amep_pub, "bridge/t");
+    recv_publish(amep_sub, "bridge/t");
+
+    amep_pub.async_close(as::use_future).get();
+    amep_sub.async_close(as::use_future).get();
+}
+
+// The clients that are not the bridge users send the bridge property.
+// The property is removed, so the publisher can't stop the message from crossing,
+// and the subscriber isn't treated as a bridge, so it receives the crossed message.
+BOOST_AUTO_TEST_CASE(spoof) {
+    broker_runner br1{"st_broker_bridge1.conf", "st_auth_bridge.json"};
+    broker_runner br2{"st_broker_bridge2.conf", "st_auth_bridge.json", 1884};
+    as::io_context ioc;
+    auto amep_pub = ep_t{am::protocol_version::v5, ioc.get_executor()};
+    auto amep_sub = ep_t{am::protocol_version::v5, ioc.get_executor()};
+    amep_pub.set_auto_pub_response(true);
+    amep_sub.set_auto_pub_response(true);
+
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+    auto on_finish = am::unique_scope_guard(
+        [&] {
+            guard.reset();
+            th.join();
+        }
+    );
+
+    connect(amep_sub, "1884", "sub1", bridge_props());
+    subscribe(amep_sub, "bridge/t");
+    connect(amep_pub, "1883", "pub1", bridge_props());
+    publish(amep_pub, "bridge/t", bridge_props());
+    recv_publish(amep_sub, "bridge/t");
+
+    amep_pub.async_close(as::use_future).get();
+    amep_sub.async_close(as::use_future).get();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
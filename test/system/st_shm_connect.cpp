@@ -0,0 +1,114 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+#include "broker_runner.hpp"
+
+#include <cstring>
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <async_mqtt/all.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/shm.hpp>
+
+BOOST_AUTO_TEST_SUITE(st_shm_connect)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+BOOST_AUTO_TEST_CASE(cb) {
+    broker_runner br;
+    as::io_context ioc;
+    using ep_t = am::endpoint<am::role::client, am::protocol::mqtt_shm>;
+    auto amep = ep_t{
+        am::protocol_version::v3_1_1,
+        ioc.get_executor()
+    };
+
+    amep.async_underlying_handshake(
+        "st_broker_shm.sock",
+        [&](am::error_code const& ec) {
+            BOOST_TEST(ec == am::error_code{});
+            amep.async_send(
+                am::v3_1_1::connect_packet{
+                    true,   // clean_session
+                    0x1234, // keep_alive
+                    "cid1",
+                    std::nullopt, // will
+                    "u1",
+                    "passforu1"
+                },
+                [&](am::error_code const& ec) {
+                    BOOST_TEST(!ec);
+                    amep.async_recv(
+                        [&](am::error_code const& ec, std::optional<am::packet_variant> pv_opt) {
+                            BOOST_TEST(!ec);
+                            pv_opt->visit(
+                                am::overload {
+                                    [&](am::v3_1_1::connack_packet const& p) {
+                                        BOOST_TEST(!p.session_present());
+                                    },
+                                    [](auto const&) {
+                                        BOOST_TEST(false);
+                                    }
+                                }
+                            );
+                            amep.async_close([]{});
+                        }
+                    );
+                }
+            );
+        }
+    );
+
+    ioc.run();
+}
+
+// the broker rejects the shared memory that could be shrunk by the client
+BOOST_AUTO_TEST_CASE(unsealed) {
+    broker_runner br;
+    as::io_context ioc;
+    as::local::stream_protocol::socket s{ioc};
+    s.connect(as::local::stream_protocol::endpoint{"st_broker_shm.sock"});
+
+    int memfd = ::memfd_create("st_shm_connect", MFD_CLOEXEC);
+    BOOST_REQUIRE(memfd != -1);
+    BOOST_TEST(::ftruncate(memfd, 1024 * 1024) == 0);
+    // memfd, client data, client space, server data, server space
+    int fds[5] = {memfd, -1, -1, -1, -1};
+    for (std::size_t i = 1; i != 5; ++i) {
+        fds[i] = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        BOOST_REQUIRE(fds[i] != -1);
+    }
+
+    char dummy = 0;
+    iovec iov{&dummy, 1};
+    alignas(cmsghdr) char cbuf[CMSG_SPACE(sizeof(fds))];
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+    auto* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+    BOOST_TEST(::sendmsg(s.native_handle(), &msg, MSG_NOSIGNAL) == 1);
+    for (auto fd : fds) ::close(fd);
+
+    // the broker closes the connection
+    char buf[1];
+    am::error_code ec;
+    s.read_some(as::buffer(buf), ec);
+    BOOST_TEST(ec == as::error::eof);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
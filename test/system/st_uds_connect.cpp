@@ -0,0 +1,80 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+#include "broker_runner.hpp"
+
+#include <filesystem>
+
+#include <async_mqtt/all.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/uds.hpp>
+
+BOOST_AUTO_TEST_SUITE(st_uds_connect)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+BOOST_AUTO_TEST_CASE(perm) {
+    broker_runner br;
+    if (!launch_broker_required()) return;
+    // st_broker.conf sets uds.perm=0600
+    auto perms = std::filesystem::status("st_broker.sock").permissions();
+    BOOST_TEST(
+        (perms & std::filesystem::perms::all) ==
+        (std::filesystem::perms::owner_read | std::filesystem::perms::owner_write)
+    );
+}
+
+BOOST_AUTO_TEST_CASE(cb) {
+    broker_runner br;
+    as::io_context ioc;
+    using ep_t = am::endpoint<am::role::client, am::protocol::mqtt_uds>;
+    auto amep = ep_t{
+        am::protocol_version::v3_1_1,
+        ioc.get_executor()
+    };
+
+    amep.async_underlying_handshake(
+        "st_broker.sock",
+        [&](am::error_code const& ec) {
+            BOOST_TEST(ec == am::error_code{});
+            amep.async_send(
+                am::v3_1_1::connect_packet{
+                    true,   // clean_session
+                    0x1234, // keep_alive
+                    "cid1",
+                    std::nullopt, // will
+                    "u1",
+                    "passforu1"
+                },
+                [&](am::error_code const& ec) {
+                    BOOST_TEST(!ec);
+                    amep.async_recv(
+                        [&](am::error_code const& ec, std::optional<am::packet_variant> pv_opt) {
+                            BOOST_TEST(!ec);
+                            pv_opt->visit(
+                                am::overload {
+                                    [&](am::v3_1_1::connack_packet const& p) {
+                                        BOOST_TEST(!p.session_present());
+                                    },
+                                    [](auto const&) {
+                                        BOOST_TEST(false);
+                                    }
+                                }
+                            );
+                            amep.async_close([]{});
+                        }
+                    );
+                }
+            );
+        }
+    );
+
+    ioc.run();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
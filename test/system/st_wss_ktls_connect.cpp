@@ -0,0 +1,184 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+#include "broker_runner.hpp"
+
+#include <fstream>
+#include <string>
+
+#include <async_mqtt/all.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/wss.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/wss_ktls.hpp>
+
+BOOST_AUTO_TEST_SUITE(st_wss_ktls_connect)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+using ep_t = am::endpoint<am::role::client, am::protocol::wss_ktls>;
+
+// the tls module is loaded to the kernel, and OpenSSL supports kTLS
+inline bool ktls_available() {
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+    std::ifstream ifs{"/proc/sys/net/ipv4/tcp_available_ulp"};
+    std::string ulp;
+    while (ifs >> ulp) {
+        if (ulp == "tls") return true;
+    }
+#endif // defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+    return false;
+}
+
+// connect, subscribe, and receive the publish that is larger than a TLS record over websocket
+template <typename Ep>
+void pub_sub(as::io_context& ioc, Ep& amep) {
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+    auto on_finish = am::unique_scope_guard(
+        [&] {
+            guard.reset();
+            th.join();
+        }
+    );
+
+    {
+        auto [ec] = amep.async_underlying_handshake(
+            "127.0.0.1",
+            "10443",
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+    {
+        auto [ec] = amep.async_send(
+            am::v3_1_1::connect_packet{
+                true,   // clean_session
+                0x1234, // keep_alive
+                "cid1",
+                std::nullopt, // will
+                "u1",
+                "passforu1"
+            },
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+    {
+        auto [ec, pv] = amep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        auto* p = pv.get_if<am::v3_1_1::connack_packet>();
+        BOOST_REQUIRE(p);
+        BOOST_TEST(p->code() == am::connect_return_code::accepted);
+    }
+    {
+        auto pid = amep.async_acquire_unique_packet_id(as::use_future).get();
+        auto [ec] = amep.async_send(
+            am::v3_1_1::subscribe_packet{
+                pid,
+                { {"topic1", am::qos::at_most_once} }
+            },
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+    {
+        auto [ec, pv] = amep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pv.get_if<am::v3_1_1::suback_packet>());
+    }
+    std::string payload(64 * 1024, 'A');
+    {
+        auto [ec] = amep.async_send(
+            am::v3_1_1::publish_packet{
+                "topic1",
+                payload,
+                am::qos::at_most_once
+            },
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+    {
+        auto [ec, pv] = amep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        auto* p = pv.get_if<am::v3_1_1::publish_packet>();
+        BOOST_REQUIRE(p);
+        BOOST_TEST(p->payload() == payload);
+    }
+    amep.async_close(as::use_future).get();
+}
+
+// The cipher that the kernel doesn't support is negotiated.
+// Both the client and the broker fallback to OpenSSL.
+BOOST_AUTO_TEST_CASE(fallback) {
+    broker_runner br{"st_broker_ktls.conf"};
+    as::io_context ioc;
+
+    as::ssl::context ctx{as::ssl::context::tlsv12_client};
+    ctx.set_verify_mode(as::ssl::verify_peer);
+    ctx.load_verify_file("cacert.pem");
+    // CBC cipher is not offloaded to the kernel
+    BOOST_REQUIRE(::SSL_CTX_set_cipher_list(ctx.native_handle(), "AES128-SHA256") == 1);
+
+    auto amep = ep_t{
+        am::protocol_version::v3_1_1,
+        ioc.get_executor(),
+        ctx
+    };
+    pub_sub(ioc, amep);
+    BOOST_TEST(!amep.next_layer().next_layer().ktls_send());
+    BOOST_TEST(!amep.next_layer().next_layer().ktls_recv());
+}
+
+// The cipher that the kernel supports is negotiated.
+// If the tls module of the kernel is not loaded, kTLS is not checked.
+BOOST_AUTO_TEST_CASE(ktls) {
+    broker_runner br{"st_broker_ktls.conf"};
+    as::io_context ioc;
+
+    as::ssl::context ctx{as::ssl::context::tlsv12_client};
+    ctx.set_verify_mode(as::ssl::verify_peer);
+    ctx.load_verify_file("cacert.pem");
+    BOOST_REQUIRE(::SSL_CTX_set_cipher_list(ctx.native_handle(), "ECDHE-RSA-AES128-GCM-SHA256") == 1);
+
+    auto amep = ep_t{
+        am::protocol_version::v3_1_1,
+        ioc.get_executor(),
+        ctx
+    };
+    pub_sub(ioc, amep);
+    if (ktls_available()) {
+        BOOST_TEST(amep.next_layer().next_layer().ktls_send());
+    }
+    else {
+        BOOST_TEST_MESSAGE("kTLS is not available, the records are encrypted by OpenSSL");
+    }
+}
+
+// The client without kTLS connects to the broker with kTLS
+BOOST_AUTO_TEST_CASE(mqtts_client) {
+    broker_runner br{"st_broker_ktls.conf"};
+    as::io_context ioc;
+
+    as::ssl::context ctx{as::ssl::context::tlsv12_client};
+    ctx.set_verify_mode(as::ssl::verify_peer);
+    ctx.load_verify_file("cacert.pem");
+
+    auto amep = am::endpoint<am::role::client, am::protocol::wss>{
+        am::protocol_version::v3_1_1,
+        ioc.get_executor(),
+        ctx
+    };
+    pub_sub(ioc, amep);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
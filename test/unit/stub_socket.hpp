@@ -65,6 +65,10 @@ struct basic_stub_socket {
         write_packet_checker_ = force_move(c);
     }
 
+    void set_write_buffers_checker(std::function<void(std::size_t num_of_buffers)> c) {
+        write_buffers_checker_ = force_move(c);
+    }
+
     void set_recv_packets(packet_queue_t recv_packets) {
         recv_packets_ = force_move(recv_packets);
         recv_packets_it_ = recv_packets_.begin();
@@ -72,6 +76,10 @@ struct basic_stub_socket {
 
     }
 
+    void set_write_error(error_code ec) {
+        write_error_ = ec;
+    }
+
     void set_close_checker(std::function<void()> c) {
         close_checker_ = force_move(c);
     }
@@ -136,6 +144,20 @@ struct basic_stub_socket {
         void operator()(
             Self& self
         ) {
+            if (socket.write_error_) {
+                self.complete(socket.write_error_, 0);
+                return;
+            }
+            if (socket.write_buffers_checker_) {
+                socket.write_buffers_checker_(
+                    static_cast<std::size_t>(
+                        std::distance(
+                            as::buffer_sequence_begin(buffers),
+                            as::buffer_sequence_end(buffers)
+                        )
+                    )
+                );
+            }
             auto it = as::buffers_iterator<ConstBufferSequence>::begin(buffers);
             auto end = as::buffers_iterator<ConstBufferSequence>::end(buffers);
             auto dis = std::distance(it, end);
@@ -248,7 +270,9 @@ private:
     typename packet_queue_t::iterator recv_packets_it_ = recv_packets_.begin();
     std::optional<std::string::iterator> packet_it_opt_;
     std::function<void(basic_packet_variant<PacketIdBytes> const& pv)> write_packet_checker_;
+    std::function<void(std::size_t num_of_buffers)> write_buffers_checker_;
     std::function<void()> close_checker_;
+    error_code write_error_;
     bool open_ = true;
     std::size_t associated_allocator_num_for_read_ = 0;
     std::size_t associated_allocator_num_for_write_ = 0;
@@ -0,0 +1,73 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <chrono>
+#include <thread>
+
+#include <broker/auth_cache.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_broker_auth_cache)
+
+namespace am = async_mqtt;
+
+BOOST_AUTO_TEST_CASE(disabled) {
+    am::auth_cache cache;
+    BOOST_TEST(!cache.enabled());
+    auto d = cache.digest("password");
+    cache.insert("u1", d);
+    BOOST_TEST(!cache.find("u1", d));
+    BOOST_TEST(cache.size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(digest) {
+    am::auth_cache cache1;
+    am::auth_cache cache2;
+    BOOST_TEST(cache1.digest("password") == cache1.digest("password"));
+    BOOST_TEST(cache1.digest("password") != cache1.digest("passwore"));
+    // salted for each cache
+    BOOST_TEST(cache1.digest("password") != cache2.digest("password"));
+}
+
+BOOST_AUTO_TEST_CASE(find) {
+    am::auth_cache cache;
+    cache.set_ttl(std::chrono::hours(1));
+    cache.insert("u1", cache.digest("password"));
+    BOOST_TEST(cache.find("u1", cache.digest("password")));
+    BOOST_TEST(!cache.find("u1", cache.digest("passwore")));
+    BOOST_TEST(!cache.find("u1", cache.digest("")));
+    BOOST_TEST(!cache.find("u2", cache.digest("password")));
+
+    // one entry for each user
+    cache.insert("u1", cache.digest("newpassword"));
+    BOOST_TEST(cache.size() == 1);
+    BOOST_TEST(cache.find("u1", cache.digest("newpassword")));
+    BOOST_TEST(!cache.find("u1", cache.digest("password")));
+
+    cache.clear();
+    BOOST_TEST(!cache.find("u1", cache.digest("newpassword")));
+}
+
+BOOST_AUTO_TEST_CASE(ttl) {
+    am::auth_cache cache;
+    cache.set_ttl(std::chrono::milliseconds(50));
+    auto d = cache.digest("password");
+    cache.insert("u1", d);
+    BOOST_TEST(cache.find("u1", d));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    BOOST_TEST(!cache.find("u1", d));
+    // verified again
+    cache.insert("u1", d);
+    BOOST_TEST(cache.find("u1", d));
+
+    // disabling clears the entries
+    cache.set_ttl(std::chrono::steady_clock::duration::zero());
+    BOOST_TEST(cache.size() == 0);
+    BOOST_TEST(!cache.find("u1", d));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
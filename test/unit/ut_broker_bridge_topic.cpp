@@ -0,0 +1,202 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <broker/bridge_topic.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_broker_bridge_topic)
+
+namespace am = async_mqtt;
+
+BOOST_AUTO_TEST_CASE(covers) {
+    BOOST_TEST(am::topic_filter_covers("a/b", "a/b"));
+    BOOST_TEST(!am::topic_filter_covers("a/b", "a/c"));
+    BOOST_TEST(am::topic_filter_covers("a/+", "a/b"));
+    BOOST_TEST(am::topic_filter_covers("a/+", "a/+"));
+    BOOST_TEST(!am::topic_filter_covers("a/b", "a/+"));
+    BOOST_TEST(am::topic_filter_covers("a/#", "a/b/c"));
+    BOOST_TEST(am::topic_filter_covers("a/#", "a/+/#"));
+    BOOST_TEST(!am::topic_filter_covers("a/+/#", "a/#"));
+    BOOST_TEST(!am::topic_filter_covers("a/+", "a/b/c"));
+    BOOST_TEST(!am::topic_filter_covers("a/b/c", "a/b"));
+    // the broker doesn't match "a/#" with "a"
+    BOOST_TEST(!am::topic_filter_covers("a/#", "a"));
+    BOOST_TEST(am::topic_filter_covers("#", "+/b"));
+    BOOST_TEST(!am::topic_filter_covers("#", "$SYS/b"));
+    BOOST_TEST(!am::topic_filter_covers("+/b", "$SYS/b"));
+}
+
+BOOST_AUTO_TEST_CASE(overlaps) {
+    BOOST_TEST(am::topic_filter_overlaps("a/b", "a/b"));
+    BOOST_TEST(!am::topic_filter_overlaps("a/b", "a/c"));
+    BOOST_TEST(am::topic_filter_overlaps("a/+/c", "a/b/+"));
+    BOOST_TEST(!am::topic_filter_overlaps("a/+/c", "a/b/d"));
+    BOOST_TEST(am::topic_filter_overlaps("a/#", "+/b"));
+    BOOST_TEST(am::topic_filter_overlaps("a/#", "a"));
+    BOOST_TEST(!am::topic_filter_overlaps("a/b", "a"));
+    BOOST_TEST(!am::topic_filter_overlaps("#", "$SYS/#"));
+    BOOST_TEST(!am::topic_filter_overlaps("+/b", "$SYS/b"));
+    BOOST_TEST(am::topic_filter_overlaps("$SYS/#", "$SYS/+"));
+}
+
+BOOST_AUTO_TEST_CASE(common_cover) {
+    BOOST_TEST(*am::topic_filter_common_cover("a/b", "a/b") == "a/b");
+    BOOST_TEST(*am::topic_filter_common_cover("a/b", "a/c") == "a/+");
+    BOOST_TEST(*am::topic_filter_common_cover("a/+/c", "a/b/#") == "a/+/#");
+    BOOST_TEST(*am::topic_filter_common_cover("a/+/c", "a/b/+") == "a/+/+");
+    BOOST_TEST(*am::topic_filter_common_cover("a/b", "a/b/c") == "a/#");
+    BOOST_TEST(*am::topic_filter_common_cover("a/#", "+/b") == "+/#");
+    BOOST_TEST(*am::topic_filter_common_cover("a/#", "a") == "#");
+    BOOST_TEST(*am::topic_filter_common_cover("$SYS/a", "$SYS/b") == "$SYS/+");
+    // the wildcard at the first level doesn't match $SYS
+    BOOST_TEST(!am::topic_filter_common_cover("$SYS/a", "a/a"));
+}
+
+BOOST_AUTO_TEST_CASE(from_str) {
+    {
+        auto bt = am::bridge_topic_from_str("sensors/#");
+        BOOST_TEST(bt.has_value());
+        BOOST_TEST(bt->filter == "sensors/#");
+        BOOST_TEST(bt->local_prefix == "");
+        BOOST_TEST(bt->remote_prefix == "");
+    }
+    {
+        auto bt = am::bridge_topic_from_str("  sensors/#  site/b/  \"\" ");
+        BOOST_TEST(bt.has_value());
+        BOOST_TEST(bt->filter == "sensors/#");
+        BOOST_TEST(bt->local_prefix == "site/b/");
+        BOOST_TEST(bt->remote_prefix == "");
+    }
+    BOOST_TEST(!am::bridge_topic_from_str(""));
+    BOOST_TEST(!am::bridge_topic_from_str("a/#/b"));
+    BOOST_TEST(!am::bridge_topic_from_str("# site/b/"));
+    BOOST_TEST(!am::bridge_topic_from_str("# site/b \"\""));
+    BOOST_TEST(!am::bridge_topic_from_str("# site/+/ \"\""));
+}
+
+BOOST_AUTO_TEST_CASE(to_local) {
+    auto bt = *am::bridge_topic_from_str("sensors/# site/b/ site/a/");
+    BOOST_TEST(bt.local_filter() == "site/b/sensors/#");
+    BOOST_TEST(bt.remote_filter() == "site/a/sensors/#");
+    BOOST_TEST(*bt.to_local("site/a/sensors/1") == "site/b/sensors/1");
+    BOOST_TEST(!bt.to_local("site/c/sensors/1"));
+}
+
+BOOST_AUTO_TEST_CASE(remote_filter_for) {
+    auto bt = *am::bridge_topic_from_str("sensors/# local/ remote/");
+    // covered by the topic map
+    BOOST_TEST(*bt.remote_filter_for("local/sensors/1/temp") == "remote/sensors/1/temp");
+    BOOST_TEST(*bt.remote_filter_for("local/sensors/+/temp") == "remote/sensors/+/temp");
+    // covers the topic map
+    BOOST_TEST(*bt.remote_filter_for("#") == "remote/sensors/#");
+    BOOST_TEST(*bt.remote_filter_for("local/#") == "remote/sensors/#");
+    // partially overlaps
+    BOOST_TEST(*bt.remote_filter_for("+/+/1") == "remote/sensors/#");
+    // disjoint
+    BOOST_TEST(!bt.remote_filter_for("local/actuators/#"));
+    BOOST_TEST(!bt.remote_filter_for("remote/sensors/1"));
+}
+
+BOOST_AUTO_TEST_CASE(remote_filters) {
+    std::vector<am::bridge_topic> topics{
+        *am::bridge_topic_from_str("sensors/#"),
+        *am::bridge_topic_from_str("cmd/# b/ a/")
+    };
+    {
+        auto filters = am::bridge_remote_filters(
+            topics,
+            {"sensors/1", "sensors/2/+", "cmd/1", "other/#"}
+        );
+        BOOST_TEST(filters.size() == 2);
+        BOOST_TEST(filters.at("sensors/1") == 0);
+        BOOST_TEST(filters.at("sensors/2/+") == 0);
+    }
+    {
+        auto filters = am::bridge_remote_filters(
+            topics,
+            {"sensors/1", "sensors/+/a", "sensors/+", "sensors/+/+", "b/cmd/x", "b/cmd/#"}
+        );
+        // sensors/1 is covered by sensors/+, and sensors/+/a is covered by sensors/+/+
+        BOOST_TEST(filters.size() == 3);
+        BOOST_TEST(filters.at("sensors/+") == 0);
+        BOOST_TEST(filters.at("sensors/+/+") == 0);
+        BOOST_TEST(filters.at("a/cmd/#") == 1);
+    }
+    {
+        // partially overlapping filters are replaced with the common cover
+        auto filters = am::bridge_remote_filters(
+            topics,
+            {"sensors/+/c", "sensors/b/#", "b/cmd/+/x", "b/cmd/y/+"}
+        );
+        BOOST_TEST(filters.size() == 2);
+        BOOST_TEST(filters.at("sensors/+/#") == 0);
+        BOOST_TEST(filters.at("a/cmd/+/+") == 1);
+    }
+    {
+        // the peer broker could match sensors/+/# with sensors/1
+        auto filters = am::bridge_remote_filters(topics, {"sensors/+/#", "sensors/1"});
+        BOOST_TEST(filters.size() == 1);
+        BOOST_TEST(filters.at("sensors/#") == 0);
+    }
+    {
+        // the common cover covers another filter
+        auto filters = am::bridge_remote_filters(
+            topics,
+            {"sensors/+/c", "sensors/b/+", "sensors/x/y"}
+        );
+        BOOST_TEST(filters.size() == 1);
+        BOOST_TEST(filters.at("sensors/+/+") == 0);
+    }
+    {
+        // # covers all topic maps
+        auto filters = am::bridge_remote_filters(topics, {"#", "sensors/1"});
+        BOOST_TEST(filters.size() == 2);
+        BOOST_TEST(filters.at("sensors/#") == 0);
+        BOOST_TEST(filters.at("a/cmd/#") == 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(property) {
+    BOOST_TEST(!am::has_bridge_property(am::properties{}));
+    BOOST_TEST(
+        !am::has_bridge_property(
+            am::properties{
+                am::property::user_property{"key", "val"}
+            }
+        )
+    );
+    BOOST_TEST(
+        am::has_bridge_property(
+            am::properties{
+                am::property::content_type{"text/plain"},
+                am::property::user_property{std::string(am::bridge_property_key), "node1"}
+            }
+        )
+    );
+}
+
+BOOST_AUTO_TEST_CASE(remove_property) {
+    am::properties props{
+        am::property::user_property{std::string(am::bridge_property_key), "node1"},
+        am::property::content_type{"text/plain"},
+        am::property::user_property{"key", "val"},
+        am::property::user_property{std::string(am::bridge_property_key), "node2"}
+    };
+    BOOST_TEST(am::remove_bridge_property(props));
+    BOOST_TEST(!am::has_bridge_property(props));
+    // the other properties are kept in order
+    BOOST_TEST(props.size() == 2U);
+    auto it = props.begin();
+    BOOST_TEST(it->get_if<am::property::content_type>());
+    ++it;
+    BOOST_TEST(it->get_if<am::property::user_property>()->key() == "key");
+
+    BOOST_TEST(!am::remove_bridge_property(props));
+    BOOST_TEST(props.size() == 2U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
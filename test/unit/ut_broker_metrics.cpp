@@ -0,0 +1,134 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <sstream>
+#include <thread>
+
+#include <broker/metrics.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_broker_metrics)
+
+namespace am = async_mqtt;
+
+BOOST_AUTO_TEST_CASE(add) {
+    am::broker_metrics m;
+    m.add(am::broker_metric::messages_received);
+    m.add(am::broker_metric::bytes_received, 100);
+    m.add(am::broker_metric::sessions);
+    m.add(am::broker_metric::sessions);
+    m.add(am::broker_metric::sessions, -1);
+    auto ss = m.aggregate();
+    BOOST_TEST(ss.get(am::broker_metric::messages_received) == 1);
+    BOOST_TEST(ss.get(am::broker_metric::bytes_received) == 100);
+    BOOST_TEST(ss.get(am::broker_metric::sessions) == 1);
+    BOOST_TEST(ss.get(am::broker_metric::messages_sent) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(add_sent) {
+    am::broker_metrics m;
+    m.add_sent("topic1", 10);
+    m.add_sent("topic1", 20);
+    // the metrics don't count themselves
+    m.add_sent("$SYS/broker/messages/sent", 30);
+    m.add_sent("$SYS", 4);
+    auto ss = m.aggregate();
+    BOOST_TEST(ss.get(am::broker_metric::messages_sent) == 2);
+    BOOST_TEST(ss.get(am::broker_metric::bytes_sent) == 30);
+}
+
+BOOST_AUTO_TEST_CASE(is_sys_topic) {
+    BOOST_TEST(am::is_sys_topic("$SYS"));
+    BOOST_TEST(am::is_sys_topic("$SYS/"));
+    BOOST_TEST(am::is_sys_topic("$SYS/broker/sessions/count"));
+    BOOST_TEST(!am::is_sys_topic("$SYSTEM/a"));
+    BOOST_TEST(!am::is_sys_topic("a/$SYS/b"));
+    BOOST_TEST(!am::is_sys_topic("$SY"));
+    BOOST_TEST(!am::is_sys_topic(""));
+}
+
+BOOST_AUTO_TEST_CASE(threads) {
+    // fewer slots than threads
+    am::broker_metrics m{2};
+    std::vector<std::thread> ths;
+    for (std::size_t t = 0; t != 8; ++t) {
+        ths.emplace_back(
+            [&] {
+                for (std::size_t i = 0; i != 10000; ++i) {
+                    m.add(am::broker_metric::messages_sent);
+                    m.add(am::broker_metric::subscriptions, (i % 2 == 0) ? 1 : -1);
+                    m.observe_fanout(i % 3);
+                }
+            }
+        );
+    }
+    for (auto& th : ths) th.join();
+    auto ss = m.aggregate();
+    BOOST_TEST(ss.get(am::broker_metric::messages_sent) == 80000);
+    BOOST_TEST(ss.get(am::broker_metric::subscriptions) == 0);
+    BOOST_TEST(ss.fanout_cumulative(am::broker_metrics_snapshot::fanout_buckets - 1) == 80000u);
+}
+
+BOOST_AUTO_TEST_CASE(fanout) {
+    BOOST_TEST(am::broker_metrics::fanout_bucket(0) == 0u);
+    BOOST_TEST(am::broker_metrics::fanout_bucket(1) == 1u);
+    BOOST_TEST(am::broker_metrics::fanout_bucket(2) == 2u);
+    BOOST_TEST(am::broker_metrics::fanout_bucket(3) == 3u);
+    BOOST_TEST(am::broker_metrics::fanout_bucket(4) == 3u);
+    BOOST_TEST(am::broker_metrics::fanout_bucket(1024) == 8u);
+    BOOST_TEST(am::broker_metrics::fanout_bucket(1025) == 9u);
+
+    am::broker_metrics m;
+    m.observe_fanout(0);
+    m.observe_fanout(3);
+    m.observe_fanout(2000);
+    auto ss = m.aggregate();
+    BOOST_TEST(ss.get(am::broker_metric::fanout_sum) == 2003);
+    BOOST_TEST(ss.fanout_cumulative(0) == 1u);
+    BOOST_TEST(ss.fanout_cumulative(2) == 1u);
+    BOOST_TEST(ss.fanout_cumulative(3) == 2u);
+    BOOST_TEST(ss.fanout_cumulative(9) == 3u);
+}
+
+BOOST_AUTO_TEST_CASE(sys_topics) {
+    am::broker_metrics m;
+    m.add(am::broker_metric::retained, 3);
+    m.observe_fanout(1);
+    auto topics = am::sys_topics(m.aggregate());
+    auto find =
+        [&](std::string const& topic) -> std::string {
+            for (auto const& [t, v] : topics) {
+                if (t == topic) return v;
+            }
+            return "not found";
+        };
+    BOOST_TEST(find("$SYS/broker/retained/count") == "3");
+    BOOST_TEST(find("$SYS/broker/messages/received") == "0");
+    BOOST_TEST(find("$SYS/broker/publish/fanout/le_0") == "0");
+    BOOST_TEST(find("$SYS/broker/publish/fanout/le_1") == "1");
+    BOOST_TEST(find("$SYS/broker/publish/fanout/le_inf") == "1");
+}
+
+BOOST_AUTO_TEST_CASE(prometheus) {
+    am::broker_metrics m;
+    m.add(am::broker_metric::messages_received, 5);
+    m.add(am::broker_metric::sessions, 2);
+    m.observe_fanout(3);
+    std::stringstream ss;
+    am::write_prometheus(ss, m.aggregate());
+    auto str = ss.str();
+    BOOST_TEST(str.find("# TYPE async_mqtt_broker_messages_received_total counter\n") != std::string::npos);
+    BOOST_TEST(str.find("async_mqtt_broker_messages_received_total 5\n") != std::string::npos);
+    BOOST_TEST(str.find("async_mqtt_broker_sessions 2\n") != std::string::npos);
+    BOOST_TEST(str.find("async_mqtt_broker_publish_fanout_bucket{le=\"2\"} 0\n") != std::string::npos);
+    BOOST_TEST(str.find("async_mqtt_broker_publish_fanout_bucket{le=\"4\"} 1\n") != std::string::npos);
+    BOOST_TEST(str.find("async_mqtt_broker_publish_fanout_bucket{le=\"+Inf\"} 1\n") != std::string::npos);
+    BOOST_TEST(str.find("async_mqtt_broker_publish_fanout_sum 3\n") != std::string::npos);
+    BOOST_TEST(str.find("async_mqtt_broker_publish_fanout_count 1\n") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -664,4 +664,253 @@ BOOST_AUTO_TEST_CASE(v5_invalid_publish_recv) {
     );
 }
 
+BOOST_AUTO_TEST_CASE(v5_publish_payload_streaming) {
+    am::rv_connection<am::role::client> c{am::protocol_version::v5};
+    c.set_auto_pub_response(true);
+    c.set_publish_payload_streaming_threshold(32);
+    {
+        auto connect = am::v5::connect_packet{
+            true,   // clean_start
+            0, // keep_alive
+            "cid1",
+            std::nullopt, // will
+            std::nullopt, // username
+            std::nullopt  // password
+        };
+        c.send(connect);
+        auto connack = am::v5::connack_packet{
+            false,   // session_present
+            am::connect_reason_code::success
+        };
+        std::istringstream is{am::to_string(connack.const_buffer_sequence())};
+        c.recv(is);
+    }
+
+    std::string payload(100, 'a');
+    auto props = am::properties{
+        am::property::content_type("json")
+    };
+    auto publish = am::v5::publish_packet(
+        1,
+        "topic1",
+        payload,
+        am::qos::at_least_once,
+        props
+    );
+    // smaller than the threshold
+    auto publish_small = am::v5::publish_packet(
+        "topic1",
+        "payload1",
+        am::qos::at_most_once
+    );
+    auto publish_str{am::to_string(publish.const_buffer_sequence())};
+    auto header_size = publish_str.size() - payload.size();
+
+    // a part of the variable header
+    {
+        std::istringstream is{publish_str.substr(0, 10)};
+        auto events = c.recv(is);
+        BOOST_TEST(events.empty());
+    }
+    // the rest of the variable header and a part of the payload
+    std::istringstream is{publish_str.substr(10, header_size - 10 + 30)};
+    {
+        auto events = c.recv(is);
+        BOOST_TEST(events.size() == 1);
+        auto expected = am::v5::publish_packet(
+            1,
+            "topic1",
+            "",
+            am::qos::at_least_once,
+            props
+        );
+        std::visit(
+            am::overload {
+                [&](am::event::publish_header_received const& ev) {
+                    BOOST_TEST(ev.get() == expected);
+                    BOOST_TEST(ev.get_payload_size() == payload.size());
+                },
+                [](auto const&) {
+                    BOOST_TEST(false);
+                }
+            },
+            events[0]
+        );
+        BOOST_TEST(c.get_publish_payload_rest() == payload.size());
+    }
+    {
+        auto events = c.recv(is);
+        BOOST_TEST(events.size() == 1);
+        std::visit(
+            am::overload {
+                [&](am::event::publish_payload_received const& ev) {
+                    BOOST_TEST(std::string_view{ev.get()} == payload.substr(0, 30));
+                    BOOST_TEST(!ev.is_last());
+                },
+                [](auto const&) {
+                    BOOST_TEST(false);
+                }
+            },
+            events[0]
+        );
+        BOOST_TEST(c.get_publish_payload_rest() == 70);
+    }
+    // the rest of the payload and the next packet
+    is = std::istringstream{
+        publish_str.substr(header_size + 30) +
+        am::to_string(publish_small.const_buffer_sequence())
+    };
+    {
+        auto events = c.recv(is);
+        // PUBACK is sent after the last chunk is received
+        BOOST_TEST(events.size() == 2);
+        std::visit(
+            am::overload {
+                [&](am::event::send const& ev) {
+                    BOOST_TEST(ev.get() == am::v5::puback_packet{1});
+                },
+                [](auto const&) {
+                    BOOST_TEST(false);
+                }
+            },
+            events[0]
+        );
+        std::visit(
+            am::overload {
+                [&](am::event::publish_payload_received const& ev) {
+                    BOOST_TEST(std::string_view{ev.get()} == payload.substr(30));
+                    BOOST_TEST(ev.is_last());
+                },
+                [](auto const&) {
+                    BOOST_TEST(false);
+                }
+            },
+            events[1]
+        );
+        BOOST_TEST(c.get_publish_payload_rest() == 0);
+    }
+    {
+        auto events = c.recv(is);
+        BOOST_TEST(events.size() == 1);
+        std::visit(
+            am::overload {
+                [&](am::event::packet_received const& ev) {
+                    BOOST_TEST(ev.get() == publish_small);
+                },
+                [](auto const&) {
+                    BOOST_TEST(false);
+                }
+            },
+            events[0]
+        );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(v5_publish_payload_streaming_header_too_large) {
+    am::rv_connection<am::role::client> c{am::protocol_version::v5};
+    c.set_publish_payload_streaming_threshold(32);
+    c.set_publish_header_max_size(16);
+    {
+        auto connect = am::v5::connect_packet{
+            true,   // clean_start
+            0, // keep_alive
+            "cid1",
+            std::nullopt, // will
+            std::nullopt, // username
+            std::nullopt  // password
+        };
+        c.send(connect);
+        auto connack = am::v5::connack_packet{
+            false,   // session_present
+            am::connect_reason_code::success
+        };
+        std::istringstream is{am::to_string(connack.const_buffer_sequence())};
+        c.recv(is);
+    }
+
+    // the property length is greater than the maximum header size
+    auto publish = am::v5::publish_packet(
+        "topic1",
+        std::string(100, 'a'),
+        am::qos::at_most_once,
+        am::properties{
+            am::property::content_type(std::string(64, 'b'))
+        }
+    );
+    // only the beginning of the variable header is received
+    std::istringstream is{am::to_string(publish.const_buffer_sequence()).substr(0, 12)};
+    auto events = c.recv(is);
+    // the connection is closed without waiting for the rest of the packet
+    BOOST_TEST(events.size() == 2);
+    BOOST_TEST(std::holds_alternative<am::event::close>(events[0]));
+    std::visit(
+        am::overload {
+            [&](am::error_code const& ec) {
+                BOOST_TEST(ec == am::disconnect_reason_code::packet_too_large);
+            },
+            [](auto const&) {
+                BOOST_TEST(false);
+            }
+        },
+        events[1]
+    );
+    BOOST_TEST(c.get_publish_payload_rest() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(v311_publish_payload_streaming_qos2_already_handled) {
+    am::rv_connection<am::role::client> c{am::protocol_version::v3_1_1};
+    c.set_auto_pub_response(true);
+    c.set_publish_payload_streaming_threshold(32);
+    c.restore_qos2_publish_handled_pids({1});
+    {
+        auto connect = am::v3_1_1::connect_packet{
+            false,   // clean_session
+            0, // keep_alive
+            "cid1",
+            std::nullopt, // will
+            std::nullopt, // username
+            std::nullopt  // password
+        };
+        c.send(connect);
+        auto connack = am::v3_1_1::connack_packet{
+            true,   // session_present
+            am::connect_return_code::accepted
+        };
+        std::istringstream is{am::to_string(connack.const_buffer_sequence())};
+        c.recv(is);
+    }
+
+    std::string payload(100, 'a');
+    auto publish = am::v3_1_1::publish_packet(
+        1,
+        "topic1",
+        payload,
+        am::qos::exactly_once | am::pub::dup::yes
+    );
+    std::istringstream is{am::to_string(publish.const_buffer_sequence())};
+    {
+        // already handled, the header is not notified
+        auto events = c.recv(is);
+        BOOST_TEST(events.empty());
+        BOOST_TEST(c.get_publish_payload_rest() == payload.size());
+    }
+    {
+        // the payload is discarded and PUBREC is sent
+        auto events = c.recv(is);
+        BOOST_TEST(events.size() == 1);
+        std::visit(
+            am::overload {
+                [&](am::event::send const& ev) {
+                    BOOST_TEST(ev.get() == am::v3_1_1::pubrec_packet{1});
+                },
+                [](auto const&) {
+                    BOOST_TEST(false);
+                }
+            },
+            events[0]
+        );
+        BOOST_TEST(c.get_publish_payload_rest() == 0);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
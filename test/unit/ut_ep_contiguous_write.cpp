@@ -0,0 +1,154 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <thread>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/endpoint.hpp>
+
+#include "stub_socket.hpp"
+
+BOOST_AUTO_TEST_SUITE(ut_ep_contiguous_write)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+BOOST_AUTO_TEST_CASE(threshold) {
+    auto version = am::protocol_version::v5;
+    as::io_context ioc;
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+
+    auto ep = am::endpoint<async_mqtt::role::client, async_mqtt::stub_socket>{
+        version,
+        // for stub_socket args
+        version,
+        ioc.get_executor()
+    };
+    ep.set_contiguous_write_threshold(128);
+
+    auto connect = am::v5::connect_packet{
+        true,   // clean_start
+        0x1234, // keep_alive
+        "cid1",
+        std::nullopt, // will
+        "user1",
+        "pass1",
+        am::properties{}
+    };
+
+    auto connack = am::v5::connack_packet{
+        false,   // session_present
+        am::connect_reason_code::success,
+        am::properties{}
+    };
+
+    ep.next_layer().set_recv_packets(
+        {
+            // receive packets
+            {connack},
+        }
+    );
+
+    // underlying handshake
+    {
+        auto [ec] = ep.async_underlying_handshake(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // send connect
+    ep.next_layer().set_write_packet_checker(
+        [&](am::packet_variant wp) {
+            BOOST_TEST(connect == wp);
+        }
+    );
+    {
+        auto [ec] = ep.async_send(connect, as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // recv connack
+    {
+        auto [ec, pv] = ep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(connack == *pv);
+    }
+
+    auto pid1 = *ep.acquire_unique_packet_id();
+    auto pid2 = *ep.acquire_unique_packet_id();
+
+    // less than the threshold
+    auto publish_small = am::v5::publish_packet(
+        pid1,
+        "topic1",
+        "payload1",
+        am::qos::at_least_once,
+        am::properties{
+            am::property::content_type{"text/plain"}
+        }
+    );
+    // greater than the threshold
+    auto publish_large = am::v5::publish_packet(
+        pid2,
+        "topic1",
+        std::string(1024, 'x'),
+        am::qos::at_least_once,
+        am::properties{
+            am::property::content_type{"text/plain"}
+        }
+    );
+
+    // copied into one contiguous buffer
+    {
+        std::size_t num_of_buffers = 0;
+        ep.next_layer().set_write_buffers_checker(
+            [&](std::size_t num) {
+                num_of_buffers = num;
+            }
+        );
+        ep.next_layer().set_write_packet_checker(
+            [&](am::packet_variant wp) {
+                BOOST_TEST(publish_small == wp);
+            }
+        );
+        auto [ec] = ep.async_send(publish_small, as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(num_of_buffers == 1);
+    }
+
+    // written as the const buffer sequence of the packet
+    {
+        std::size_t num_of_buffers = 0;
+        ep.next_layer().set_write_buffers_checker(
+            [&](std::size_t num) {
+                num_of_buffers = num;
+            }
+        );
+        ep.next_layer().set_write_packet_checker(
+            [&](am::packet_variant wp) {
+                BOOST_TEST(publish_large == wp);
+            }
+        );
+        auto [ec] = ep.async_send(publish_large, as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(num_of_buffers == publish_large.num_of_const_buffer_sequence());
+    }
+
+    ep.next_layer().set_write_buffers_checker({});
+    ep.async_close(as::as_tuple(as::use_future)).get();
+    guard.reset();
+    th.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <future>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/endpoint.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/inproc.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_ep_inproc)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+// The client sends QoS1 PUBLISH packets without calling async_recv().
+// The server's PUBACK packets are kept in the inproc buffer,
+// so the server's writes and the client's sends complete.
+BOOST_AUTO_TEST_CASE(qos1_publish_without_recv) {
+    as::io_context ioc;
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+
+    auto sep = am::endpoint<am::role::server, am::protocol::mqtt_inproc>{
+        am::protocol_version::undetermined,
+        as::make_strand(ioc.get_executor())
+    };
+    auto cep = am::endpoint<am::role::client, am::protocol::mqtt_inproc>{
+        am::protocol_version::v3_1_1,
+        as::make_strand(ioc.get_executor())
+    };
+    sep.set_auto_pub_response(true);
+    cep.next_layer().connect(sep.next_layer());
+    sep.underlying_accepted();
+
+    // connect
+    {
+        auto [ec] = cep.async_send(
+            am::v3_1_1::connect_packet{
+                true,   // clean_session
+                0x0,    // keep_alive
+                "cid1",
+                std::nullopt, // will
+                std::nullopt, // username
+                std::nullopt  // password
+            },
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+    {
+        auto [ec, pv] = sep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pv.get_if<am::v3_1_1::connect_packet>());
+    }
+    {
+        auto [ec] = sep.async_send(
+            am::v3_1_1::connack_packet{
+                false, // session_present
+                am::connect_return_code::accepted
+            },
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+    {
+        auto [ec, pv] = cep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pv.get_if<am::v3_1_1::connack_packet>());
+    }
+
+    // the server receives PUBLISH packets and sends PUBACK packets automatically
+    std::size_t const num = 1000;
+    std::promise<void> received;
+    std::size_t count = 0;
+    std::function<void()> recv_publish =
+        [&] {
+            sep.async_recv(
+                [&](am::error_code const& ec, am::packet_variant pv) {
+                    BOOST_TEST(!ec);
+                    BOOST_TEST(pv.get_if<am::v3_1_1::publish_packet>());
+                    if (++count == num) {
+                        received.set_value();
+                        return;
+                    }
+                    recv_publish();
+                }
+            );
+        };
+    as::dispatch(sep.get_executor(), recv_publish);
+
+    // the client doesn't receive PUBACK packets
+    for (std::size_t i = 0; i != num; ++i) {
+        auto pid = cep.async_acquire_unique_packet_id(as::use_future).get();
+        auto [ec] = cep.async_send(
+            am::v3_1_1::publish_packet{
+                pid,
+                "topic1",
+                "payload1",
+                am::qos::at_least_once
+            },
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+    BOOST_TEST(
+        received.get_future().wait_for(std::chrono::seconds(10)) == std::future_status::ready
+    );
+
+    // the server's write completes though the client doesn't read
+    {
+        auto [ec] = sep.async_send(
+            am::v3_1_1::publish_packet{
+                "topic1",
+                "payload1",
+                am::qos::at_most_once
+            },
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+    }
+
+    cep.async_close(as::as_tuple(as::use_future)).get();
+    sep.async_close(as::as_tuple(as::use_future)).get();
+    guard.reset();
+    th.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,356 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <thread>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/endpoint.hpp>
+
+#include "stub_socket.hpp"
+
+BOOST_AUTO_TEST_SUITE(ut_ep_recv_some)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+BOOST_AUTO_TEST_CASE(recv_some) {
+    auto version = am::protocol_version::v5;
+    as::io_context ioc;
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+
+    auto ep = am::endpoint<async_mqtt::role::client, async_mqtt::stub_socket>{
+        version,
+        // for stub_socket args
+        version,
+        ioc.get_executor()
+    };
+
+    auto connect = am::v5::connect_packet{
+        true,   // clean_start
+        0x1234, // keep_alive
+        "cid1",
+        std::nullopt, // will
+        "user1",
+        "pass1",
+        am::properties{}
+    };
+
+    auto connack = am::v5::connack_packet{
+        false,   // session_present
+        am::connect_reason_code::success,
+        am::properties{}
+    };
+
+    auto publish1 = am::v5::publish_packet(
+        0x0, // packet_id
+        "topic1",
+        "payload1",
+        am::qos::at_most_once,
+        am::properties{}
+    );
+
+    auto publish2 = am::v5::publish_packet(
+        0x0, // packet_id
+        "topic2",
+        "payload2",
+        am::qos::at_most_once,
+        am::properties{}
+    );
+
+    auto pingresp = am::v5::pingresp_packet{};
+
+    // three packets and a half of the packet in one read
+    auto chunk1 =
+        am::to_string(publish1.const_buffer_sequence()) +
+        am::to_string(publish2.const_buffer_sequence()) +
+        am::to_string(publish1.const_buffer_sequence());
+    auto publish2_str = am::to_string(publish2.const_buffer_sequence());
+    auto half = publish2_str.size() / 2;
+    chunk1 += publish2_str.substr(0, half);
+    auto chunk2 = publish2_str.substr(half);
+
+    // filtered packet in the middle
+    auto chunk3 =
+        am::to_string(publish1.const_buffer_sequence()) +
+        am::to_string(pingresp.const_buffer_sequence()) +
+        am::to_string(publish2.const_buffer_sequence());
+
+    ep.next_layer().set_recv_packets(
+        {
+            // receive packets
+            {connack},
+            {chunk1},
+            {chunk2},
+            {chunk3},
+        }
+    );
+
+    // underlying handshake
+    {
+        auto [ec] = ep.async_underlying_handshake(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // send connect
+    ep.next_layer().set_write_packet_checker(
+        [&](am::packet_variant wp) {
+            BOOST_TEST(connect == wp);
+        }
+    );
+    {
+        auto [ec] = ep.async_send(connect, as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // recv connack
+    {
+        auto [ec, pvs] = ep.async_recv_some(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pvs.size() == 1);
+        BOOST_TEST(connack == pvs.front());
+    }
+
+    // recv all decoded packets in the first read
+    {
+        auto [ec, pvs] = ep.async_recv_some(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pvs.size() == 3);
+        BOOST_TEST(publish1 == pvs[0]);
+        BOOST_TEST(publish2 == pvs[1]);
+        BOOST_TEST(publish1 == pvs[2]);
+    }
+
+    // recv the rest of the packet
+    {
+        auto [ec, pvs] = ep.async_recv_some(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pvs.size() == 1);
+        BOOST_TEST(publish2 == pvs.front());
+    }
+
+    // filter
+    {
+        auto [ec, pvs] = ep.async_recv_some(
+            am::filter::except,
+            {am::control_packet_type::pingresp},
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pvs.size() == 2);
+        BOOST_TEST(publish1 == pvs[0]);
+        BOOST_TEST(publish2 == pvs[1]);
+    }
+
+    ep.async_close(as::as_tuple(as::use_future)).get();
+    guard.reset();
+    th.join();
+}
+
+BOOST_AUTO_TEST_CASE(packets_before_error) {
+    auto version = am::protocol_version::v3_1_1;
+    as::io_context ioc;
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+
+    auto ep = am::endpoint<async_mqtt::role::client, async_mqtt::stub_socket>{
+        version,
+        // for stub_socket args
+        version,
+        ioc.get_executor()
+    };
+
+    auto connect = am::v3_1_1::connect_packet{
+        true,   // clean_session
+        0x1234, // keep_alive
+        "cid1",
+        std::nullopt, // will
+        "user1",
+        "pass1"
+    };
+
+    auto connack = am::v3_1_1::connack_packet{
+        false,   // session_present
+        am::connect_return_code::accepted
+    };
+
+    auto publish1 = am::v3_1_1::publish_packet(
+        0x0, // packet_id
+        "topic1",
+        "payload1",
+        am::qos::at_most_once
+    );
+
+    // a valid packet and a malformed packet in one read
+    auto chunk1 =
+        am::to_string(publish1.const_buffer_sequence()) +
+        std::string("\x20\x02\x02\x00", 4); // invalid reserved flag
+
+    ep.next_layer().set_recv_packets(
+        {
+            // receive packets
+            {connack},
+            {chunk1},
+            {am::errc::make_error_code(am::errc::connection_reset)},
+        }
+    );
+
+    // underlying handshake
+    {
+        auto [ec] = ep.async_underlying_handshake(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // send connect
+    ep.next_layer().set_write_packet_checker(
+        [&](am::packet_variant wp) {
+            BOOST_TEST(connect == wp);
+        }
+    );
+    {
+        auto [ec] = ep.async_send(connect, as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // recv connack
+    {
+        auto [ec, pvs] = ep.async_recv_some(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pvs.size() == 1);
+        BOOST_TEST(connack == pvs.front());
+    }
+
+    // the packet decoded before the error is passed first
+    {
+        auto [ec, pvs] = ep.async_recv_some(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pvs.size() == 1);
+        BOOST_TEST(publish1 == pvs.front());
+    }
+
+    // then the error is reported
+    {
+        auto [ec, pvs] = ep.async_recv_some(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(ec == am::disconnect_reason_code::malformed_packet);
+        BOOST_TEST(pvs.empty());
+    }
+
+    ep.async_close(as::as_tuple(as::use_future)).get();
+    guard.reset();
+    th.join();
+}
+
+// The error decided after the packets passed by async_recv_some() is reported
+// by async_recv() too, so it is not left for a later async_recv_some().
+BOOST_AUTO_TEST_CASE(packets_before_error_recv) {
+    auto version = am::protocol_version::v3_1_1;
+    as::io_context ioc;
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+
+    auto ep = am::endpoint<async_mqtt::role::client, async_mqtt::stub_socket>{
+        version,
+        // for stub_socket args
+        version,
+        ioc.get_executor()
+    };
+
+    auto connect = am::v3_1_1::connect_packet{
+        true,   // clean_session
+        0x1234, // keep_alive
+        "cid1",
+        std::nullopt, // will
+        "user1",
+        "pass1"
+    };
+
+    auto connack = am::v3_1_1::connack_packet{
+        false,   // session_present
+        am::connect_return_code::accepted
+    };
+
+    auto publish1 = am::v3_1_1::publish_packet(
+        0x0, // packet_id
+        "topic1",
+        "payload1",
+        am::qos::at_most_once
+    );
+
+    // a valid packet and a malformed packet in one read
+    auto chunk1 =
+        am::to_string(publish1.const_buffer_sequence()) +
+        std::string("\x20\x02\x02\x00", 4); // invalid reserved flag
+
+    ep.next_layer().set_recv_packets(
+        {
+            // receive packets
+            {connack},
+            {chunk1},
+            {am::errc::make_error_code(am::errc::connection_reset)},
+        }
+    );
+
+    // underlying handshake
+    {
+        auto [ec] = ep.async_underlying_handshake(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // send connect
+    ep.next_layer().set_write_packet_checker(
+        [&](am::packet_variant wp) {
+            BOOST_TEST(connect == wp);
+        }
+    );
+    {
+        auto [ec] = ep.async_send(connect, as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // recv connack
+    {
+        auto [ec, pvs] = ep.async_recv_some(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pvs.size() == 1);
+        BOOST_TEST(connack == pvs.front());
+    }
+
+    // the packet decoded before the error is passed first
+    {
+        auto [ec, pvs] = ep.async_recv_some(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(pvs.size() == 1);
+        BOOST_TEST(publish1 == pvs.front());
+    }
+
+    // then the error is reported by async_recv()
+    {
+        auto [ec, pv] = ep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(ec == am::disconnect_reason_code::malformed_packet);
+    }
+
+    ep.async_close(as::as_tuple(as::use_future)).get();
+    guard.reset();
+    th.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
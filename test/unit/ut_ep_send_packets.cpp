@@ -0,0 +1,375 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <thread>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/endpoint.hpp>
+
+#include "stub_socket.hpp"
+
+BOOST_AUTO_TEST_SUITE(ut_ep_send_packets)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+BOOST_AUTO_TEST_CASE(send_packets) {
+    auto version = am::protocol_version::v5;
+    as::io_context ioc;
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+
+    auto ep = am::endpoint<async_mqtt::role::client, async_mqtt::stub_socket>{
+        version,
+        // for stub_socket args
+        version,
+        ioc.get_executor()
+    };
+
+    auto connect = am::v5::connect_packet{
+        true,   // clean_start
+        0x1234, // keep_alive
+        "cid1",
+        std::nullopt, // will
+        "user1",
+        "pass1",
+        am::properties{}
+    };
+
+    auto connack = am::v5::connack_packet{
+        false,   // session_present
+        am::connect_reason_code::success,
+        am::properties{}
+    };
+
+    ep.next_layer().set_recv_packets(
+        {
+            // receive packets
+            {connack},
+        }
+    );
+
+    // underlying handshake
+    {
+        auto [ec] = ep.async_underlying_handshake(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // send connect
+    ep.next_layer().set_write_packet_checker(
+        [&](am::packet_variant wp) {
+            BOOST_TEST(connect == wp);
+        }
+    );
+    {
+        auto [ec] = ep.async_send(connect, as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // recv connack
+    {
+        auto [ec, pv] = ep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(connack == *pv);
+    }
+
+    auto pid1 = *ep.acquire_unique_packet_id();
+    auto pid2 = *ep.acquire_unique_packet_id();
+    auto pid3 = *ep.acquire_unique_packet_id();
+
+    auto publish_q0 = am::v5::publish_packet(
+        0x0, // packet_id
+        "topic1",
+        "payload1",
+        am::qos::at_most_once,
+        am::properties{}
+    );
+
+    auto publish_q1 = am::v5::publish_packet(
+        pid1,
+        "topic1",
+        "payload1",
+        am::qos::at_least_once,
+        am::properties{}
+    );
+
+    auto publish_q2 = am::v5::publish_packet(
+        pid2,
+        "topic1",
+        "payload1",
+        am::qos::exactly_once,
+        am::properties{}
+    );
+
+    auto subscribe = am::v5::subscribe_packet(
+        pid3,
+        { {"topic1", am::qos::at_most_once} },
+        am::properties{}
+    );
+
+    // all packets are sent
+    {
+        std::vector<am::packet_variant> expected{publish_q0, publish_q1};
+        std::size_t index = 0;
+        ep.next_layer().set_write_packet_checker(
+            [&](am::packet_variant wp) {
+                BOOST_TEST(index < expected.size());
+                BOOST_TEST(expected[index++] == wp);
+            }
+        );
+        auto [ec, accepted] = ep.async_send(
+            expected,
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(accepted == 2);
+        BOOST_TEST(index == 2);
+    }
+
+    // connack is not allowed to send as client
+    {
+        std::vector<am::packet_variant> packets{publish_q0, connack, publish_q2, subscribe};
+        std::size_t index = 0;
+        ep.next_layer().set_write_packet_checker(
+            [&](am::packet_variant wp) {
+                BOOST_TEST(index == 0);
+                ++index;
+                BOOST_TEST(publish_q0 == wp);
+            }
+        );
+        auto [ec, accepted] = ep.async_send(
+            packets,
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(ec == am::mqtt_error::packet_not_allowed_to_send);
+        BOOST_TEST(accepted == 1);
+        BOOST_TEST(index == 1);
+    }
+
+    // packet_ids of the packets after the error packet are released
+    BOOST_TEST(ep.register_packet_id(pid2));
+    BOOST_TEST(ep.register_packet_id(pid3));
+
+    ep.async_close(as::as_tuple(as::use_future)).get();
+    guard.reset();
+    th.join();
+}
+
+BOOST_AUTO_TEST_CASE(send_packets_enqueued) {
+    auto version = am::protocol_version::v5;
+    as::io_context ioc;
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+
+    auto ep = am::endpoint<async_mqtt::role::client, async_mqtt::stub_socket>{
+        version,
+        // for stub_socket args
+        version,
+        ioc.get_executor()
+    };
+
+    auto connect = am::v5::connect_packet{
+        true,   // clean_start
+        0x1234, // keep_alive
+        "cid1",
+        std::nullopt, // will
+        "user1",
+        "pass1",
+        am::properties{}
+    };
+
+    auto connack = am::v5::connack_packet{
+        false,   // session_present
+        am::connect_reason_code::success,
+        am::properties{
+            am::property::receive_maximum{1}
+        }
+    };
+
+    ep.next_layer().set_recv_packets(
+        {
+            // receive packets
+            {connack},
+        }
+    );
+
+    // underlying handshake
+    {
+        auto [ec] = ep.async_underlying_handshake(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // send connect
+    ep.next_layer().set_write_packet_checker(
+        [&](am::packet_variant wp) {
+            BOOST_TEST(connect == wp);
+        }
+    );
+    {
+        auto [ec] = ep.async_send(connect, as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // recv connack
+    {
+        auto [ec, pv] = ep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(connack == *pv);
+    }
+
+    auto pid1 = *ep.acquire_unique_packet_id();
+    auto pid2 = *ep.acquire_unique_packet_id();
+
+    auto publish1 = am::v5::publish_packet(
+        pid1,
+        "topic1",
+        "payload1",
+        am::qos::at_least_once,
+        am::properties{}
+    );
+
+    auto publish2 = am::v5::publish_packet(
+        pid2,
+        "topic1",
+        "payload2",
+        am::qos::at_least_once,
+        am::properties{}
+    );
+
+    // the second packet exceeds receive_maximum and is enqueued
+    {
+        std::size_t index = 0;
+        ep.next_layer().set_write_packet_checker(
+            [&](am::packet_variant wp) {
+                BOOST_TEST(index == 0);
+                ++index;
+                BOOST_TEST(publish1 == wp);
+            }
+        );
+        auto [ec, accepted] = ep.async_send(
+            std::vector<am::packet_variant>{publish1, publish2},
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(ec == am::mqtt_error::packet_enqueued);
+        BOOST_TEST(accepted == 2);
+        BOOST_TEST(index == 1);
+    }
+
+    ep.async_close(as::as_tuple(as::use_future)).get();
+    guard.reset();
+    th.join();
+}
+
+BOOST_AUTO_TEST_CASE(send_packets_write_error) {
+    auto version = am::protocol_version::v3_1_1;
+    as::io_context ioc;
+    auto guard = as::make_work_guard(ioc.get_executor());
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+
+    auto ep = am::endpoint<async_mqtt::role::client, async_mqtt::stub_socket>{
+        version,
+        // for stub_socket args
+        version,
+        ioc.get_executor()
+    };
+
+    auto connect = am::v3_1_1::connect_packet{
+        true,   // clean_session
+        0x1234, // keep_alive
+        "cid1",
+        std::nullopt, // will
+        "user1",
+        "pass1"
+    };
+
+    auto connack = am::v3_1_1::connack_packet{
+        false,   // session_present
+        am::connect_return_code::accepted
+    };
+
+    ep.next_layer().set_recv_packets(
+        {
+            // receive packets
+            {connack},
+        }
+    );
+
+    // underlying handshake
+    {
+        auto [ec] = ep.async_underlying_handshake(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // send connect
+    ep.next_layer().set_write_packet_checker(
+        [&](am::packet_variant wp) {
+            BOOST_TEST(connect == wp);
+        }
+    );
+    {
+        auto [ec] = ep.async_send(connect, as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+
+    // recv connack
+    {
+        auto [ec, pv] = ep.async_recv(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+        BOOST_TEST(connack == *pv);
+    }
+
+    auto pid1 = *ep.acquire_unique_packet_id();
+
+    auto publish1 = am::v3_1_1::publish_packet(
+        pid1,
+        "topic1",
+        "payload1",
+        am::qos::at_least_once
+    );
+
+    auto publish2 = am::v3_1_1::publish_packet(
+        "topic1",
+        "payload2",
+        am::qos::at_most_once
+    );
+
+    // both packets pass the check, but the write fails
+    {
+        ep.next_layer().set_write_error(am::errc::make_error_code(am::errc::connection_reset));
+        auto [ec, accepted] = ep.async_send(
+            std::vector<am::packet_variant>{publish1, publish2},
+            as::as_tuple(as::use_future)
+        ).get();
+        BOOST_TEST(ec == am::errc::connection_reset);
+        // none of the packets is known to be written
+        BOOST_TEST(accepted == 0);
+    }
+
+    // the packet_id is not stored for resending (clean_session), so it is released
+    BOOST_TEST(ep.register_packet_id(pid1));
+
+    ep.async_close(as::as_tuple(as::use_future)).get();
+    guard.reset();
+    th.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <broker/interned_topic.hpp>
+#include <broker/retained_topic_map.hpp>
+#include <broker/subscription_map.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_interned_topic)
+
+namespace am = async_mqtt;
+
+BOOST_AUTO_TEST_CASE(share) {
+    auto base = am::interned_topic::table_size();
+    {
+        am::interned_topic t1{"ut_interned_topic/share"};
+        std::string str{"ut_interned_topic/share"};
+        am::interned_topic t2{str};
+        BOOST_TEST(t1 == t2);
+        BOOST_TEST(t1.id() == t2.id());
+        BOOST_TEST(static_cast<void const*>(t1.str().data()) == static_cast<void const*>(t2.str().data()));
+        BOOST_TEST(t1.use_count() == 2);
+        BOOST_TEST(t1 == "ut_interned_topic/share");
+        BOOST_TEST(t1.size() == str.size());
+
+        am::interned_topic t3{"ut_interned_topic/other"};
+        BOOST_TEST(t1 != t3);
+        BOOST_TEST(t1.id() != t3.id());
+
+        // the topics and the levels "ut_interned_topic", "share", "other"
+        BOOST_TEST(am::interned_topic::table_size() == base + 5);
+
+        auto t4 = t1;
+        BOOST_TEST(t1.use_count() == 3);
+        auto t5 = std::move(t4);
+        BOOST_TEST(t1.use_count() == 3);
+        BOOST_TEST(t4.empty());
+        t5 = t3;
+        BOOST_TEST(t1.use_count() == 2);
+        BOOST_TEST(t3.use_count() == 2);
+    }
+    BOOST_TEST(am::interned_topic::table_size() == base);
+}
+
+BOOST_AUTO_TEST_CASE(empty) {
+    am::interned_topic t1;
+    am::interned_topic t2{""};
+    BOOST_TEST(t1.empty());
+    BOOST_TEST(t2.empty());
+    BOOST_TEST(t1 == t2);
+    BOOST_TEST(t1.id() == 0);
+    BOOST_TEST(t1.str().empty());
+    BOOST_TEST(t1.level_count() == 1);
+    BOOST_TEST(t1.use_count() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(levels) {
+    am::interned_topic t{"ut_interned_topic//b/c"};
+    BOOST_TEST(t.level_count() == 4);
+    BOOST_TEST(t.level(0) == "ut_interned_topic");
+    BOOST_TEST(t.level(1).empty());
+    BOOST_TEST(t.level(2) == "b");
+    BOOST_TEST(t.level(3) == "c");
+
+    am::interned_topic b{"b"};
+    BOOST_TEST(t.level(2) == b);
+    BOOST_TEST(b.level_count() == 1);
+    BOOST_TEST(b.level(0) == b);
+
+    am::interned_topic t2{"b/c"};
+    auto ids = t.level_ids();
+    auto ids2 = t2.level_ids();
+    BOOST_TEST(ids.size() == 4);
+    BOOST_TEST(ids[0] != 0);
+    BOOST_TEST(ids[1] == 0);
+    BOOST_TEST(ids[2] == ids2[0]);
+    BOOST_TEST(ids[3] == ids2[1]);
+}
+
+BOOST_AUTO_TEST_CASE(compare) {
+    am::interned_topic a{"a"};
+    am::interned_topic b{"b"};
+    BOOST_TEST(a < b);
+    BOOST_TEST(!(b < a));
+    std::set<am::interned_topic> s{b, a, am::interned_topic{"a"}};
+    BOOST_TEST(s.size() == 2);
+    BOOST_TEST(*s.begin() == "a");
+
+    std::stringstream ss;
+    ss << a << "/" << b;
+    BOOST_TEST(ss.str() == "a/b");
+}
+
+BOOST_AUTO_TEST_CASE(multi_thread) {
+    auto base = am::interned_topic::table_size();
+    std::vector<std::thread> ths;
+    for (std::size_t t = 0; t != 4; ++t) {
+        ths.emplace_back(
+            [t] {
+                std::vector<am::interned_topic> keep;
+                for (std::size_t i = 0; i != 10000; ++i) {
+                    am::interned_topic topic{"ut_interned_topic/mt/" + std::to_string(i % 16)};
+                    if ((i + t) % 3 == 0) keep.push_back(topic);
+                    if (keep.size() > 8) keep.erase(keep.begin());
+                }
+            }
+        );
+    }
+    for (auto& th : ths) th.join();
+    BOOST_TEST(am::interned_topic::table_size() == base);
+}
+
+BOOST_AUTO_TEST_CASE(maps_share_levels) {
+    auto base = am::interned_topic::table_size();
+    {
+        am::single_subscription_map<std::string> subs;
+        am::retained_topic_map<std::string> retains;
+        subs.insert("ut_interned_topic/1/cmd", "v");
+        subs.insert("ut_interned_topic/2/cmd", "v");
+        retains.insert_or_assign("ut_interned_topic/1/cmd", "v");
+        retains.insert_or_assign("ut_interned_topic/2/cmd", "v");
+        // "ut_interned_topic", "1", "2", and "cmd"
+        BOOST_TEST(am::interned_topic::table_size() == base + 4);
+
+        std::vector<std::string> matched;
+        subs.find("ut_interned_topic/2/cmd", [&](std::string const& v) { matched.push_back(v); });
+        BOOST_TEST(matched.size() == 1);
+    }
+    BOOST_TEST(am::interned_topic::table_size() == base);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,174 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <boost/asio.hpp>
+
+#include <broker/outbound_queue.hpp>
+#include <broker/offline_message.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_outbound_queue)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+BOOST_AUTO_TEST_CASE(unlimited) {
+    am::outbound_queue_limits l;
+    am::outbound_queue q;
+    for (std::size_t i = 0; i != 1000; ++i) {
+        BOOST_TEST(l.try_acquire(q, 100));
+    }
+    BOOST_TEST(q.queued_messages() == 1000);
+    BOOST_TEST(q.queued_bytes() == 100000);
+    BOOST_TEST(l.queued_messages() == 1000);
+    BOOST_TEST(l.queued_bytes() == 100000);
+    for (std::size_t i = 0; i != 1000; ++i) {
+        l.release(q, 100);
+    }
+    BOOST_TEST(q.queued_messages() == 0);
+    BOOST_TEST(q.queued_bytes() == 0);
+    BOOST_TEST(l.queued_messages() == 0);
+    BOOST_TEST(l.queued_bytes() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(session_messages) {
+    am::outbound_queue_limits l;
+    l.set_session_limits(0, 2);
+    am::outbound_queue q1;
+    am::outbound_queue q2;
+    BOOST_TEST(l.try_acquire(q1, 10));
+    BOOST_TEST(l.try_acquire(q1, 10));
+    BOOST_TEST(!l.try_acquire(q1, 10));
+    // other session is not affected
+    BOOST_TEST(l.try_acquire(q2, 10));
+    BOOST_TEST(q1.queued_messages() == 2);
+    BOOST_TEST(q1.queued_bytes() == 20);
+    BOOST_TEST(l.queued_messages() == 3);
+
+    l.release(q1, 10);
+    BOOST_TEST(l.try_acquire(q1, 10));
+    BOOST_TEST(!l.try_acquire(q1, 10));
+}
+
+BOOST_AUTO_TEST_CASE(session_bytes) {
+    am::outbound_queue_limits l;
+    l.set_session_limits(100, 0);
+    am::outbound_queue q;
+    // the first message is always acquired
+    BOOST_TEST(l.try_acquire(q, 1000));
+    BOOST_TEST(!l.try_acquire(q, 1));
+    l.release(q, 1000);
+    BOOST_TEST(l.try_acquire(q, 60));
+    BOOST_TEST(l.try_acquire(q, 40));
+    BOOST_TEST(!l.try_acquire(q, 1));
+    BOOST_TEST(q.queued_bytes() == 100);
+}
+
+BOOST_AUTO_TEST_CASE(global) {
+    am::outbound_queue_limits l;
+    l.set_global_limits(0, 3);
+    am::outbound_queue q1;
+    am::outbound_queue q2;
+    am::outbound_queue q3;
+    BOOST_TEST(l.try_acquire(q1, 10));
+    BOOST_TEST(l.try_acquire(q1, 10));
+    BOOST_TEST(l.try_acquire(q2, 10));
+    BOOST_TEST(!l.try_acquire(q1, 10));
+    BOOST_TEST(!l.try_acquire(q2, 10));
+    // each session can queue one message
+    BOOST_TEST(l.try_acquire(q3, 10));
+    BOOST_TEST(l.queued_messages() == 4);
+
+    l.set_global_limits(25, 0);
+    BOOST_TEST(!l.try_acquire(q1, 1));
+    l.set_global_limits(0, 0);
+    BOOST_TEST(l.try_acquire(q1, 1));
+}
+
+BOOST_AUTO_TEST_CASE(dropped) {
+    am::outbound_queue_limits l;
+    am::outbound_queue q1;
+    am::outbound_queue q2;
+    l.add_dropped(q1);
+    l.add_dropped(q1);
+    l.add_dropped(q2);
+    BOOST_TEST(q1.dropped_messages() == 2);
+    BOOST_TEST(q2.dropped_messages() == 1);
+    BOOST_TEST(l.dropped_messages() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(offline) {
+    am::outbound_queue_limits l;
+    // unlimited
+    BOOST_TEST(l.can_store_offline(100000, 100000, 100000));
+
+    l.set_offline_limits(0, 2);
+    BOOST_TEST(l.can_store_offline(0, 0, 10));
+    BOOST_TEST(l.can_store_offline(1, 10, 10));
+    BOOST_TEST(!l.can_store_offline(2, 20, 10));
+
+    l.set_offline_limits(100, 0);
+    BOOST_TEST(l.can_store_offline(5, 90, 10));
+    BOOST_TEST(!l.can_store_offline(5, 90, 11));
+    // unlike the outbound queue, the first message can exceed the limit
+    BOOST_TEST(!l.can_store_offline(0, 0, 101));
+}
+
+BOOST_AUTO_TEST_CASE(offline_messages_bytes) {
+    as::io_context ioc;
+    am::offline_messages om;
+    om.push_back(
+        ioc.get_executor(),
+        am::interned_topic{"topic1"},
+        {am::buffer{"abc"}},
+        am::qos::at_most_once,
+        am::properties{}
+    );
+    om.push_back(
+        ioc.get_executor(),
+        am::interned_topic{"topic2"},
+        {am::buffer{"de"}},
+        am::qos::at_most_once,
+        am::properties{
+            am::property::message_expiry_interval{1}
+        }
+    );
+    BOOST_TEST(om.size() == 2);
+    BOOST_TEST(om.bytes() == 17);
+
+    // the expired message is uncounted
+    ioc.run();
+    BOOST_TEST(om.size() == 1);
+    BOOST_TEST(om.bytes() == 9);
+
+    om.clear();
+    BOOST_TEST(om.size() == 0);
+    BOOST_TEST(om.bytes() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(policy) {
+    am::outbound_queue_limits l;
+    BOOST_TEST(l.get_policy() == am::slow_consumer_policy::drop_qos0);
+    l.set_policy(am::slow_consumer_policy::disconnect);
+    BOOST_TEST(l.get_policy() == am::slow_consumer_policy::disconnect);
+
+    for (auto p : {
+            am::slow_consumer_policy::drop_qos0,
+            am::slow_consumer_policy::disconnect,
+            am::slow_consumer_policy::offline
+        }) {
+        BOOST_TEST(*am::slow_consumer_policy_from_str(am::slow_consumer_policy_to_str(p)) == p);
+    }
+    BOOST_TEST(!am::slow_consumer_policy_from_str("unknown"));
+}
+
+BOOST_AUTO_TEST_CASE(bytes) {
+    std::vector<am::buffer> payload{am::buffer{"abc"}, am::buffer{"de"}};
+    BOOST_TEST(am::outbound_bytes("topic", payload) == 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2872,6 +2872,66 @@ BOOST_AUTO_TEST_CASE(props) {
     BOOST_TEST(ps1 == ps2);
 }
 
+BOOST_AUTO_TEST_CASE(props_get) {
+    am::properties ps{
+        am::property::user_property{"key1", "val1"},
+        am::property::message_expiry_interval{10},
+        am::property::user_property{"key2", "val2"},
+        am::property::topic_alias{3}
+    };
+    BOOST_TEST(ps.contains(am::property::id::message_expiry_interval));
+    BOOST_TEST(ps.contains(am::property::id::user_property));
+    BOOST_TEST(!ps.contains(am::property::id::content_type));
+    BOOST_TEST(ps.get<am::property::content_type>() == nullptr);
+
+    auto mei = ps.get<am::property::message_expiry_interval>();
+    BOOST_TEST(mei);
+    BOOST_TEST(mei->val() == 10);
+
+    // first one is returned
+    auto up = ps.get<am::property::user_property>();
+    BOOST_TEST(up);
+    BOOST_TEST(up->key() == "key1");
+
+    // update via get
+    *ps.get<am::property::message_expiry_interval>() = am::property::message_expiry_interval{20};
+    BOOST_TEST(ps.get<am::property::message_expiry_interval>()->val() == 20);
+
+    // erase keeps wire order and index
+    auto it = ps.cbegin();
+    ps.erase(it);
+    BOOST_TEST(ps.size() == 3);
+    BOOST_TEST(ps.get<am::property::user_property>()->key() == "key2");
+    BOOST_TEST(ps.get<am::property::topic_alias>()->val() == 3);
+
+    ps.pop_back();
+    BOOST_TEST(!ps.get<am::property::topic_alias>());
+
+    ps.push_back(am::property::topic_alias{4});
+    BOOST_TEST(ps.get<am::property::topic_alias>()->val() == 4);
+    BOOST_TEST(
+        boost::lexical_cast<std::string>(ps) ==
+        "[{id:message_expiry_interval,val:20},{id:user_property,key:key2,val:val2},{id:topic_alias,val:4}]"
+    );
+
+    ps.clear();
+    BOOST_TEST(ps.empty());
+    BOOST_TEST(!ps.get<am::property::message_expiry_interval>());
+}
+
+BOOST_AUTO_TEST_CASE(props_get_many) {
+    am::properties ps;
+    for (std::size_t i = 0; i != 300; ++i) {
+        ps.emplace_back(am::property::user_property{"key", std::to_string(i)});
+    }
+    ps.emplace_back(am::property::message_expiry_interval{1});
+    auto mei = ps.get<am::property::message_expiry_interval>();
+    BOOST_TEST(mei);
+    BOOST_TEST(mei->val() == 1);
+    ps.pop_back();
+    BOOST_TEST(!ps.get<am::property::message_expiry_interval>());
+}
+
 
 BOOST_AUTO_TEST_CASE(empty) {
     am::buffer buf;
@@ -300,4 +300,70 @@ BOOST_AUTO_TEST_CASE(wildcard_multiple_matches) {
     BOOST_TEST(matches[0] == "message1");
 }
 
+BOOST_AUTO_TEST_CASE(cursor) {
+    am::retained_topic_map<std::string> map;
+    std::vector<std::string> topics = {
+        "a", "a/b", "a/b/c", "a/c", "a/d/c", "b/b/c", "$SYS/a", "$SYS/a/b", "a/$b", "/a", "a/", "x/y/z"
+    };
+    for (auto const& t : topics) {
+        map.insert_or_assign(t, t);
+    }
+
+    std::vector<std::string> filters = {
+        "#", "+", "a/#", "a/+", "+/b/c", "+/+/c", "a/b/c", "a/x", "$SYS/#", "$SYS/+", "+/#", "/+", "a/+/#", "+/"
+    };
+    for (auto const& f : filters) {
+        std::vector<std::string> expected;
+        map.find(f, [&](std::string const& v) { expected.push_back(v); });
+        std::sort(expected.begin(), expected.end());
+
+        for (std::size_t page : {1, 2, 3, 100}) {
+            std::vector<std::string> matches;
+            auto c = map.make_cursor(f);
+            while (!c.done()) {
+                std::size_t found = 0;
+                auto visits = map.find_some(
+                    c,
+                    page,
+                    [&](std::string const& v) {
+                        matches.push_back(v);
+                        ++found;
+                    }
+                );
+                BOOST_TEST(visits <= page);
+                BOOST_TEST(found <= page);
+            }
+            std::sort(matches.begin(), matches.end());
+            BOOST_TEST(matches == expected, "filter:" << f << " page:" << page);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cursor_modified) {
+    am::retained_topic_map<std::string> map;
+    // keep the node fleet
+    map.insert_or_assign("fleet", "fleet");
+    for (std::size_t i = 0; i != 100; ++i) {
+        map.insert_or_assign("fleet/" + std::to_string(i) + "/twin", std::to_string(i));
+    }
+
+    auto c = map.make_cursor("fleet/+/twin");
+    std::set<std::string> matches;
+    map.find_some(c, 20, [&](std::string const& v) { matches.insert(v); });
+    BOOST_TEST(!c.done());
+
+    // erase all the topics including the visited one
+    for (std::size_t i = 0; i != 100; ++i) {
+        map.erase("fleet/" + std::to_string(i) + "/twin");
+    }
+    // insert new topic behind the cursor
+    map.insert_or_assign("fleet/zz/twin", "zz");
+
+    while (!c.done()) {
+        map.find_some(c, 20, [&](std::string const& v) { matches.insert(v); });
+    }
+    BOOST_TEST(matches.size() <= 20U + 1U);
+    BOOST_TEST(matches.count("zz") == 1U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
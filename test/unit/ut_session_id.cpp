@@ -0,0 +1,60 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <broker/session_id.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_session_id)
+
+namespace am = async_mqtt;
+
+BOOST_AUTO_TEST_CASE(dense) {
+    am::session_id_pool ids;
+    BOOST_TEST(ids.allocate() == 1);
+    BOOST_TEST(ids.allocate() == 2);
+    BOOST_TEST(ids.allocate() == 3);
+    ids.deallocate(2);
+    // the lowest vacant id is reused
+    BOOST_TEST(ids.allocate() == 2);
+    BOOST_TEST(ids.allocate() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(never_no_session_id) {
+    am::session_id_pool ids;
+    for (std::size_t i = 0; i != 100; ++i) {
+        BOOST_TEST(ids.allocate() != am::no_session_id);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(multi_thread) {
+    am::session_id_pool ids;
+    std::vector<std::vector<am::session_id_type>> allocated(4);
+    std::vector<std::thread> ths;
+    for (std::size_t t = 0; t != allocated.size(); ++t) {
+        ths.emplace_back(
+            [&, t] {
+                for (std::size_t i = 0; i != 1000; ++i) {
+                    allocated[t].push_back(ids.allocate());
+                    if (i % 2 == 1) {
+                        ids.deallocate(allocated[t].back());
+                        allocated[t].pop_back();
+                    }
+                }
+            }
+        );
+    }
+    for (auto& th : ths) th.join();
+    std::set<am::session_id_type> all;
+    for (auto const& v : allocated) all.insert(v.begin(), v.end());
+    BOOST_TEST(all.size() == 2000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
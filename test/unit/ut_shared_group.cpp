@@ -0,0 +1,117 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <map>
+#include <string>
+
+#include <broker/shared_group.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_shared_group)
+
+namespace am = async_mqtt;
+
+struct member {
+    std::string name;
+    std::size_t inflight;
+};
+
+inline std::size_t inflight(member const& m) {
+    return m.inflight;
+}
+
+BOOST_AUTO_TEST_CASE(empty) {
+    am::shared_group<member> gr;
+    BOOST_TEST(gr.empty());
+    BOOST_TEST(!gr.select(am::shared_strategy::round_robin, "t", inflight));
+    BOOST_TEST(!gr.select(am::shared_strategy::least_inflight, "t", inflight));
+    BOOST_TEST(!gr.select(am::shared_strategy::sticky, "t", inflight));
+}
+
+BOOST_AUTO_TEST_CASE(round_robin) {
+    am::shared_group<member> gr;
+    gr.members().push_back(member{"a", 0});
+    gr.members().push_back(member{"b", 0});
+    gr.members().push_back(member{"c", 0});
+
+    std::map<std::string, std::size_t> counts;
+    for (std::size_t i = 0; i != 30; ++i) {
+        ++counts[gr.select(am::shared_strategy::round_robin, "t", inflight)->name];
+    }
+    BOOST_TEST(counts["a"] == 10);
+    BOOST_TEST(counts["b"] == 10);
+    BOOST_TEST(counts["c"] == 10);
+}
+
+BOOST_AUTO_TEST_CASE(least_inflight) {
+    am::shared_group<member> gr;
+    gr.members().push_back(member{"a", 10});
+    gr.members().push_back(member{"b", 0});
+
+    for (std::size_t i = 0; i != 10; ++i) {
+        BOOST_TEST(gr.select(am::shared_strategy::least_inflight, "t", inflight)->name == "b");
+    }
+
+    gr.members().push_back(member{"c", 5});
+    for (std::size_t i = 0; i != 30; ++i) {
+        // the member that has the most inflight is never selected
+        BOOST_TEST(gr.select(am::shared_strategy::least_inflight, "t", inflight)->name != "a");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(single_member) {
+    am::shared_group<member> gr;
+    gr.members().push_back(member{"a", 3});
+    BOOST_TEST(gr.select(am::shared_strategy::round_robin, "t", inflight)->name == "a");
+    BOOST_TEST(gr.select(am::shared_strategy::least_inflight, "t", inflight)->name == "a");
+    BOOST_TEST(gr.select(am::shared_strategy::sticky, "t", inflight)->name == "a");
+}
+
+BOOST_AUTO_TEST_CASE(sticky) {
+    am::shared_group<member> gr;
+    gr.members().push_back(member{"a", 0});
+    gr.members().push_back(member{"b", 0});
+    gr.members().push_back(member{"c", 0});
+
+    auto t1 = gr.select(am::shared_strategy::sticky, "topic/1", inflight)->name;
+    auto t2 = gr.select(am::shared_strategy::sticky, "topic/2", inflight)->name;
+    for (std::size_t i = 0; i != 10; ++i) {
+        BOOST_TEST(gr.select(am::shared_strategy::sticky, "topic/1", inflight)->name == t1);
+        BOOST_TEST(gr.select(am::shared_strategy::sticky, "topic/2", inflight)->name == t2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(erase) {
+    am::shared_group<member> gr;
+    gr.members().push_back(member{"a", 0});
+    gr.members().push_back(member{"b", 0});
+    gr.members().push_back(member{"c", 0});
+
+    gr.erase(0);
+    BOOST_TEST(gr.members().size() == 2U);
+    BOOST_TEST(gr.members()[0].name == "c");
+    BOOST_TEST(gr.members()[1].name == "b");
+
+    gr.erase(1);
+    BOOST_TEST(gr.members().size() == 1U);
+    BOOST_TEST(gr.members()[0].name == "c");
+
+    gr.erase(0);
+    BOOST_TEST(gr.empty());
+}
+
+BOOST_AUTO_TEST_CASE(strategy_str) {
+    BOOST_TEST(*am::shared_strategy_from_str("round_robin") == am::shared_strategy::round_robin);
+    BOOST_TEST(*am::shared_strategy_from_str("least_inflight") == am::shared_strategy::least_inflight);
+    BOOST_TEST(*am::shared_strategy_from_str("sticky") == am::shared_strategy::sticky);
+    BOOST_TEST(!am::shared_strategy_from_str("random"));
+    BOOST_TEST(
+        std::string(am::shared_strategy_to_str(am::shared_strategy::least_inflight)) == "least_inflight"
+    );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
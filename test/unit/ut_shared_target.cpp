@@ -0,0 +1,203 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <map>
+#include <string>
+
+#include <broker/shared_target_impl.hpp>
+
+namespace ut_shared_target {
+struct ep {};
+} // namespace ut_shared_target
+
+namespace async_mqtt {
+
+// session_state that has only the members used by shared_target
+template <>
+struct session_state<ut_shared_target::ep> {
+    session_state(session_id_type id, std::string client_id)
+        :id{id},
+         cid{force_move(client_id)}
+    {}
+    session_id_type session_id() const {
+        return id;
+    }
+    std::string const& client_id() const {
+        return cid;
+    }
+    std::size_t get_outstanding_publish_count() const {
+        return 0;
+    }
+    session_id_type id;
+    std::string cid;
+};
+
+} // namespace async_mqtt
+
+BOOST_AUTO_TEST_SUITE(ut_shared_target)
+
+namespace am = async_mqtt;
+
+using ss_t = am::session_state<ep>;
+using sub_t = am::subscription<ep>;
+using group_t = am::shared_subscription_group<ep>;
+
+inline sub_t make_sub(ss_t& ss, std::string const& share_name, std::string const& topic_filter) {
+    return sub_t{
+        ss,
+        share_name,
+        am::interned_topic{topic_filter},
+        am::qos::at_least_once,
+        std::nullopt
+    };
+}
+
+struct matches {
+    std::size_t subs = 0;
+    // group -> the number of visits
+    std::map<group_t const*, std::size_t> groups;
+    // client_id -> the number of deliveries
+    std::map<std::string, std::size_t> delivered;
+};
+
+// same as broker::do_publish
+inline matches find(
+    am::sub_con_map<ep> const& subs_map,
+    am::shared_target<ep> const& targets,
+    std::string_view topic
+) {
+    matches ret;
+    subs_map.find(
+        topic,
+        [&](am::sub_con_key<ep> const&, am::sub_con_value<ep> const& value) {
+            if (auto const* sub = std::get_if<sub_t>(&value)) {
+                ++ret.subs;
+                ++ret.delivered[sub->ss.get().client_id()];
+            }
+            else {
+                auto const* gr = std::get<group_t const*>(value);
+                ++ret.groups[gr];
+                if (auto const* m = targets.select(*gr, topic)) {
+                    ++ret.delivered[m->ssr.get().client_id()];
+                }
+            }
+        }
+    );
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(shared_and_non_shared) {
+    am::sub_con_map<ep> subs_map;
+    am::shared_target<ep> targets;
+    ss_t ss1{1, "cid1"};
+    ss_t ss2{2, "cid2"};
+    ss_t ss3{3, "cid3"};
+
+    // non shared subscription and shared subscription on the same topic filter
+    subs_map.insert_or_assign(
+        "t/a",
+        am::sub_con_key<ep>{ss1.session_id()},
+        am::sub_con_value<ep>{make_sub(ss1, "", "t/a")}
+    );
+    BOOST_TEST(targets.insert(subs_map, "g", "t/a", make_sub(ss2, "g", "t/a"), ss2));
+    BOOST_TEST(targets.insert(subs_map, "g", "t/a", make_sub(ss3, "g", "t/a"), ss3));
+    // the group is one entry
+    BOOST_TEST(subs_map.size() == 2U);
+
+    for (std::size_t i = 0; i != 4; ++i) {
+        auto ret = find(subs_map, targets, "t/a");
+        BOOST_TEST(ret.subs == 1U);
+        BOOST_TEST(ret.groups.size() == 1U);
+        BOOST_TEST(ret.delivered["cid1"] == 1U);
+        BOOST_TEST(ret.delivered["cid2"] + ret.delivered["cid3"] == 1U);
+    }
+
+    // erasing the shared member doesn't affect the non shared subscription
+    BOOST_TEST(targets.erase(subs_map, "g", "t/a", ss2) == 1U);
+    auto ret = find(subs_map, targets, "t/a");
+    BOOST_TEST(ret.subs == 1U);
+    BOOST_TEST(ret.delivered["cid1"] == 1U);
+    BOOST_TEST(ret.delivered["cid3"] == 1U);
+    BOOST_TEST(ret.delivered.count("cid2") == 0U);
+}
+
+BOOST_AUTO_TEST_CASE(erase_last_member) {
+    am::sub_con_map<ep> subs_map;
+    am::shared_target<ep> targets;
+    ss_t ss1{1, "cid1"};
+    ss_t ss2{2, "cid2"};
+
+    BOOST_TEST(targets.insert(subs_map, "g", "t/a", make_sub(ss1, "g", "t/a"), ss1));
+    BOOST_TEST(targets.insert(subs_map, "g", "t/a", make_sub(ss2, "g", "t/a"), ss2));
+    // update the subscription of the existing member
+    BOOST_TEST(!targets.insert(subs_map, "g", "t/a", make_sub(ss2, "g", "t/a"), ss2));
+    BOOST_TEST(subs_map.size() == 1U);
+
+    BOOST_TEST(targets.erase(subs_map, "g", "t/a", ss1) == 1U);
+    BOOST_TEST(subs_map.size() == 1U);
+    BOOST_TEST(find(subs_map, targets, "t/a").delivered["cid2"] == 1U);
+
+    // the group is erased from subs_map with its last member
+    BOOST_TEST(targets.erase(subs_map, ss2) == 1U);
+    BOOST_TEST(subs_map.size() == 0U);
+    auto ret = find(subs_map, targets, "t/a");
+    BOOST_TEST(ret.groups.empty());
+    BOOST_TEST(ret.delivered.empty());
+
+    // erasing again is ignored
+    BOOST_TEST(targets.erase(subs_map, "g", "t/a", ss2) == 0U);
+
+    // the group is created again
+    BOOST_TEST(targets.insert(subs_map, "g", "t/a", make_sub(ss1, "g", "t/a"), ss1));
+    BOOST_TEST(subs_map.size() == 1U);
+    BOOST_TEST(find(subs_map, targets, "t/a").delivered["cid1"] == 1U);
+}
+
+BOOST_AUTO_TEST_CASE(overlapping_filters) {
+    am::sub_con_map<ep> subs_map;
+    am::shared_target<ep> targets;
+    ss_t ss1{1, "cid1"};
+    ss_t ss2{2, "cid2"};
+    ss_t ss3{3, "cid3"};
+
+    // (g, t/#) and (g, t/+) are different groups
+    for (auto* ss : {&ss1, &ss2, &ss3}) {
+        BOOST_TEST(targets.insert(subs_map, "g", "t/#", make_sub(*ss, "g", "t/#"), *ss));
+        BOOST_TEST(targets.insert(subs_map, "g", "t/+", make_sub(*ss, "g", "t/+"), *ss));
+    }
+    BOOST_TEST(targets.insert(subs_map, "h", "t/+", make_sub(ss1, "h", "t/+"), ss1));
+    BOOST_TEST(subs_map.size() == 3U);
+
+    for (std::size_t i = 0; i != 6; ++i) {
+        auto ret = find(subs_map, targets, "t/a");
+        // each group is visited exactly once and delivers to one member
+        BOOST_TEST(ret.groups.size() == 3U);
+        for (auto const& [gr, count] : ret.groups) {
+            BOOST_TEST(count == 1U);
+        }
+        std::size_t delivered = 0;
+        for (auto const& [cid, count] : ret.delivered) {
+            delivered += count;
+        }
+        BOOST_TEST(delivered == 3U);
+    }
+
+    // only (g, t/#) matches
+    auto ret = find(subs_map, targets, "t/a/b");
+    BOOST_TEST(ret.groups.size() == 1U);
+    BOOST_TEST(ret.groups.begin()->first->topic_filter == "t/#");
+
+    // erasing the session removes it from all groups
+    BOOST_TEST(targets.erase(subs_map, ss1) == 3U);
+    BOOST_TEST(subs_map.size() == 2U);
+    for (std::size_t i = 0; i != 6; ++i) {
+        BOOST_TEST(find(subs_map, targets, "t/a").delivered.count("cid1") == 0U);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
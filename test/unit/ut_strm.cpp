@@ -7,10 +7,19 @@
 #include "../common/test_main.hpp"
 #include "../common/global_fixture.hpp"
 
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
 #include <thread>
 
 #include <boost/asio.hpp>
 
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/socket.h>
+#endif // defined(__linux__)
+
 #include <async_mqtt/asio_bind/impl/stream.hpp>
 #include <async_mqtt/util/scope_guard.hpp>
 #include <async_mqtt/protocol/impl/buffer_to_packet_variant.ipp>
@@ -60,4 +69,93 @@ BOOST_AUTO_TEST_CASE(write_cont) {
     ioc.run();
 }
 
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+
+// The zerocopy write is partially sent and the wait for the socket buffer is canceled.
+// The packet is held until the kernel notifies the completion of the sent bytes.
+BOOST_AUTO_TEST_CASE(zerocopy_wait_error) {
+    as::io_context ioc;
+    auto guard{as::make_work_guard(ioc.get_executor())};
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+    auto on_finish = am::unique_scope_guard(
+        [&] {
+            guard.reset();
+            th.join();
+        }
+    );
+
+    as::ip::tcp::acceptor ac{ioc, as::ip::tcp::endpoint{as::ip::address_v4::loopback(), 0}};
+    ac.set_option(as::socket_base::receive_buffer_size(4096));
+    using strm_t = am::stream<as::ip::tcp::socket>;
+    strm_t s{ioc.get_executor()};
+    s.next_layer().connect(ac.local_endpoint());
+    s.next_layer().set_option(as::socket_base::send_buffer_size(4096));
+    // the peer doesn't read
+    auto peer = ac.accept();
+    s.set_zerocopy_write_threshold(1);
+
+    auto payload = std::make_shared<std::string>(4 * 1024 * 1024, 'A');
+    std::weak_ptr<std::string> wp = payload;
+    auto p = am::v3_1_1::publish_packet{
+        "topic1",
+        am::buffer{std::string_view{*payload}, payload},
+        am::qos::at_most_once
+    };
+    payload.reset();
+    auto fut = s.async_write_packet(p, as::as_tuple(as::use_future));
+    // the packet is copied into the operation
+    p = am::v3_1_1::publish_packet{"topic1", "", am::qos::at_most_once};
+
+    // wait until the socket buffer is full, then fail the wait
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    as::post(
+        s.get_executor(),
+        [&] {
+            s.next_layer().cancel();
+        }
+    );
+    auto [ec, size] = fut.get();
+    BOOST_TEST(ec == as::error::operation_aborted);
+
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!wp.expired() && std::chrono::steady_clock::now() < until) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BOOST_TEST(wp.expired());
+
+    // the payload is released after all notifications are received
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::promise<int> pr;
+    as::post(
+        s.get_executor(),
+        [&] {
+            char control[128];
+            ::msghdr msg{};
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            auto r = ::recvmsg(s.next_layer().native_handle(), &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+            pr.set_value(r < 0 ? errno : 0);
+        }
+    );
+    auto err = pr.get_future().get();
+    BOOST_TEST((err == EAGAIN || err == EWOULDBLOCK));
+
+    std::promise<void> closed;
+    as::post(
+        s.get_executor(),
+        [&] {
+            am::error_code ec;
+            s.next_layer().close(ec);
+            closed.set_value();
+        }
+    );
+    closed.get_future().get();
+}
+
+#endif // defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -6,6 +6,8 @@
 #include "../common/test_main.hpp"
 #include "../common/global_fixture.hpp"
 
+#include <set>
+
 #include <broker/subscription_map.hpp>
 
 BOOST_AUTO_TEST_SUITE(ut_subscription_map)
@@ -305,4 +307,49 @@ BOOST_AUTO_TEST_CASE( test_move_only ) {
     map.insert_or_assign("a/b/c", "456", my(2));
 }
 
+BOOST_AUTO_TEST_CASE( test_for_each_generation ) {
+    using mi_t = am::multiple_subscription_map<std::string, int>;
+    mi_t map;
+    auto gen = map.generation();
+
+    map.insert_or_assign("a/b/c", "123", 1);
+    BOOST_TEST(map.generation() != gen);
+    gen = map.generation();
+
+    // update doesn't change the generation
+    map.insert_or_assign("a/b/c", "123", 2);
+    BOOST_TEST(map.generation() == gen);
+
+    map.insert_or_assign("a/b/c", "456", 3);
+    map.insert_or_assign("a/#", "123", 4);
+    map.insert_or_assign("+/b", "456", 5);
+    BOOST_TEST(map.generation() != gen);
+
+    std::set<std::string> filters;
+    std::size_t values = 0;
+    map.for_each(
+        [&](mi_t::handle const& h, auto const& cont) {
+            filters.insert(map.handle_to_topic_filter(h));
+            values += cont.size();
+        }
+    );
+    BOOST_TEST((filters == std::set<std::string>{"a/b/c", "a/#", "+/b"}));
+    BOOST_TEST(values == 4);
+
+    gen = map.generation();
+    map.erase("a/#", "123");
+    BOOST_TEST(map.generation() != gen);
+    gen = map.generation();
+    map.erase("a/#", "123");
+    BOOST_TEST(map.generation() == gen);
+
+    filters.clear();
+    map.for_each(
+        [&](mi_t::handle const& h, auto const&) {
+            filters.insert(map.handle_to_topic_filter(h));
+        }
+    );
+    BOOST_TEST((filters == std::set<std::string>{"a/b/c", "+/b"}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
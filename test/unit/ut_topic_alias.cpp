@@ -55,6 +55,47 @@ BOOST_AUTO_TEST_CASE( send ) {
 
 }
 
+BOOST_AUTO_TEST_CASE( auto_map_lru ) {
+    am::topic_alias_send tas{2};
+    BOOST_TEST((*tas.auto_map("topic1") == std::make_pair(am::topic_alias_type(1), true)));
+    BOOST_TEST((*tas.auto_map("topic1") == std::make_pair(am::topic_alias_type(1), false)));
+    BOOST_TEST((*tas.auto_map("topic2") == std::make_pair(am::topic_alias_type(2), true)));
+    // remap the least recently used alias
+    BOOST_TEST((*tas.auto_map("topic3") == std::make_pair(am::topic_alias_type(1), true)));
+    BOOST_TEST(tas.find(1) == "topic3");
+    BOOST_TEST(!tas.find("topic1"));
+}
+
+BOOST_AUTO_TEST_CASE( auto_map_frequency ) {
+    am::topic_alias_send tas{2, am::topic_alias_send_policy::frequency};
+    // the first send is not mapped
+    BOOST_TEST(!tas.auto_map("topic1"));
+    BOOST_TEST((*tas.auto_map("topic1") == std::make_pair(am::topic_alias_type(1), true)));
+    BOOST_TEST((*tas.auto_map("topic1") == std::make_pair(am::topic_alias_type(1), false)));
+    BOOST_TEST(!tas.auto_map("topic2"));
+    BOOST_TEST((*tas.auto_map("topic2") == std::make_pair(am::topic_alias_type(2), true)));
+
+    // topic1:3 topic2:2
+    BOOST_TEST(!tas.auto_map("topic3"));
+    // topic3:2 is not more frequent than topic2:2
+    BOOST_TEST(!tas.auto_map("topic3"));
+    // topic3:3 takes the alias of topic2
+    BOOST_TEST((*tas.auto_map("topic3") == std::make_pair(am::topic_alias_type(2), true)));
+    BOOST_TEST(tas.find(2) == "topic3");
+    BOOST_TEST(!tas.find("topic2"));
+    BOOST_TEST(*tas.find("topic1") == 1);
+
+    // topic2 is counted from 2, so it needs 2 more sends to take the alias from topic1:3 or topic3:3
+    BOOST_TEST(!tas.auto_map("topic2"));
+    auto ta_opt = tas.auto_map("topic2");
+    BOOST_TEST(ta_opt.has_value());
+    BOOST_TEST(ta_opt->second);
+    BOOST_TEST(*tas.find("topic2") == ta_opt->first);
+
+    tas.clear();
+    BOOST_TEST(!tas.auto_map("topic1"));
+}
+
 BOOST_AUTO_TEST_CASE( recv ) {
     am::topic_alias_send tar{5};
     tar.insert_or_update("topic1", 1);
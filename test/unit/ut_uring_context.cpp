@@ -0,0 +1,200 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/predefined_layer/uring_context.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_uring_context)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+using cqe_type = std::pair<std::int32_t, std::uint32_t>;
+
+struct test_completion : am::detail::uring_completion {
+    explicit test_completion(std::vector<cqe_type>& cqes)
+        :cqes{cqes}
+    {}
+    void on_cqe(std::int32_t res, std::uint32_t flags) override {
+        cqes.emplace_back(res, flags);
+    }
+    std::vector<cqe_type>& cqes;
+};
+
+template <typename Pred>
+bool run_until(as::io_context& ioc, Pred const& pred) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > until) return false;
+        ioc.restart();
+        ioc.run_one_for(std::chrono::milliseconds(100));
+    }
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(invalid_recv_buf_count) {
+    as::io_context ioc;
+    BOOST_CHECK_THROW(
+        am::uring_context(ioc.get_executor(), 8, 16, 3),
+        am::system_error
+    );
+}
+
+BOOST_AUTO_TEST_CASE(recv_buffer_ring) {
+    as::io_context ioc;
+    // two receive buffers of 16 bytes
+    am::uring_context uctx{ioc.get_executor(), 8, 16, 2};
+    int sv[2];
+    BOOST_REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+    std::vector<cqe_type> cqes;
+    auto arm =
+        [&] {
+            uctx.submit(
+                new test_completion{cqes},
+                [&](io_uring_sqe& sqe) {
+                    sqe.opcode = IORING_OP_RECV;
+                    sqe.fd = sv[1];
+                    sqe.ioprio = IORING_RECV_MULTISHOT;
+                    sqe.flags = IOSQE_BUFFER_SELECT;
+                    sqe.buf_group = am::uring_context::buffer_group_id;
+                },
+                true
+            );
+        };
+    auto bid_of =
+        [](cqe_type const& cqe) {
+            BOOST_TEST(bool(cqe.second & IORING_CQE_F_BUFFER));
+            return static_cast<std::uint16_t>(cqe.second >> IORING_CQE_BUFFER_SHIFT);
+        };
+    auto send =
+        [&](std::string const& data) {
+            BOOST_TEST(::write(sv[0], data.data(), data.size()) == ssize_t(data.size()));
+        };
+
+    arm();
+    send(std::string(16, 'A'));
+    BOOST_TEST(run_until(ioc, [&] { return cqes.size() == 1; }));
+    BOOST_TEST(cqes[0].first == 16);
+    BOOST_TEST(bool(cqes[0].second & IORING_CQE_F_MORE));
+    auto bid0 = bid_of(cqes[0]);
+    BOOST_TEST(std::string(uctx.recv_buffer(bid0), 16) == std::string(16, 'A'));
+
+    send(std::string(16, 'B'));
+    BOOST_TEST(run_until(ioc, [&] { return cqes.size() == 2; }));
+    BOOST_TEST(cqes[1].first == 16);
+    auto bid1 = bid_of(cqes[1]);
+    BOOST_TEST(bid1 != bid0);
+    BOOST_TEST(std::string(uctx.recv_buffer(bid1), 16) == std::string(16, 'B'));
+
+    // all buffers are in use, the multishot receive is terminated
+    send(std::string(16, 'C'));
+    BOOST_TEST(run_until(ioc, [&] { return cqes.size() == 3; }));
+    BOOST_TEST(cqes[2].first == -ENOBUFS);
+    BOOST_TEST(!(cqes[2].second & IORING_CQE_F_MORE));
+
+    // the returned buffer is used by the next receive
+    bool notified = false;
+    uctx.wait_recv_buffer([&] { notified = true; });
+    uctx.return_recv_buffer(bid0);
+    BOOST_TEST(notified);
+    arm();
+    BOOST_TEST(run_until(ioc, [&] { return cqes.size() == 4; }));
+    BOOST_TEST(cqes[3].first == 16);
+    BOOST_TEST(bid_of(cqes[3]) == bid0);
+    BOOST_TEST(std::string(uctx.recv_buffer(bid0), 16) == std::string(16, 'C'));
+
+    ::close(sv[0]);
+    ::close(sv[1]);
+}
+
+BOOST_AUTO_TEST_CASE(submission_queue_full) {
+    as::io_context ioc;
+    // the submission queue has 2 entries
+    am::uring_context uctx{ioc.get_executor(), 2, 16, 2};
+
+    std::vector<cqe_type> cqes;
+    for (int i = 0; i != 64; ++i) {
+        uctx.submit(
+            new test_completion{cqes},
+            [](io_uring_sqe& sqe) {
+                sqe.opcode = IORING_OP_NOP;
+            }
+        );
+    }
+    BOOST_TEST(run_until(ioc, [&] { return cqes.size() == 64; }));
+    for (auto const& cqe : cqes) {
+        BOOST_TEST(cqe.first == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(plain_write_by_default) {
+    as::io_context ioc;
+    am::uring_context uctx{ioc.get_executor(), 8, 16, 2, 64, 2};
+    // zerocopy send is opt-in
+    BOOST_TEST(!uctx.fixed_write_buffers());
+    BOOST_TEST(uctx.acquire_write_buffer().has_value());
+}
+
+BOOST_AUTO_TEST_CASE(fixed_write_buffer) {
+    as::io_context ioc;
+    am::uring_context uctx{ioc.get_executor(), 8, 16, 2, 64, 2, true};
+    if (!uctx.fixed_write_buffers()) {
+        BOOST_TEST_MESSAGE("write buffers are not registered, skip");
+        return;
+    }
+
+    // zerocopy send requires TCP
+    as::ip::tcp::acceptor ac{ioc, as::ip::tcp::endpoint{as::ip::address_v4::loopback(), 0}};
+    as::ip::tcp::socket s1{ioc};
+    s1.connect(ac.local_endpoint());
+    auto s2 = ac.accept();
+
+    auto index = uctx.acquire_write_buffer();
+    BOOST_REQUIRE(index);
+    auto* p = uctx.write_buffer(*index);
+    std::memcpy(p, "hello", 5);
+
+    std::vector<cqe_type> cqes;
+    uctx.submit(
+        new test_completion{cqes},
+        [&](io_uring_sqe& sqe) {
+            sqe.opcode = IORING_OP_SEND_ZC;
+            sqe.fd = s1.native_handle();
+            sqe.addr = reinterpret_cast<std::uint64_t>(p);
+            sqe.len = 5;
+            sqe.msg_flags = MSG_NOSIGNAL;
+            sqe.ioprio = IORING_RECVSEND_FIXED_BUF;
+            sqe.buf_index = *index;
+        },
+        true
+    );
+    // the result and the notification
+    BOOST_TEST(run_until(ioc, [&] { return cqes.size() == 2; }));
+    BOOST_TEST(cqes[0].first == 5);
+    BOOST_TEST(bool(cqes[0].second & IORING_CQE_F_MORE));
+    BOOST_TEST(bool(cqes[1].second & IORING_CQE_F_NOTIF));
+    uctx.release_write_buffer(*index);
+
+    char buf[5];
+    as::read(s2, as::buffer(buf));
+    BOOST_TEST(std::string(buf, 5) == "hello");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
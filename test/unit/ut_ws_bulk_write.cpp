@@ -0,0 +1,214 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/endpoint.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/ws.hpp>
+#include <async_mqtt/util/scope_guard.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_ws_bulk_write)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+namespace bs = boost::beast;
+
+using ep_t = am::endpoint<am::role::client, am::protocol::ws>;
+
+// Beast's default is kept if bulk write is not enabled
+BOOST_AUTO_TEST_CASE(default_auto_fragment) {
+    as::io_context ioc;
+    auto ep = ep_t{
+        am::protocol_version::v3_1_1,
+        ioc.get_executor()
+    };
+    BOOST_TEST(ep.next_layer().auto_fragment());
+}
+
+// the concatenated packets are sent as one frame
+BOOST_AUTO_TEST_CASE(bulk_write) {
+    as::io_context ioc;
+    auto ep = ep_t{
+        am::protocol_version::v3_1_1,
+        ioc.get_executor()
+    };
+    ep.set_bulk_write(true);
+    BOOST_TEST(!ep.next_layer().auto_fragment());
+    ep.set_bulk_write(false);
+    BOOST_TEST(ep.next_layer().auto_fragment());
+}
+
+// read the WebSocket frames from the raw socket and return the payload size of each frame
+static std::vector<std::size_t> read_frames(as::ip::tcp::socket& s, std::size_t total) {
+    std::vector<std::size_t> frames;
+    std::size_t received = 0;
+    while (received != total) {
+        std::uint8_t hdr[2];
+        as::read(s, as::buffer(hdr));
+        std::uint64_t len = hdr[1] & 0x7f;
+        if (len == 126) {
+            std::uint8_t ext[2];
+            as::read(s, as::buffer(ext));
+            len = (std::uint64_t(ext[0]) << 8) | ext[1];
+        }
+        else if (len == 127) {
+            std::uint8_t ext[8];
+            as::read(s, as::buffer(ext));
+            len = 0;
+            for (auto b : ext) len = (len << 8) | b;
+        }
+        // the client masks the payload
+        std::uint8_t mask[4];
+        if (hdr[1] & 0x80) as::read(s, as::buffer(mask));
+        std::vector<char> payload(static_cast<std::size_t>(len));
+        as::read(s, as::buffer(payload));
+        frames.push_back(payload.size());
+        received += payload.size();
+    }
+    return frames;
+}
+
+// send the packets and return the payload size of each frame on the wire
+static std::vector<std::size_t> send_packets(bool bulk_write, std::size_t num, std::size_t payload_size) {
+    as::io_context ioc;
+    auto guard{as::make_work_guard(ioc.get_executor())};
+    std::thread th {
+        [&] {
+            ioc.run();
+        }
+    };
+    auto on_finish = am::unique_scope_guard(
+        [&] {
+            guard.reset();
+            th.join();
+        }
+    );
+
+    as::ip::tcp::acceptor ac{ioc, as::ip::tcp::endpoint{as::ip::address_v4::loopback(), 0}};
+    bs::websocket::stream<as::ip::tcp::socket> server{ioc};
+    auto fut_accept = ac.async_accept(server.next_layer(), as::as_tuple(as::use_future));
+
+    auto ep = ep_t{
+        am::protocol_version::v3_1_1,
+        ioc.get_executor()
+    };
+    ep.set_bulk_write(bulk_write);
+    auto fut_handshake = ep.async_underlying_handshake(
+        "127.0.0.1",
+        std::to_string(ac.local_endpoint().port()),
+        as::as_tuple(as::use_future)
+    );
+    {
+        auto [ec] = fut_accept.get();
+        BOOST_TEST(!ec);
+    }
+    {
+        // the WebSocket handshake is done by beast, then the frames are read from the raw socket
+        auto [ec] = server.async_accept(as::as_tuple(as::use_future)).get();
+        BOOST_TEST(!ec);
+    }
+    {
+        auto [ec] = fut_handshake.get();
+        BOOST_TEST(!ec);
+    }
+
+    auto p = am::v3_1_1::publish_packet{
+        "topic1",
+        std::string(payload_size, 'A'),
+        am::qos::at_most_once
+    };
+    std::vector<std::future<std::tuple<am::error_code>>> futs;
+    std::promise<void> sent;
+    // the packets are queued while the first packet is written
+    as::post(
+        ioc.get_executor(),
+        [&] {
+            for (std::size_t i = 0; i != num; ++i) {
+                futs.push_back(ep.async_send(p, as::as_tuple(as::use_future)));
+            }
+            sent.set_value();
+        }
+    );
+    auto frames = read_frames(server.next_layer(), p.size() * num);
+    sent.get_future().get();
+    for (auto& fut : futs) {
+        auto [ec] = fut.get();
+        BOOST_TEST(!ec);
+    }
+
+    std::promise<void> closed;
+    as::post(
+        ioc.get_executor(),
+        [&] {
+            am::error_code ec;
+            ep.lowest_layer().close(ec);
+            server.next_layer().close(ec);
+            closed.set_value();
+        }
+    );
+    closed.get_future().get();
+    return frames;
+}
+
+// Beast fragments each packet into write_buffer_bytes (4096) frames
+BOOST_AUTO_TEST_CASE(frames_auto_fragment) {
+    auto frames = send_packets(false, 3, 20000);
+    BOOST_TEST(frames.size() == 15U);
+}
+
+// each write is one frame that contains whole packets
+BOOST_AUTO_TEST_CASE(frames_bulk_write) {
+    auto p = am::v3_1_1::publish_packet{
+        "topic1",
+        std::string(20000, 'A'),
+        am::qos::at_most_once
+    };
+    auto frames = send_packets(true, 3, 20000);
+    BOOST_TEST(frames.size() <= 3U);
+    for (auto size : frames) {
+        BOOST_TEST(size % p.size() == 0U);
+    }
+}
+
+// the buffers for closing are reused
+BOOST_AUTO_TEST_CASE(read_buffer_pool) {
+    using pool = am::detail::ws_read_buffer_pool;
+    bs::flat_buffer const* addr = nullptr;
+    {
+        auto buf = pool::acquire();
+        addr = buf.get();
+        as::buffer_copy(buf->prepare(16), as::buffer(std::string(16, 'A')));
+        buf->commit(16);
+    }
+    auto before = pool::size();
+    BOOST_TEST(before >= 1U);
+    {
+        // the last returned buffer is reused, and it is cleared
+        auto buf = pool::acquire();
+        BOOST_TEST(buf.get() == addr);
+        BOOST_TEST(buf->size() == 0U);
+        BOOST_TEST(pool::size() == before - 1);
+    }
+    BOOST_TEST(pool::size() == before);
+    {
+        // the grown buffer is not returned
+        auto buf = pool::acquire();
+        buf->prepare(pool::max_capacity + 1);
+    }
+    BOOST_TEST(pool::size() == before - 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
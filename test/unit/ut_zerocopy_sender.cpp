@@ -0,0 +1,117 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../common/test_main.hpp"
+#include "../common/global_fixture.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/asio_bind/detail/zerocopy_sender.hpp>
+
+BOOST_AUTO_TEST_SUITE(ut_zerocopy_sender)
+
+namespace am = async_mqtt;
+namespace as = boost::asio;
+
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+
+template <typename Pred>
+bool wait_until(Pred const& pred) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > until) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+struct fixture {
+    fixture() {
+        s1.connect(ac.local_endpoint());
+        s2 = ac.accept();
+    }
+    as::io_context ioc;
+    as::ip::tcp::acceptor ac{ioc, as::ip::tcp::endpoint{as::ip::address_v4::loopback(), 0}};
+    as::ip::tcp::socket s1{ioc};
+    as::ip::tcp::socket s2{ioc};
+};
+
+BOOST_FIXTURE_TEST_CASE(hold_until_notified, fixture) {
+    am::detail::zerocopy_sender zc;
+    if (!zc.setup(s1.native_handle())) {
+        BOOST_TEST_MESSAGE("SO_ZEROCOPY is not available, skip");
+        return;
+    }
+    auto data = std::make_shared<std::string>(1024, 'A');
+    std::weak_ptr<std::string> wp = data;
+
+    am::error_code ec;
+    auto size = zc.send(as::buffer(*data), 0, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(size == data->size());
+    zc.hold(data);
+    data.reset();
+    BOOST_TEST(!wp.expired());
+    BOOST_TEST(zc.pending());
+
+    BOOST_TEST(wait_until([&] { return !zc.reap(true); }));
+    BOOST_TEST(wp.expired());
+    BOOST_TEST(!zc.pending());
+}
+
+// The peer resets the connection after the zerocopy send.
+// The lifetime is held, and the notification waiting is finished.
+BOOST_FIXTURE_TEST_CASE(hold_on_error, fixture) {
+    am::detail::zerocopy_sender zc;
+    if (!zc.setup(s1.native_handle())) {
+        BOOST_TEST_MESSAGE("SO_ZEROCOPY is not available, skip");
+        return;
+    }
+    auto data = std::make_shared<std::string>(1024, 'A');
+    std::weak_ptr<std::string> wp = data;
+
+    am::error_code ec;
+    zc.send(as::buffer(*data), 0, ec);
+    BOOST_TEST(!ec);
+
+    // send RST
+    s2.set_option(as::socket_base::linger{true, 0});
+    s2.close();
+    BOOST_TEST(
+        wait_until(
+            [&] {
+                zc.send(as::buffer(*data), 0, ec);
+                return ec && ec != as::error::would_block;
+            }
+        )
+    );
+    // the bytes sent before the error are still held
+    zc.hold(data);
+    data.reset();
+
+    // the waiting for wait_error is not repeated forever
+    BOOST_TEST(wait_until([&] { zc.reap(true); return !zc.pending(); }));
+
+    zc.reset();
+    BOOST_TEST(wp.expired());
+}
+
+#endif // defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+
+BOOST_AUTO_TEST_CASE(hold_without_send) {
+    am::detail::zerocopy_sender zc;
+    auto data = std::make_shared<int>(0);
+    zc.hold(data);
+    BOOST_TEST(data.use_count() == 1);
+    BOOST_TEST(!zc.pending());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 // (See accompanying file LICENSE_1_0.txt or copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 
+#include <functional>
 #include <thread>
 #include <fstream>
 #include <iostream>
@@ -16,6 +17,7 @@
 
 #if defined(ASYNC_MQTT_USE_TLS)
 #include <async_mqtt/asio_bind/predefined_layer/mqtts.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/mqtts_ktls.hpp>
 #endif // defined(ASYNC_MQTT_USE_TLS)
 
 #if defined(ASYNC_MQTT_USE_WS)
@@ -24,10 +26,32 @@
 
 #if defined(ASYNC_MQTT_USE_TLS) && defined(ASYNC_MQTT_USE_WS)
 #include <async_mqtt/asio_bind/predefined_layer/wss.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/wss_ktls.hpp>
 #endif // defined(ASYNC_MQTT_USE_TLS) && defined(ASYNC_MQTT_USE_WS)
 
+#if defined(ASYNC_MQTT_USE_URING)
+#include <async_mqtt/asio_bind/predefined_layer/uring.hpp>
+#endif // defined(ASYNC_MQTT_USE_URING)
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#include <async_mqtt/asio_bind/predefined_layer/uds.hpp>
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+#include <async_mqtt/asio_bind/predefined_layer/shm.hpp>
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+
+#include <async_mqtt/asio_bind/predefined_layer/inproc.hpp>
+
+#include <broker/endpoint_variant.hpp>
+#include <broker/broker.hpp>
+
 #include "locked_cout.hpp"
 
+#if defined(ASYNC_MQTT_USE_TLS)
+#include "handshake_storm.hpp"
+#endif // defined(ASYNC_MQTT_USE_TLS)
+
 namespace as = boost::asio;
 namespace am = async_mqtt;
 
@@ -47,7 +71,8 @@ enum class phase {
 enum class mode {
     single,
     send,
-    recv
+    recv,
+    handshake
 };
 
 enum class ev_type {
@@ -216,12 +241,26 @@ struct bench_context {
     std::optional<bool> tcp_no_delay_opt;
     std::optional<std::size_t> send_buf_size_opt;
     std::optional<std::size_t> recv_buf_size_opt;
+    std::function<void()> after_close;
 };
 
 template <typename ClientInfo>
 struct bench {
     using ep_type = typename ClientInfo::client_type;
     using next_layer_type = typename ep_type::next_layer_type;
+    // Unix domain socket and shared memory. host is the socket file path and port is not used.
+    static constexpr bool is_local =
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        std::is_same_v<
+            typename ep_type::lowest_layer_type,
+            am::protocol::mqtt_uds
+        >;
+#else  // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        false;
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    // In-process. It has already been connected to the embedded broker.
+    static constexpr bool is_inproc = std::is_same_v<next_layer_type, am::protocol::mqtt_inproc>;
+
     bench(
         std::vector<ClientInfo>& cis,
         bench_context& bc
@@ -281,9 +320,8 @@ private:
             }
 
             // Handshake underlying layer
-            yield pci->c.async_underlying_handshake(
-                pci->host,
-                pci->port,
+            yield async_underlying_handshake(
+                *pci,
                 as::append(
                     *this,
                     pci
@@ -294,23 +332,7 @@ private:
                 exit(-1);
             }
 
-            if (bc_.tcp_no_delay_opt) {
-                pci->c.lowest_layer().set_option(as::ip::tcp::no_delay(*bc_.tcp_no_delay_opt));
-            }
-            if (bc_.recv_buf_size_opt) {
-                pci->c.lowest_layer().set_option(
-                    as::socket_base::receive_buffer_size(
-                        boost::numeric_cast<int>(*bc_.recv_buf_size_opt)
-                    )
-                );
-            }
-            if (bc_.send_buf_size_opt) {
-                pci->c.lowest_layer().set_option(
-                    as::socket_base::send_buffer_size(
-                        boost::numeric_cast<int>(*bc_.send_buf_size_opt)
-                    )
-                );
-            }
+            apply_socket_opts(*pci);
 
             // MQTT connect send
             yield {
@@ -875,6 +897,7 @@ private:
                             for (auto& ci : cis_) {
                                 ci.c.async_close([]{});
                             }
+                            if (bc_.after_close) bc_.after_close();
                             for (auto& guard_ioc : bc_.guard_iocs) guard_ioc.reset();
                             bc_.guard_ioc_timer.reset();
                         }
@@ -1129,6 +1152,56 @@ private:
         }
     }
 
+    template <typename CompletionToken>
+    static void async_underlying_handshake(ClientInfo& ci, CompletionToken&& token) {
+        if constexpr (is_inproc) {
+            as::post(
+                ci.c.get_executor(),
+                as::append(
+                    std::forward<CompletionToken>(token),
+                    am::error_code{}
+                )
+            );
+        }
+        else if constexpr (is_local) {
+            ci.c.async_underlying_handshake(
+                ci.host,
+                std::forward<CompletionToken>(token)
+            );
+        }
+        else {
+            ci.c.async_underlying_handshake(
+                ci.host,
+                ci.port,
+                std::forward<CompletionToken>(token)
+            );
+        }
+    }
+
+    void apply_socket_opts(ClientInfo& ci) {
+        if constexpr (!is_inproc) {
+            if constexpr (!is_local) {
+                if (bc_.tcp_no_delay_opt) {
+                    ci.c.lowest_layer().set_option(as::ip::tcp::no_delay(*bc_.tcp_no_delay_opt));
+                }
+            }
+            if (bc_.recv_buf_size_opt) {
+                ci.c.lowest_layer().set_option(
+                    as::socket_base::receive_buffer_size(
+                        boost::numeric_cast<int>(*bc_.recv_buf_size_opt)
+                    )
+                );
+            }
+            if (bc_.send_buf_size_opt) {
+                ci.c.lowest_layer().set_option(
+                    as::socket_base::send_buffer_size(
+                        boost::numeric_cast<int>(*bc_.send_buf_size_opt)
+                    )
+                );
+            }
+        }
+    }
+
 private:
     std::vector<ClientInfo>& cis_;
     bench_context& bc_;
@@ -1158,7 +1231,8 @@ int main(int argc, char *argv[]) {
             (
                 "target",
                 boost::program_options::value<std::vector<std::string>>(),
-                "mqtt broker's hostname:port to connect. when you set this option  multiple times, "
+                "mqtt broker's hostname:port to connect. when protocol is mqtt_uds or mqtt_shm, set the socket file path. "
+                "when you set this option  multiple times, "
                 "then connect round robin for each client. "
                 "Note set as --target host1:1883 --target host2:1883, not --target host1:1883 host2:1883."
             )
@@ -1170,7 +1244,7 @@ int main(int argc, char *argv[]) {
             (
                 "protocol",
                 boost::program_options::value<std::string>()->default_value("mqtt"),
-                "mqtt mqtts ws wss"
+                "mqtt mqtts mqtts_ktls ws wss wss_ktls mqtt_uring mqtt_uds mqtt_shm mqtt_inproc"
             )
             (
                 "mqtt_version",
@@ -1282,6 +1356,16 @@ int main(int argc, char *argv[]) {
                 boost::program_options::value<bool>()->default_value(false),
                 "Set bulk write mode for all connections"
             )
+            (
+                "contiguous_write_threshold",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Packets (or concatenated packets on bulk write) up to this size are copied into one buffer before writing. 0 means disabled."
+            )
+            (
+                "zerocopy_write_threshold",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Packets from this size are sent with MSG_ZEROCOPY. Only for TCP (mqtt) on Linux. 0 means disabled."
+            )
             (
                 "clients",
                 boost::program_options::value<std::size_t>()->default_value(1),
@@ -1350,7 +1434,7 @@ int main(int argc, char *argv[]) {
             (
                 "cacert",
                 boost::program_options::value<std::string>(),
-                "CA Certificate file to verify server certificate for mqtts and wss connections"
+                "CA Certificate file to verify server certificate for mqtts, mqtts_ktls, wss, and wss_ktls connections"
             )
             (
                 "ws_path",
@@ -1360,10 +1444,34 @@ int main(int argc, char *argv[]) {
             (
                 "mode",
                 boost::program_options::value<std::string>()->default_value("single"),
-                "bench mode. [single|send|recv] "
+                "bench mode. [single|send|recv|handshake] "
                 "single is send/recv by bench. "
                 "send is publish only. payload contains timestamp. "
                 "recv is receive only. time is caluclated by timestamp. "
+                "handshake is TLS handshake storm. clients repeat connect, TLS handshake, and shutdown times. "
+                "protocol should be mqtts or mqtts_ktls. "
+            )
+            (
+                "tls_resume",
+                boost::program_options::value<bool>()->default_value(true),
+                "Resume the previous TLS session on reconnect. Only for the handshake mode and the storm."
+            )
+            (
+                "storm_target",
+                boost::program_options::value<std::string>(),
+                "TLS broker's hostname:port for the handshake storm that runs in the background of the measurement. "
+                "It is used to measure the effect of a connect storm to the established connections."
+            )
+            (
+                "storm_clients",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Number of clients of the background handshake storm. 0 means no storm."
+            )
+            (
+                "storm_times",
+                boost::program_options::value<std::size_t>()->default_value(1000),
+                "Number of handshakes for each client of the background handshake storm. "
+                "The storm is stopped when the measurement is finished."
             )
             (
                 "manager",
@@ -1530,8 +1638,14 @@ int main(int argc, char *argv[]) {
             return -1;
         }
 
+        auto protocol = vm["protocol"].as<std::string>();
         std::vector<am::host_port> hps;
         for (auto& t : target) {
+            if (protocol == "mqtt_uds" || protocol == "mqtt_shm") {
+                // target is the socket file path
+                hps.emplace_back(t, 0);
+                continue;
+            }
             auto hp_opt = am::host_port_from_string(t);
             if (hp_opt) {
                 hps.emplace_back(am::force_move(*hp_opt));
@@ -1544,7 +1658,6 @@ int main(int argc, char *argv[]) {
                 return -1;
             }
         }
-        auto protocol = vm["protocol"].as<std::string>();
         auto mqtt_version = vm["mqtt_version"].as<std::string>();
         auto qos = static_cast<am::qos>(vm["qos"].as<unsigned int>());
         auto retain =
@@ -1655,10 +1768,19 @@ int main(int argc, char *argv[]) {
         else if (md_str == "recv") {
             md = mode::recv;
         }
+        else if (md_str == "handshake") {
+            md = mode::handshake;
+            if (protocol != "mqtts" && protocol != "mqtts_ktls") {
+                std::cout
+                    << "mode handshake requires protocol mqtts or mqtts_ktls."
+                    << std::endl;
+                return -1;
+            }
+        }
         else {
             std::cout
                 << "invalid mode:" << md_str
-                << " mode should be [single|send|recv]."
+                << " mode should be [single|send|recv|handshake]."
                 << std::endl;
             return -1;
         }
@@ -1741,6 +1863,52 @@ int main(int argc, char *argv[]) {
         std::vector<as::io_context> iocs(num_of_iocs);
         BOOST_ASSERT(!iocs.empty());
 
+        if (md == mode::handshake) {
+#if defined(ASYNC_MQTT_USE_TLS)
+            // The TLS handshake is the same for mqtts and mqtts_ktls.
+            // kTLS is enabled after the handshake.
+            as::ssl::context ctx{as::ssl::context::tlsv12};
+            if (cacert) {
+                ctx.set_verify_mode(as::ssl::verify_peer);
+                ctx.load_verify_file(*cacert);
+            }
+            else {
+                ctx.set_verify_mode(as::ssl::verify_none);
+            }
+            handshake_storm hs{ctx, vm["tls_resume"].as<bool>()};
+            std::size_t hps_index = target_index;
+            for (std::size_t i = 0; i != clients; ++i) {
+                hs.add_client(
+                    iocs.at(i % num_of_iocs).get_executor(),
+                    hps[hps_index].host,
+                    std::to_string(hps[hps_index].port),
+                    times
+                );
+                ++hps_index;
+                if (hps_index == hps.size()) hps_index = 0;
+            }
+            std::cout << "Start handshake storm" << std::endl;
+            hs.start();
+            std::vector<std::thread> ths;
+            ths.reserve(num_of_iocs * threads_per_ioc);
+            for (auto& ioc : iocs) {
+                for (std::size_t i = 0; i != threads_per_ioc; ++i) {
+                    ths.emplace_back(
+                        [&] {
+                            ioc.run();
+                        }
+                    );
+                }
+            }
+            for (auto& th : ths) th.join();
+            hs.report();
+            return 0;
+#else  // defined(ASYNC_MQTT_USE_TLS)
+            std::cout << "ASYNC_MQTT_USE_TLS compiler option is required" << std::endl;
+            return -1;
+#endif // defined(ASYNC_MQTT_USE_TLS)
+        }
+
         std::vector<
             as::executor_work_guard<
                 as::io_context::executor_type
@@ -1962,11 +2130,59 @@ int main(int argc, char *argv[]) {
             }
         }
 
+#if defined(ASYNC_MQTT_USE_TLS)
+        // TLS handshake storm in the background of the measurement
+        as::io_context ioc_storm;
+        as::ssl::context storm_ctx{as::ssl::context::tlsv12};
+        std::optional<handshake_storm> storm;
+        if (auto storm_clients = vm["storm_clients"].as<std::size_t>(); storm_clients != 0) {
+            if (!vm.count("storm_target")) {
+                std::cout << "storm_clients requires storm_target" << std::endl;
+                return -1;
+            }
+            auto hp_opt = am::host_port_from_string(vm["storm_target"].as<std::string>());
+            if (!hp_opt) {
+                std::cout
+                    << "at option storm_target, invalid host:port is set:"
+                    << vm["storm_target"].as<std::string>()
+                    << std::endl;
+                return -1;
+            }
+            if (cacert) {
+                storm_ctx.set_verify_mode(as::ssl::verify_peer);
+                storm_ctx.load_verify_file(*cacert);
+            }
+            else {
+                storm_ctx.set_verify_mode(as::ssl::verify_none);
+            }
+            storm.emplace(storm_ctx, vm["tls_resume"].as<bool>());
+            for (std::size_t i = 0; i != storm_clients; ++i) {
+                storm->add_client(
+                    ioc_storm.get_executor(),
+                    hp_opt->host,
+                    std::to_string(hp_opt->port),
+                    vm["storm_times"].as<std::size_t>()
+                );
+            }
+        }
+#endif // defined(ASYNC_MQTT_USE_TLS)
+
         auto run_and_join =
             [&] {
                 if (progress_timer_sec > 0) {
                     tim_progress_proc();
                 }
+#if defined(ASYNC_MQTT_USE_TLS)
+                std::optional<std::thread> th_storm;
+                if (storm) {
+                    storm->start();
+                    th_storm.emplace(
+                        [&] {
+                            ioc_storm.run();
+                        }
+                    );
+                }
+#endif // defined(ASYNC_MQTT_USE_TLS)
                 std::thread th_progress_timer {
                     [&] {
                         ioc_progress_timer.run();
@@ -2010,6 +2226,13 @@ int main(int argc, char *argv[]) {
 
 
                 for (auto& th : ths) th.join();
+#if defined(ASYNC_MQTT_USE_TLS)
+                if (th_storm) {
+                    ioc_storm.stop();
+                    th_storm->join();
+                    storm->report();
+                }
+#endif // defined(ASYNC_MQTT_USE_TLS)
                 th_timer.join();
                 tim_progress->cancel();
                 th_progress_timer.join();
@@ -2114,6 +2337,8 @@ int main(int argc, char *argv[]) {
                     std::to_string(hps[hps_index].port)
                 );
                 cis.back().c.set_bulk_write(vm["bulk_write"].as<bool>());
+                cis.back().c.set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                cis.back().c.set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
                 ++hps_index;
                 if (hps_index == hps.size()) hps_index = 0;
             }
@@ -2180,6 +2405,81 @@ int main(int argc, char *argv[]) {
                     std::to_string(hps[hps_index].port)
                 );
                 cis.back().c.set_bulk_write(vm["bulk_write"].as<bool>());
+                cis.back().c.set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                cis.back().c.set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                ++hps_index;
+                if (hps_index == hps.size()) hps_index = 0;
+            }
+            auto b = bench(
+                cis,
+                bc
+            );
+            b();
+            run_and_join();
+            return 0;
+#else  // defined(ASYNC_MQTT_USE_TLS)
+            std::cout << "ASYNC_MQTT_USE_TLS compiler option is required" << std::endl;
+            return -1;
+#endif // defined(ASYNC_MQTT_USE_TLS)
+        }
+        else if (protocol == "mqtts_ktls") {
+#if defined(ASYNC_MQTT_USE_TLS)
+            struct client_info : client_info_base {
+                using client_type = am::endpoint<am::role::client, am::protocol::mqtts_ktls>;
+                client_info(
+                    client_type c,
+                    std::string cid_prefix,
+                    std::size_t index,
+                    std::size_t payload_size,
+                    std::size_t times,
+                    std::size_t idle_count,
+                    std::string host,
+                    std::string port
+                )
+                    :client_info_base{
+                        am::force_move(cid_prefix),
+                        index,
+                        payload_size,
+                        times,
+                        idle_count,
+                        am::force_move(host),
+                        am::force_move(port)
+                     },
+                     c{am::force_move(c)}
+                {
+                }
+                client_type c;
+            };
+
+            std::vector<client_info> cis;
+            cis.reserve(clients);
+            std::size_t hps_index = target_index;
+            for (std::size_t i = 0; i != clients; ++i) {
+                as::ssl::context ctx{as::ssl::context::tlsv12};
+                if (cacert) {
+                    ctx.set_verify_mode(as::ssl::verify_peer);
+                    ctx.load_verify_file(*cacert);
+                }
+                else {
+                    ctx.set_verify_mode(as::ssl::verify_none);
+                }
+                cis.emplace_back(
+                    client_info::client_type{
+                        version,
+                        as::make_strand(iocs.at(i % num_of_iocs).get_executor()),
+                        ctx
+                    },
+                    cid_prefix,
+                    i + start_index,
+                    payload_size,
+                    times,
+                    pub_idle_count,
+                    hps[hps_index].host,
+                    std::to_string(hps[hps_index].port)
+                );
+                cis.back().c.set_bulk_write(vm["bulk_write"].as<bool>());
+                cis.back().c.set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                cis.back().c.set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
                 ++hps_index;
                 if (hps_index == hps.size()) hps_index = 0;
             }
@@ -2242,6 +2542,8 @@ int main(int argc, char *argv[]) {
                     std::to_string(hps[hps_index].port)
                 );
                 cis.back().c.set_bulk_write(vm["bulk_write"].as<bool>());
+                cis.back().c.set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                cis.back().c.set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
                 ++hps_index;
                 if (hps_index == hps.size()) hps_index = 0;
             }
@@ -2313,6 +2615,81 @@ int main(int argc, char *argv[]) {
                     std::to_string(hps[hps_index].port)
                 );
                 cis.back().c.set_bulk_write(vm["bulk_write"].as<bool>());
+                cis.back().c.set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                cis.back().c.set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                ++hps_index;
+                if (hps_index == hps.size()) hps_index = 0;
+            }
+            auto b = bench(
+                cis,
+                bc
+            );
+            b();
+            run_and_join();
+            return 0;
+#else  // defined(ASYNC_MQTT_USE_TLS) && defined(ASYNC_MQTT_USE_WS)
+            std::cout << "ASYNC_MQTT_USE_TLS and ASYNC_MQTT_USE_WS compiler option are required" << std::endl;
+            return -1;
+#endif // defined(ASYNC_MQTT_USE_TLS) && defined(ASYNC_MQTT_USE_WS)
+        }
+        else if (protocol == "wss_ktls") {
+#if defined(ASYNC_MQTT_USE_TLS) && defined(ASYNC_MQTT_USE_WS)
+            struct client_info : client_info_base {
+                using client_type = am::endpoint<am::role::client, am::protocol::wss_ktls>;
+                client_info(
+                    client_type c,
+                    std::string cid_prefix,
+                    std::size_t index,
+                    std::size_t payload_size,
+                    std::size_t times,
+                    std::size_t idle_count,
+                    std::string host,
+                    std::string port
+                )
+                    :client_info_base{
+                        am::force_move(cid_prefix),
+                        index,
+                        payload_size,
+                        times,
+                        idle_count,
+                        am::force_move(host),
+                        am::force_move(port)
+                     },
+                     c{am::force_move(c)}
+                {
+                }
+                client_type c;
+            };
+
+            std::vector<client_info> cis;
+            cis.reserve(clients);
+            std::size_t hps_index = target_index;
+            for (std::size_t i = 0; i != clients; ++i) {
+                as::ssl::context ctx{as::ssl::context::tlsv12};
+                if (cacert) {
+                    ctx.set_verify_mode(as::ssl::verify_peer);
+                    ctx.load_verify_file(*cacert);
+                }
+                else {
+                    ctx.set_verify_mode(as::ssl::verify_none);
+                }
+                cis.emplace_back(
+                    client_info::client_type{
+                        version,
+                        as::make_strand(iocs.at(i % num_of_iocs).get_executor()),
+                        ctx
+                    },
+                    cid_prefix,
+                    i + start_index,
+                    payload_size,
+                    times,
+                    pub_idle_count,
+                    hps[hps_index].host,
+                    std::to_string(hps[hps_index].port)
+                );
+                cis.back().c.set_bulk_write(vm["bulk_write"].as<bool>());
+                cis.back().c.set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                cis.back().c.set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
                 ++hps_index;
                 if (hps_index == hps.size()) hps_index = 0;
             }
@@ -2328,8 +2705,290 @@ int main(int argc, char *argv[]) {
             return -1;
 #endif // defined(ASYNC_MQTT_USE_TLS) && defined(ASYNC_MQTT_USE_WS)
         }
+        else if (protocol == "mqtt_uring") {
+#if defined(ASYNC_MQTT_USE_URING)
+            struct client_info : client_info_base {
+                using client_type = am::endpoint<am::role::client, am::protocol::mqtt_uring>;
+                client_info(
+                    client_type c,
+                    std::string cid_prefix,
+                    std::size_t index,
+                    std::size_t payload_size,
+                    std::size_t times,
+                    std::size_t idle_count,
+                    std::string host,
+                    std::string port
+                )
+                    :client_info_base{
+                        am::force_move(cid_prefix),
+                        index,
+                        payload_size,
+                        times,
+                        idle_count,
+                        am::force_move(host),
+                        am::force_move(port)
+                     },
+                     c{am::force_move(c)}
+                {
+                }
+                client_type c;
+            };
+
+            // one io_uring instance per io_context
+            std::vector<std::unique_ptr<am::uring_context>> uctxs;
+            uctxs.reserve(num_of_iocs);
+            for (auto& ioc : iocs) {
+                uctxs.push_back(std::make_unique<am::uring_context>(ioc.get_executor()));
+            }
+            bc.after_close =
+                [&] {
+                    for (auto& uctx : uctxs) uctx->close();
+                };
+
+            std::vector<client_info> cis;
+            cis.reserve(clients);
+            std::size_t hps_index = target_index;
+            for (std::size_t i = 0; i != clients; ++i) {
+                cis.emplace_back(
+                    client_info::client_type{
+                        version,
+                        *uctxs.at(i % num_of_iocs),
+                        as::make_strand(iocs.at(i % num_of_iocs).get_executor())
+                    },
+                    cid_prefix,
+                    i + start_index,
+                    payload_size,
+                    times,
+                    pub_idle_count,
+                    hps[hps_index].host,
+                    std::to_string(hps[hps_index].port)
+                );
+                cis.back().c.set_bulk_write(vm["bulk_write"].as<bool>());
+                cis.back().c.set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                cis.back().c.set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                ++hps_index;
+                if (hps_index == hps.size()) hps_index = 0;
+            }
+            auto b = bench(
+                cis,
+                bc
+            );
+            b();
+            run_and_join();
+#else  // defined(ASYNC_MQTT_USE_URING)
+            std::cout << "ASYNC_MQTT_USE_URING compiler option is required" << std::endl;
+            return -1;
+#endif // defined(ASYNC_MQTT_USE_URING)
+        }
+        else if (protocol == "mqtt_uds") {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+            struct client_info : client_info_base {
+                using client_type = am::endpoint<am::role::client, am::protocol::mqtt_uds>;
+                client_info(
+                    client_type c,
+                    std::string cid_prefix,
+                    std::size_t index,
+                    std::size_t payload_size,
+                    std::size_t times,
+                    std::size_t idle_count,
+                    std::string host,
+                    std::string port
+                )
+                    :client_info_base{
+                        am::force_move(cid_prefix),
+                        index,
+                        payload_size,
+                        times,
+                        idle_count,
+                        am::force_move(host),
+                        am::force_move(port)
+                     },
+                     c{am::force_move(c)}
+                {
+                }
+                client_type c;
+            };
+
+            std::vector<client_info> cis;
+            cis.reserve(clients);
+            std::size_t hps_index = target_index;
+            for (std::size_t i = 0; i != clients; ++i) {
+                cis.emplace_back(
+                    client_info::client_type{
+                        version,
+                        as::make_strand(iocs.at(i % num_of_iocs).get_executor())
+                    },
+                    cid_prefix,
+                    i + start_index,
+                    payload_size,
+                    times,
+                    pub_idle_count,
+                    hps[hps_index].host,
+                    std::to_string(hps[hps_index].port)
+                );
+                cis.back().c.set_bulk_write(vm["bulk_write"].as<bool>());
+                cis.back().c.set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                cis.back().c.set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                ++hps_index;
+                if (hps_index == hps.size()) hps_index = 0;
+            }
+            auto b = bench(
+                cis,
+                bc
+            );
+            b();
+            run_and_join();
+#else  // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+            std::cout << "Unix domain socket is not supported on this platform" << std::endl;
+            return -1;
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        }
+        else if (protocol == "mqtt_shm") {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+            struct client_info : client_info_base {
+                using client_type = am::endpoint<am::role::client, am::protocol::mqtt_shm>;
+                client_info(
+                    client_type c,
+                    std::string cid_prefix,
+                    std::size_t index,
+                    std::size_t payload_size,
+                    std::size_t times,
+                    std::size_t idle_count,
+                    std::string host,
+                    std::string port
+                )
+                    :client_info_base{
+                        am::force_move(cid_prefix),
+                        index,
+                        payload_size,
+                        times,
+                        idle_count,
+                        am::force_move(host),
+                        am::force_move(port)
+                     },
+                     c{am::force_move(c)}
+                {
+                }
+                client_type c;
+            };
+
+            std::vector<client_info> cis;
+            cis.reserve(clients);
+            std::size_t hps_index = target_index;
+            for (std::size_t i = 0; i != clients; ++i) {
+                cis.emplace_back(
+                    client_info::client_type{
+                        version,
+                        as::make_strand(iocs.at(i % num_of_iocs).get_executor())
+                    },
+                    cid_prefix,
+                    i + start_index,
+                    payload_size,
+                    times,
+                    pub_idle_count,
+                    hps[hps_index].host,
+                    std::to_string(hps[hps_index].port)
+                );
+                cis.back().c.set_bulk_write(vm["bulk_write"].as<bool>());
+                cis.back().c.set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                cis.back().c.set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                ++hps_index;
+                if (hps_index == hps.size()) hps_index = 0;
+            }
+            auto b = bench(
+                cis,
+                bc
+            );
+            b();
+            run_and_join();
+#else  // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+            std::cout << "Shared memory is not supported on this platform" << std::endl;
+            return -1;
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+        }
+        else if (protocol == "mqtt_inproc") {
+            struct client_info : client_info_base {
+                using client_type = am::endpoint<am::role::client, am::protocol::mqtt_inproc>;
+                client_info(
+                    client_type c,
+                    std::string cid_prefix,
+                    std::size_t index,
+                    std::size_t payload_size,
+                    std::size_t times,
+                    std::size_t idle_count,
+                    std::string host,
+                    std::string port
+                )
+                    :client_info_base{
+                        am::force_move(cid_prefix),
+                        index,
+                        payload_size,
+                        times,
+                        idle_count,
+                        am::force_move(host),
+                        am::force_move(port)
+                     },
+                     c{am::force_move(c)}
+                {
+                }
+                client_type c;
+            };
+
+            // embedded broker. target is not used.
+            using epv_type = am::basic_endpoint_variant<
+                am::role::server,
+                2,
+                am::protocol::mqtt_inproc
+            >;
+            am::broker<epv_type> brk{ioc_timer.get_executor()};
+
+            std::vector<client_info> cis;
+            cis.reserve(clients);
+            std::size_t hps_index = target_index;
+            for (std::size_t i = 0; i != clients; ++i) {
+                cis.emplace_back(
+                    client_info::client_type{
+                        version,
+                        as::make_strand(iocs.at(i % num_of_iocs).get_executor())
+                    },
+                    cid_prefix,
+                    i + start_index,
+                    payload_size,
+                    times,
+                    pub_idle_count,
+                    hps[hps_index].host,
+                    std::to_string(hps[hps_index].port)
+                );
+                cis.back().c.set_bulk_write(vm["bulk_write"].as<bool>());
+                cis.back().c.set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                cis.back().c.set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                // connect before io_contexts run
+                auto epsp =
+                    std::make_shared<
+                        am::basic_endpoint<
+                            am::role::server,
+                            2,
+                            am::protocol::mqtt_inproc
+                        >
+                    >(
+                        am::protocol_version::undetermined,
+                        as::make_strand(iocs.at(i % num_of_iocs).get_executor())
+                    );
+                cis.back().c.next_layer().connect(epsp->next_layer());
+                epsp->underlying_accepted();
+                brk.handle_accept(epv_type{am::force_move(epsp)});
+                ++hps_index;
+                if (hps_index == hps.size()) hps_index = 0;
+            }
+            auto b = bench(
+                cis,
+                bc
+            );
+            b();
+            run_and_join();
+        }
         else {
-            std::cerr << "invalid protocol:" << protocol << " it should be mqtt, mqtts, ws, or wss" << std::endl;
+            std::cerr << "invalid protocol:" << protocol << " it should be mqtt, mqtts, mqtts_ktls, ws, wss, wss_ktls, mqtt_uring, mqtt_uds, mqtt_shm, or mqtt_inproc" << std::endl;
             return -1;
         }
 
@@ -5,6 +5,7 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 
 #include <fstream>
+#include <set>
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
@@ -19,6 +20,7 @@
 
 #if defined(ASYNC_MQTT_USE_TLS)
 #include <async_mqtt/asio_bind/predefined_layer/mqtts.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/mqtts_ktls.hpp>
 #endif // defined(ASYNC_MQTT_USE_TLS)
 
 #if defined(ASYNC_MQTT_USE_WS)
@@ -29,12 +31,29 @@ namespace bs = boost::beast;
 
 #if defined(ASYNC_MQTT_USE_TLS) && defined(ASYNC_MQTT_USE_WS)
 #include <async_mqtt/asio_bind/predefined_layer/wss.hpp>
+#include <async_mqtt/asio_bind/predefined_layer/wss_ktls.hpp>
 #endif // defined(ASYNC_MQTT_USE_TLS) && defined(ASYNC_MQTT_USE_WS)
 
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#include <filesystem>
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#endif // !defined(_WIN32)
+#include <async_mqtt/asio_bind/predefined_layer/uds.hpp>
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+#include <async_mqtt/asio_bind/predefined_layer/shm.hpp>
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+
 #include <broker/endpoint_variant.hpp>
 #include <broker/broker.hpp>
+#include <broker/bridge.hpp>
 #include <broker/constant.hpp>
 #include <broker/fixed_core_map.hpp>
+#if defined(ASYNC_MQTT_USE_TLS)
+#include <broker/tls_resumption.hpp>
+#endif // defined(ASYNC_MQTT_USE_TLS)
 
 namespace am = async_mqtt;
 namespace as = boost::asio;
@@ -43,10 +62,8 @@ namespace as = boost::asio;
 
 inline
 bool verify_certificate(
-    std::string const& verify_field,
     bool preverified,
-    as::ssl::verify_context& ctx,
-    std::shared_ptr<std::optional<std::string>> const& username) {
+    as::ssl::verify_context& ctx) {
 
     if (!preverified) return false;
 
@@ -58,13 +75,32 @@ bool verify_certificate(
             << ", message: " << X509_verify_cert_error_string(error);
         return false;
     }
+    return true;
+}
+
+// The username is taken from the client certificate after the handshake.
+// A resumed session has no verify callback call, but it keeps the client certificate.
+inline
+std::optional<std::string> get_username(
+    std::string const& verify_field,
+    SSL* ssl) {
+
+    auto cert = std::unique_ptr<X509, decltype(&X509_free)>(
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        SSL_get1_peer_certificate(ssl),
+#else  // OPENSSL_VERSION_NUMBER >= 0x30000000L
+        SSL_get_peer_certificate(ssl),
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+        &X509_free
+    );
+    if (!cert) return std::nullopt;
 
-    X509* cert = X509_STORE_CTX_get_current_cert(ctx.native_handle());
+    std::optional<std::string> username;
     std::string verify_field_value;
 
     if (verify_field == "subjectAltName") {
         // Extract Subject Alternative Name (DNS)
-        GENERAL_NAMES* san_names = static_cast<GENERAL_NAMES*>(X509_get_ext_d2i(cert, NID_subject_alt_name, nullptr, nullptr));
+        GENERAL_NAMES* san_names = static_cast<GENERAL_NAMES*>(X509_get_ext_d2i(cert.get(), NID_subject_alt_name, nullptr, nullptr));
         if (san_names) {
             int san_count = sk_GENERAL_NAME_num(san_names);
             for (int i = 0; i != san_count; ++i) {
@@ -74,7 +110,7 @@ bool verify_certificate(
                     int len = ASN1_STRING_length(current_name->d.dNSName);
                     verify_field_value.assign(reinterpret_cast<char const*>(dns_name), static_cast<std::size_t>(len));
                     ASYNC_MQTT_LOG("mqtt_broker", info) << "[clicrt] " << verify_field << ":DNS:" << verify_field_value;
-                    *username = verify_field_value;
+                    username = verify_field_value;
                     break; // the first SAN entry is used
                 }
             }
@@ -83,7 +119,7 @@ bool verify_certificate(
     }
     else {
         // Extract from Subject DN using provided field (e.g., "CN")
-        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME* name = X509_get_subject_name(cert.get());
         auto obj = std::unique_ptr<ASN1_OBJECT, decltype(&ASN1_OBJECT_free)>(
             OBJ_txt2obj(verify_field.c_str(), 0),
             &ASN1_OBJECT_free
@@ -99,11 +135,11 @@ bool verify_certificate(
             );
             verify_field_value.resize(static_cast<std::size_t>(std::max(size, 0)));
             ASYNC_MQTT_LOG("mqtt_broker", info) << "[clicrt] " << verify_field << ":" << verify_field_value;
-            *username = verify_field_value;
+            username = verify_field_value;
         }
     }
 
-    return true;
+    return username;
 }
 
 inline
@@ -144,6 +180,63 @@ std::shared_ptr<as::ssl::context> init_ctx(
 
 #endif // defined(ASYNC_MQTT_USE_TLS)
 
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+inline
+std::filesystem::perms parse_socket_perm(std::string const& name, std::string const& perm) {
+    if (perm.empty() ||
+        perm.size() > 4 ||
+        perm.find_first_not_of("01234567") != std::string::npos) {
+        throw std::runtime_error(
+            "An invalid " + name + " was specified: " + perm + " (octal e.g. 0660 is expected)"
+        );
+    }
+    auto value = std::stoul(perm, nullptr, 8);
+    if (value > 0777) {
+        throw std::runtime_error(
+            "An invalid " + name + " was specified: " + perm + " (0000 to 0777 is expected)"
+        );
+    }
+    return static_cast<std::filesystem::perms>(value);
+}
+
+inline
+void listen_socket_file(
+    as::local::stream_protocol::acceptor& ac,
+    std::string const& path,
+    std::optional<std::filesystem::perms> perm
+) {
+    // remove the socket file that is left by the previous run.
+    // the other kind of file is never removed.
+    std::error_code fec;
+    auto st = std::filesystem::symlink_status(path, fec);
+    if (std::filesystem::exists(st)) {
+        if (!std::filesystem::is_socket(st)) {
+            throw std::runtime_error(path + " exists and it is not a socket file");
+        }
+        std::filesystem::remove(path);
+    }
+
+    as::local::stream_protocol::endpoint ep{path};
+    ac.open(ep.protocol());
+    // bind creates the socket file with the permissions masked by umask,
+    // so the file is never accessible with the wider permissions.
+    // umask is process wide, it is restored just after bind.
+    std::optional<mode_t> prev_mask;
+    if (perm) {
+        prev_mask.emplace(::umask(static_cast<mode_t>(~static_cast<unsigned>(*perm) & 0777)));
+    }
+    boost::system::error_code ec;
+    ac.bind(ep, ec);
+    if (prev_mask) ::umask(*prev_mask);
+    if (ec) {
+        throw std::runtime_error("Failed to bind " + path + ": " + ec.message());
+    }
+    ac.listen();
+}
+
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
 inline
 void run_broker(boost::program_options::variables_map const& vm) {
     try {
@@ -160,11 +253,23 @@ void run_broker(boost::program_options::variables_map const& vm) {
 #if defined(ASYNC_MQTT_USE_TLS)
             ,
             am::protocol::mqtts
+            ,
+            am::protocol::mqtts_ktls
 #if defined(ASYNC_MQTT_USE_WS)
             ,
             am::protocol::wss
+            ,
+            am::protocol::wss_ktls
 #endif // defined(ASYNC_MQTT_USE_WS)
 #endif // defined(ASYNC_MQTT_USE_TLS)
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+            ,
+            am::protocol::mqtt_uds
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+            ,
+            am::protocol::mqtt_shm
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
         >;
 
         auto num_of_iocs =
@@ -262,9 +367,85 @@ void run_broker(boost::program_options::variables_map const& vm) {
                 }
             };
 
+#if defined(ASYNC_MQTT_USE_TLS)
+        // it must outlive the endpoints that refer the TLS contexts
+        am::tls_resumption tls_res{
+            vm["tls_session_cache_size"].as<std::size_t>(),
+            vm["tls_session_cache_shards"].as<std::size_t>(),
+            std::chrono::seconds{vm["tls_session_timeout"].as<std::size_t>()},
+            vm["tls_session_tickets"].as<bool>(),
+            std::chrono::seconds{vm["tls_ticket_key_rotation"].as<std::size_t>()}
+        };
+
+        // TLS handshake pool
+        // If tls_handshake_threads is 0, the TLS handshake runs on the connection's io_context.
+        // Otherwise, the handshake (OpenSSL computation) runs on the handshake pool in order not to
+        // delay the established connections on the same io_context during a connect storm.
+        // The socket stays on the connection's io_context. Only the handlers run on the pool.
+        auto tls_handshake_threads = vm["tls_handshake_threads"].as<std::size_t>();
+        std::optional<as::io_context> handshake_ioc;
+        std::optional<
+            as::executor_work_guard<
+                as::io_context::executor_type
+            >
+        > guard_handshake_ioc;
+        if (tls_handshake_threads != 0) {
+            handshake_ioc.emplace(boost::numeric_cast<int>(tls_handshake_threads));
+            guard_handshake_ioc.emplace(handshake_ioc->get_executor());
+        }
+        auto async_tls_handshake =
+            [&](auto& tls_layer, auto epsp, auto handler) {
+                if (!handshake_ioc) {
+                    tls_layer.async_handshake(
+                        as::ssl::stream_base::server,
+                        force_move(handler)
+                    );
+                    return;
+                }
+                tls_layer.async_handshake(
+                    as::ssl::stream_base::server,
+                    as::bind_executor(
+                        as::make_strand(handshake_ioc->get_executor()),
+                        [epsp, handler = force_move(handler)]
+                        (boost::system::error_code const& ec) mutable {
+                            // migrate to the connection's strand
+                            auto exe = epsp->get_executor();
+                            as::post(
+                                exe,
+                                as::append(
+                                    force_move(handler),
+                                    ec
+                                )
+                            );
+                        }
+                    )
+                );
+            };
+#endif // defined(ASYNC_MQTT_USE_TLS)
+
+        // Auth pool
+        // If auth_threads is 0, the password is verified on the connection's io_context.
+        // Otherwise, the SHA-256 calculation runs on the auth pool, and CONNACK is sent
+        // on the connection's strand.
+        auto auth_threads = vm["auth_threads"].as<std::size_t>();
+        std::optional<as::io_context> auth_ioc;
+        std::optional<
+            as::executor_work_guard<
+                as::io_context::executor_type
+            >
+        > guard_auth_ioc;
+        if (auth_threads != 0) {
+            auth_ioc.emplace(boost::numeric_cast<int>(auth_threads));
+            guard_auth_ioc.emplace(auth_ioc->get_executor());
+        }
+
         am::broker<
             epv_type
         > brk{timer_ioc.get_executor(), vm["recycling_allocator"].as<bool>()};
+        if (auth_ioc) {
+            brk.set_auth_executor(auth_ioc->get_executor());
+        }
+        brk.set_auth_cache_ttl(std::chrono::seconds{vm["auth_cache_ttl"].as<std::size_t>()});
 
         auto set_auth =
             [&] {
@@ -292,6 +473,148 @@ void run_broker(boost::program_options::variables_map const& vm) {
             };
         set_auth();
 
+        {
+            auto str = vm["shared_sub_strategy"].as<std::string>();
+            auto strategy = am::shared_strategy_from_str(str);
+            if (!strategy) {
+                throw std::runtime_error(
+                    "An invalid shared_sub_strategy was specified: " + str
+                );
+            }
+            brk.set_shared_sub_strategy(*strategy);
+        }
+        {
+            auto size = vm["retained_page_size"].as<std::size_t>();
+            if (size == 0) {
+                throw std::runtime_error(
+                    "retained_page_size must be greater than 0"
+                );
+            }
+            brk.set_retained_page_size(size);
+        }
+        {
+            auto str = vm["slow_consumer_policy"].as<std::string>();
+            auto policy = am::slow_consumer_policy_from_str(str);
+            if (!policy) {
+                throw std::runtime_error(
+                    "An invalid slow_consumer_policy was specified: " + str
+                );
+            }
+            brk.set_slow_consumer_policy(*policy);
+            brk.set_outbound_queue_limits(
+                vm["outbound_queue_session_max_bytes"].as<std::size_t>(),
+                vm["outbound_queue_session_max_messages"].as<std::size_t>(),
+                vm["outbound_queue_global_max_bytes"].as<std::size_t>(),
+                vm["outbound_queue_global_max_messages"].as<std::size_t>()
+            );
+            brk.set_offline_message_limits(
+                vm["offline_messages_session_max_bytes"].as<std::size_t>(),
+                vm["offline_messages_session_max_messages"].as<std::size_t>()
+            );
+        }
+        {
+            auto str = vm["topic_alias_send_policy"].as<std::string>();
+            if (str == "lru") {
+                brk.set_auto_map_topic_alias_send(am::topic_alias_send_policy::lru);
+            }
+            else if (str == "frequency") {
+                brk.set_auto_map_topic_alias_send(am::topic_alias_send_policy::frequency);
+            }
+            else if (str != "none") {
+                throw std::runtime_error(
+                    "An invalid topic_alias_send_policy was specified: " + str
+                );
+            }
+        }
+        {
+            auto interval = vm["metrics_interval"].as<std::size_t>();
+            std::optional<std::string> prometheus_file;
+            if (vm.count("prometheus_file")) {
+                prometheus_file.emplace(vm["prometheus_file"].as<std::string>());
+            }
+            if (interval != 0) {
+                brk.start_metrics(
+                    std::chrono::seconds(interval),
+                    vm["sys_topics"].as<bool>(),
+                    am::force_move(prometheus_file)
+                );
+            }
+        }
+
+        if (vm.count("bridge.user")) {
+            auto users = vm["bridge.user"].as<std::vector<std::string>>();
+            brk.set_bridge_users(std::set<std::string>(users.begin(), users.end()));
+        }
+
+        // Bridge
+        // The bridge clients run on bridge_ioc. The messages received from the peer brokers
+        // are published to brk on the bridge threads.
+        std::optional<as::io_context> bridge_ioc;
+        std::optional<am::bridge<am::broker<epv_type>>> brg;
+        if (vm.count("bridge.peer")) {
+            am::bridge_config config;
+            config.name = vm["bridge.name"].as<std::string>();
+            if (config.name.empty()) {
+                throw std::runtime_error(
+                    "bridge.name must be specified if bridge.peer is specified"
+                );
+            }
+            std::vector<std::string> topics{"#"};
+            if (vm.count("bridge.topic")) {
+                topics = vm["bridge.topic"].as<std::vector<std::string>>();
+            }
+            for (auto const& str : topics) {
+                auto bt = am::bridge_topic_from_str(str);
+                if (!bt) {
+                    throw std::runtime_error(
+                        "An invalid bridge.topic was specified: " + str
+                    );
+                }
+                config.topics.push_back(am::force_move(*bt));
+            }
+            if (vm.count("bridge.username")) {
+                config.username.emplace(vm["bridge.username"].as<std::string>());
+            }
+            if (vm.count("bridge.password")) {
+                config.password.emplace(vm["bridge.password"].as<std::string>());
+            }
+            config.receive_maximum = vm["bridge.receive_maximum"].as<std::uint16_t>();
+            if (config.receive_maximum == 0) {
+                throw std::runtime_error(
+                    "bridge.receive_maximum must be greater than 0"
+                );
+            }
+            config.bulk_write = vm["bridge.bulk_write"].as<bool>();
+            config.interest_interval =
+                std::chrono::milliseconds{vm["bridge.interest_interval"].as<std::size_t>()};
+            if (config.interest_interval == std::chrono::steady_clock::duration::zero()) {
+                throw std::runtime_error(
+                    "bridge.interest_interval must be greater than 0"
+                );
+            }
+
+            auto bridge_threads = vm["bridge.threads"].as<std::size_t>();
+            if (bridge_threads == 0) {
+                throw std::runtime_error(
+                    "bridge.threads must be greater than 0"
+                );
+            }
+            bridge_ioc.emplace(boost::numeric_cast<int>(bridge_threads));
+            brg.emplace(bridge_ioc->get_executor(), brk, am::force_move(config));
+            for (auto const& str : vm["bridge.peer"].as<std::vector<std::string>>()) {
+                auto pos = str.rfind(':');
+                if (pos == std::string::npos || pos == 0 || pos + 1 == str.size()) {
+                    throw std::runtime_error(
+                        "An invalid bridge.peer was specified: " + str
+                    );
+                }
+                ASYNC_MQTT_LOG("mqtt_broker", info)
+                    << "bridge.peer:" << str;
+                brg->add_peer(str.substr(0, pos), str.substr(pos + 1));
+            }
+            brg->start();
+        }
+
         if (vm.count("tcp.port")) {
             mqtt_endpoint.emplace(as::ip::tcp::v4(), vm["tcp.port"].as<std::uint16_t>());
             mqtt_ac.emplace(accept_ioc, *mqtt_endpoint);
@@ -309,6 +632,8 @@ void run_broker(boost::program_options::variables_map const& vm) {
                             as::make_strand(con_ioc_getter().get_executor())
                         );
                     epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                    epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                    epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
                     epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
                     auto& lowest_layer = epsp->lowest_layer();
                     mqtt_ac->async_accept(
@@ -332,6 +657,179 @@ void run_broker(boost::program_options::variables_map const& vm) {
             mqtt_async_accept();
         }
 
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        // mqtt_uds (MQTT on Unix domain socket)
+        std::optional<as::local::stream_protocol::acceptor> uds_ac;
+        std::function<void()> uds_async_accept;
+        auto apply_uds_socket_opts =
+            [&](auto& lowest_layer) {
+                // tcp_no_delay is not applicable
+                if (vm.count("recv_buf_size")) {
+                    lowest_layer.set_option(
+                        as::socket_base::receive_buffer_size(
+                            boost::numeric_cast<int>(vm["recv_buf_size"].as<std::size_t>())
+                        )
+                    );
+                }
+                if (vm.count("send_buf_size")) {
+                    lowest_layer.set_option(
+                        as::socket_base::send_buffer_size(
+                            boost::numeric_cast<int>(vm["send_buf_size"].as<std::size_t>())
+                        )
+                    );
+                }
+            };
+        if (vm.count("uds.path")) {
+            auto path = vm["uds.path"].as<std::string>();
+            std::optional<std::filesystem::perms> perm;
+            if (vm.count("uds.perm")) {
+                perm = parse_socket_perm("uds.perm", vm["uds.perm"].as<std::string>());
+            }
+            uds_ac.emplace(accept_ioc);
+            listen_socket_file(*uds_ac, path, perm);
+            ASYNC_MQTT_LOG("mqtt_broker", info)
+                << "UDS listen path:" << path;
+            uds_async_accept =
+                [&] {
+                    auto epsp =
+                        std::make_shared<
+                            am::basic_endpoint<
+                                am::role::server,
+                                2,
+                                am::protocol::mqtt_uds
+                            >
+                        >(
+                            am::protocol_version::undetermined,
+                            as::make_strand(con_ioc_getter().get_executor())
+                        );
+                    epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                    epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                    epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                    epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
+                    auto& lowest_layer = epsp->lowest_layer();
+                    uds_ac->async_accept(
+                        lowest_layer,
+                        [&uds_async_accept, &apply_uds_socket_opts, &lowest_layer, &brk, epsp]
+                        (boost::system::error_code const& ec) mutable {
+                            if (ec) {
+                                ASYNC_MQTT_LOG("mqtt_broker", error)
+                                    << "UDS accept error:" << ec.message();
+                            }
+                            else {
+                                apply_uds_socket_opts(lowest_layer);
+                                epsp->underlying_accepted();
+                                brk.handle_accept(epv_type{force_move(epsp)});
+                            }
+                            uds_async_accept();
+                        }
+                    );
+                };
+
+            uds_async_accept();
+        }
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+        // mqtt_shm (MQTT on shared memory)
+        // Unix domain socket is used to pass the shared memory from the client
+        std::optional<as::local::stream_protocol::acceptor> shm_ac;
+        std::function<void()> shm_async_accept;
+        if (vm.count("shm.path")) {
+            auto path = vm["shm.path"].as<std::string>();
+            std::optional<std::filesystem::perms> perm;
+            if (vm.count("shm.perm")) {
+                perm = parse_socket_perm("shm.perm", vm["shm.perm"].as<std::string>());
+            }
+            shm_ac.emplace(accept_ioc);
+            listen_socket_file(*shm_ac, path, perm);
+            ASYNC_MQTT_LOG("mqtt_broker", info)
+                << "SHM listen path:" << path;
+            shm_async_accept =
+                [&] {
+                    auto epsp =
+                        std::make_shared<
+                            am::basic_endpoint<
+                                am::role::server,
+                                2,
+                                am::protocol::mqtt_shm
+                            >
+                        >(
+                            am::protocol_version::undetermined,
+                            as::make_strand(con_ioc_getter().get_executor())
+                        );
+                    epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                    epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                    epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                    epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
+                    auto& lowest_layer = epsp->lowest_layer();
+                    shm_ac->async_accept(
+                        lowest_layer,
+                        [&shm_async_accept, &vm, &brk, epsp]
+                        (boost::system::error_code const& ec) mutable {
+                            if (ec) {
+                                ASYNC_MQTT_LOG("mqtt_broker", error)
+                                    << "SHM accept error:" << ec.message();
+                            }
+                            else {
+                                // the client that doesn't pass the shared memory is disconnected
+                                auto tim = std::make_shared<as::steady_timer>(epsp->get_executor());
+                                tim->expires_after(
+                                    std::chrono::seconds(vm["shm.accept_timeout"].as<std::size_t>())
+                                );
+                                tim->async_wait(
+                                    [wp = std::weak_ptr{epsp}]
+                                    (boost::system::error_code const& ec) {
+                                        if (ec) return;
+                                        if (auto sp = wp.lock()) {
+                                            ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                << "SHM channel accept timeout";
+                                            boost::system::error_code ec;
+                                            sp->lowest_layer().close(ec);
+                                        }
+                                    }
+                                );
+                                auto& layer = epsp->next_layer();
+                                layer.async_accept(
+                                    [&brk, epsp, tim]
+                                    (boost::system::error_code const& ec) mutable {
+                                        tim->cancel();
+                                        if (ec) {
+                                            ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                << "SHM channel accept error:" << ec.message();
+                                            return;
+                                        }
+                                        // The client doesn't send anything on the socket after passing
+                                        // the shared memory. The socket becomes readable when the client
+                                        // closes it or the client process dies, then the endpoint is closed.
+                                        // The rings can't tell the crash, so the endpoint without
+                                        // keep alive would be left forever.
+                                        auto& lowest_layer = epsp->lowest_layer();
+                                        lowest_layer.async_wait(
+                                            as::socket_base::wait_read,
+                                            [wp = std::weak_ptr{epsp}]
+                                            (boost::system::error_code const& ec) {
+                                                if (ec) return;
+                                                if (auto sp = wp.lock()) {
+                                                    ASYNC_MQTT_LOG("mqtt_broker", info)
+                                                        << "SHM peer closed the socket";
+                                                    sp->async_close(as::detached);
+                                                }
+                                            }
+                                        );
+                                        epsp->underlying_accepted();
+                                        brk.handle_accept(epv_type{force_move(epsp)});
+                                    }
+                                );
+                            }
+                            shm_async_accept();
+                        }
+                    );
+                };
+
+            shm_async_accept();
+        }
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS) && defined(__linux__)
+
 #if defined(ASYNC_MQTT_USE_WS)
         // ws (MQTT on WebSocket)
         std::optional<as::ip::tcp::endpoint> ws_endpoint;
@@ -354,6 +852,8 @@ void run_broker(boost::program_options::variables_map const& vm) {
                             as::make_strand(con_ioc_getter().get_executor())
                         );
                     epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                    epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                    epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
                     epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
                     auto& lowest_layer = epsp->lowest_layer();
                     ws_ac->async_accept(
@@ -455,80 +955,113 @@ void run_broker(boost::program_options::variables_map const& vm) {
                 vm["verify_field"].as<std::string>()
             );
         }
+        std::shared_ptr<as::ssl::context> mqtts_ctx;
+        std::function<std::shared_ptr<as::ssl::context>()> make_mqtts_ctx;
         if (vm.count("tls.port")) {
             mqtts_endpoint.emplace(as::ip::tcp::v4(), vm["tls.port"].as<std::uint16_t>());
             mqtts_ac.emplace(accept_ioc, *mqtts_endpoint);
-            mqtts_async_accept =
-                [&] {
+            // it is called again when the certificate is reloaded
+            make_mqtts_ctx =
+                [&vm, &tls_res] {
                     std::optional<std::string> verify_file;
                     if (vm.count("verify_file")) {
                         verify_file = vm["verify_file"].as<std::string>();
                     }
-                    auto mqtts_ctx = init_ctx(
+                    auto ctx = init_ctx(
                         vm["certificate"].as<std::string>(),
                         vm["private_key"].as<std::string>(),
                         verify_file
                     );
-                    // shared_ptr for username
-                    auto username = std::make_shared<std::optional<std::string>>();
-                    mqtts_ctx->set_verify_mode(as::ssl::verify_peer);
-                    mqtts_ctx->set_verify_callback(
-                        [username, &vm] // copy capture socket shared_ptr
+                    ctx->set_verify_mode(as::ssl::verify_peer);
+                    ctx->set_verify_callback(
+                        []
                         (bool preverified, boost::asio::ssl::verify_context& ctx) {
-                            // user can set username in the callback
-                            return
-                                verify_certificate(
-                                    vm["verify_field"].as<std::string>(),
-                                    preverified,
-                                    ctx,
-                                    username
-                                );
+                            return verify_certificate(preverified, ctx);
                         }
                     );
-                    auto epsp =
-                        std::make_shared<
-                            am::basic_endpoint<
-                                am::role::server,
-                                2,
-                               am::protocol::mqtts
-                            >
-                        >(
-                            am::protocol_version::undetermined,
-                            as::make_strand(con_ioc_getter().get_executor()),
-                            *mqtts_ctx
-                        );
-                    epsp->set_bulk_write(vm["bulk_write"].as<bool>());
-                    epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
-                    auto& lowest_layer = epsp->lowest_layer();
-                    mqtts_ac->async_accept(
-                        lowest_layer,
-                        [&mqtts_async_accept, &apply_socket_opts, &lowest_layer, &brk, epsp, username, mqtts_ctx]
-                        (boost::system::error_code const& ec) mutable {
-                            if (ec) {
-                                ASYNC_MQTT_LOG("mqtt_broker", error)
-                                    << "TCP accept error:" << ec.message();
-                            }
-                            else {
-                                // TBD insert underlying timeout here
-                                apply_socket_opts(lowest_layer);
-                                epsp->next_layer().async_handshake(
-                                    as::ssl::stream_base::server,
-                                    [&brk, epsp, username, mqtts_ctx]
-                                    (boost::system::error_code const& ec) mutable {
-                                        if (ec) {
-                                            ASYNC_MQTT_LOG("mqtt_broker", error)
-                                                << "TLS handshake error:" << ec.message();
-                                        }
-                                        else {
-                                            epsp->underlying_accepted();
-                                            brk.handle_accept(epv_type{force_move(epsp)}, *username);
-                                        }
+                    tls_res.attach(*ctx, "mqtts");
+                    return ctx;
+                };
+            // the context is shared by all connections in order to resume the TLS sessions
+            mqtts_ctx = make_mqtts_ctx();
+            mqtts_async_accept =
+                [&] {
+                    // the connection keeps the context that is used to create it
+                    // until the handshake is finished even if the context is rebuilt
+                    auto ctx = mqtts_ctx;
+                    auto accept =
+                        [&, ctx](auto epsp) {
+                            epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                            epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                            epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                            epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
+                            auto& lowest_layer = epsp->lowest_layer();
+                            mqtts_ac->async_accept(
+                                lowest_layer,
+                                [&mqtts_async_accept, &apply_socket_opts, &async_tls_handshake, &lowest_layer, &brk, &vm, &tls_res, epsp, ctx]
+                                (boost::system::error_code const& ec) mutable {
+                                    if (ec) {
+                                        ASYNC_MQTT_LOG("mqtt_broker", error)
+                                            << "TCP accept error:" << ec.message();
                                     }
-                                );
-                            }
-                            mqtts_async_accept();
-                        }
-                    );
+                                    else {
+                                        // TBD insert underlying timeout here
+                                        apply_socket_opts(lowest_layer);
+                                        async_tls_handshake(
+                                            epsp->next_layer(),
+                                            epsp,
+                                            [&brk, &vm, &tls_res, epsp, ctx]
+                                            (boost::system::error_code const& ec) mutable {
+                                                ctx.reset();
+                                                if (ec) {
+                                                    tls_res.handshake_failed();
+                                                    ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                        << "TLS handshake error:" << ec.message();
+                                                }
+                                                else {
+                                                    auto ssl = epsp->next_layer().native_handle();
+                                                    tls_res.handshake_succeeded(ssl);
+                                                    auto username = get_username(vm["verify_field"].as<std::string>(), ssl);
+                                                    epsp->underlying_accepted();
+                                                    brk.handle_accept(epv_type{force_move(epsp)}, force_move(username));
+                                                }
+                                            }
+                                        );
+                                    }
+                                    mqtts_async_accept();
+                                }
+                            );
+                        };
+                    if (vm["ktls"].as<bool>()) {
+                        accept(
+                            std::make_shared<
+                                am::basic_endpoint<
+                                    am::role::server,
+                                    2,
+                                   am::protocol::mqtts_ktls
+                                >
+                            >(
+                                am::protocol_version::undetermined,
+                                as::make_strand(con_ioc_getter().get_executor()),
+                                *ctx
+                            )
+                        );
+                    }
+                    else {
+                        accept(
+                            std::make_shared<
+                                am::basic_endpoint<
+                                    am::role::server,
+                                    2,
+                                   am::protocol::mqtts
+                                >
+                            >(
+                                am::protocol_version::undetermined,
+                                as::make_strand(con_ioc_getter().get_executor()),
+                                *ctx
+                            )
+                        );
+                    }
                 };
 
             mqtts_async_accept();
@@ -552,152 +1085,185 @@ void run_broker(boost::program_options::variables_map const& vm) {
                 vm["verify_field"].as<std::string>()
             );
         }
+        std::shared_ptr<as::ssl::context> wss_ctx;
+        std::function<std::shared_ptr<as::ssl::context>()> make_wss_ctx;
         if (vm.count("wss.port")) {
             wss_endpoint.emplace(as::ip::tcp::v4(), vm["wss.port"].as<std::uint16_t>());
             wss_ac.emplace(accept_ioc, *wss_endpoint);
-            wss_async_accept =
-                [&] {
+            // it is called again when the certificate is reloaded
+            make_wss_ctx =
+                [&vm, &tls_res] {
                     std::optional<std::string> verify_file;
                     if (vm.count("verify_file")) {
                         verify_file = vm["verify_file"].as<std::string>();
                     }
-                    auto wss_ctx = init_ctx(
+                    auto ctx = init_ctx(
                         vm["certificate"].as<std::string>(),
                         vm["private_key"].as<std::string>(),
                         verify_file
                     );
-                    // shared_ptr for username
-                    auto username = std::make_shared<std::optional<std::string>>();
-                    wss_ctx->set_verify_mode(as::ssl::verify_peer);
-                    wss_ctx->set_verify_callback(
-                        [username, &vm]
+                    ctx->set_verify_mode(as::ssl::verify_peer);
+                    ctx->set_verify_callback(
+                        []
                         (bool preverified, boost::asio::ssl::verify_context& ctx) {
-                            // user can set username in the callback
                             ASYNC_MQTT_LOG("mqtt_broker", trace)
                                 << "verify_callback preverified:" << preverified;
                             ASYNC_MQTT_LOG("mqtt_broker", trace)
                                 << "host_name_verification:"
                                 << as::ssl::host_name_verification("redboltz.net")(preverified, ctx);
-                            return
-                                verify_certificate(
-                                    vm["verify_field"].as<std::string>(),
-                                    preverified,
-                                    ctx,
-                                    username
-                                );
+                            return verify_certificate(preverified, ctx);
                         }
                     );
-                    auto epsp =
-                        std::make_shared<
-                            am::basic_endpoint<
-                                am::role::server,
-                                2,
-                               am::protocol::wss
-                            >
-                        >(
-                            am::protocol_version::undetermined,
-                            as::make_strand(con_ioc_getter().get_executor()),
-                            *wss_ctx
-                        );
-                    epsp->set_bulk_write(vm["bulk_write"].as<bool>());
-                    epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
-                    auto& lowest_layer = epsp->lowest_layer();
-                    wss_ac->async_accept(
-                        lowest_layer,
-                        [&wss_async_accept, &apply_socket_opts, &lowest_layer, &brk, epsp, username, wss_ctx]
-                        (boost::system::error_code const& ec) mutable {
-                            if (ec) {
-                                ASYNC_MQTT_LOG("mqtt_broker", error)
-                                    << "TCP accept error:" << ec.message();
-                            }
-                            else {
-                                ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: TCP connection accepted, starting TLS handshake";
-                                // TBD insert underlying timeout here
-                                apply_socket_opts(lowest_layer);
-                                epsp->next_layer().next_layer().async_handshake(
-                                    as::ssl::stream_base::server,
-                                    [&brk, epsp, username, wss_ctx]
-                                    (boost::system::error_code const& ec) mutable {
-                                        if (ec) {
-                                            ASYNC_MQTT_LOG("mqtt_broker", error)
-                                                << "TLS handshake error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
-                                        }
-                                        else {
-                                            ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: Waiting for HTTP upgrade request";
-                                            auto& ws_layer = epsp->next_layer();
-                                            auto sb = std::make_shared<boost::asio::streambuf>();
-                                            auto request =
-                                                std::make_shared<
-                                                    bs::http::request<
-                                                        bs::http::string_body
-                                                    >
-                                                >();
-                                            bs::http::async_read(
-                                                ws_layer.next_layer(),
-                                                *sb,
-                                                *request,
-                                                [&brk, epsp, &ws_layer, sb, request, username]
-                                                (boost::system::error_code const& ec, std::size_t) mutable {
-                                                    if (ec) {
-                                                        ASYNC_MQTT_LOG("mqtt_broker", error)
-                                                            << "HTTP upgrade error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
-                                                    }
-                                                    else if (bs::websocket::is_upgrade(*request)) {
-                                                        ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: HTTP upgrade request received, method: " << request->method_string() << ", target: " << request->target();
-                                                        for (
-                                                            auto it = request->find(bs::http::field::sec_websocket_protocol);
-                                                            it != request->end();
-                                                            ++it
-                                                        ) {
-                                                            if (it->value() == "mqtt") {
-                                                                ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: MQTT subprotocol found, setting response header";
-                                                                ws_layer.set_option(
-                                                                    bs::websocket::stream_base::decorator(
-                                                                        [
-                                                                            name = it->name(),  // enum
-                                                                            value = it->value() // string_view
-                                                                        ]
-                                                                        (bs::websocket::response_type& res) {
-                                                                            res.set(name, value);
+                    tls_res.attach(*ctx, "wss");
+                    return ctx;
+                };
+            // the context is shared by all connections in order to resume the TLS sessions
+            wss_ctx = make_wss_ctx();
+            wss_async_accept =
+                [&] {
+                    // the connection keeps the context that is used to create it
+                    // until the handshake is finished even if the context is rebuilt
+                    auto ctx = wss_ctx;
+                    auto accept =
+                        [&, ctx](auto epsp) {
+                            epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                            epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                            epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                            epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
+                            auto& lowest_layer = epsp->lowest_layer();
+                            wss_ac->async_accept(
+                                lowest_layer,
+                                [&wss_async_accept, &apply_socket_opts, &async_tls_handshake, &lowest_layer, &brk, &vm, &tls_res, epsp, ctx]
+                                (boost::system::error_code const& ec) mutable {
+                                    if (ec) {
+                                        ASYNC_MQTT_LOG("mqtt_broker", error)
+                                            << "TCP accept error:" << ec.message();
+                                    }
+                                    else {
+                                        ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: TCP connection accepted, starting TLS handshake";
+                                        // TBD insert underlying timeout here
+                                        apply_socket_opts(lowest_layer);
+                                        async_tls_handshake(
+                                            epsp->next_layer().next_layer(),
+                                            epsp,
+                                            [&brk, &vm, &tls_res, epsp, ctx]
+                                            (boost::system::error_code const& ec) mutable {
+                                                ctx.reset();
+                                                if (ec) {
+                                                    tls_res.handshake_failed();
+                                                    ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                        << "TLS handshake error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
+                                                }
+                                                else {
+                                                    auto ssl = epsp->next_layer().next_layer().native_handle();
+                                                    tls_res.handshake_succeeded(ssl);
+                                                    auto username = get_username(vm["verify_field"].as<std::string>(), ssl);
+                                                    ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: Waiting for HTTP upgrade request";
+                                                    auto& ws_layer = epsp->next_layer();
+                                                    auto sb = std::make_shared<boost::asio::streambuf>();
+                                                    auto request =
+                                                        std::make_shared<
+                                                            bs::http::request<
+                                                                bs::http::string_body
+                                                            >
+                                                        >();
+                                                    bs::http::async_read(
+                                                        ws_layer.next_layer(),
+                                                        *sb,
+                                                        *request,
+                                                        [&brk, epsp, &ws_layer, sb, request, username]
+                                                        (boost::system::error_code const& ec, std::size_t) mutable {
+                                                            if (ec) {
+                                                                ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                                    << "HTTP upgrade error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
+                                                            }
+                                                            else if (bs::websocket::is_upgrade(*request)) {
+                                                                ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: HTTP upgrade request received, method: " << request->method_string() << ", target: " << request->target();
+                                                                for (
+                                                                    auto it = request->find(bs::http::field::sec_websocket_protocol);
+                                                                    it != request->end();
+                                                                    ++it
+                                                                ) {
+                                                                    if (it->value() == "mqtt") {
+                                                                        ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: MQTT subprotocol found, setting response header";
+                                                                        ws_layer.set_option(
+                                                                            bs::websocket::stream_base::decorator(
+                                                                                [
+                                                                                    name = it->name(),  // enum
+                                                                                    value = it->value() // string_view
+                                                                                ]
+                                                                                (bs::websocket::response_type& res) {
+                                                                                    res.set(name, value);
+                                                                                }
+                                                                            )
+                                                                        );
+                                                                        break;
+                                                                    }
+                                                                }
+                                                                ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: Starting WebSocket accept";
+                                                                ws_layer.async_accept(
+                                                                    *request,
+                                                                    [&brk, epsp, username]
+                                                                    (boost::system::error_code const& ec) mutable {
+                                                                        if (ec) {
+                                                                            ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                                                << "WS accept error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
                                                                         }
-                                                                    )
+                                                                        else {
+                                                                            ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: WebSocket connection established successfully";
+                                                                            epsp->underlying_accepted();
+                                                                            brk.handle_accept(
+                                                                                epv_type{force_move(epsp)},
+                                                                                force_move(username)
+                                                                            );
+                                                                        }
+                                                                    }
                                                                 );
-                                                                break;
                                                             }
-                                                        }
-                                                        ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: Starting WebSocket accept";
-                                                        ws_layer.async_accept(
-                                                            *request,
-                                                            [&brk, epsp, username]
-                                                            (boost::system::error_code const& ec) mutable {
-                                                                if (ec) {
-                                                                    ASYNC_MQTT_LOG("mqtt_broker", error)
-                                                                        << "WS accept error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
-                                                                }
-                                                                else {
-                                                                    ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS: WebSocket connection established successfully";
-                                                                    epsp->underlying_accepted();
-                                                                    brk.handle_accept(
-                                                                        epv_type{force_move(epsp)},
-                                                                        *username
-                                                                    );
-                                                                }
+                                                            else {
+                                                                ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                                    << "HTTP upgrade error: non upgrade request received";
                                                             }
-                                                        );
-                                                    }
-                                                    else {
-                                                        ASYNC_MQTT_LOG("mqtt_broker", error)
-                                                            << "HTTP upgrade error: non upgrade request received";
-                                                    }
+                                                        }
+                                                    );
                                                 }
-                                            );
-                                        }
+                                            }
+                                        );
                                     }
-                                );
-                            }
-                            wss_async_accept();
-                        }
-                    );
+                                    wss_async_accept();
+                                }
+                            );
+                        };
+                    if (vm["ktls"].as<bool>()) {
+                        accept(
+                            std::make_shared<
+                                am::basic_endpoint<
+                                    am::role::server,
+                                    2,
+                                   am::protocol::wss_ktls
+                                >
+                            >(
+                                am::protocol_version::undetermined,
+                                as::make_strand(con_ioc_getter().get_executor()),
+                                *ctx
+                            )
+                        );
+                    }
+                    else {
+                        accept(
+                            std::make_shared<
+                                am::basic_endpoint<
+                                    am::role::server,
+                                    2,
+                                   am::protocol::wss
+                                >
+                            >(
+                                am::protocol_version::undetermined,
+                                as::make_strand(con_ioc_getter().get_executor()),
+                                *ctx
+                            )
+                        );
+                    }
                 };
 
             wss_async_accept();
@@ -709,140 +1275,225 @@ void run_broker(boost::program_options::variables_map const& vm) {
         std::function<void()> wss_vn_async_accept;
         std::optional<as::steady_timer> wss_vn_timer;
         wss_vn_timer.emplace(accept_ioc);
+        std::shared_ptr<as::ssl::context> wss_vn_ctx;
+        std::function<std::shared_ptr<as::ssl::context>()> make_wss_vn_ctx;
         if (vm.count("wss_vn.port")) {
             wss_vn_endpoint.emplace(as::ip::tcp::v4(), vm["wss_vn.port"].as<std::uint16_t>());
             wss_vn_ac.emplace(accept_ioc, *wss_vn_endpoint);
-            wss_vn_async_accept =
-                [&] {
+            // it is called again when the certificate is reloaded
+            make_wss_vn_ctx =
+                [&vm, &tls_res] {
                     std::optional<std::string> verify_file;
                     if (vm.count("verify_file")) {
                         verify_file = vm["verify_file"].as<std::string>();
                     }
-                    auto wss_vn_ctx = init_ctx(
+                    auto ctx = init_ctx(
                         vm["certificate"].as<std::string>(),
                         vm["private_key"].as<std::string>(),
                         verify_file
                     );
-                    // shared_ptr for username
-                    auto username = std::make_shared<std::optional<std::string>>();
-                    wss_vn_ctx->set_verify_mode(as::ssl::verify_none);
-                    auto epsp =
-                        std::make_shared<
-                            am::basic_endpoint<
-                                am::role::server,
-                                2,
-                               am::protocol::wss
-                            >
-                        >(
-                            am::protocol_version::undetermined,
-                            as::make_strand(con_ioc_getter().get_executor()),
-                            *wss_vn_ctx
-                        );
-                    epsp->set_bulk_write(vm["bulk_write"].as<bool>());
-                    epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
-                    auto& lowest_layer = epsp->lowest_layer();
-                    wss_vn_ac->async_accept(
-                        lowest_layer,
-                        [&wss_vn_async_accept, &apply_socket_opts, &lowest_layer, &brk, epsp, username, wss_vn_ctx]
-                        (boost::system::error_code const& ec) mutable {
-                            if (ec) {
-                                ASYNC_MQTT_LOG("mqtt_broker", error)
-                                    << "TCP accept error:" << ec.message();
-                            }
-                            else {
-                                ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): TCP connection accepted, starting TLS handshake";
-                                // TBD insert underlying timeout here
-                                apply_socket_opts(lowest_layer);
-                                epsp->next_layer().next_layer().async_handshake(
-                                    as::ssl::stream_base::server,
-                                    [&brk, epsp, username, wss_vn_ctx]
-                                    (boost::system::error_code const& ec) mutable {
-                                        if (ec) {
-                                            ASYNC_MQTT_LOG("mqtt_broker", error)
-                                                << "TLS handshake error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
-                                        }
-                                        else {
-                                            ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): Waiting for HTTP upgrade request";
-                                            auto& ws_layer = epsp->next_layer();
-                                            auto sb = std::make_shared<boost::asio::streambuf>();
-                                            auto request =
-                                                std::make_shared<
-                                                    bs::http::request<
-                                                        bs::http::string_body
-                                                    >
-                                                >();
-                                            bs::http::async_read(
-                                                ws_layer.next_layer(),
-                                                *sb,
-                                                *request,
-                                                [&brk, epsp, &ws_layer, sb, request, username]
-                                                (boost::system::error_code const& ec, std::size_t) mutable {
-                                                    if (ec) {
-                                                        ASYNC_MQTT_LOG("mqtt_broker", error)
-                                                            << "HTTP upgrade error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
-                                                    }
-                                                    else if (bs::websocket::is_upgrade(*request)) {
-                                                        ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): HTTP upgrade request received, method: " << request->method_string() << ", target: " << request->target();
-                                                        for (
-                                                            auto it = request->find(bs::http::field::sec_websocket_protocol);
-                                                            it != request->end();
-                                                            ++it
-                                                        ) {
-                                                            if (it->value() == "mqtt") {
-                                                                ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): MQTT subprotocol found, setting response header";
-                                                                ws_layer.set_option(
-                                                                    bs::websocket::stream_base::decorator(
-                                                                        [
-                                                                            name = it->name(),  // enum
-                                                                            value = it->value() // string_view
-                                                                        ]
-                                                                        (bs::websocket::response_type& res) {
-                                                                            res.set(name, value);
+                    ctx->set_verify_mode(as::ssl::verify_none);
+                    tls_res.attach(*ctx, "wss_vn");
+                    return ctx;
+                };
+            // the context is shared by all connections in order to resume the TLS sessions
+            wss_vn_ctx = make_wss_vn_ctx();
+            wss_vn_async_accept =
+                [&] {
+                    // the connection keeps the context that is used to create it
+                    // until the handshake is finished even if the context is rebuilt
+                    auto ctx = wss_vn_ctx;
+                    auto accept =
+                        [&, ctx](auto epsp) {
+                            epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                            epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                            epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
+                            epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
+                            auto& lowest_layer = epsp->lowest_layer();
+                            wss_vn_ac->async_accept(
+                                lowest_layer,
+                                [&wss_vn_async_accept, &apply_socket_opts, &async_tls_handshake, &lowest_layer, &brk, &tls_res, epsp, ctx]
+                                (boost::system::error_code const& ec) mutable {
+                                    if (ec) {
+                                        ASYNC_MQTT_LOG("mqtt_broker", error)
+                                            << "TCP accept error:" << ec.message();
+                                    }
+                                    else {
+                                        ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): TCP connection accepted, starting TLS handshake";
+                                        // TBD insert underlying timeout here
+                                        apply_socket_opts(lowest_layer);
+                                        async_tls_handshake(
+                                            epsp->next_layer().next_layer(),
+                                            epsp,
+                                            [&brk, &tls_res, epsp, ctx]
+                                            (boost::system::error_code const& ec) mutable {
+                                                ctx.reset();
+                                                if (ec) {
+                                                    tls_res.handshake_failed();
+                                                    ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                        << "TLS handshake error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
+                                                }
+                                                else {
+                                                    tls_res.handshake_succeeded(epsp->next_layer().next_layer().native_handle());
+                                                    ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): Waiting for HTTP upgrade request";
+                                                    auto& ws_layer = epsp->next_layer();
+                                                    auto sb = std::make_shared<boost::asio::streambuf>();
+                                                    auto request =
+                                                        std::make_shared<
+                                                            bs::http::request<
+                                                                bs::http::string_body
+                                                            >
+                                                        >();
+                                                    bs::http::async_read(
+                                                        ws_layer.next_layer(),
+                                                        *sb,
+                                                        *request,
+                                                        [&brk, epsp, &ws_layer, sb, request]
+                                                        (boost::system::error_code const& ec, std::size_t) mutable {
+                                                            if (ec) {
+                                                                ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                                    << "HTTP upgrade error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
+                                                            }
+                                                            else if (bs::websocket::is_upgrade(*request)) {
+                                                                ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): HTTP upgrade request received, method: " << request->method_string() << ", target: " << request->target();
+                                                                for (
+                                                                    auto it = request->find(bs::http::field::sec_websocket_protocol);
+                                                                    it != request->end();
+                                                                    ++it
+                                                                ) {
+                                                                    if (it->value() == "mqtt") {
+                                                                        ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): MQTT subprotocol found, setting response header";
+                                                                        ws_layer.set_option(
+                                                                            bs::websocket::stream_base::decorator(
+                                                                                [
+                                                                                    name = it->name(),  // enum
+                                                                                    value = it->value() // string_view
+                                                                                ]
+                                                                                (bs::websocket::response_type& res) {
+                                                                                    res.set(name, value);
+                                                                                }
+                                                                            )
+                                                                        );
+                                                                        break;
+                                                                    }
+                                                                }
+                                                                ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): Starting WebSocket accept";
+                                                                ws_layer.async_accept(
+                                                                    *request,
+                                                                    [&brk, epsp]
+                                                                    (boost::system::error_code const& ec) mutable {
+                                                                        if (ec) {
+                                                                            ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                                                << "WS accept error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
                                                                         }
-                                                                    )
+                                                                        else {
+                                                                            ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): WebSocket connection established successfully";
+                                                                            epsp->underlying_accepted();
+                                                                            brk.handle_accept(
+                                                                                epv_type{force_move(epsp)}
+                                                                            );
+                                                                        }
+                                                                    }
                                                                 );
-                                                                break;
                                                             }
-                                                        }
-                                                        ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): Starting WebSocket accept";
-                                                        ws_layer.async_accept(
-                                                            *request,
-                                                            [&brk, epsp, username]
-                                                            (boost::system::error_code const& ec) mutable {
-                                                                if (ec) {
-                                                                    ASYNC_MQTT_LOG("mqtt_broker", error)
-                                                                        << "WS accept error: " << ec.message() << " (category: " << ec.category().name() << ", value: " << ec.value() << ")";
-                                                                }
-                                                                else {
-                                                                    ASYNC_MQTT_LOG("mqtt_broker", trace) << "WSS(verify_none): WebSocket connection established successfully";
-                                                                    epsp->underlying_accepted();
-                                                                    brk.handle_accept(
-                                                                        epv_type{force_move(epsp)},
-                                                                        *username
-                                                                    );
-                                                                }
+                                                            else {
+                                                                ASYNC_MQTT_LOG("mqtt_broker", error)
+                                                                    << "HTTP upgrade error: non upgrade request received";
                                                             }
-                                                        );
-                                                    }
-                                                    else {
-                                                        ASYNC_MQTT_LOG("mqtt_broker", error)
-                                                            << "HTTP upgrade error: non upgrade request received";
-                                                    }
+                                                        }
+                                                    );
                                                 }
-                                            );
-                                        }
+                                            }
+                                        );
                                     }
-                                );
-                            }
-                            wss_vn_async_accept();
-                        }
-                    );
+                                    wss_vn_async_accept();
+                                }
+                            );
+                        };
+                    if (vm["ktls"].as<bool>()) {
+                        accept(
+                            std::make_shared<
+                                am::basic_endpoint<
+                                    am::role::server,
+                                    2,
+                                   am::protocol::wss_ktls
+                                >
+                            >(
+                                am::protocol_version::undetermined,
+                                as::make_strand(con_ioc_getter().get_executor()),
+                                *ctx
+                            )
+                        );
+                    }
+                    else {
+                        accept(
+                            std::make_shared<
+                                am::basic_endpoint<
+                                    am::role::server,
+                                    2,
+                                   am::protocol::wss
+                                >
+                            >(
+                                am::protocol_version::undetermined,
+                                as::make_strand(con_ioc_getter().get_executor()),
+                                *ctx
+                            )
+                        );
+                    }
                 };
 
             wss_vn_async_accept();
         }
 
 #endif // defined(ASYNC_MQTT_USE_WS)
+
+        // TLS handshake and resumption counters
+        as::steady_timer tls_stats_timer{timer_ioc};
+        std::function<void()> tls_stats_output;
+        if (auto interval = vm["tls_stats_interval"].as<std::size_t>(); interval != 0) {
+            tls_stats_output =
+                [&, interval] {
+                    tls_stats_timer.expires_after(std::chrono::seconds{interval});
+                    tls_stats_timer.async_wait(
+                        [&](boost::system::error_code const& ec) {
+                            if (ec) return;
+                            ASYNC_MQTT_LOG("mqtt_broker", info)
+                                << "TLS " << tls_res.stats();
+                            tls_stats_output();
+                        }
+                    );
+                };
+            tls_stats_output();
+        }
+#endif // defined(ASYNC_MQTT_USE_TLS)
+
+        // Rebuild the TLS contexts in order to load the renewed certificate and private key.
+        // It runs on accept_ioc, so no connection is created during the rebuild.
+        // The established connections are not affected.
+        std::function<void()> reload_tls_ctx;
+#if defined(ASYNC_MQTT_USE_TLS)
+        reload_tls_ctx =
+            [&] {
+                auto reload =
+                    [](std::string_view name, auto& ctx, auto const& make_ctx) {
+                        if (!make_ctx) return;
+                        try {
+                            ctx = make_ctx();
+                            ASYNC_MQTT_LOG("mqtt_broker", info)
+                                << "TLS context of " << name << " is reloaded";
+                        }
+                        catch (std::exception const& e) {
+                            // keep the current context
+                            ASYNC_MQTT_LOG("mqtt_broker", error)
+                                << "Failed to reload TLS context of " << name << ":" << e.what();
+                        }
+                    };
+                reload("tls", mqtts_ctx, make_mqtts_ctx);
+#if defined(ASYNC_MQTT_USE_WS)
+                reload("wss", wss_ctx, make_wss_ctx);
+                reload("wss_vn", wss_vn_ctx, make_wss_vn_ctx);
+#endif // defined(ASYNC_MQTT_USE_WS)
+            };
 #endif // defined(ASYNC_MQTT_USE_TLS)
 
         std::thread th_accept {
@@ -899,6 +1550,64 @@ void run_broker(boost::program_options::variables_map const& vm) {
             ++ioc_index;
         }
 
+#if defined(ASYNC_MQTT_USE_TLS)
+        std::vector<std::thread> ts_handshake;
+        if (handshake_ioc) {
+            ts_handshake.reserve(tls_handshake_threads);
+            for (std::size_t i = 0; i != tls_handshake_threads; ++i) {
+                ts_handshake.emplace_back(
+                    [&handshake_ioc] {
+                        try {
+                            handshake_ioc->run();
+                        }
+                        catch (std::exception const& e) {
+                            ASYNC_MQTT_LOG("mqtt_broker", error)
+                                << "th handshake exception:" << e.what();
+                        }
+                        ASYNC_MQTT_LOG("mqtt_broker", trace) << "handshake_ioc.run() finished";
+                    }
+                );
+            }
+        }
+#endif // defined(ASYNC_MQTT_USE_TLS)
+
+        std::vector<std::thread> ts_auth;
+        ts_auth.reserve(auth_threads);
+        for (std::size_t i = 0; i != auth_threads; ++i) {
+            ts_auth.emplace_back(
+                [&auth_ioc] {
+                    try {
+                        auth_ioc->run();
+                    }
+                    catch (std::exception const& e) {
+                        ASYNC_MQTT_LOG("mqtt_broker", error)
+                            << "th auth exception:" << e.what();
+                    }
+                    ASYNC_MQTT_LOG("mqtt_broker", trace) << "auth_ioc.run() finished";
+                }
+            );
+        }
+
+        std::vector<std::thread> ts_bridge;
+        if (bridge_ioc) {
+            auto bridge_threads = vm["bridge.threads"].as<std::size_t>();
+            ts_bridge.reserve(bridge_threads);
+            for (std::size_t i = 0; i != bridge_threads; ++i) {
+                ts_bridge.emplace_back(
+                    [&bridge_ioc] {
+                        try {
+                            bridge_ioc->run();
+                        }
+                        catch (std::exception const& e) {
+                            ASYNC_MQTT_LOG("mqtt_broker", error)
+                                << "th bridge exception:" << e.what();
+                        }
+                        ASYNC_MQTT_LOG("mqtt_broker", trace) << "bridge_ioc.run() finished";
+                    }
+                );
+            }
+        }
+
         as::io_context ioc_signal;
         as::signal_set signals{
             ioc_signal,
@@ -910,7 +1619,7 @@ void run_broker(boost::program_options::variables_map const& vm) {
 #endif // !defined(_WIN32)
         };
         std::function<void(boost::system::error_code const&, int num)> handle_signal
-            = [&set_auth, &signals, &handle_signal] (
+            = [&set_auth, &reload_tls_ctx, &accept_ioc, &signals, &handle_signal] (
                 boost::system::error_code const& ec,
                 int num
             ) {
@@ -923,8 +1632,9 @@ void run_broker(boost::program_options::variables_map const& vm) {
 #if !defined(_WIN32)
                     else if (num == SIGUSR1) {
                         ASYNC_MQTT_LOG("mqtt_broker", trace)
-                            << "Signal " << num << " received. Update auth information";
+                            << "Signal " << num << " received. Update auth information and TLS certificate";
                         set_auth();
+                        if (reload_tls_ctx) as::post(accept_ioc, reload_tls_ctx);
                         signals.async_wait(handle_signal);
                     }
 #endif // !defined(_WIN32)
@@ -947,9 +1657,24 @@ void run_broker(boost::program_options::variables_map const& vm) {
         ASYNC_MQTT_LOG("mqtt_broker", trace) << "th_accept joined";
 
         for (auto& g : guard_con_iocs) g.reset();
+#if defined(ASYNC_MQTT_USE_TLS)
+        guard_handshake_ioc.reset();
+        for (auto& t : ts_handshake) t.join();
+        ASYNC_MQTT_LOG("mqtt_broker", trace) << "ts_handshake joined";
+#endif // defined(ASYNC_MQTT_USE_TLS)
+
         for (auto& t : ts) t.join();
         ASYNC_MQTT_LOG("mqtt_broker", trace) << "ts joined";
 
+        guard_auth_ioc.reset();
+        for (auto& t : ts_auth) t.join();
+        ASYNC_MQTT_LOG("mqtt_broker", trace) << "ts_auth joined";
+
+        // The bridge timers wait forever, so bridge_ioc is stopped explicitly.
+        if (bridge_ioc) bridge_ioc->stop();
+        for (auto& t : ts_bridge) t.join();
+        ASYNC_MQTT_LOG("mqtt_broker", trace) << "ts_bridge joined";
+
         guard_timer_ioc.reset();
         th_timer.join();
         ASYNC_MQTT_LOG("mqtt_broker", trace) << "th_timer joined";
@@ -1010,6 +1735,16 @@ int main(int argc, char *argv[]) {
                 boost::program_options::value<bool>()->default_value(false),
                 "Set bulk write mode for all connections"
             )
+            (
+                "contiguous_write_threshold",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Packets (or concatenated packets on bulk write) up to this size are copied into one buffer before writing. 0 means disabled."
+            )
+            (
+                "zerocopy_write_threshold",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Packets from this size are sent with MSG_ZEROCOPY. Only for TCP (mqtt) on Linux. 0 means disabled."
+            )
             (
                 "read_buf_size",
                 boost::program_options::value<std::size_t>()->default_value(65536),
@@ -1033,12 +1768,12 @@ int main(int argc, char *argv[]) {
             (
                 "certificate",
                 boost::program_options::value<std::string>(),
-                "Certificate file for TLS connections"
+                "Certificate file for TLS connections. It is reloaded by SIGUSR1."
             )
             (
                 "private_key",
                 boost::program_options::value<std::string>(),
-                "Private key file for TLS connections"
+                "Private key file for TLS connections. It is reloaded by SIGUSR1."
             )
             (
                 "verify_file",
@@ -1050,11 +1785,144 @@ int main(int argc, char *argv[]) {
                 boost::program_options::value<std::string>()->default_value("subjectAltName"),
                 "Field to be used from certificate for authenticating clients. subjectAltName or CN is commonly used"
             )
+            (
+                "tls_session_cache_size",
+                boost::program_options::value<std::size_t>()->default_value(20480),
+                "Max number of TLS sessions cached by the broker for the session resumption. 0 means no session cache."
+            )
+            (
+                "tls_session_cache_shards",
+                boost::program_options::value<std::size_t>()->default_value(16),
+                "Number of shards of the TLS session cache. Each shard has its own lock."
+            )
+            (
+                "tls_session_timeout",
+                boost::program_options::value<std::size_t>()->default_value(7200),
+                "Lifetime (seconds) of the cached TLS sessions and the session tickets"
+            )
+            (
+                "tls_session_tickets",
+                boost::program_options::value<bool>()->default_value(true),
+                "Issue TLS session tickets (stateless resumption)"
+            )
+            (
+                "tls_ticket_key_rotation",
+                boost::program_options::value<std::size_t>()->default_value(3600),
+                "Interval (seconds) of the session ticket key rotation. Old keys are kept for tls_session_timeout to decrypt the issued tickets."
+            )
+            (
+                "tls_stats_interval",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Interval (seconds) of the TLS handshake and resumption counters output to the log (info). 0 means no output."
+            )
+            (
+                "tls_handshake_threads",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Number of threads for the TLS handshake pool. "
+                "If it is 0, the TLS handshake runs on the connection's io_context. "
+                "Otherwise, the TLS handshake runs on the pool and the connection moves to the connection's io_context after the handshake."
+            )
+            (
+                "ktls",
+                boost::program_options::value<bool>()->default_value(false),
+                "Offload the TLS record encryption to the kernel (kTLS) on TLS and TLS Websocket listeners. If kTLS is not available, OpenSSL encrypts the records."
+            )
             (
                 "auth_file",
                 boost::program_options::value<std::string>(),
                 "Authentication file"
             )
+            (
+                "auth_cache_ttl",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "TTL (seconds) of the cache of the verified user name and password pairs. "
+                "Reconnecting clients skip the lookup of the authentication settings within the TTL. "
+                "The passwords are cached as salted SHA-256 digests. 0 means no cache."
+            )
+            (
+                "auth_threads",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Number of threads for the password verification. "
+                "If it is 0, the password is verified on the connection's io_context. "
+                "Otherwise, the password is verified on the pool and CONNACK is sent after the verification."
+            )
+            (
+                "retained_page_size",
+                boost::program_options::value<std::size_t>()->default_value(256),
+                "Maximum number of the retained topics that are visited at once when a client subscribes. "
+                "The retained messages are sent page by page without holding the lock of the retained messages."
+            )
+            (
+                "shared_sub_strategy",
+                boost::program_options::value<std::string>()->default_value("round_robin"),
+                "Load balancing strategy of shared subscriptions. "
+                "round_robin, least_inflight (fewest outstanding QoS1/QoS2 PUBLISH), or sticky (hash of the topic)"
+            )
+            (
+                "outbound_queue_session_max_bytes",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Maximum bytes (topic name + payload) of the PUBLISH messages that are queued "
+                "but not written yet for each session. 0 means unlimited."
+            )
+            (
+                "outbound_queue_session_max_messages",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Maximum number of the PUBLISH messages that are queued but not written yet "
+                "for each session. 0 means unlimited."
+            )
+            (
+                "outbound_queue_global_max_bytes",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Maximum total bytes of the queued PUBLISH messages of all sessions. 0 means unlimited."
+            )
+            (
+                "outbound_queue_global_max_messages",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Maximum total number of the queued PUBLISH messages of all sessions. 0 means unlimited."
+            )
+            (
+                "offline_messages_session_max_bytes",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Maximum bytes (topic name + payload) of the offline messages of each session. "
+                "The messages that exceed the limit are dropped. 0 means unlimited."
+            )
+            (
+                "offline_messages_session_max_messages",
+                boost::program_options::value<std::size_t>()->default_value(1000),
+                "Maximum number of the offline messages of each session. "
+                "The messages that exceed the limit are dropped. 0 means unlimited."
+            )
+            (
+                "slow_consumer_policy",
+                boost::program_options::value<std::string>()->default_value("drop_qos0"),
+                "Policy when the outbound queue exceeds the limits. "
+                "drop_qos0 (drop QoS0, store QoS1/QoS2 as offline messages), "
+                "disconnect (DISCONNECT with Quota Exceeded), or offline (store all as offline messages)"
+            )
+            (
+                "topic_alias_send_policy",
+                boost::program_options::value<std::string>()->default_value("none"),
+                "Automatic topic alias mapping of the PUBLISH packets sent to the v5 clients "
+                "that accept topic aliases. "
+                "frequency (map the frequently sent topics), lru (map every topic), or none (default). "
+                "frequency and lru change the PUBLISH packets on the wire: the mapped ones have an empty "
+                "topic name and the Topic Alias property."
+            )
+            (
+                "metrics_interval",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Interval (seconds) of the metrics aggregation. 0 means the metrics are not output."
+            )
+            (
+                "sys_topics",
+                boost::program_options::value<bool>()->default_value(true),
+                "Publish the metrics on the $SYS/broker/... topics every metrics_interval."
+            )
+            (
+                "prometheus_file",
+                boost::program_options::value<std::string>(),
+                "Write the metrics in the Prometheus text format to the file every metrics_interval."
+            )
             (
                 "fixed_core_map",
                 boost::program_options::value<bool>()->default_value(false),
@@ -1068,6 +1936,37 @@ int main(int argc, char *argv[]) {
         ;
         desc.add(general_desc).add(notls_desc);
 
+        boost::program_options::options_description uds_desc("Unix domain socket Server options");
+        uds_desc.add_options()
+            ("uds.path", boost::program_options::value<std::string>(), "socket file path (Unix domain socket)")
+            (
+                "uds.perm",
+                boost::program_options::value<std::string>(),
+                "permissions of the socket file in octal (0000 to 0777). e.g. 0660"
+            )
+        ;
+        desc.add(uds_desc);
+
+        boost::program_options::options_description shm_desc("Shared memory Server options");
+        shm_desc.add_options()
+            (
+                "shm.path",
+                boost::program_options::value<std::string>(),
+                "socket file path that is used to pass the shared memory (Linux only)"
+            )
+            (
+                "shm.perm",
+                boost::program_options::value<std::string>(),
+                "permissions of the socket file in octal (0000 to 0777). e.g. 0660"
+            )
+            (
+                "shm.accept_timeout",
+                boost::program_options::value<std::size_t>()->default_value(10),
+                "Timeout (seconds) for the client to pass the shared memory after connecting to the socket file"
+            )
+        ;
+        desc.add(shm_desc);
+
         boost::program_options::options_description ws_desc("TCP websocket Server options");
         ws_desc.add_options()
             ("ws.port", boost::program_options::value<std::uint16_t>(), "default port (TCP)")
@@ -1094,6 +1993,68 @@ int main(int argc, char *argv[]) {
         ;
         desc.add(tlsws_vn_desc);
 
+        boost::program_options::options_description bridge_desc("Bridge options");
+        bridge_desc.add_options()
+            (
+                "bridge.name",
+                boost::program_options::value<std::string>()->default_value(""),
+                "Name of this node. It is the value of the bridge user property and a part of the client id "
+                "that the bridge connects to the peer brokers with. It must be unique in the nodes."
+            )
+            (
+                "bridge.peer",
+                boost::program_options::value<std::vector<std::string>>()->multitoken()->composing(),
+                "Peer broker (host:port) that the bridge connects to. It can be specified multiple times. "
+                "Each node connects to all other nodes."
+            )
+            (
+                "bridge.topic",
+                boost::program_options::value<std::vector<std::string>>()->multitoken()->composing(),
+                "Topic map of the bridge: 'filter' or 'filter local_prefix remote_prefix'. "
+                "\"\" is the empty prefix. It can be specified multiple times. The default is #"
+            )
+            (
+                "bridge.user",
+                boost::program_options::value<std::vector<std::string>>()->multitoken()->composing(),
+                "User that the peer brokers' bridges connect as. It must be authenticated by password "
+                "or client certificate. It can be specified multiple times. "
+                "The bridge property from the other users is removed."
+            )
+            (
+                "bridge.username",
+                boost::program_options::value<std::string>(),
+                "User name that the bridge connects to the peer brokers with"
+            )
+            (
+                "bridge.password",
+                boost::program_options::value<std::string>(),
+                "Password that the bridge connects to the peer brokers with"
+            )
+            (
+                "bridge.receive_maximum",
+                boost::program_options::value<std::uint16_t>()->default_value(65535),
+                "Receive Maximum that the bridge sends to the peer brokers. "
+                "It is the number of the QoS1 messages in flight on each bridge connection."
+            )
+            (
+                "bridge.bulk_write",
+                boost::program_options::value<bool>()->default_value(true),
+                "Set bulk write mode for the bridge connections"
+            )
+            (
+                "bridge.interest_interval",
+                boost::program_options::value<std::size_t>()->default_value(200),
+                "Interval (milliseconds) of checking the local subscriptions. "
+                "The bridge updates the subscriptions on the peer brokers if they are changed."
+            )
+            (
+                "bridge.threads",
+                boost::program_options::value<std::size_t>()->default_value(1),
+                "Number of threads for the bridge connections"
+            )
+        ;
+        desc.add(bridge_desc);
+
         boost::program_options::variables_map vm;
         boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
 
@@ -284,6 +284,8 @@ coro_broker(
                             as::make_strand(con_ioc_getter().get_executor())
                         );
                         epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                        epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                        epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
                         epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
                         auto& lowest_layer = epsp->lowest_layer();
                         auto [ec] = co_await mqtt_ac->async_accept(
@@ -333,6 +335,8 @@ coro_broker(
                             as::make_strand(con_ioc_getter().get_executor())
                         );
                         epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                        epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                        epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
                         epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
                         auto& lowest_layer = epsp->lowest_layer();
                         auto [ec] = co_await ws_ac->async_accept(
@@ -471,6 +475,8 @@ coro_broker(
                             *mqtts_ctx
                         );
                         epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                        epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                        epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
                         epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
                         auto& lowest_layer = epsp->lowest_layer();
                         auto [ec] = co_await mqtts_ac->async_accept(
@@ -569,6 +575,8 @@ coro_broker(
                             *wss_ctx
                         );
                         epsp->set_bulk_write(vm["bulk_write"].as<bool>());
+                        epsp->set_contiguous_write_threshold(vm["contiguous_write_threshold"].as<std::size_t>());
+                        epsp->set_zerocopy_write_threshold(vm["zerocopy_write_threshold"].as<std::size_t>());
                         epsp->set_read_buffer_size(vm["read_buf_size"].as<std::size_t>());
                         auto& lowest_layer = epsp->lowest_layer();
                         auto [ec] = co_await wss_ac->async_accept(
@@ -832,6 +840,16 @@ int main(int argc, char *argv[]) {
                 boost::program_options::value<bool>()->default_value(false),
                 "Set bulk write mode for all connections"
             )
+            (
+                "contiguous_write_threshold",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Packets (or concatenated packets on bulk write) up to this size are copied into one buffer before writing. 0 means disabled."
+            )
+            (
+                "zerocopy_write_threshold",
+                boost::program_options::value<std::size_t>()->default_value(0),
+                "Packets from this size are sent with MSG_ZEROCOPY. Only for TCP (mqtt) on Linux. 0 means disabled."
+            )
             (
                 "read_buf_size",
                 boost::program_options::value<std::size_t>()->default_value(65536),
@@ -0,0 +1,246 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_HANDSHAKE_STORM_HPP)
+#define ASYNC_MQTT_HANDSHAKE_STORM_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+
+#include "locked_cout.hpp"
+
+/**
+ * @brief TLS handshake storm
+ *
+ * All clients connect, do TLS handshake, and shutdown repeatedly.
+ * No MQTT packets are sent. It measures the handshake cost of the broker
+ * when many clients reconnect at once.
+ * If resume is true, each client keeps the previous session and offers it
+ * on the next handshake (session id or session ticket).
+ */
+class handshake_storm {
+public:
+    using stream_type = boost::asio::ssl::stream<boost::asio::ip::tcp::socket>;
+
+    handshake_storm(
+        boost::asio::ssl::context& ctx,
+        bool resume
+    ):ctx_{ctx},
+      resume_{resume}
+    {
+    }
+
+    /**
+     * @brief add a client
+     * @param exe   executor of the client
+     * @param host  target host
+     * @param port  target port
+     * @param times number of handshakes
+     */
+    void add_client(
+        boost::asio::any_io_executor exe,
+        std::string host,
+        std::string port,
+        std::size_t times
+    ) {
+        clients_.push_back(
+            std::make_shared<client>(
+                *this,
+                boost::asio::make_strand(exe),
+                std::move(host),
+                std::move(port),
+                times
+            )
+        );
+    }
+
+    /**
+     * @brief start all clients
+     * run the io_contexts after calling this function.
+     */
+    void start() {
+        tp_start_ = std::chrono::steady_clock::now();
+        rest_ = clients_.size();
+        for (auto& c : clients_) {
+            c->start();
+        }
+    }
+
+    /**
+     * @brief output the result
+     * It can be called after the io_contexts are stopped.
+     */
+    void report() const {
+        // the storm might be stopped before all clients finish
+        auto tp_end = rest_ == 0 ? tp_end_ : std::chrono::steady_clock::now();
+        auto dur_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            tp_end - tp_start_
+        ).count();
+        auto succeeded = full_ + resumed_;
+        locked_cout()
+            << "handshake storm finished" << "\n"
+            << "  resume     : " << std::boolalpha << resume_ << "\n"
+            << "  handshakes : " << succeeded
+            << " (full:" << full_ << " resumed:" << resumed_ << ")" << "\n"
+            << "  resumed    : "
+            << (succeeded == 0 ? 0.0 : double(resumed_) * 100 / double(succeeded)) << " %" << "\n"
+            << "  errors     : " << errors_ << "\n"
+            << "  duration   : " << dur_us / 1000 << " ms" << "\n"
+            << "  throughput : "
+            << (dur_us == 0 ? 0.0 : double(succeeded) * 1000 * 1000 / double(dur_us)) << " handshake/sec" << "\n"
+            << "  latency avg: "
+            << (succeeded == 0 ? 0 : latency_us_ / succeeded) << " us"
+            << std::endl;
+    }
+
+private:
+    struct client : std::enable_shared_from_this<client> {
+        client(
+            handshake_storm& hs,
+            boost::asio::strand<boost::asio::any_io_executor> exe,
+            std::string host,
+            std::string port,
+            std::size_t times
+        ):hs{hs},
+          exe{std::move(exe)},
+          resolver{this->exe},
+          host{std::move(host)},
+          port{std::move(port)},
+          rest{times}
+        {
+        }
+
+        ~client() {
+            if (session) SSL_SESSION_free(session);
+        }
+
+        void start() {
+            resolver.async_resolve(
+                host,
+                port,
+                [this, sp = this->shared_from_this()]
+                (boost::system::error_code const& ec, auto results) {
+                    if (ec) {
+                        locked_cout() << "resolve error:" << ec.message() << std::endl;
+                        hs.errors_ += rest;
+                        hs.finish();
+                        return;
+                    }
+                    eps = std::move(results);
+                    connect();
+                }
+            );
+        }
+
+        void connect() {
+            if (rest == 0) {
+                hs.finish();
+                return;
+            }
+            --rest;
+            stream.emplace(exe, hs.ctx_);
+            SSL_set_tlsext_host_name(stream->native_handle(), host.c_str());
+            if (hs.resume_ && session) {
+                SSL_set_session(stream->native_handle(), session);
+            }
+            tp = std::chrono::steady_clock::now();
+            boost::asio::async_connect(
+                stream->lowest_layer(),
+                eps,
+                [this, sp = this->shared_from_this()]
+                (boost::system::error_code const& ec, auto const&) {
+                    if (ec) {
+                        error(ec);
+                        return;
+                    }
+                    stream->lowest_layer().set_option(boost::asio::ip::tcp::no_delay(true));
+                    stream->async_handshake(
+                        boost::asio::ssl::stream_base::client,
+                        [this, sp = this->shared_from_this()]
+                        (boost::system::error_code const& ec) {
+                            if (ec) {
+                                error(ec);
+                                return;
+                            }
+                            hs.latency_us_ += std::uint64_t(
+                                std::chrono::duration_cast<std::chrono::microseconds>(
+                                    std::chrono::steady_clock::now() - tp
+                                ).count()
+                            );
+                            if (SSL_session_reused(stream->native_handle())) {
+                                ++hs.resumed_;
+                            }
+                            else {
+                                ++hs.full_;
+                            }
+                            // TLS1.3 session tickets are received after the handshake.
+                            // They are processed during the shutdown.
+                            stream->async_shutdown(
+                                [this, sp = this->shared_from_this()]
+                                (boost::system::error_code const& /*ec*/) {
+                                    if (hs.resume_) {
+                                        if (auto s = SSL_get1_session(stream->native_handle())) {
+                                            if (session) SSL_SESSION_free(session);
+                                            session = s;
+                                        }
+                                    }
+                                    boost::system::error_code ec;
+                                    stream->lowest_layer().close(ec);
+                                    connect();
+                                }
+                            );
+                        }
+                    );
+                }
+            );
+        }
+
+        void error(boost::system::error_code const& ec) {
+            locked_cout() << "handshake error:" << ec.message() << std::endl;
+            ++hs.errors_;
+            boost::system::error_code ec_close;
+            stream->lowest_layer().close(ec_close);
+            connect();
+        }
+
+        handshake_storm& hs;
+        boost::asio::strand<boost::asio::any_io_executor> exe;
+        boost::asio::ip::tcp::resolver resolver;
+        boost::asio::ip::tcp::resolver::results_type eps;
+        std::string host;
+        std::string port;
+        std::size_t rest;
+        std::optional<stream_type> stream;
+        SSL_SESSION* session = nullptr;
+        std::chrono::steady_clock::time_point tp;
+    };
+
+    void finish() {
+        if (--rest_ == 0) {
+            tp_end_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    boost::asio::ssl::context& ctx_;
+    bool resume_;
+    std::vector<std::shared_ptr<client>> clients_;
+    std::atomic<std::size_t> rest_{0};
+    std::atomic<std::size_t> full_{0};
+    std::atomic<std::size_t> resumed_{0};
+    std::atomic<std::size_t> errors_{0};
+    std::atomic<std::uint64_t> latency_us_{0};
+    std::chrono::steady_clock::time_point tp_start_;
+    std::chrono::steady_clock::time_point tp_end_;
+};
+
+#endif // ASYNC_MQTT_HANDSHAKE_STORM_HPP
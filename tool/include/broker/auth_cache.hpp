@@ -0,0 +1,126 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_BROKER_AUTH_CACHE_HPP)
+#define ASYNC_MQTT_BROKER_AUTH_CACHE_HPP
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <async_mqtt/util/move.hpp>
+
+#include <broker/mutex.hpp>
+#include <broker/security.hpp>
+#include <broker/uuid.hpp>
+
+namespace async_mqtt {
+
+/**
+ * @brief cache of the verified user name and password pairs
+ *
+ * When a client reconnects with the same credential within the TTL, the broker doesn't
+ * look up the authentication settings nor take the lock of the security settings again.
+ * Only the successful logins are cached, so the number of the entries is bounded by the number
+ * of the users in the authentication settings. Each user has at most one entry.
+ * The entry holds the SHA-256 digest of the password salted by a random value of the cache,
+ * so the plaintext password is not kept in memory. The caller calculates the digest by digest()
+ * once, and passes it to both find() and insert(). All member functions are thread safe.
+ */
+class auth_cache {
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    /**
+     * @brief set the TTL of the entries
+     * @param ttl TTL. zero disables the cache. The default is zero.
+     */
+    void set_ttl(clock_type::duration ttl) {
+        std::lock_guard<mutex> g{mtx_};
+        ttl_ = ttl;
+        if (ttl_ == clock_type::duration::zero()) entries_.clear();
+    }
+
+    bool enabled() const {
+        std::shared_lock<mutex> g{mtx_};
+        return ttl_ != clock_type::duration::zero();
+    }
+
+    /**
+     * @brief calculate the digest of the password for find() and insert()
+     * It should be called only if enabled() returns true, in order not to pay the SHA-256
+     * calculation for the disabled cache.
+     * @param password password
+     * @return salted SHA-256 digest
+     */
+    std::string digest(std::string_view password) const {
+        return security::sha256hash(salt_ + std::string(password));
+    }
+
+    /**
+     * @brief find the verified credential
+     * @param username user name
+     * @param digest   digest of the password that is returned by digest()
+     * @return true if the pair has been verified within the TTL
+     */
+    bool find(std::string_view username, std::string_view digest) const {
+        auto now = clock_type::now();
+        std::shared_lock<mutex> g{mtx_};
+        if (ttl_ == clock_type::duration::zero()) return false;
+        auto it = entries_.find(std::string(username));
+        if (it == entries_.end()) return false;
+        auto const& e = it->second;
+        return e.expiry > now && e.digest == digest;
+    }
+
+    /**
+     * @brief insert the verified credential
+     * The previous entry of the user is overwritten.
+     * @param username user name
+     * @param digest   digest of the password that is returned by digest()
+     */
+    void insert(std::string_view username, std::string digest) {
+        std::lock_guard<mutex> g{mtx_};
+        if (ttl_ == clock_type::duration::zero()) return;
+        auto& e = entries_[std::string(username)];
+        e.digest = force_move(digest);
+        e.expiry = clock_type::now() + ttl_;
+    }
+
+    /**
+     * @brief remove all entries
+     * It should be called when the authentication settings are updated.
+     */
+    void clear() {
+        std::lock_guard<mutex> g{mtx_};
+        entries_.clear();
+    }
+
+    std::size_t size() const {
+        std::shared_lock<mutex> g{mtx_};
+        return entries_.size();
+    }
+
+private:
+    struct entry {
+        std::string digest;
+        clock_type::time_point expiry;
+    };
+
+    // generated for each cache, so the digests can't be compared with precomputed ones
+    std::string const salt_ = create_uuid_string();
+    mutable mutex mtx_;
+    clock_type::duration ttl_{};
+    std::unordered_map<std::string, entry> entries_;
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_BROKER_AUTH_CACHE_HPP
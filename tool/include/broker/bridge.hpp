@@ -0,0 +1,406 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_BROKER_BRIDGE_HPP)
+#define ASYNC_MQTT_BROKER_BRIDGE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include <async_mqtt/all.hpp>
+#include <broker/bridge_topic.hpp>
+
+namespace async_mqtt {
+
+/**
+ * @brief configuration of the bridge
+ */
+struct bridge_config {
+    /// name of this node. It is the value of the bridge property and a part of the client id.
+    std::string name;
+    /// topic maps. A message crosses the bridge only if its topic matches one of them.
+    std::vector<bridge_topic> topics;
+    std::optional<std::string> username;
+    std::optional<std::string> password;
+    /// Receive Maximum sent to the peer broker. It is the number of the in-flight QoS1 messages.
+    receive_maximum_type receive_maximum = 65535;
+    bool bulk_write = true;
+    std::uint16_t keep_alive = 60;
+    /// interval of checking the local subscriptions
+    std::chrono::steady_clock::duration interest_interval = std::chrono::seconds(1);
+    std::chrono::steady_clock::duration reconnect_delay = std::chrono::seconds(1);
+};
+
+/**
+ * @brief bridge to the peer brokers
+ *
+ * The bridge connects to each peer broker as an MQTT v5 client and subscribes the topic filters
+ * that are subscribed by the clients of the local broker and match the topic maps. The messages
+ * delivered by the peer broker are published to the local broker with the bridge property.
+ * So a message crosses to a node only if the node has matching subscribers, and the peer broker
+ * sends the messages as pipelined QoS1 PUBLISH packets within the Receive Maximum.
+ *
+ * Each node bridges to all other nodes. A message that has the bridge property is not delivered
+ * to the bridge sessions, so it crosses at most one bridge and never loops.
+ * @tparam Broker broker type
+ */
+template <typename Broker>
+class bridge {
+public:
+    using client_type = client<protocol_version::v5, protocol::mqtt>;
+
+    /**
+     * @brief constructor
+     * @param exe executor that the clients of the bridge run on
+     * @param brk local broker
+     * @param config configuration
+     */
+    bridge(as::any_io_executor exe, Broker& brk, bridge_config config)
+        :exe_{force_move(exe)},
+         brk_{brk},
+         config_{std::make_shared<bridge_config>(force_move(config))}
+    {
+    }
+
+    /**
+     * @brief add the peer broker
+     * @param host host name of the peer broker
+     * @param port port of the peer broker
+     */
+    void add_peer(std::string host, std::string port) {
+        peers_.push_back(
+            std::make_shared<peer>(
+                as::make_strand(exe_),
+                brk_,
+                config_,
+                force_move(host),
+                force_move(port)
+            )
+        );
+    }
+
+    /**
+     * @brief start connecting to the peer brokers
+     */
+    void start() {
+        for (auto& p : peers_) p->start();
+    }
+
+private:
+    class peer : public std::enable_shared_from_this<peer> {
+    public:
+        peer(
+            as::any_io_executor exe,
+            Broker& brk,
+            std::shared_ptr<bridge_config const> config,
+            std::string host,
+            std::string port
+        )
+            :exe_{force_move(exe)},
+             brk_{brk},
+             config_{force_move(config)},
+             host_{force_move(host)},
+             port_{force_move(port)},
+             tim_reconnect_{exe_},
+             tim_interest_{exe_}
+        {
+        }
+
+        void start() {
+            as::dispatch(
+                exe_,
+                [this, self = this->shared_from_this()] {
+                    wait_interest();
+                    connect();
+                }
+            );
+        }
+
+    private:
+        void connect() {
+            // The client is re-constructed for each connection because the stream
+            // cannot be reused after it is closed.
+            // The old client is kept alive by its async_close handler until the close finishes.
+            cli_ = std::make_shared<client_type>(exe_);
+            cli_->set_bulk_write(config_->bulk_write);
+            connected_ = false;
+            updating_ = false;
+            subscribed_.clear();
+            rejected_.clear();
+            cli_->async_underlying_handshake(
+                host_,
+                port_,
+                [this, self = this->shared_from_this(), gen = ++connection_]
+                (error_code const& ec) {
+                    if (gen != connection_) return;
+                    if (ec) {
+                        ASYNC_MQTT_LOG("mqtt_broker", warning)
+                            << "bridge " << host_ << ":" << port_
+                            << " handshake failed:" << ec.message();
+                        reconnect();
+                        return;
+                    }
+                    start_session();
+                }
+            );
+        }
+
+        void start_session() {
+            cli_->async_start(
+                true, // clean_start
+                config_->keep_alive,
+                std::string(bridge_property_key) + "/" + config_->name,
+                config_->username,
+                config_->password,
+                properties{
+                    property::receive_maximum{config_->receive_maximum},
+                    property::user_property{std::string(bridge_property_key), config_->name}
+                },
+                [this, self = this->shared_from_this(), gen = connection_]
+                (error_code const& ec, std::optional<client_type::connack_packet> connack_opt) {
+                    if (gen != connection_) return;
+                    if (ec || !connack_opt) {
+                        ASYNC_MQTT_LOG("mqtt_broker", warning)
+                            << "bridge " << host_ << ":" << port_
+                            << " connect failed:" << ec.message();
+                        reconnect();
+                        return;
+                    }
+                    ASYNC_MQTT_LOG("mqtt_broker", info)
+                        << "bridge " << host_ << ":" << port_ << " connected";
+                    connected_ = true;
+                    recv();
+                    update_subscriptions();
+                }
+            );
+        }
+
+        void reconnect() {
+            connected_ = false;
+            if (cli_) {
+                auto& a_cli{*cli_};
+                a_cli.async_close(
+                    [cli = cli_](error_code const&) {
+                    }
+                );
+            }
+            tim_reconnect_.expires_after(config_->reconnect_delay);
+            tim_reconnect_.async_wait(
+                [this, self = this->shared_from_this()]
+                (error_code const& ec) {
+                    if (!ec) connect();
+                }
+            );
+        }
+
+        void recv() {
+            cli_->async_recv(
+                [this, self = this->shared_from_this(), gen = connection_]
+                (error_code const& ec, std::optional<packet_variant> pv_opt) {
+                    if (gen != connection_) return;
+                    if (ec) {
+                        ASYNC_MQTT_LOG("mqtt_broker", info)
+                            << "bridge " << host_ << ":" << port_
+                            << " disconnected:" << ec.message();
+                        reconnect();
+                        return;
+                    }
+                    if (auto* p = pv_opt->get_if<v5::publish_packet>()) {
+                        forward(*p);
+                    }
+                    recv();
+                }
+            );
+        }
+
+        // publish the message received from the peer broker to the local broker
+        void forward(v5::publish_packet const& p) {
+            auto remote_topic = p.topic();
+            std::optional<std::string> local_topic;
+            properties props;
+            for (auto const& prop : p.props()) {
+                prop.visit(
+                    overload {
+                        [&](property::subscription_identifier const& v) {
+                            // The identifier is the index of the topic map + 1
+                            if (!local_topic && v.val() != 0 && v.val() <= config_->topics.size()) {
+                                local_topic = config_->topics[v.val() - 1].to_local(remote_topic);
+                            }
+                        },
+                        [&](property::topic_alias const&) {
+                        },
+                        [&](auto const& v) {
+                            props.push_back(v);
+                        }
+                    }
+                );
+            }
+            if (!local_topic) {
+                for (auto const& t : config_->topics) {
+                    if (compare_topic_filter(t.remote_filter(), remote_topic)) {
+                        local_topic = t.to_local(remote_topic);
+                        if (local_topic) break;
+                    }
+                }
+            }
+            if (!local_topic) {
+                ASYNC_MQTT_LOG("mqtt_broker", warning)
+                    << "bridge " << host_ << ":" << port_
+                    << " received unmapped topic:" << remote_topic;
+                return;
+            }
+            brk_.publish_from_bridge(
+                config_->name,
+                force_move(*local_topic),
+                p.payload_as_buffer(),
+                p.opts().get_qos() | p.opts().get_retain(),
+                force_move(props)
+            );
+        }
+
+        void wait_interest() {
+            tim_interest_.expires_after(config_->interest_interval);
+            tim_interest_.async_wait(
+                [this, self = this->shared_from_this()]
+                (error_code const& ec) {
+                    if (ec) return;
+                    if (auto filters = brk_.get_local_topic_filters(generation_)) {
+                        desired_ = bridge_remote_filters(config_->topics, *filters);
+                        // the rejected filters are retried when the local subscriptions are changed
+                        rejected_.clear();
+                    }
+                    update_subscriptions();
+                    wait_interest();
+                }
+            );
+        }
+
+        // Send one SUBSCRIBE or UNSUBSCRIBE packet at a time until subscribed_ becomes desired_
+        void update_subscriptions() {
+            if (!connected_ || updating_) return;
+
+            std::vector<topic_sharename> unsub_entries;
+            for (auto const& e : subscribed_) {
+                auto it = desired_.find(e.first);
+                if (it == desired_.end() || it->second != e.second) {
+                    unsub_entries.emplace_back(e.first);
+                }
+            }
+            if (!unsub_entries.empty()) {
+                auto pid = cli_->acquire_unique_packet_id();
+                if (!pid) return;
+                updating_ = true;
+                cli_->async_unsubscribe(
+                    *pid,
+                    unsub_entries,
+                    [this, self = this->shared_from_this(), gen = connection_, unsub_entries]
+                    (error_code const& ec, std::optional<client_type::unsuback_packet>) {
+                        if (gen != connection_) return;
+                        updating_ = false;
+                        if (ec && ec != mqtt_error::partial_error_detected) {
+                            ASYNC_MQTT_LOG("mqtt_broker", warning)
+                                << "bridge " << host_ << ":" << port_
+                                << " unsubscribe failed:" << ec.message();
+                        }
+                        for (auto const& e : unsub_entries) {
+                            subscribed_.erase(std::string(e.topic()));
+                        }
+                        update_subscriptions();
+                    }
+                );
+                return;
+            }
+
+            // The Subscription Identifier is set for each SUBSCRIBE packet,
+            // so the topic filters of the same topic map are subscribed together.
+            std::optional<std::size_t> index;
+            std::vector<topic_subopts> sub_entries;
+            for (auto const& e : desired_) {
+                if (subscribed_.count(e.first) || rejected_.count(e.first)) continue;
+                if (!index) index = e.second;
+                if (*index != e.second) continue;
+                sub_entries.emplace_back(
+                    e.first,
+                    qos::at_least_once | sub::rap::retain | sub::retain_handling::send_only_new_subscription
+                );
+            }
+            if (sub_entries.empty()) return;
+            auto pid = cli_->acquire_unique_packet_id();
+            if (!pid) return;
+            updating_ = true;
+            cli_->async_subscribe(
+                *pid,
+                sub_entries,
+                properties{
+                    property::subscription_identifier{static_cast<std::uint32_t>(*index + 1)}
+                },
+                [this, self = this->shared_from_this(), gen = connection_, sub_entries, index = *index]
+                (error_code const& ec, std::optional<client_type::suback_packet> suback_opt) {
+                    if (gen != connection_) return;
+                    updating_ = false;
+                    if (!suback_opt) {
+                        ASYNC_MQTT_LOG("mqtt_broker", warning)
+                            << "bridge " << host_ << ":" << port_
+                            << " subscribe failed:" << ec.message();
+                        return;
+                    }
+                    // Only the accepted filters are recorded. The peer broker sends nothing for
+                    // the rejected ones, and they must not be unsubscribed later.
+                    auto const& codes = suback_opt->entries();
+                    for (std::size_t i = 0; i != sub_entries.size(); ++i) {
+                        auto code = i < codes.size() ? codes[i] : suback_reason_code::unspecified_error;
+                        if (code >= suback_reason_code::unspecified_error) {
+                            // It is not retried until the local subscriptions are changed.
+                            ASYNC_MQTT_LOG("mqtt_broker", warning)
+                                << "bridge " << host_ << ":" << port_
+                                << " subscribe " << sub_entries[i].topic() << " rejected:" << code;
+                            rejected_.emplace(sub_entries[i].topic());
+                            continue;
+                        }
+                        subscribed_.emplace(std::string(sub_entries[i].topic()), index);
+                    }
+                    update_subscriptions();
+                }
+            );
+        }
+
+        as::any_io_executor exe_;
+        Broker& brk_;
+        std::shared_ptr<bridge_config const> config_;
+        std::string host_;
+        std::string port_;
+        std::shared_ptr<client_type> cli_;
+        as::steady_timer tim_reconnect_;
+        as::steady_timer tim_interest_;
+        // incremented on each connection, so that the handlers of the old client are ignored
+        std::uint64_t connection_ = 0;
+        bool connected_ = false;
+        bool updating_ = false;
+        std::uint64_t generation_ = 0;
+        // topic filter on the peer broker -> index of the topic map
+        std::map<std::string, std::size_t> desired_;
+        std::map<std::string, std::size_t> subscribed_;
+        // topic filters that the peer broker rejected on SUBACK
+        std::set<std::string> rejected_;
+    };
+
+    as::any_io_executor exe_;
+    Broker& brk_;
+    std::shared_ptr<bridge_config const> config_;
+    std::vector<std::shared_ptr<peer>> peers_;
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_BROKER_BRIDGE_HPP
@@ -0,0 +1,248 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_BROKER_BRIDGE_TOPIC_HPP)
+#define ASYNC_MQTT_BROKER_BRIDGE_TOPIC_HPP
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <async_mqtt/protocol/packet/property_variant.hpp>
+#include <async_mqtt/util/move.hpp>
+
+#include <broker/topic_filter.hpp>
+
+namespace async_mqtt {
+
+/**
+ * @brief key of the user property that marks the messages and the sessions of the bridge
+ * The value is the name of the node.
+ * A PUBLISH packet that has the property is never forwarded to the bridge sessions again, and
+ * a CONNECT packet that has the property makes the session a bridge session if the user is
+ * one of the bridge users of the broker. The property is removed from the other clients'
+ * CONNECT and PUBLISH packets, and from the messages delivered to the clients.
+ */
+static constexpr std::string_view bridge_property_key = "async_mqtt_bridge";
+
+/**
+ * @brief check if the properties contain the bridge property
+ * @param props properties
+ * @return true if contained
+ */
+inline bool has_bridge_property(properties const& props) {
+    for (auto const& prop : props) {
+        if (auto p = prop.get_if<property::user_property>()) {
+            if (p->key() == bridge_property_key) return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief remove the bridge property from the properties
+ * It is used for the messages and the sessions that are not allowed to be a bridge, and for
+ * the messages that are delivered to the clients.
+ * @param props properties
+ * @return true if the bridge property was contained
+ */
+inline bool remove_bridge_property(properties& props) {
+    auto it = std::remove_if(
+        props.begin(),
+        props.end(),
+        [](property_variant const& prop) {
+            auto p = prop.get_if<property::user_property>();
+            return p && p->key() == bridge_property_key;
+        }
+    );
+    bool removed = it != props.end();
+    props.erase(it, props.end());
+    return removed;
+}
+
+/**
+ * @brief topic map of the bridge
+ *
+ * The messages whose topic matches remote_prefix + filter on the peer broker are
+ * published as local_prefix + (the rest of the topic) on the local broker.
+ * The prefixes don't contain the wildcard characters, and end with '/' if not empty.
+ */
+struct bridge_topic {
+    std::string filter;
+    std::string local_prefix;
+    std::string remote_prefix;
+
+    /**
+     * @brief get the topic filter on the local broker
+     * @return local_prefix + filter
+     */
+    std::string local_filter() const {
+        return local_prefix + filter;
+    }
+
+    /**
+     * @brief get the topic filter on the peer broker
+     * @return remote_prefix + filter
+     */
+    std::string remote_filter() const {
+        return remote_prefix + filter;
+    }
+
+    /**
+     * @brief convert the topic of the peer broker into the local topic
+     * @param remote_topic topic name on the peer broker
+     * @return local topic name. std::nullopt if the topic doesn't start with remote_prefix
+     */
+    std::optional<std::string> to_local(std::string_view remote_topic) const {
+        if (remote_topic.substr(0, remote_prefix.size()) != remote_prefix) return std::nullopt;
+        remote_topic.remove_prefix(remote_prefix.size());
+        return local_prefix + std::string(remote_topic);
+    }
+
+    /**
+     * @brief get the topic filter to subscribe on the peer broker for the local subscription
+     * @param local_filter topic filter that is subscribed by a local client
+     * @return topic filter on the peer broker. std::nullopt if no message of the topic map
+     *         matches local_filter
+     */
+    std::optional<std::string> remote_filter_for(std::string_view local_filter) const {
+        auto lf = this->local_filter();
+        if (!topic_filter_overlaps(lf, local_filter)) return std::nullopt;
+        if (topic_filter_covers(lf, local_filter)) {
+            // local_filter starts with local_prefix because the prefix has no wildcards
+            local_filter.remove_prefix(local_prefix.size());
+            return remote_prefix + std::string(local_filter);
+        }
+        return remote_filter();
+    }
+};
+
+namespace detail {
+
+inline bool valid_bridge_prefix(std::string_view prefix) {
+    return
+        prefix.empty() ||
+        (validate_topic_name(prefix) && prefix.back() == topic_filter_separator);
+}
+
+} // namespace detail
+
+/**
+ * @brief parse the topic map of the bridge
+ * @param str `filter` or `filter local_prefix remote_prefix`. `""` can be used as the empty prefix.
+ * @return bridge_topic. std::nullopt if str is invalid
+ */
+inline std::optional<bridge_topic> bridge_topic_from_str(std::string_view str) {
+    std::vector<std::string> tokens;
+    while (true) {
+        auto begin = str.find_first_not_of(' ');
+        if (begin == std::string_view::npos) break;
+        str.remove_prefix(begin);
+        auto end = str.find(' ');
+        auto token = str.substr(0, end);
+        tokens.emplace_back(token == "\"\"" ? std::string_view() : token);
+        if (end == std::string_view::npos) break;
+        str.remove_prefix(end);
+    }
+    if (tokens.size() != 1 && tokens.size() != 3) return std::nullopt;
+
+    bridge_topic bt;
+    bt.filter = force_move(tokens[0]);
+    if (tokens.size() == 3) {
+        bt.local_prefix = force_move(tokens[1]);
+        bt.remote_prefix = force_move(tokens[2]);
+    }
+    if (!validate_topic_filter(bt.filter)) return std::nullopt;
+    if (!detail::valid_bridge_prefix(bt.local_prefix)) return std::nullopt;
+    if (!detail::valid_bridge_prefix(bt.remote_prefix)) return std::nullopt;
+    return bt;
+}
+
+/**
+ * @brief calculate the topic filters to subscribe on the peer broker
+ *
+ * Only the topics that the local clients subscribe cross the bridge.
+ * The peer broker sends a message for each matched subscription, so no two filters of the
+ * same topic map overlap. The topic filter that is covered by another one is removed, and
+ * partially overlapping filters are replaced with their common cover.
+ * e.g. "a/+/c" and "a/b/#" are replaced with "a/+/#".
+ * The overlap is judged liberally, because the peer broker could match "a/#" with "a".
+ * @param topics        topic maps
+ * @param local_filters topic filters that are subscribed by the local clients
+ * @return map of the topic filter on the peer broker to the index of the topic map
+ */
+inline std::map<std::string, std::size_t> bridge_remote_filters(
+    std::vector<bridge_topic> const& topics,
+    std::vector<std::string> const& local_filters
+) {
+    std::map<std::string, std::size_t> filters;
+    for (auto const& local_filter : local_filters) {
+        for (std::size_t i = 0; i != topics.size(); ++i) {
+            if (auto rf = topics[i].remote_filter_for(local_filter)) {
+                filters.emplace(force_move(*rf), i);
+            }
+        }
+    }
+
+    // Only a filter that contains the wildcard characters can overlap another filter,
+    // so the number of the comparisons is bounded by the number of the wildcard filters.
+    // The filters of the different topic maps are not compared because the topics are
+    // converted by the topic map of the subscription.
+    while (true) {
+        std::vector<std::pair<std::string, std::size_t>> wildcards;
+        for (auto const& e : filters) {
+            if (e.first.find_first_of("+#") != std::string::npos) wildcards.push_back(e);
+        }
+        for (auto it = filters.begin(); it != filters.end();) {
+            bool covered = false;
+            for (auto const& w : wildcards) {
+                if (w.second == it->second && w.first != it->first && topic_filter_covers(w.first, it->first)) {
+                    covered = true;
+                    break;
+                }
+            }
+            if (covered) {
+                it = filters.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        // the remaining overlapping filters partially overlap
+        auto merged =
+            [&] {
+                for (auto const& w : wildcards) {
+                    if (filters.count(w.first) == 0) continue;
+                    for (auto const& e : filters) {
+                        if (e.second != w.second || e.first == w.first) continue;
+                        if (!topic_filter_overlaps(w.first, e.first)) continue;
+                        auto cover = topic_filter_common_cover(w.first, e.first);
+                        // the filter of the topic map covers all filters of the topic map
+                        auto const& rf = topics[w.second].remote_filter();
+                        if (!cover || !topic_filter_covers(rf, *cover)) cover = rf;
+                        auto index = w.second;
+                        auto other = e.first;
+                        filters.erase(w.first);
+                        filters.erase(other);
+                        filters.emplace(force_move(*cover), index);
+                        return true;
+                    }
+                }
+                return false;
+            } ();
+        if (!merged) break;
+    }
+    return filters;
+}
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_BROKER_BRIDGE_TOPIC_HPP
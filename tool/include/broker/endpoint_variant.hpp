@@ -335,6 +335,19 @@ public:
         return preauthed_user_name_;
     }
 
+    /**
+     * @brief set whether the client is a bridge of another broker
+     * It is copied to the session_state when CONNACK is sent.
+     * @param val true if the CONNECT packet has the bridge property
+     */
+    void set_bridge(bool val) {
+        bridge_ = val;
+    }
+
+    bool is_bridge() const {
+        return bridge_;
+    }
+
     protocol_version get_protocol_version() const {
         if (!protocol_version_) {
             // On multi threaded environment,
@@ -360,6 +373,23 @@ public:
         );
     }
 
+    std::optional<std::size_t> get_receive_maximum_vacancy_for_send() const {
+        return visit(
+            [&](auto& ep) {
+                return ep.get_receive_maximum_vacancy_for_send();
+            }
+        );
+    }
+
+    void enable_auto_map_topic_alias_send(topic_alias_send_policy policy) {
+        visit(
+            [&](auto& ep) {
+                ep.set_auto_map_topic_alias_send(true);
+                ep.set_auto_map_topic_alias_send_policy(policy);
+            }
+        );
+    }
+
     void set_client_id(std::string cid) {
         client_id_ = force_move(cid);
     }
@@ -411,6 +441,7 @@ private:
     epsp_type epsp_;
     std::string client_id_;
     std::optional<std::string> preauthed_user_name_;
+    bool bridge_ = false;
     mutable std::optional<protocol_version> protocol_version_;
     session_state<this_type>* session_state_ = nullptr;
 };
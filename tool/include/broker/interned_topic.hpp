@@ -0,0 +1,374 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_BROKER_INTERNED_TOPIC_HPP)
+#define ASYNC_MQTT_BROKER_INTERNED_TOPIC_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <async_mqtt/util/move.hpp>
+
+namespace async_mqtt {
+
+/**
+ * @brief refcounted interned topic name, topic filter, or topic level
+ *
+ * Equal strings share one entry of the process wide intern table, so the subscription
+ * map, the retained map, the sessions, and the offline messages can hold the same topic
+ * without duplicating the string. Copying is one atomic increment. The entry is removed
+ * from the table when the last interned_topic that refers to it is destroyed.
+ *
+ * Each entry also holds its topic levels as interned_topic. While an entry is alive,
+ * id() is unique to the string, so the id of a level can be used as the token id.
+ * The empty string is not stored in the table. Its id() is 0.
+ * All member functions are thread safe.
+ */
+class interned_topic {
+public:
+    using id_type = std::uintptr_t;
+
+    /**
+     * @brief constructor of the empty string
+     */
+    interned_topic() = default;
+
+    /**
+     * @brief constructor
+     * If the equal string is already interned, refer to it, otherwise intern the string.
+     * @param str string to intern
+     */
+    explicit interned_topic(std::string_view str)
+        :e_{acquire(str)}
+    {
+    }
+
+    interned_topic(interned_topic const& other)
+        :e_{other.e_}
+    {
+        if (e_) e_->ref.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    interned_topic(interned_topic&& other) noexcept
+        :e_{other.e_}
+    {
+        other.e_ = nullptr;
+    }
+
+    interned_topic& operator=(interned_topic const& other) {
+        interned_topic tmp{other};
+        std::swap(e_, tmp.e_);
+        return *this;
+    }
+
+    interned_topic& operator=(interned_topic&& other) noexcept {
+        interned_topic tmp{force_move(other)};
+        std::swap(e_, tmp.e_);
+        return *this;
+    }
+
+    ~interned_topic() {
+        if (e_) release(e_);
+    }
+
+    /**
+     * @brief get the string
+     * @return string. It is valid while this interned_topic refers to it.
+     */
+    std::string_view str() const {
+        return e_ ? e_->str() : std::string_view();
+    }
+
+    operator std::string_view() const {
+        return str();
+    }
+
+    std::size_t size() const {
+        return str().size();
+    }
+
+    bool empty() const {
+        return e_ == nullptr;
+    }
+
+    /**
+     * @brief get the id
+     * @return id that is unique to the string while it is interned. 0 for the empty string.
+     */
+    id_type id() const {
+        return reinterpret_cast<id_type>(e_);
+    }
+
+    /**
+     * @brief get the number of the topic levels
+     * @return number of the levels. "a/b" is 2, "a" and "" are 1.
+     */
+    std::size_t level_count() const {
+        if (!e_ || e_->level_count == 0) return 1;
+        return e_->level_count;
+    }
+
+    /**
+     * @brief get the topic level
+     * @param i index of the level
+     * @return interned level. If the topic has only one level, *this.
+     */
+    interned_topic const& level(std::size_t i) const {
+        BOOST_ASSERT(i < level_count());
+        if (!e_ || e_->level_count == 0) return *this;
+        return e_->levels()[i];
+    }
+
+    /**
+     * @brief get the token ids of the topic levels
+     * @return ids of the levels
+     */
+    std::vector<id_type> level_ids() const {
+        std::vector<id_type> ids;
+        auto num = level_count();
+        ids.reserve(num);
+        for (std::size_t i = 0; i != num; ++i) ids.push_back(level(i).id());
+        return ids;
+    }
+
+    /**
+     * @brief get the number of the interned_topic that refer to the same string
+     * @return reference count. 0 for the empty string.
+     */
+    std::size_t use_count() const {
+        return e_ ? e_->ref.load(std::memory_order_relaxed) : 0;
+    }
+
+    /**
+     * @brief get the number of the interned strings including the topic levels
+     * @return number of the entries of the intern table
+     */
+    static std::size_t table_size() {
+        std::size_t size = 0;
+        for (auto& s : shards()) {
+            std::lock_guard<std::mutex> g{s.mtx};
+            size += s.entries.size();
+        }
+        return size;
+    }
+
+    friend bool operator==(interned_topic const& lhs, interned_topic const& rhs) {
+        return lhs.e_ == rhs.e_;
+    }
+    friend bool operator!=(interned_topic const& lhs, interned_topic const& rhs) {
+        return lhs.e_ != rhs.e_;
+    }
+    friend bool operator<(interned_topic const& lhs, interned_topic const& rhs) {
+        return lhs.str() < rhs.str();
+    }
+    friend bool operator==(interned_topic const& lhs, std::string_view rhs) {
+        return lhs.str() == rhs;
+    }
+    friend bool operator!=(interned_topic const& lhs, std::string_view rhs) {
+        return lhs.str() != rhs;
+    }
+    friend bool operator==(std::string_view lhs, interned_topic const& rhs) {
+        return lhs == rhs.str();
+    }
+    friend bool operator!=(std::string_view lhs, interned_topic const& rhs) {
+        return lhs != rhs.str();
+    }
+
+    friend std::ostream& operator<<(std::ostream& o, interned_topic const& v) {
+        o << v.str();
+        return o;
+    }
+
+private:
+    // The levels and the characters follow the entry in the same allocation,
+    // so that an interned string costs one allocation and one table node.
+    struct entry {
+        std::atomic<std::size_t> ref{1};
+        std::size_t hash;
+        std::uint32_t size;
+        // 0 if the string has only one level
+        std::uint32_t level_count;
+
+        interned_topic* levels() {
+            return reinterpret_cast<interned_topic*>(this + 1);
+        }
+        interned_topic const* levels() const {
+            return reinterpret_cast<interned_topic const*>(this + 1);
+        }
+        std::string_view str() const {
+            return std::string_view(reinterpret_cast<char const*>(levels() + level_count), size);
+        }
+
+        static entry* create(std::string_view str, std::size_t hash, std::vector<interned_topic>& levels) {
+            auto* mem = ::operator new(
+                sizeof(entry) + sizeof(interned_topic) * levels.size() + str.size()
+            );
+            auto* e = new (mem) entry{
+                {1},
+                hash,
+                static_cast<std::uint32_t>(str.size()),
+                static_cast<std::uint32_t>(levels.size())
+            };
+            for (std::size_t i = 0; i != levels.size(); ++i) {
+                new (e->levels() + i) interned_topic(force_move(levels[i]));
+            }
+            std::memcpy(reinterpret_cast<char*>(e->levels() + levels.size()), str.data(), str.size());
+            return e;
+        }
+
+        static void destroy(entry* e) {
+            for (std::size_t i = 0; i != e->level_count; ++i) {
+                e->levels()[i].~interned_topic();
+            }
+            e->~entry();
+            ::operator delete(e);
+        }
+    };
+
+    struct entry_hash {
+        std::size_t operator()(entry const* e) const {
+            return e->hash;
+        }
+        std::size_t operator()(std::string_view str) const {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    struct entry_equal {
+        bool operator()(entry const* lhs, entry const* rhs) const {
+            return lhs->str() == rhs->str();
+        }
+        bool operator()(std::string_view lhs, entry const* rhs) const {
+            return lhs == rhs->str();
+        }
+    };
+
+    static constexpr std::size_t shard_num = 64;
+
+    struct alignas(64) shard {
+        std::mutex mtx;
+        boost::unordered_set<entry*, entry_hash, entry_equal> entries;
+    };
+
+    // The table is never destroyed, so an interned_topic in a static object can be
+    // destroyed after main() returns.
+    static std::array<shard, shard_num>& shards() {
+        static auto* p = new std::array<shard, shard_num>;
+        return *p;
+    }
+
+    static shard& shard_of(std::size_t hash) {
+        return shards()[hash % shard_num];
+    }
+
+    static std::vector<interned_topic> split(std::string_view str) {
+        std::vector<interned_topic> levels;
+        if (str.find('/') == std::string_view::npos) return levels;
+        std::size_t start = 0;
+        while (true) {
+            auto pos = str.find('/', start);
+            if (pos == std::string_view::npos) {
+                levels.emplace_back(str.substr(start));
+                break;
+            }
+            levels.emplace_back(str.substr(start, pos - start));
+            start = pos + 1;
+        }
+        return levels;
+    }
+
+    static entry* find(shard& s, std::string_view str, std::size_t hash) {
+        auto it = s.entries.find(
+            str,
+            [hash](std::string_view) { return hash; },
+            entry_equal{}
+        );
+        if (it == s.entries.end()) return nullptr;
+        (*it)->ref.fetch_add(1, std::memory_order_relaxed);
+        return *it;
+    }
+
+    static entry* acquire(std::string_view str) {
+        if (str.empty()) return nullptr;
+        auto hash = entry_hash{}(str);
+        auto& s = shard_of(hash);
+        {
+            std::lock_guard<std::mutex> g{s.mtx};
+            if (auto* e = find(s, str, hash)) return e;
+        }
+        // The levels are interned and released without the lock because they could be
+        // in the same shard.
+        auto levels = split(str);
+        entry* e = nullptr;
+        {
+            std::lock_guard<std::mutex> g{s.mtx};
+            // another thread could intern the same string meanwhile
+            e = find(s, str, hash);
+            if (!e) {
+                e = entry::create(str, hash, levels);
+                s.entries.insert(e);
+            }
+        }
+        return e;
+    }
+
+    static void release(entry* e) {
+        // fast path: not the last reference
+        auto ref = e->ref.load(std::memory_order_relaxed);
+        while (ref > 1) {
+            if (e->ref.compare_exchange_weak(
+                    ref,
+                    ref - 1,
+                    std::memory_order_acq_rel,
+                    std::memory_order_relaxed
+                )
+            ) {
+                return;
+            }
+        }
+        // The count reaches 0 only under the lock, so acquire() never picks up
+        // the entry that is being destroyed.
+        // The entry is destroyed after unlock because it releases the levels.
+        bool erased = false;
+        {
+            auto& s = shard_of(e->hash);
+            std::lock_guard<std::mutex> g{s.mtx};
+            if (e->ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                s.entries.erase(e);
+                erased = true;
+            }
+        }
+        if (erased) entry::destroy(e);
+    }
+
+    entry* e_ = nullptr;
+};
+
+} // namespace async_mqtt
+
+namespace std {
+
+template <>
+struct hash<async_mqtt::interned_topic> {
+    std::size_t operator()(async_mqtt::interned_topic const& v) const noexcept {
+        return std::hash<async_mqtt::interned_topic::id_type>{}(v.id());
+    }
+};
+
+} // namespace std
+
+#endif // ASYNC_MQTT_BROKER_INTERNED_TOPIC_HPP
@@ -0,0 +1,254 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_BROKER_METRICS_HPP)
+#define ASYNC_MQTT_BROKER_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace async_mqtt {
+
+/**
+ * @brief broker metrics
+ * Counters are monotonically increasing. Gauges are the sum of the increments and the decrements.
+ */
+enum class broker_metric : std::size_t {
+    messages_received, ///< counter: PUBLISH packets received from the clients
+    messages_sent,     ///< counter: PUBLISH packets sent to the subscribers except $SYS topics
+    bytes_received,    ///< counter: topic name + payload bytes received from the clients
+    bytes_sent,        ///< counter: topic name + payload bytes sent to the subscribers except $SYS topics
+    dropped_messages,  ///< counter: messages dropped by the slow consumer policy or the offline message limits
+    auth_failures,     ///< counter: login failures and unauthorized PUBLISH/SUBSCRIBE
+    fanout_sum,        ///< counter: sum of the fan-out of the received PUBLISH packets
+    retained,          ///< gauge: retained messages
+    sessions,          ///< gauge: sessions including offline sessions
+    subscriptions,     ///< gauge: subscriptions
+    num                ///< number of the metrics
+};
+
+/**
+ * @brief check whether the topic is a $SYS topic
+ * @param topic topic name
+ * @return true if the topic is $SYS or starts with $SYS/
+ */
+inline bool is_sys_topic(std::string_view topic) {
+    constexpr std::string_view sys{"$SYS"};
+    return
+        topic.substr(0, sys.size()) == sys &&
+        (topic.size() == sys.size() || topic[sys.size()] == '/');
+}
+
+/**
+ * @brief aggregated broker metrics
+ */
+struct broker_metrics_snapshot {
+    /// upper bounds (inclusive) of the fan-out histogram buckets. The last bucket is +Inf.
+    static constexpr std::array<std::size_t, 9> fanout_bounds{0, 1, 2, 4, 8, 16, 64, 256, 1024};
+    static constexpr std::size_t fanout_buckets = fanout_bounds.size() + 1;
+
+    std::int64_t get(broker_metric m) const {
+        return values[static_cast<std::size_t>(m)];
+    }
+
+    /**
+     * @brief get the cumulative count of the fan-out histogram
+     * @param bucket index of the bucket
+     * @return number of the PUBLISH packets whose fan-out is less than or equal to the bound
+     */
+    std::uint64_t fanout_cumulative(std::size_t bucket) const {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i <= bucket; ++i) sum += fanout[i];
+        return sum;
+    }
+
+    std::array<std::int64_t, static_cast<std::size_t>(broker_metric::num)> values{};
+    std::array<std::uint64_t, fanout_buckets> fanout{};
+};
+
+/**
+ * @brief lock-free broker metrics
+ *
+ * Each thread updates its own cache-line-aligned slot by a relaxed fetch_add.
+ * If the number of the threads exceeds the number of the slots, the threads share
+ * the slots. aggregate() sums up all slots without locks. The snapshot is not
+ * atomic as a whole, but each value is.
+ */
+class broker_metrics {
+public:
+    /**
+     * @brief constructor
+     * @param slots number of the slots. It should be greater than or equal to the number of the threads.
+     */
+    explicit broker_metrics(std::size_t slots = 64)
+        :slots_(slots == 0 ? 1 : slots)
+    {
+    }
+
+    /**
+     * @brief add the value to the metric
+     * @param m metric
+     * @param v value. It can be negative for the gauges
+     */
+    void add(broker_metric m, std::int64_t v = 1) {
+        slot().values[static_cast<std::size_t>(m)].fetch_add(v, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief count the PUBLISH packet that is sent to the subscriber
+     * The messages on the $SYS topics are not counted, so the metrics don't count themselves.
+     * @param topic topic name
+     * @param bytes topic name + payload bytes
+     */
+    void add_sent(std::string_view topic, std::size_t bytes) {
+        if (is_sys_topic(topic)) return;
+        auto& s = slot();
+        s.values[static_cast<std::size_t>(broker_metric::messages_sent)].fetch_add(
+            1,
+            std::memory_order_relaxed
+        );
+        s.values[static_cast<std::size_t>(broker_metric::bytes_sent)].fetch_add(
+            static_cast<std::int64_t>(bytes),
+            std::memory_order_relaxed
+        );
+    }
+
+    /**
+     * @brief record the fan-out of the received PUBLISH packet
+     * @param n number of the subscribers that the message is delivered to
+     */
+    void observe_fanout(std::size_t n) {
+        auto& s = slot();
+        s.fanout[fanout_bucket(n)].fetch_add(1, std::memory_order_relaxed);
+        s.values[static_cast<std::size_t>(broker_metric::fanout_sum)].fetch_add(
+            static_cast<std::int64_t>(n),
+            std::memory_order_relaxed
+        );
+    }
+
+    broker_metrics_snapshot aggregate() const {
+        broker_metrics_snapshot ss;
+        for (auto const& s : slots_) {
+            for (std::size_t i = 0; i != ss.values.size(); ++i) {
+                ss.values[i] += s.values[i].load(std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i != ss.fanout.size(); ++i) {
+                ss.fanout[i] += s.fanout[i].load(std::memory_order_relaxed);
+            }
+        }
+        return ss;
+    }
+
+    static std::size_t fanout_bucket(std::size_t n) {
+        auto const& bounds = broker_metrics_snapshot::fanout_bounds;
+        for (std::size_t i = 0; i != bounds.size(); ++i) {
+            if (n <= bounds[i]) return i;
+        }
+        return bounds.size();
+    }
+
+private:
+    struct alignas(64) slot_type {
+        std::array<std::atomic<std::int64_t>, static_cast<std::size_t>(broker_metric::num)> values{};
+        std::array<std::atomic<std::uint64_t>, broker_metrics_snapshot::fanout_buckets> fanout{};
+    };
+
+    slot_type& slot() {
+        return slots_[thread_index() % slots_.size()];
+    }
+
+    static std::size_t thread_index() {
+        static std::atomic<std::size_t> next{0};
+        thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    std::vector<slot_type> slots_;
+};
+
+/**
+ * @brief make the $SYS topics and the values
+ * @param ss snapshot
+ * @return pairs of the topic name and the value string
+ */
+inline std::vector<std::pair<std::string, std::string>> sys_topics(broker_metrics_snapshot const& ss) {
+    std::vector<std::pair<std::string, std::string>> ret{
+        {"$SYS/broker/messages/received", std::to_string(ss.get(broker_metric::messages_received))},
+        {"$SYS/broker/messages/sent",     std::to_string(ss.get(broker_metric::messages_sent))},
+        {"$SYS/broker/messages/dropped",  std::to_string(ss.get(broker_metric::dropped_messages))},
+        {"$SYS/broker/bytes/received",    std::to_string(ss.get(broker_metric::bytes_received))},
+        {"$SYS/broker/bytes/sent",        std::to_string(ss.get(broker_metric::bytes_sent))},
+        {"$SYS/broker/auth/failures",     std::to_string(ss.get(broker_metric::auth_failures))},
+        {"$SYS/broker/retained/count",    std::to_string(ss.get(broker_metric::retained))},
+        {"$SYS/broker/sessions/count",    std::to_string(ss.get(broker_metric::sessions))},
+        {"$SYS/broker/subscriptions/count", std::to_string(ss.get(broker_metric::subscriptions))},
+        {"$SYS/broker/publish/fanout/sum", std::to_string(ss.get(broker_metric::fanout_sum))},
+    };
+    auto const& bounds = broker_metrics_snapshot::fanout_bounds;
+    for (std::size_t i = 0; i != ss.fanout.size(); ++i) {
+        ret.emplace_back(
+            "$SYS/broker/publish/fanout/le_" +
+            (i == bounds.size() ? std::string("inf") : std::to_string(bounds[i])),
+            std::to_string(ss.fanout_cumulative(i))
+        );
+    }
+    return ret;
+}
+
+/**
+ * @brief write the snapshot in the Prometheus text exposition format
+ * @param o  output stream
+ * @param ss snapshot
+ */
+inline void write_prometheus(std::ostream& o, broker_metrics_snapshot const& ss) {
+    auto counter =
+        [&](char const* name, char const* help, broker_metric m) {
+            o << "# HELP async_mqtt_broker_" << name << "_total " << help << "\n"
+              << "# TYPE async_mqtt_broker_" << name << "_total counter\n"
+              << "async_mqtt_broker_" << name << "_total " << ss.get(m) << "\n";
+        };
+    auto gauge =
+        [&](char const* name, char const* help, broker_metric m) {
+            o << "# HELP async_mqtt_broker_" << name << " " << help << "\n"
+              << "# TYPE async_mqtt_broker_" << name << " gauge\n"
+              << "async_mqtt_broker_" << name << " " << ss.get(m) << "\n";
+        };
+    counter("messages_received", "PUBLISH packets received from the clients.", broker_metric::messages_received);
+    counter("messages_sent", "PUBLISH packets sent to the subscribers except $SYS topics.", broker_metric::messages_sent);
+    counter("messages_dropped", "Messages dropped by the slow consumer policy or the offline message limits.", broker_metric::dropped_messages);
+    counter("bytes_received", "Topic name and payload bytes received from the clients.", broker_metric::bytes_received);
+    counter("bytes_sent", "Topic name and payload bytes sent to the subscribers except $SYS topics.", broker_metric::bytes_sent);
+    counter("auth_failures", "Login failures and unauthorized PUBLISH/SUBSCRIBE.", broker_metric::auth_failures);
+    gauge("retained_messages", "Retained messages.", broker_metric::retained);
+    gauge("sessions", "Sessions including offline sessions.", broker_metric::sessions);
+    gauge("subscriptions", "Subscriptions.", broker_metric::subscriptions);
+
+    o << "# HELP async_mqtt_broker_publish_fanout Number of the subscribers that a received PUBLISH is delivered to.\n"
+      << "# TYPE async_mqtt_broker_publish_fanout histogram\n";
+    auto const& bounds = broker_metrics_snapshot::fanout_bounds;
+    for (std::size_t i = 0; i != ss.fanout.size(); ++i) {
+        o << "async_mqtt_broker_publish_fanout_bucket{le=\"";
+        if (i == bounds.size()) {
+            o << "+Inf";
+        }
+        else {
+            o << bounds[i];
+        }
+        o << "\"} " << ss.fanout_cumulative(i) << "\n";
+    }
+    o << "async_mqtt_broker_publish_fanout_sum " << ss.get(broker_metric::fanout_sum) << "\n"
+      << "async_mqtt_broker_publish_fanout_count " << ss.fanout_cumulative(bounds.size()) << "\n";
+}
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_BROKER_METRICS_HPP
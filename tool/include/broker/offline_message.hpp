@@ -8,6 +8,7 @@
 #define ASYNC_MQTT_BROKER_OFFLINE_MESSAGE_HPP
 
 #include <optional>
+#include <string_view>
 
 #include <boost/asio/steady_timer.hpp>
 #include <boost/multi_index_container.hpp>
@@ -25,6 +26,8 @@
 #include <async_mqtt/protocol/packet/v5_pubrel.hpp>
 #include <async_mqtt/protocol/packet/pubopts.hpp>
 
+#include <broker/interned_topic.hpp>
+#include <broker/outbound_queue.hpp>
 #include <broker/tags.hpp>
 
 namespace async_mqtt {
@@ -40,7 +43,7 @@ class offline_messages;
 class offline_message {
 public:
     offline_message(
-        std::string topic,
+        interned_topic topic,
         std::vector<buffer> payload,
         pub::opts pubopts,
         properties props,
@@ -53,10 +56,27 @@ public:
     {
     }
 
-    template <typename Epsp>
-    bool send(Epsp epsp, protocol_version ver) {
+    /**
+     * @brief send the message
+     * @param epsp    endpoint
+     * @param ver     protocol version
+     * @param acquire called with bytes() before sending. If it returns false, the message is not sent.
+     * @param release called with bytes() when the acquired message is written or not sent.
+     * @param on_send called with the packet id (0 for QoS0), the topic name, and bytes()
+     *                before the PUBLISH packet is sent.
+     * @return true if the message is sent, otherwise false
+     */
+    template <typename Epsp, typename Acquire, typename Release, typename OnSend>
+    bool send(
+        Epsp epsp,
+        protocol_version ver,
+        Acquire& acquire,
+        Release const& release,
+        OnSend const& on_send
+    ) {
         auto publish =
             [&] (packet_id_type pid) {
+                on_send(pid, std::string_view{topic_}, bytes());
                 switch (ver) {
                 case protocol_version::v3_1_1:
                     epsp.async_send(
@@ -66,12 +86,13 @@ public:
                             payload_,
                             pubopts_
                         },
-                        [epsp](error_code const& ec) {
+                        [epsp, release, size = bytes()](error_code const& ec) {
                             if (ec) {
                                 ASYNC_MQTT_LOG("mqtt_broker", warning)
                                     << ASYNC_MQTT_ADD_VALUE(address, epsp.get_address())
                                     << ec.message();
                             }
+                            release(size);
                         }
                     );
                     break;
@@ -94,21 +115,24 @@ public:
                     }
                     epsp.async_send(
                         force_move(packet),
-                        [epsp](error_code const& ec) {
+                        [epsp, release, size = bytes()](error_code const& ec) {
                             if (ec) {
                                 ASYNC_MQTT_LOG("mqtt_broker", warning)
                                     << ASYNC_MQTT_ADD_VALUE(address, epsp.get_address())
                                     << ec.message();
                             }
+                            release(size);
                         }
                     );
                 } break;
                 default:
                     BOOST_ASSERT(false);
+                    release(bytes());
                     break;
                 }
             };
 
+        if (!acquire(bytes())) return false;
         auto qos_value = pubopts_.get_qos();
         if (qos_value == qos::at_least_once ||
             qos_value == qos::exactly_once) {
@@ -117,6 +141,7 @@ public:
                 return true;
             }
             else {
+                release(bytes());
                 return false;
             }
         }
@@ -126,10 +151,18 @@ public:
         }
     }
 
+    /**
+     * @brief size that is counted by the outbound queue
+     * @return topic name size + payload size
+     */
+    std::size_t bytes() const {
+        return outbound_bytes(topic_, payload_);
+    }
+
 private:
     friend class offline_messages;
 
-    std::string topic_;
+    interned_topic topic_;
     std::vector<buffer> payload_;
     pub::opts pubopts_;
     properties props_;
@@ -138,10 +171,25 @@ private:
 
 class offline_messages {
 public:
-    template <typename Epsp>
-    void send_until_fail(Epsp& epsp, protocol_version ver) {
+    /**
+     * @brief send the messages in order until a message can't be sent
+     * @param epsp    endpoint
+     * @param ver     protocol version
+     * @param acquire See offline_message::send()
+     * @param release See offline_message::send()
+     * @param on_send See offline_message::send()
+     */
+    template <typename Epsp, typename Acquire, typename Release, typename OnSend>
+    void send_until_fail(
+        Epsp& epsp,
+        protocol_version ver,
+        Acquire acquire,
+        Release release,
+        OnSend on_send
+    ) {
         epsp.dispatch(
-            [this, epsp, ver] {
+            [this, epsp, ver, acquire = force_move(acquire), release = force_move(release), on_send = force_move(on_send)]
+            () mutable {
                 auto& idx = messages_.get<tag_seq>();
                 while (!idx.empty()) {
                     auto it = idx.begin();
@@ -149,7 +197,8 @@ public:
                     // const_cast is appropriate here
                     // See https://github.com/boostorg/multi_index/issues/50
                     auto& m = const_cast<offline_message&>(*it);
-                    if (m.send(epsp, ver)) {
+                    if (m.send(epsp, ver, acquire, release, on_send)) {
+                        bytes_ -= m.bytes();
                         idx.pop_front();
                     }
                     else {
@@ -162,15 +211,28 @@ public:
 
     void clear() {
         messages_.clear();
+        bytes_ = 0;
     }
 
     bool empty() const {
         return messages_.empty();
     }
 
+    std::size_t size() const {
+        return messages_.size();
+    }
+
+    /**
+     * @brief get the bytes of the messages
+     * @return sum of offline_message::bytes() of the messages
+     */
+    std::size_t bytes() const {
+        return bytes_;
+    }
+
     void push_back(
         as::any_io_executor exe,
-        std::string pub_topic,
+        interned_topic pub_topic,
         std::vector<buffer> payload,
         pub::opts pubopts,
         properties props) {
@@ -194,13 +256,18 @@ public:
                 [this, wp = std::weak_ptr<as::steady_timer>(tim_message_expiry)](error_code ec) mutable {
                     if (auto sp = wp.lock()) {
                         if (!ec) {
-                            messages_.get<tag_tim>().erase(sp);
+                            auto& idx = messages_.get<tag_tim>();
+                            auto [b, e] = idx.equal_range(sp);
+                            for (; b != e; b = idx.erase(b)) {
+                                bytes_ -= b->bytes();
+                            }
                         }
                     }
                 }
             );
         }
 
+        bytes_ += outbound_bytes(pub_topic, payload);
         auto& seq_idx = messages_.get<tag_seq>();
         seq_idx.emplace_back(
             force_move(pub_topic),
@@ -226,6 +293,7 @@ private:
     >;
 
     mi_offline_message messages_;
+    std::size_t bytes_ = 0;
 };
 
 } // namespace async_mqtt
@@ -0,0 +1,259 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_BROKER_OUTBOUND_QUEUE_HPP)
+#define ASYNC_MQTT_BROKER_OUTBOUND_QUEUE_HPP
+
+#include <atomic>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include <async_mqtt/util/buffer.hpp>
+
+namespace async_mqtt {
+
+/**
+ * @brief policy when the outbound queue of the session exceeds the limit
+ */
+enum class slow_consumer_policy {
+    drop_qos0,  ///< drop QoS0 messages. QoS1/QoS2 messages are stored as offline messages
+    disconnect, ///< disconnect the client with Quota Exceeded (v5) or close the connection (v3.1.1).
+                ///< QoS0 messages are dropped. QoS1/QoS2 messages are stored as offline messages
+    offline,    ///< store the messages as offline messages and send them after the queue is drained
+};
+
+inline char const* slow_consumer_policy_to_str(slow_consumer_policy v) {
+    switch (v) {
+    case slow_consumer_policy::drop_qos0:  return "drop_qos0";
+    case slow_consumer_policy::disconnect: return "disconnect";
+    case slow_consumer_policy::offline:    return "offline";
+    default:                               return "unknown_slow_consumer_policy";
+    }
+}
+
+inline std::ostream& operator<<(std::ostream& o, slow_consumer_policy v) {
+    o << slow_consumer_policy_to_str(v);
+    return o;
+}
+
+inline std::optional<slow_consumer_policy> slow_consumer_policy_from_str(std::string_view str) {
+    if (str == "drop_qos0")  return slow_consumer_policy::drop_qos0;
+    if (str == "disconnect") return slow_consumer_policy::disconnect;
+    if (str == "offline")    return slow_consumer_policy::offline;
+    return std::nullopt;
+}
+
+/**
+ * @brief size of the PUBLISH message that is counted by the outbound queue
+ * The fixed header, the packet identifier, and the properties are not counted.
+ * @param topic   topic name
+ * @param payload payload
+ * @return topic name size + payload size
+ */
+inline std::size_t outbound_bytes(std::string_view topic, std::vector<buffer> const& payload) {
+    std::size_t bytes = topic.size();
+    for (auto const& b : payload) bytes += b.size();
+    return bytes;
+}
+
+class outbound_queue_limits;
+
+/**
+ * @brief PUBLISH messages of one session that are passed to the endpoint but not written yet
+ *
+ * The counters are updated by outbound_queue_limits.
+ */
+class outbound_queue {
+public:
+    /**
+     * @brief get the queued bytes
+     * @return sum of outbound_bytes() of the queued messages
+     */
+    std::size_t queued_bytes() const {
+        return bytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief get the number of the queued messages
+     * @return number of the queued messages
+     */
+    std::size_t queued_messages() const {
+        return messages_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief get the number of the dropped messages
+     * It includes the QoS0 messages dropped by the slow_consumer_policy and the messages
+     * dropped by the offline message limits.
+     * @return number of the dropped messages
+     */
+    std::size_t dropped_messages() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class outbound_queue_limits;
+
+    std::atomic<std::size_t> bytes_{0};
+    std::atomic<std::size_t> messages_{0};
+    std::atomic<std::size_t> dropped_{0};
+};
+
+/**
+ * @brief limits of the outbound queues and the total of all sessions
+ *
+ * The broker has one outbound_queue_limits and each session has one outbound_queue.
+ * The limit 0 means unlimited. All limits are unlimited by default.
+ * All member functions are thread safe.
+ */
+class outbound_queue_limits {
+public:
+    /**
+     * @brief set the limits of each session
+     * @param max_bytes    maximum queued bytes of the session
+     * @param max_messages maximum number of the queued messages of the session
+     */
+    void set_session_limits(std::size_t max_bytes, std::size_t max_messages) {
+        session_max_bytes_.store(max_bytes, std::memory_order_relaxed);
+        session_max_messages_.store(max_messages, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief set the limits of the total of all sessions
+     * @param max_bytes    maximum queued bytes of all sessions
+     * @param max_messages maximum number of the queued messages of all sessions
+     */
+    void set_global_limits(std::size_t max_bytes, std::size_t max_messages) {
+        global_max_bytes_.store(max_bytes, std::memory_order_relaxed);
+        global_max_messages_.store(max_messages, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief set the limits of the offline messages of each session
+     * The offline messages are not counted by the outbound queue, so they are limited separately.
+     * @param max_bytes    maximum bytes (topic name + payload) of the offline messages of the session
+     * @param max_messages maximum number of the offline messages of the session
+     */
+    void set_offline_limits(std::size_t max_bytes, std::size_t max_messages) {
+        offline_max_bytes_.store(max_bytes, std::memory_order_relaxed);
+        offline_max_messages_.store(max_messages, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief check whether a message can be stored as an offline message
+     * @param messages number of the offline messages of the session
+     * @param bytes    bytes of the offline messages of the session
+     * @param msg_bytes outbound_bytes() of the message
+     * @return true if the message doesn't exceed the offline limits, otherwise false
+     */
+    bool can_store_offline(std::size_t messages, std::size_t bytes, std::size_t msg_bytes) const {
+        return
+            !exceeded(messages + 1, offline_max_messages_) &&
+            !exceeded(bytes + msg_bytes, offline_max_bytes_);
+    }
+
+    void set_policy(slow_consumer_policy policy) {
+        policy_.store(policy, std::memory_order_relaxed);
+    }
+
+    slow_consumer_policy get_policy() const {
+        return policy_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief check whether a message can be queued and count it if it can
+     * If the queue of the session is empty, the message is always counted even if it
+     * exceeds the limits. It guarantees that each session can send at least one message.
+     * @param q     outbound queue of the session
+     * @param bytes outbound_bytes() of the message
+     * @return true if the message is counted, otherwise false
+     */
+    bool try_acquire(outbound_queue& q, std::size_t bytes) {
+        auto msgs = q.messages_.fetch_add(1, std::memory_order_relaxed) + 1;
+        auto q_bytes = q.bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        auto g_msgs = messages_.fetch_add(1, std::memory_order_relaxed) + 1;
+        auto g_bytes = bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        if (msgs == 1) return true;
+        if (exceeded(q_bytes, session_max_bytes_) ||
+            exceeded(msgs, session_max_messages_) ||
+            exceeded(g_bytes, global_max_bytes_) ||
+            exceeded(g_msgs, global_max_messages_)) {
+            release(q, bytes);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief uncount the message that is counted by try_acquire()
+     * It is called when the message is written or the write is failed.
+     * @param q     outbound queue of the session
+     * @param bytes outbound_bytes() of the message
+     */
+    void release(outbound_queue& q, std::size_t bytes) {
+        q.messages_.fetch_sub(1, std::memory_order_relaxed);
+        q.bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+        messages_.fetch_sub(1, std::memory_order_relaxed);
+        bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief count the dropped message
+     * @param q outbound queue of the session
+     */
+    void add_dropped(outbound_queue& q) {
+        q.dropped_.fetch_add(1, std::memory_order_relaxed);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief get the queued bytes of all sessions
+     * @return queued bytes
+     */
+    std::size_t queued_bytes() const {
+        return bytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief get the number of the queued messages of all sessions
+     * @return number of the queued messages
+     */
+    std::size_t queued_messages() const {
+        return messages_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief get the number of the dropped messages of all sessions
+     * @return number of the dropped messages
+     */
+    std::size_t dropped_messages() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static bool exceeded(std::size_t value, std::atomic<std::size_t> const& limit) {
+        auto l = limit.load(std::memory_order_relaxed);
+        return l != 0 && value > l;
+    }
+
+    std::atomic<std::size_t> session_max_bytes_{0};
+    std::atomic<std::size_t> session_max_messages_{0};
+    std::atomic<std::size_t> global_max_bytes_{0};
+    std::atomic<std::size_t> global_max_messages_{0};
+    std::atomic<std::size_t> offline_max_bytes_{0};
+    std::atomic<std::size_t> offline_max_messages_{0};
+    std::atomic<slow_consumer_policy> policy_{slow_consumer_policy::drop_qos0};
+
+    std::atomic<std::size_t> bytes_{0};
+    std::atomic<std::size_t> messages_{0};
+    std::atomic<std::size_t> dropped_{0};
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_BROKER_OUTBOUND_QUEUE_HPP
@@ -12,6 +12,7 @@
 #include <async_mqtt/util/buffer.hpp>
 #include <async_mqtt/protocol/packet/property_variant.hpp>
 #include <async_mqtt/protocol/packet/subopts.hpp>
+#include <broker/interned_topic.hpp>
 
 namespace async_mqtt {
 
@@ -19,7 +20,7 @@ namespace async_mqtt {
 // case clients add a new subscription to the associated topics.
 struct retain_type {
     retain_type(
-        std::string topic,
+        interned_topic topic,
         std::vector<buffer> payload,
         properties props,
         qos qos_value,
@@ -36,7 +37,7 @@ struct retain_type {
         }
     }
 
-    std::string topic;
+    interned_topic topic;
     std::vector<buffer> payload;
     properties props;
     qos qos_value;
@@ -9,7 +9,9 @@
 
 #include <deque>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include <boost/functional/hash.hpp>
 #include <boost/multi_index_container.hpp>
@@ -19,6 +21,7 @@
 
 #include <async_mqtt/util/buffer.hpp>
 
+#include <broker/interned_topic.hpp>
 #include <broker/topic_filter.hpp>
 
 namespace async_mqtt {
@@ -65,7 +68,8 @@ class retained_topic_map {
         }
 
         node_id_type parent_id;
-        std::string name;
+        // The topic level is interned, so the same level under many parents shares one string.
+        interned_topic name;
 
         node_id_type id;
 
@@ -89,13 +93,40 @@ class retained_topic_map {
                 >
             >,
             // index required for wildcard processing
-            mi::ordered_non_unique<
+            // children are ordered by name, so that the cursor can resume
+            // the iteration from the last visited child
+            mi::ordered_unique<
                 mi::tag<wildcard_index_tag>,
-                mi::key<&path_entry::parent_id>
+                mi::key<
+                    &path_entry::parent_id,
+                    &path_entry::name_as_string_view
+                >
             >
         >
     >;
 
+public:
+    // Incremental search state of find_some().
+    // It doesn't refer to the map, so it can be kept while the map is unlocked.
+    class cursor {
+    public:
+        // true if no more topics can be found
+        bool done() const { return frames_.empty(); }
+
+    private:
+        friend class retained_topic_map;
+
+        struct frame {
+            node_id_type id;                  // matched node
+            std::size_t level;                // index of the token to match with the children
+            std::optional<std::string> after; // last visited child name for the wildcards
+        };
+
+        std::vector<std::string> tokens_;
+        std::vector<frame> frames_;
+    };
+
+private:
     using direct_const_iterator = typename path_entry_set::template index<direct_index_tag>::type::const_iterator;
     using wildcard_const_iterator = typename path_entry_set::template index<wildcard_index_tag>::type::const_iterator;
 
@@ -180,7 +211,7 @@ class retained_topic_map {
                 for (auto i = wildcard_index.lower_bound(root); i != wildcard_index.end() && i->parent_id == root; ++i) {
 
                     // Should we ignore system matches
-                    if (!ignore_system || i->name.empty() || i->name[0] != '$') {
+                    if (!ignore_system || i->name.empty() || i->name.str()[0] != '$') {
                         if (i->value) {
                             callback(*i->value);
                         }
@@ -223,12 +254,9 @@ class retained_topic_map {
 
                     if (t == std::string_view("+")) {
                         for (auto i = wildcard_index.lower_bound(parent); i != wildcard_index.end() && i->parent_id == parent; ++i) {
-                            if (parent != root_node_id || i->name.empty() || i->name[0] != '$') {
+                            if (parent != root_node_id || i->name.empty() || i->name.str()[0] != '$') {
                                 new_entries.push_back(map.template project<direct_index_tag, wildcard_const_iterator>(i));
                             }
-                            else {
-                                break;
-                            }
                         }
                     }
                     else if (t == std::string_view("#")) {
@@ -264,6 +292,23 @@ class retained_topic_map {
         }
     }
 
+    // Match the child of the cursor's frame
+    template<typename Output>
+    static void match_child(cursor& c, path_entry const& child, std::size_t level, Output& callback) {
+        if (level == c.tokens_.size()) {
+            if (child.value) {
+                callback(*child.value);
+            }
+        }
+        else {
+            // the parent level of # also matches
+            if (c.tokens_[level] == "#" && child.value) {
+                callback(*child.value);
+            }
+            c.frames_.push_back(typename cursor::frame{child.id, level, std::nullopt});
+        }
+    }
+
     // Remove a value at the specified topic
     size_t erase_topic(std::string_view topic) {
         auto path = find_topic(topic);
@@ -356,6 +401,73 @@ public:
         find_match(topic_filter, std::forward<Output>(callback));
     }
 
+    // Create a cursor to find stored topics that match the specified topic_filter incrementally
+    cursor make_cursor(std::string_view topic_filter) const {
+        cursor c;
+        topic_filter_tokenizer(
+            topic_filter,
+            [&c](std::string_view t) {
+                c.tokens_.emplace_back(t);
+                return true;
+            }
+        );
+        if (!c.tokens_.empty()) {
+            c.frames_.push_back(typename cursor::frame{root_node_id, 0, std::nullopt});
+        }
+        return c;
+    }
+
+    // Continue to find stored topics from the cursor.
+    // It visits at most max_visits nodes, so the callback is called at most max_visits times.
+    // The map can be modified between the calls. The erased topics are never found.
+    // The inserted topics are found only if they are not behind the cursor.
+    // Returns the number of visited nodes.
+    template<typename Output>
+    std::size_t find_some(cursor& c, std::size_t max_visits, Output&& callback) const {
+        auto const& direct_index = map.template get<direct_index_tag>();
+        auto const& wildcard_index = map.template get<wildcard_index_tag>();
+        std::size_t visits = 0;
+        while (!c.frames_.empty() && visits != max_visits) {
+            auto& f = c.frames_.back();
+            auto id = f.id;
+            auto level = f.level;
+            std::string_view t = c.tokens_[level];
+            if (t == "+" || t == "#") {
+                // resume the iteration from the last visited child
+                auto i = f.after
+                    ? wildcard_index.upper_bound(std::make_tuple(id, std::string_view{*f.after}))
+                    : wildcard_index.lower_bound(id);
+                if (i == wildcard_index.end() || i->parent_id != id) {
+                    c.frames_.pop_back();
+                    continue;
+                }
+                ++visits;
+                f.after = std::string(i->name.str());
+                // system topics don't match the wildcards on the first level
+                if (id == root_node_id && !i->name.empty() && i->name.str()[0] == '$') continue;
+                if (t == "#") {
+                    // Match all underlying topics
+                    if (i->value) {
+                        callback(*i->value);
+                    }
+                    c.frames_.push_back(typename cursor::frame{i->id, level, std::nullopt});
+                }
+                else {
+                    match_child(c, *i, level + 1, callback);
+                }
+            }
+            else {
+                c.frames_.pop_back();
+                ++visits;
+                auto i = direct_index.find(std::make_tuple(id, t));
+                if (i != direct_index.end()) {
+                    match_child(c, *i, level + 1, callback);
+                }
+            }
+        }
+        return visits;
+    }
+
     // Remove a stored value at the specified topic
     std::size_t erase(std::string_view topic) {
         auto result = erase_topic(topic);
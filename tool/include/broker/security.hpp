@@ -7,9 +7,11 @@
 #if !defined(ASYNC_MQTT_BROKER_SECURITY_HPP)
 #define ASYNC_MQTT_BROKER_SECURITY_HPP
 
+#include <array>
 #include <string>
 #include <string_view>
 #include <map>
+#include <memory>
 #include <set>
 #include <optional>
 
@@ -172,14 +174,45 @@ struct security {
     template<typename T>
     static std::string to_hex(T start, T end) {
         std::string result;
+        result.reserve(static_cast<std::size_t>(std::distance(start, end)) * 2);
         boost::algorithm::hex(start, end, std::back_inserter(result));
         return result;
     }
 
+#if ASYNC_MQTT_USE_TLS
+    static EVP_MD const* sha256_md() {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        // OpenSSL 3 fetches the implementation on each EVP_DigestInit_ex() unless it is fetched in advance.
+        static EVP_MD* md = EVP_MD_fetch(nullptr, "SHA256", nullptr);
+        return md;
+#else  // OPENSSL_VERSION_NUMBER >= 0x30000000L
+        return EVP_sha256();
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+    }
+#endif // ASYNC_MQTT_USE_TLS
+
     static std::string sha256hash(std::string_view message) {
-        std::vector<unsigned char> hash(picosha2::k_digest_size);
+#if ASYNC_MQTT_USE_TLS
+        // OpenSSL uses the SHA extensions of the CPU if available.
+        thread_local std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx{
+            EVP_MD_CTX_new(),
+            &EVP_MD_CTX_free
+        };
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int digest_size = 0;
+        if (auto const* md = sha256_md();
+            md && ctx &&
+            EVP_DigestInit_ex(ctx.get(), md, nullptr) == 1 &&
+            EVP_DigestUpdate(ctx.get(), message.data(), message.size()) == 1 &&
+            EVP_DigestFinal_ex(ctx.get(), digest, &digest_size) == 1
+        ) {
+            return to_hex(digest, digest + digest_size);
+        }
+#endif // ASYNC_MQTT_USE_TLS
+        std::array<unsigned char, picosha2::k_digest_size> hash;
         picosha2::hash256(message.begin(), message.end(), hash.begin(), hash.end());
-        return picosha2::bytes_to_hex_string(hash.begin(), hash.end());
+        // picosha2::bytes_to_hex_string() uses std::ostringstream, and it is slower than the hash itself.
+        return to_hex(hash.begin(), hash.end());
     }
 
     bool login_cert(std::string_view username) const {
@@ -0,0 +1,67 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_BROKER_SESSION_ID_HPP)
+#define ASYNC_MQTT_BROKER_SESSION_ID_HPP
+
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+#include <async_mqtt/util/value_allocator.hpp>
+
+namespace async_mqtt {
+
+/**
+ * @brief integer id of the session
+ * The client id is used only to find the session on CONNECT. After that, the broker
+ * identifies the session by this id.
+ */
+using session_id_type = std::uint32_t;
+
+/// id of no session. It is used as the source when the broker publishes the message.
+static constexpr session_id_type no_session_id = 0;
+
+/**
+ * @brief allocator of the session ids
+ *
+ * The lowest vacant id is allocated, so the ids are dense.
+ * A session holds its id until it is destroyed. All member functions are thread safe.
+ */
+class session_id_pool {
+public:
+    /**
+     * @brief allocate the session id
+     * @return session id. It is never no_session_id.
+     */
+    session_id_type allocate() {
+        std::lock_guard<std::mutex> g{mtx_};
+        auto id = ids_.allocate();
+        if (!id) throw std::overflow_error("session ids are exhausted");
+        return *id;
+    }
+
+    /**
+     * @brief deallocate the session id
+     * @param id session id that is gotten by allocate()
+     */
+    void deallocate(session_id_type id) {
+        std::lock_guard<std::mutex> g{mtx_};
+        ids_.deallocate(id);
+    }
+
+private:
+    std::mutex mtx_;
+    value_allocator<session_id_type> ids_{
+        no_session_id + 1,
+        std::numeric_limits<session_id_type>::max()
+    };
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_BROKER_SESSION_ID_HPP
@@ -0,0 +1,142 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_BROKER_SHARED_GROUP_HPP)
+#define ASYNC_MQTT_BROKER_SHARED_GROUP_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+namespace async_mqtt {
+
+/**
+ * @brief load balancing strategy of shared subscriptions
+ */
+enum class shared_strategy {
+    round_robin,    ///< select the members in turn
+    least_inflight, ///< select the member that has fewer outstanding QoS1/QoS2 PUBLISH packets (power of two choices)
+    sticky,         ///< select the member by the hash of the topic name
+};
+
+inline char const* shared_strategy_to_str(shared_strategy v) {
+    switch (v) {
+    case shared_strategy::round_robin:    return "round_robin";
+    case shared_strategy::least_inflight: return "least_inflight";
+    case shared_strategy::sticky:         return "sticky";
+    default:                              return "unknown_shared_strategy";
+    }
+}
+
+inline std::ostream& operator<<(std::ostream& o, shared_strategy v) {
+    o << shared_strategy_to_str(v);
+    return o;
+}
+
+inline std::optional<shared_strategy> shared_strategy_from_str(std::string_view str) {
+    if (str == "round_robin")    return shared_strategy::round_robin;
+    if (str == "least_inflight") return shared_strategy::least_inflight;
+    if (str == "sticky")         return shared_strategy::sticky;
+    return std::nullopt;
+}
+
+/**
+ * @brief members of one shared subscription (share_name, topic_filter)
+ *
+ * Selection doesn't modify the members, so it can be called concurrently
+ * under a shared lock. Modifying the members requires an exclusive lock.
+ * @tparam Member member type
+ */
+template <typename Member>
+class shared_group {
+public:
+    std::vector<Member>& members() {
+        return members_;
+    }
+
+    std::vector<Member> const& members() const {
+        return members_;
+    }
+
+    bool empty() const {
+        return members_.empty();
+    }
+
+    /**
+     * @brief remove the member at the index
+     * The last member is moved to the index, so the order is not kept.
+     * @param index index of the member
+     */
+    void erase(std::size_t index) {
+        BOOST_ASSERT(index < members_.size());
+        if (index != members_.size() - 1) {
+            members_[index] = std::move(members_.back());
+        }
+        members_.pop_back();
+    }
+
+    /**
+     * @brief select a member
+     * @param strategy load balancing strategy
+     * @param topic    topic name of the PUBLISH packet. It is used by shared_strategy::sticky
+     * @param inflight function that returns the number of outstanding PUBLISH packets of the member.
+     *                 It is used by shared_strategy::least_inflight
+     * @return selected member. nullptr if there is no member.
+     */
+    template <typename InflightFunc>
+    Member const* select(
+        shared_strategy strategy,
+        std::string_view topic,
+        InflightFunc&& inflight
+    ) const {
+        auto size = members_.size();
+        if (size == 0) return nullptr;
+        switch (strategy) {
+        case shared_strategy::round_robin:
+            return &members_[next_.fetch_add(1, std::memory_order_relaxed) % size];
+        case shared_strategy::least_inflight: {
+            // power of two choices
+            // Compare the round robin member and the pseudo randomly chosen member,
+            // and select the fewer one. Scanning all members is O(N) and the
+            // result is not so different.
+            auto n = next_.fetch_add(1, std::memory_order_relaxed);
+            auto const& first = members_[n % size];
+            if (size == 1) return &first;
+            auto i = mix(n) % (size - 1);
+            if (i >= n % size) ++i; // skip the first member
+            auto const& second = members_[i];
+            return inflight(second) < inflight(first) ? &second : &first;
+        }
+        case shared_strategy::sticky:
+            return &members_[std::hash<std::string_view>{}(topic) % size];
+        default:
+            BOOST_ASSERT(false);
+            return nullptr;
+        }
+    }
+
+private:
+    static std::size_t mix(std::size_t v) {
+        // splitmix64 finalizer
+        std::uint64_t x = v;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<std::size_t>(x ^ (x >> 31));
+    }
+
+    std::vector<Member> members_;
+    mutable std::atomic<std::size_t> next_{0};
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_BROKER_SHARED_GROUP_HPP
@@ -7,60 +7,99 @@
 #if !defined(ASYNC_MQTT_BROKER_SHARED_TARGET_HPP)
 #define ASYNC_MQTT_BROKER_SHARED_TARGET_HPP
 
-#include <map>
-#include <optional>
-#include <chrono>
-
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/key.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
+#include <boost/container_hash/hash.hpp>
 
 #include <broker/session_state_fwd.hpp>
-#include <broker/tags.hpp>
-#include <broker/mutex.hpp>
+#include <broker/session_id.hpp>
 #include <broker/subscription.hpp>
+#include <broker/shared_group.hpp>
+#include <broker/sub_con_map.hpp>
 
 namespace async_mqtt {
 
-namespace mi = boost::multi_index;
-
+/**
+ * @brief shared subscription groups
+ *
+ * Each group is inserted to sub_con_map as one entry when it is created, and erased from
+ * sub_con_map when its last member is erased. The groups are protected by the lock of
+ * sub_con_map. The modifying functions must be called with the exclusive lock, and select()
+ * must be called with the shared lock.
+ * @tparam Sp endpoint type
+ */
 template <typename Sp>
 class shared_target {
 public:
-    void insert(std::string share_name, std::string topic_filter, subscription<Sp> sub, session_state<Sp>& ss);
-    void erase(std::string share_name, std::string topic_filter, session_state<Sp> const& ss);
-    void erase(session_state<Sp> const& ss);
-    std::optional<std::tuple<session_state_ref<Sp>, subscription<Sp>>>
-    get_target(std::string const& share_name, std::string const& topic_filter);
+    using group = shared_subscription_group<Sp>;
+    using member = shared_member<Sp>;
+
+    void set_strategy(shared_strategy strategy);
+    shared_strategy get_strategy() const;
+
+    /**
+     * @brief insert the member to the group
+     * @return true if the member is inserted, false if the subscription of the member is updated
+     */
+    bool insert(
+        sub_con_map<Sp>& subs_map,
+        std::string share_name,
+        std::string topic_filter,
+        subscription<Sp> sub,
+        session_state<Sp>& ss
+    );
+
+    /**
+     * @brief erase the member from the group
+     * @return the number of the erased members
+     */
+    std::size_t erase(
+        sub_con_map<Sp>& subs_map,
+        std::string_view share_name,
+        std::string_view topic_filter,
+        session_state<Sp> const& ss
+    );
+
+    /**
+     * @brief erase the member from all groups
+     * @return the number of the erased members
+     */
+    std::size_t erase(sub_con_map<Sp>& subs_map, session_state<Sp> const& ss);
+
+    /**
+     * @brief select the member that the message is delivered to
+     * @param gr    group that is found in sub_con_map
+     * @param topic topic name of the PUBLISH packet
+     * @return selected member. nullptr if there is no member.
+     */
+    member const* select(group const& gr, std::string_view topic) const;
 
 private:
-    struct entry {
-        entry(std::string share_name, session_state<Sp>& ss, std::chrono::time_point<std::chrono::steady_clock> tp);
-
-        std::string const& client_id() const;
-        std::string share_name;
-        session_state_ref<Sp> ssr;
-        std::chrono::time_point<std::chrono::steady_clock> tp;
-        std::map<std::string, subscription<Sp>> tf_subs;
+    //                           share_name        topic_filter
+    using group_key = std::tuple<std::string_view, std::string_view>;
+
+    struct group_key_hash {
+        std::size_t operator()(group_key const& key) const noexcept {
+            std::size_t result = 0;
+            boost::hash_combine(result, std::get<0>(key));
+            boost::hash_combine(result, std::get<1>(key));
+            return result;
+        }
     };
 
-    using mi_shared_target = mi::multi_index_container<
-        entry,
-        mi::indexed_by<
-            mi::ordered_unique<
-                mi::tag<tag_cid_sn>,
-                mi::key<&entry::client_id, &entry::share_name>
-            >,
-            mi::ordered_non_unique<
-                mi::tag<tag_sn_tp>,
-                mi::key<&entry::share_name, &entry::tp>
-            >
-        >
-    >;
-
-    mutable mutex mtx_targets_;
-    mi_shared_target targets_;
+    std::size_t erase_member(sub_con_map<Sp>& subs_map, group& gr, session_state<Sp> const& ss);
+
+    std::atomic<shared_strategy> strategy_{shared_strategy::round_robin};
+    // keys refer to share_name and topic_filter of the group
+    std::unordered_map<group_key, std::unique_ptr<group>, group_key_hash> groups_;
+    // to efficient remove
+    std::unordered_map<session_id_type, std::vector<group*>> session_groups_;
 };
 
 } // namespace async_mqtt
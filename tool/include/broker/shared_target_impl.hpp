@@ -7,7 +7,7 @@
 #if !defined(ASYNC_MQTT_BROKER_SHARED_TARGET_IMPL_HPP)
 #define ASYNC_MQTT_BROKER_SHARED_TARGET_IMPL_HPP
 
-#include <optional>
+#include <algorithm>
 
 #include <broker/shared_target.hpp>
 #include <broker/session_state.hpp>
@@ -15,111 +15,128 @@
 namespace async_mqtt {
 
 template <typename Sp>
-inline void shared_target<Sp>::insert(
+inline void shared_target<Sp>::set_strategy(shared_strategy strategy) {
+    strategy_.store(strategy, std::memory_order_relaxed);
+}
+
+template <typename Sp>
+inline shared_strategy shared_target<Sp>::get_strategy() const {
+    return strategy_.load(std::memory_order_relaxed);
+}
+
+template <typename Sp>
+inline bool shared_target<Sp>::insert(
+    sub_con_map<Sp>& subs_map,
     std::string share_name,
     std::string topic_filter,
     subscription<Sp> sub,
     session_state<Sp>& ss
 ) {
-    std::lock_guard<mutex> g{mtx_targets_};
-    auto& idx = targets_.template get<tag_cid_sn>();
-    auto it = idx.lower_bound(std::make_tuple(ss.client_id(), share_name));
-    if (it == idx.end() || (it->share_name != share_name || it->client_id() != ss.client_id())) {
-        it = idx.emplace_hint(it, force_move(share_name), ss, std::chrono::steady_clock::now());
-
-        // const_cast is appropriate here
-        // See https://github.com/boostorg/multi_index/issues/50
-        auto& st = const_cast<entry&>(*it);
-        bool inserted;
-        std::tie(std::ignore, inserted) = st.tf_subs.emplace(force_move(topic_filter), force_move(sub));
-        BOOST_ASSERT(inserted);
+    auto it = groups_.find(group_key{share_name, topic_filter});
+    if (it == groups_.end()) {
+        auto gr = std::make_unique<group>(force_move(share_name), force_move(topic_filter));
+        group const* p = gr.get();
+        subs_map.insert_or_assign(gr->topic_filter, sub_con_key<Sp>{p}, sub_con_value<Sp>{p});
+        group_key key{gr->share_name, gr->topic_filter};
+        std::tie(it, std::ignore) = groups_.emplace(key, force_move(gr));
     }
-    else {
-        // entry exists
-
-        // const_cast is appropriate here
-        // See https://github.com/boostorg/multi_index/issues/50
-        auto& st = const_cast<entry&>(*it);
-        st.tf_subs.emplace(force_move(topic_filter), force_move(sub)); // ignore overwrite
+    auto& gr = *it->second;
+    auto& members = gr.members();
+    auto mit = std::find_if(
+        members.begin(),
+        members.end(),
+        [&](member const& m) { return m.ssr.get().session_id() == ss.session_id(); }
+    );
+    if (mit == members.end()) {
+        members.push_back(member{ss, force_move(sub)});
+        session_groups_[ss.session_id()].push_back(&gr);
+        return true;
     }
+    // overwrite subscription options
+    mit->sub = force_move(sub);
+    return false;
 }
 
 template <typename Sp>
-inline void shared_target<Sp>::erase(
-    std::string share_name,
-    std::string topic_filter,
+inline std::size_t shared_target<Sp>::erase(
+    sub_con_map<Sp>& subs_map,
+    std::string_view share_name,
+    std::string_view topic_filter,
     session_state<Sp> const& ss
 ) {
-    std::lock_guard<mutex> g{mtx_targets_};
-    auto& idx = targets_.template get<tag_cid_sn>();
-    auto it = idx.find(std::make_tuple(ss.client_id(), share_name));
-    if (it == idx.end()) {
+    auto it = groups_.find(group_key{share_name, topic_filter});
+    auto sit = session_groups_.find(ss.session_id());
+    if (it == groups_.end() || sit == session_groups_.end()) {
         ASYNC_MQTT_LOG("mqtt_broker", warning)
             << "attempt to erase non exist entry"
             << " share_name:" << share_name
             << " topic_filtere:" << topic_filter
             << " client_id:" << ss.client_id();
-        return;
+        return 0;
     }
 
-    // entry exists
-
-    // const_cast is appropriate here
-    // See https://github.com/boostorg/multi_index/issues/50
-    auto& st = const_cast<entry&>(*it);
-    st.tf_subs.erase(topic_filter);
-    if (it->tf_subs.empty()) {
-        idx.erase(it);
-    }
+    auto& gr = *it->second;
+    auto& grs = sit->second;
+    grs.erase(std::remove(grs.begin(), grs.end(), &gr), grs.end());
+    if (grs.empty()) session_groups_.erase(sit);
+    return erase_member(subs_map, gr, ss);
 }
 
 template <typename Sp>
-inline void shared_target<Sp>::erase(
+inline std::size_t shared_target<Sp>::erase(
+    sub_con_map<Sp>& subs_map,
     session_state<Sp> const& ss
 ) {
-    std::lock_guard<mutex> g{mtx_targets_};
-    auto& idx = targets_.template get<tag_cid_sn>();
-    auto r = idx.equal_range(ss.client_id());
-    idx.erase(r.first, r.second);
-}
-
-template <typename Sp>
-inline std::optional<std::tuple<session_state_ref<Sp>, subscription<Sp>>> shared_target<Sp>::get_target(
-    std::string const& share_name,
-    std::string const& topic_filter
-) {
-    std::lock_guard<mutex> g{mtx_targets_};
-    // get share_name matched range ordered by timestamp (ascending)
-    auto& idx = targets_.template get<tag_sn_tp>();
-    auto r = idx.equal_range(share_name);
-    for (; r.first != r.second; ++r.first) {
-        auto const& elem = *r.first;
-        auto it = elem.tf_subs.find(topic_filter);
-
-        // no share_name/topic_filter matched
-        if (it == elem.tf_subs.end()) continue;
-
-        // matched
-        // update timestamp (timestamp is key)
-        idx.modify(r.first, [](auto& e) { e.tp = std::chrono::steady_clock::now(); });
-        return std::make_tuple(elem.ssr, it->second);
+    auto sit = session_groups_.find(ss.session_id());
+    if (sit == session_groups_.end()) return 0;
+    std::size_t erased = 0;
+    for (auto* gr : sit->second) {
+        erased += erase_member(subs_map, *gr, ss);
     }
-    return std::nullopt;
+    session_groups_.erase(sit);
+    return erased;
 }
 
 template <typename Sp>
-inline shared_target<Sp>::entry::entry(
-    std::string share_name,
-    session_state<Sp>& ss,
-    std::chrono::time_point<std::chrono::steady_clock> tp)
-    : share_name { force_move(share_name) },
-      ssr { ss },
-      tp { force_move(tp) }
-{}
+inline typename shared_target<Sp>::member const* shared_target<Sp>::select(
+    group const& gr,
+    std::string_view topic
+) const {
+    // selection is lock free, so publishers don't block each other
+    return gr.select(
+        strategy_.load(std::memory_order_relaxed),
+        topic,
+        [](member const& m) {
+            return m.ssr.get().get_outstanding_publish_count();
+        }
+    );
+}
 
 template <typename Sp>
-inline std::string const& shared_target<Sp>::entry::client_id() const {
-    return ssr.get().client_id();
+inline std::size_t shared_target<Sp>::erase_member(
+    sub_con_map<Sp>& subs_map,
+    group& gr,
+    session_state<Sp> const& ss
+) {
+    std::size_t erased = 0;
+    auto const& ms = gr.members();
+    for (std::size_t i = 0; i != ms.size(); ++i) {
+        if (ms[i].ssr.get().session_id() == ss.session_id()) {
+            gr.erase(i);
+            erased = 1;
+            break;
+        }
+    }
+    if (!gr.empty()) return erased;
+
+    // the group is erased from subs_map before it is destroyed
+    group const* p = &gr;
+    subs_map.erase(gr.topic_filter, sub_con_key<Sp>{p});
+    // the key refers to the strings in the group
+    auto it = groups_.find(group_key{gr.share_name, gr.topic_filter});
+    BOOST_ASSERT(it != groups_.end());
+    groups_.erase(it);
+    return erased;
 }
 
 } // namespace async_mqtt
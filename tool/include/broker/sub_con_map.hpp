@@ -7,13 +7,58 @@
 #if !defined(ASYNC_MQTT_BROKER_SUB_CON_MAP_HPP)
 #define ASYNC_MQTT_BROKER_SUB_CON_MAP_HPP
 
+#include <string>
+#include <variant>
+
 #include <broker/subscription_map.hpp>
 #include <broker/subscription.hpp>
+#include <broker/session_id.hpp>
+#include <broker/session_state_fwd.hpp>
+#include <broker/shared_group.hpp>
+#include <async_mqtt/util/move.hpp>
 
 namespace async_mqtt {
 
 template <typename Sp>
-using sub_con_map = multiple_subscription_map<std::string, subscription<Sp>>;
+struct shared_member {
+    session_state_ref<Sp> ssr;
+    subscription<Sp> sub;
+};
+
+/**
+ * @brief members of one shared subscription (share_name, topic_filter)
+ * The group is stored in sub_con_map as one entry, so a PUBLISH visits the group once
+ * and selects the member from it.
+ * @tparam Sp endpoint type
+ */
+template <typename Sp>
+struct shared_subscription_group : shared_group<shared_member<Sp>> {
+    shared_subscription_group(std::string share_name, std::string topic_filter)
+        :share_name{force_move(share_name)},
+         topic_filter{force_move(topic_filter)}
+    {}
+
+    std::string share_name;
+    std::string topic_filter;
+};
+
+/**
+ * @brief key of sub_con_map
+ * A non shared subscription is keyed by the session id of the subscriber.
+ * A shared subscription group is keyed by the address of the group.
+ */
+template <typename Sp>
+using sub_con_key = std::variant<session_id_type, shared_subscription_group<Sp> const*>;
+
+/**
+ * @brief value of sub_con_map
+ * The subscription of the session, or the shared subscription group.
+ */
+template <typename Sp>
+using sub_con_value = std::variant<subscription<Sp>, shared_subscription_group<Sp> const*>;
+
+template <typename Sp>
+using sub_con_map = multiple_subscription_map<sub_con_key<Sp>, sub_con_value<Sp>>;
 
 } // namespace async_mqtt
 
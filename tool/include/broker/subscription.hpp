@@ -11,6 +11,7 @@
 #include <string>
 
 #include <async_mqtt/protocol/packet/subopts.hpp>
+#include <broker/interned_topic.hpp>
 #include <broker/session_state_fwd.hpp>
 #include <async_mqtt/util/move.hpp>
 
@@ -21,7 +22,7 @@ struct subscription {
     subscription(
         session_state_ref<Sp> ss,
         std::string sharename,
-        std::string topic,
+        interned_topic topic,
         sub::opts opts,
         std::optional<std::size_t> sid)
         :ss{ss},
@@ -33,7 +34,7 @@ struct subscription {
 
     session_state_ref<Sp> ss;
     std::string sharename;
-    std::string topic;
+    interned_topic topic;
     sub::opts opts;
     std::optional<std::size_t> sid;
 };
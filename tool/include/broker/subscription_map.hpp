@@ -7,15 +7,18 @@
 #if !defined(ASYNC_MQTT_BROKER_SUBSCRIPTION_MAP_HPP)
 #define ASYNC_MQTT_BROKER_SUBSCRIPTION_MAP_HPP
 
+#include <cstdint>
 #include <unordered_map>
 #include <string_view>
 #include <optional>
 
 #include <boost/functional/hash.hpp>
 #include <boost/range/adaptor/reversed.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <async_mqtt/util/buffer.hpp>
 
+#include <broker/interned_topic.hpp>
 #include <broker/topic_filter.hpp>
 
 namespace async_mqtt {
@@ -168,7 +171,8 @@ template<typename Value>
 class subscription_map_base {
 public:
     using node_id_type = std::size_t;
-    using path_entry_key = std::pair<node_id_type, std::string>;
+    // The topic level is interned, so the same level under many parents shares one string.
+    using path_entry_key = std::pair<node_id_type, interned_topic>;
     using handle = path_entry_key;
 
 private:
@@ -212,8 +216,31 @@ private:
 
     using this_type = subscription_map_base<Value>;
 
-    // Use boost hash to hash pair in path_entry_key
-    using map_type = std::unordered_map< path_entry_key, path_entry, boost::hash< path_entry_key > >;
+    // Hash and compare the level as a string, so that the map can be looked up by
+    // std::pair<node_id_type, std::string_view> without interning the level.
+    struct path_entry_key_hash {
+        std::size_t operator()(path_entry_key const& key) const {
+            return hash(key.first, key.second);
+        }
+        std::size_t operator()(std::pair<node_id_type, std::string_view> const& key) const {
+            return hash(key.first, key.second);
+        }
+        static std::size_t hash(node_id_type id, std::string_view level) {
+            std::size_t seed = 0;
+            boost::hash_combine(seed, id);
+            boost::hash_combine(seed, std::hash<std::string_view>{}(level));
+            return seed;
+        }
+    };
+
+    struct path_entry_key_equal {
+        template <typename Lhs, typename Rhs>
+        bool operator()(Lhs const& lhs, Rhs const& rhs) const {
+            return lhs.first == rhs.first && std::string_view(lhs.second) == std::string_view(rhs.second);
+        }
+    };
+
+    using map_type = boost::unordered_map< path_entry_key, path_entry, path_entry_key_hash, path_entry_key_equal >;
 
     map_type map;
     using map_type_iterator = typename map_type::iterator;
@@ -234,7 +261,19 @@ protected:
     // Map size tracks the total number of subscriptions within the map
     size_t map_size = 0;
 
+    // Generation is incremented whenever a subscription is inserted or removed
+    std::uint64_t map_generation = 0;
+
     map_type_iterator get_key(path_entry_key key) { return map.find(key); }
+
+    template <typename ThisType>
+    static auto find_child(ThisType& self, node_id_type parent_id, std::string_view level) {
+        return self.map.find(
+            std::pair<node_id_type, std::string_view>(parent_id, level),
+            path_entry_key_hash{},
+            path_entry_key_equal{}
+        );
+    }
     map_type_iterator begin() { return map.begin(); }
     map_type_iterator end() { return map.end(); }
     map_type const& get_map() const { return map; }
@@ -250,7 +289,7 @@ protected:
         topic_filter_tokenizer(
             topic_filter,
             [this, &path, &parent_id](std::string_view t) mutable {
-                auto entry = map.find(path_entry_key(parent_id, t));
+                auto entry = find_child(*this, parent_id, t);
 
                 if (entry == map.end()) {
                     path.clear();
@@ -274,14 +313,14 @@ protected:
         topic_filter_tokenizer(
             topic_filter,
             [this, &parent, &result](std::string_view t) mutable {
-                auto entry = map.find(path_entry_key(parent->second.id, t));
+                auto entry = find_child(*this, parent->second.id, t);
 
                 if (entry == map.end()) {
                     entry =
                         map.emplace(
                             path_entry_key(
                                 parent->second.id,
-                                t
+                                interned_topic(t)
                             ),
                             path_entry(generate_node_id(), parent->first)
                         ).first;
@@ -354,13 +393,13 @@ protected:
 
                 for (auto& entry : entries) {
                     auto parent = entry->second.id;
-                    auto i = self.map.find(path_entry_key(parent, t));
+                    auto i = find_child(self, parent, t);
                     if (i != self.map.end()) {
                         new_entries.push_back(i);
                     }
 
                     if (entry->second.count .has_plus_child()) {
-                        i = self.map.find(path_entry_key(parent, std::string_view("+")));
+                        i = find_child(self, parent, std::string_view("+"));
                         if (i != self.map.end()) {
                             if (parent != self.root_node_id || t.empty() || t[0] != '$') {
                                 new_entries.push_back(i);
@@ -369,7 +408,7 @@ protected:
                     }
 
                     if (entry->second.count.has_hash_child()) {
-                        i = self.map.find(path_entry_key(parent, std::string_view("#")));
+                        i = find_child(self, parent, std::string_view("#"));
                         if (i != self.map.end()) {
                             if (parent != self.root_node_id || t.empty() || t[0] != '$'){
                                 callback(i->second.value);
@@ -441,12 +480,14 @@ protected:
         }
 
         ++map_size;
+        ++map_generation;
     }
 
     // Decrease the map size (total number of subscriptions stored)
     void decrease_map_size() {
         BOOST_ASSERT(map_size > 0);
         --map_size;
+        ++map_generation;
     }
 
     // Increase the number of subscriptions for this path
@@ -460,7 +501,7 @@ protected:
     {
         // Create the root node
         root_node_id = generate_node_id();
-        root_key = path_entry_key(generate_node_id(), buffer());
+        root_key = path_entry_key(generate_node_id(), interned_topic());
         map.emplace(root_key, path_entry(root_node_id, path_entry_key()));
     }
 
@@ -471,6 +512,9 @@ public:
     // Return the number of registered topic filters
     std::size_t size() const { return this->map_size; }
 
+    // Return the generation. It is changed when a subscription is inserted or removed
+    std::uint64_t generation() const { return this->map_generation; }
+
     // Lookup a topic filter
     std::optional<handle> lookup(std::string_view topic_filter) {
         auto path = this->find_topic_filter(topic_filter);
@@ -742,6 +786,17 @@ public:
         );
     }
 
+    // Call the callback with the handle and the values of each registered topic filter
+    // The topic filter can be gotten by handle_to_topic_filter()
+    template<typename Output>
+    void for_each(Output&& callback) const {
+        for (auto const& i : this->get_map()) {
+            if (!i.second.value.empty()) {
+                callback(i.first, i.second.value);
+            }
+        }
+    }
+
     template<typename Output>
     void dump(Output &out) {
         out << "Root node id: " << this->root_node_id << std::endl;
@@ -0,0 +1,529 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(ASYNC_MQTT_BROKER_TLS_RESUMPTION_HPP)
+#define ASYNC_MQTT_BROKER_TLS_RESUMPTION_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <boost/asio/ssl.hpp>
+
+#include <openssl/rand.h>
+#include <openssl/evp.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#else  // OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/hmac.h>
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+#include <async_mqtt/util/log.hpp>
+
+#include <broker/mutex.hpp>
+
+namespace async_mqtt {
+
+namespace as = boost::asio;
+
+/**
+ * @brief counters of TLS handshakes and resumptions
+ * All counters are updated from any threads.
+ */
+struct tls_resumption_stats {
+    std::atomic<std::uint64_t> full_handshakes{0};
+    std::atomic<std::uint64_t> resumed_handshakes{0};
+    std::atomic<std::uint64_t> handshake_errors{0};
+    std::atomic<std::uint64_t> cache_hits{0};
+    std::atomic<std::uint64_t> cache_misses{0};
+    std::atomic<std::uint64_t> cache_stores{0};
+    std::atomic<std::uint64_t> cache_evictions{0};
+    std::atomic<std::uint64_t> tickets_issued{0};
+    std::atomic<std::uint64_t> tickets_accepted{0};
+    std::atomic<std::uint64_t> tickets_renewed{0};
+    std::atomic<std::uint64_t> tickets_unknown_key{0};
+    std::atomic<std::uint64_t> ticket_key_rotations{0};
+
+    /**
+     * @brief resumed handshakes / all succeeded handshakes
+     * @return rate in percent
+     */
+    double resumption_rate() const {
+        auto full = full_handshakes.load(std::memory_order_relaxed);
+        auto resumed = resumed_handshakes.load(std::memory_order_relaxed);
+        if (full + resumed == 0) return 0;
+        return double(resumed) * 100 / double(full + resumed);
+    }
+
+    friend
+    std::ostream& operator<<(std::ostream& o, tls_resumption_stats const& v) {
+        auto ld = [](auto const& a) { return a.load(std::memory_order_relaxed); };
+        o << "handshake"
+          << " full:" << ld(v.full_handshakes)
+          << " resumed:" << ld(v.resumed_handshakes)
+          << " error:" << ld(v.handshake_errors)
+          << " resumption_rate:" << v.resumption_rate() << "%"
+          << " cache"
+          << " hit:" << ld(v.cache_hits)
+          << " miss:" << ld(v.cache_misses)
+          << " store:" << ld(v.cache_stores)
+          << " evict:" << ld(v.cache_evictions)
+          << " ticket"
+          << " issued:" << ld(v.tickets_issued)
+          << " accepted:" << ld(v.tickets_accepted)
+          << " renewed:" << ld(v.tickets_renewed)
+          << " unknown_key:" << ld(v.tickets_unknown_key)
+          << " key_rotations:" << ld(v.ticket_key_rotations);
+        return o;
+    }
+};
+
+/**
+ * @brief server side TLS session cache that is shared by the all threads
+ * OpenSSL's internal cache is protected by one lock per SSL_CTX and is
+ * flushed only when the cache is full. This cache is divided into shards
+ * that have their own lock, LRU list, and capacity. Expired sessions are
+ * removed on lookup and on insertion.
+ */
+class tls_session_cache {
+public:
+    /**
+     * @brief constructor
+     * @param capacity     max number of sessions. divided into shards.
+     * @param num_of_shards number of shards
+     * @param ttl          lifetime of the session
+     * @param stats        counters
+     */
+    tls_session_cache(
+        std::size_t capacity,
+        std::size_t num_of_shards,
+        std::chrono::seconds ttl,
+        tls_resumption_stats& stats
+    ):num_of_shards_{std::max(num_of_shards, std::size_t(1))},
+      shard_capacity_{std::max(capacity / num_of_shards_, std::size_t(1))},
+      ttl_{ttl},
+      shards_{std::make_unique<shard[]>(num_of_shards_)},
+      stats_{stats}
+    {}
+
+    tls_session_cache(tls_session_cache const&) = delete;
+    tls_session_cache& operator=(tls_session_cache const&) = delete;
+
+    /**
+     * @brief store the session. the reference of the session is moved to the cache.
+     * @param sess session
+     */
+    void insert(SSL_SESSION* sess) {
+        auto key = session_key(sess);
+        auto& s = get_shard(key);
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> g{s.mtx};
+        if (auto it = s.map.find(key); it != s.map.end()) {
+            s.erase(it->second);
+        }
+        // the oldest entry is at the back
+        while (
+            !s.lru.empty() &&
+            (s.lru.size() >= shard_capacity_ || s.lru.back().expiry <= now)
+        ) {
+            s.erase(std::prev(s.lru.end()));
+            ++stats_.cache_evictions;
+        }
+        s.lru.push_front(entry{key, session_ptr{sess}, now + ttl_});
+        s.map.emplace(s.lru.front().key, s.lru.begin());
+        ++stats_.cache_stores;
+    }
+
+    /**
+     * @brief find the session
+     * @param id session id
+     * @return session that has a new reference. nullptr if not found.
+     */
+    SSL_SESSION* find(std::string_view id) {
+        auto& s = get_shard(id);
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> g{s.mtx};
+        auto it = s.map.find(std::string{id});
+        if (it == s.map.end()) {
+            ++stats_.cache_misses;
+            return nullptr;
+        }
+        auto lit = it->second;
+        if (lit->expiry <= now) {
+            s.erase(lit);
+            ++stats_.cache_evictions;
+            ++stats_.cache_misses;
+            return nullptr;
+        }
+        s.lru.splice(s.lru.begin(), s.lru, lit);
+        ++stats_.cache_hits;
+        ::SSL_SESSION_up_ref(lit->sess.get());
+        return lit->sess.get();
+    }
+
+    /**
+     * @brief remove the session
+     * OpenSSL calls it when the session becomes invalid.
+     * @param id session id
+     */
+    void erase(std::string_view id) {
+        auto& s = get_shard(id);
+        std::lock_guard<std::mutex> g{s.mtx};
+        if (auto it = s.map.find(std::string{id}); it != s.map.end()) {
+            s.erase(it->second);
+        }
+    }
+
+    static std::string session_key(SSL_SESSION const* sess) {
+        unsigned int len = 0;
+        auto id = ::SSL_SESSION_get_id(sess, &len);
+        return std::string(reinterpret_cast<char const*>(id), len);
+    }
+
+private:
+    struct session_deleter {
+        void operator()(SSL_SESSION* p) const {
+            ::SSL_SESSION_free(p);
+        }
+    };
+    using session_ptr = std::unique_ptr<SSL_SESSION, session_deleter>;
+
+    struct entry {
+        std::string key;
+        session_ptr sess;
+        std::chrono::steady_clock::time_point expiry;
+    };
+
+    struct shard {
+        void erase(std::list<entry>::iterator it) {
+            map.erase(it->key);
+            lru.erase(it);
+        }
+
+        std::mutex mtx;
+        std::list<entry> lru;
+        std::unordered_map<std::string, std::list<entry>::iterator> map;
+    };
+
+    shard& get_shard(std::string_view key) {
+        return shards_[std::hash<std::string_view>{}(key) % num_of_shards_];
+    }
+
+    std::size_t num_of_shards_;
+    std::size_t shard_capacity_;
+    std::chrono::seconds ttl_;
+    std::unique_ptr<shard[]> shards_;
+    tls_resumption_stats& stats_;
+};
+
+/**
+ * @brief session ticket keys that are rotated periodically
+ * The newest key encrypts new tickets. The older keys only decrypt tickets
+ * until the tickets expire. If a ticket encrypted by an older key is used,
+ * the client gets a new ticket.
+ */
+class tls_ticket_keys {
+public:
+    static constexpr std::size_t name_size = 16;
+    static constexpr std::size_t secret_size = 32;
+
+    /**
+     * @brief constructor
+     * @param rotation interval of the key rotation
+     * @param ttl      lifetime of the ticket
+     * @param stats    counters
+     */
+    tls_ticket_keys(
+        std::chrono::seconds rotation,
+        std::chrono::seconds ttl,
+        tls_resumption_stats& stats
+    ):rotation_{rotation},
+      ttl_{ttl},
+      stats_{stats}
+    {
+        std::lock_guard<mutex> g{mtx_};
+        keys_.push_front(make_key(std::chrono::steady_clock::now()));
+    }
+
+    tls_ticket_keys(tls_ticket_keys const&) = delete;
+    tls_ticket_keys& operator=(tls_ticket_keys const&) = delete;
+
+    struct key {
+        std::array<unsigned char, name_size> name;
+        std::array<unsigned char, secret_size> aes;
+        std::array<unsigned char, secret_size> hmac;
+        std::chrono::steady_clock::time_point created;
+    };
+
+    /**
+     * @brief get the current key. rotate the keys if the current key is old.
+     * @return current key
+     */
+    key current() {
+        auto now = std::chrono::steady_clock::now();
+        {
+            std::shared_lock<mutex> g{mtx_};
+            if (now - keys_.front().created < rotation_) return keys_.front();
+        }
+        std::lock_guard<mutex> g{mtx_};
+        if (now - keys_.front().created >= rotation_) {
+            keys_.push_front(make_key(now));
+            ++stats_.ticket_key_rotations;
+            // tickets encrypted by the key are valid until ttl after the next key is created
+            while (keys_.size() > 1 && now - std::prev(keys_.end(), 2)->created >= ttl_) {
+                keys_.pop_back();
+            }
+            ASYNC_MQTT_LOG("mqtt_broker", info)
+                << "TLS ticket key rotated. keys:" << keys_.size();
+        }
+        return keys_.front();
+    }
+
+    /**
+     * @brief find the key that encrypted the ticket
+     * @param name key name in the ticket
+     * @param k    found key is set
+     * @return 0: not found, 1: found current key, 2: found older key
+     */
+    int find(unsigned char const* name, key& k) const {
+        std::shared_lock<mutex> g{mtx_};
+        for (auto it = keys_.begin(); it != keys_.end(); ++it) {
+            if (std::memcmp(it->name.data(), name, name_size) == 0) {
+                k = *it;
+                return it == keys_.begin() ? 1 : 2;
+            }
+        }
+        return 0;
+    }
+
+private:
+    static key make_key(std::chrono::steady_clock::time_point now) {
+        key k;
+        if (
+            ::RAND_bytes(k.name.data(), int(k.name.size())) != 1 ||
+            ::RAND_bytes(k.aes.data(), int(k.aes.size())) != 1 ||
+            ::RAND_bytes(k.hmac.data(), int(k.hmac.size())) != 1
+        ) {
+            throw std::runtime_error("Failed to generate TLS ticket key");
+        }
+        k.created = now;
+        return k;
+    }
+
+    std::chrono::seconds rotation_;
+    std::chrono::seconds ttl_;
+    mutable mutex mtx_;
+    std::deque<key> keys_;
+    tls_resumption_stats& stats_;
+};
+
+/**
+ * @brief TLS session resumption of the broker
+ * attach() sets the shared session cache and the rotating ticket keys
+ * to as::ssl::context. The same object can be attached to the contexts
+ * of the all listeners. The session id context separates the sessions,
+ * so a session of a verify_none listener is not resumed on a verify_peer listener.
+ * The object must be alive while the contexts are alive.
+ */
+class tls_resumption {
+public:
+    /**
+     * @brief constructor
+     * @param cache_size    max number of cached sessions. 0 means no session cache.
+     * @param cache_shards  number of shards of the session cache
+     * @param ttl           lifetime of the sessions and the tickets
+     * @param tickets       if true, session tickets are issued
+     * @param key_rotation  interval of the ticket key rotation
+     */
+    tls_resumption(
+        std::size_t cache_size,
+        std::size_t cache_shards,
+        std::chrono::seconds ttl,
+        bool tickets,
+        std::chrono::seconds key_rotation
+    ):ttl_{ttl}
+    {
+        if (cache_size != 0) {
+            cache_.emplace(cache_size, cache_shards, ttl, stats_);
+        }
+        if (tickets) {
+            keys_.emplace(key_rotation, ttl, stats_);
+        }
+    }
+
+    tls_resumption(tls_resumption const&) = delete;
+    tls_resumption& operator=(tls_resumption const&) = delete;
+
+    /**
+     * @brief set the session cache and the ticket keys to the context
+     * @param ctx    context
+     * @param sid_ctx session id context. different value should be used for each listener.
+     */
+    void attach(as::ssl::context& ctx, std::string_view sid_ctx) {
+        auto native = ctx.native_handle();
+        ::SSL_CTX_set_ex_data(native, ex_index(), this);
+        ::SSL_CTX_set_session_id_context(
+            native,
+            reinterpret_cast<unsigned char const*>(sid_ctx.data()),
+            static_cast<unsigned int>(std::min(sid_ctx.size(), std::size_t(SSL_MAX_SID_CTX_LENGTH)))
+        );
+        ::SSL_CTX_set_timeout(native, static_cast<long>(ttl_.count()));
+        if (cache_) {
+            ::SSL_CTX_set_session_cache_mode(
+                native,
+                SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL
+            );
+            ::SSL_CTX_sess_set_new_cb(native, &tls_resumption::new_session_cb);
+            ::SSL_CTX_sess_set_get_cb(native, &tls_resumption::get_session_cb);
+            ::SSL_CTX_sess_set_remove_cb(native, &tls_resumption::remove_session_cb);
+        }
+        else {
+            ::SSL_CTX_set_session_cache_mode(native, SSL_SESS_CACHE_OFF);
+        }
+        if (keys_) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+            ::SSL_CTX_set_tlsext_ticket_key_evp_cb(native, &tls_resumption::ticket_key_cb);
+#else  // OPENSSL_VERSION_NUMBER >= 0x30000000L
+            ::SSL_CTX_set_tlsext_ticket_key_cb(native, &tls_resumption::ticket_key_cb);
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+        }
+        else {
+            ::SSL_CTX_set_options(native, SSL_OP_NO_TICKET);
+        }
+    }
+
+    /**
+     * @brief count the handshake result
+     * @param ssl SSL object that finished the handshake
+     */
+    void handshake_succeeded(SSL* ssl) {
+        if (::SSL_session_reused(ssl)) {
+            ++stats_.resumed_handshakes;
+        }
+        else {
+            ++stats_.full_handshakes;
+        }
+    }
+
+    void handshake_failed() {
+        ++stats_.handshake_errors;
+    }
+
+    tls_resumption_stats const& stats() const {
+        return stats_;
+    }
+
+private:
+    static int ex_index() {
+        static int index = ::SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        return index;
+    }
+
+    static tls_resumption& get(SSL_CTX* ctx) {
+        return *static_cast<tls_resumption*>(::SSL_CTX_get_ex_data(ctx, ex_index()));
+    }
+
+    static int new_session_cb(SSL* ssl, SSL_SESSION* sess) {
+        auto& self = get(::SSL_get_SSL_CTX(ssl));
+        self.cache_->insert(sess);
+        // the cache has the reference
+        return 1;
+    }
+
+    static SSL_SESSION* get_session_cb(SSL* ssl, unsigned char const* id, int len, int* copy) {
+        auto& self = get(::SSL_get_SSL_CTX(ssl));
+        // the reference is already added by find()
+        *copy = 0;
+        return self.cache_->find(
+            std::string_view{reinterpret_cast<char const*>(id), static_cast<std::size_t>(len)}
+        );
+    }
+
+    static void remove_session_cb(SSL_CTX* ctx, SSL_SESSION* sess) {
+        auto& self = get(ctx);
+        self.cache_->erase(tls_session_cache::session_key(sess));
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static int ticket_key_cb(
+        SSL* ssl,
+        unsigned char* key_name,
+        unsigned char* iv,
+        EVP_CIPHER_CTX* cctx,
+        EVP_MAC_CTX* hctx,
+        int enc
+    ) {
+        auto set_hmac =
+            [&](tls_ticket_keys::key& k) {
+                OSSL_PARAM params[] = {
+                    OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, k.hmac.data(), k.hmac.size()),
+                    OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0),
+                    OSSL_PARAM_construct_end()
+                };
+                return ::EVP_MAC_CTX_set_params(hctx, params) == 1;
+            };
+#else  // OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static int ticket_key_cb(
+        SSL* ssl,
+        unsigned char* key_name,
+        unsigned char* iv,
+        EVP_CIPHER_CTX* cctx,
+        HMAC_CTX* hctx,
+        int enc
+    ) {
+        auto set_hmac =
+            [&](tls_ticket_keys::key& k) {
+                return ::HMAC_Init_ex(hctx, k.hmac.data(), int(k.hmac.size()), ::EVP_sha256(), nullptr) == 1;
+            };
+#endif // OPENSSL_VERSION_NUMBER >= 0x30000000L
+        auto& self = get(::SSL_get_SSL_CTX(ssl));
+        if (enc) {
+            auto k = self.keys_->current();
+            if (::RAND_bytes(iv, EVP_CIPHER_iv_length(::EVP_aes_256_cbc())) != 1) return -1;
+            std::memcpy(key_name, k.name.data(), k.name.size());
+            if (::EVP_EncryptInit_ex(cctx, ::EVP_aes_256_cbc(), nullptr, k.aes.data(), iv) != 1) return -1;
+            if (!set_hmac(k)) return -1;
+            ++self.stats_.tickets_issued;
+            return 1;
+        }
+        tls_ticket_keys::key k;
+        auto ret = self.keys_->find(key_name, k);
+        if (ret == 0) {
+            // full handshake
+            ++self.stats_.tickets_unknown_key;
+            return 0;
+        }
+        if (!set_hmac(k)) return -1;
+        if (::EVP_DecryptInit_ex(cctx, ::EVP_aes_256_cbc(), nullptr, k.aes.data(), iv) != 1) return -1;
+        ++self.stats_.tickets_accepted;
+        // 2 means the ticket is renewed by the current key
+        if (ret == 2) ++self.stats_.tickets_renewed;
+        return ret;
+    }
+
+    std::chrono::seconds ttl_;
+    tls_resumption_stats stats_;
+    std::optional<tls_session_cache> cache_;
+    std::optional<tls_ticket_keys> keys_;
+};
+
+} // namespace async_mqtt
+
+#endif // ASYNC_MQTT_BROKER_TLS_RESUMPTION_HPP
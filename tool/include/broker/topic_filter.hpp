@@ -8,9 +8,12 @@
 #define ASYNC_MQTT_BROKER_TOPIC_FILTER_HPP
 
 #include <algorithm>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <limits>
 #include <cstdint>
+#include <vector>
 
 #include <boost/assert.hpp>
 
@@ -260,6 +263,126 @@ static_assert(compare_topic_filter("bob/alice/#", "bob/alice/mary/sue"), "Each n
 static_assert(compare_topic_filter("bob/alice/mary/#", "bob/alice/mary/sue"), "Each non-wildcarded level in the Topic Filter has to match the corresponding level in the Topic Name character for character for the match to succeed");
 static_assert( ! compare_topic_filter("bob/alice/mary/sue/#", "bob/alice/mary/sue"), "Each non-wildcarded level in the Topic Filter has to match the corresponding level in the Topic Name character for character for the match to succeed");
 
+namespace detail {
+
+inline std::vector<std::string_view> topic_filter_levels(std::string_view topic_filter) {
+    std::vector<std::string_view> levels;
+    topic_filter_tokenizer(
+        topic_filter,
+        [&levels](std::string_view t) {
+            levels.push_back(t);
+            return true;
+        }
+    );
+    return levels;
+}
+
+// A topic name beginning with $ doesn't match the wildcard at the first level
+inline bool topic_filter_level_matches_wildcard(std::string_view level, std::size_t index) {
+    return index != 0 || level.empty() || level[0] != '$';
+}
+
+} // namespace detail
+
+/**
+ * @brief check if the topic filter covers the other topic filter
+ * It is conservative. If it is not sure, it returns false.
+ * @param cover  topic filter that covers
+ * @param filter topic filter that is covered
+ * @return true if all topic names that match `filter` also match `cover`
+ */
+inline bool topic_filter_covers(std::string_view cover, std::string_view filter) {
+    auto cs = detail::topic_filter_levels(cover);
+    auto fs = detail::topic_filter_levels(filter);
+    for (std::size_t i = 0; i != cs.size(); ++i) {
+        auto c = cs[i];
+        if (i == fs.size()) {
+            // `filter` is shorter. The broker doesn't match "a/#" with "a".
+            return false;
+        }
+        auto f = fs[i];
+        if (c == "#") {
+            return f == "#" || f == "+" || detail::topic_filter_level_matches_wildcard(f, i);
+        }
+        if (f == "#") return false;
+        if (c == "+") {
+            if (f != "+" && !detail::topic_filter_level_matches_wildcard(f, i)) return false;
+            continue;
+        }
+        if (c != f) return false;
+    }
+    return cs.size() == fs.size();
+}
+
+/**
+ * @brief check if the topic filters overlap
+ * It is liberal. If it is not sure, it returns true.
+ * @param lhs topic filter
+ * @param rhs topic filter
+ * @return true if a topic name could match both `lhs` and `rhs`
+ */
+inline bool topic_filter_overlaps(std::string_view lhs, std::string_view rhs) {
+    auto ls = detail::topic_filter_levels(lhs);
+    auto rs = detail::topic_filter_levels(rhs);
+    for (std::size_t i = 0; i != std::min(ls.size(), rs.size()); ++i) {
+        auto l = ls[i];
+        auto r = rs[i];
+        if (l == "#" || r == "#") {
+            if (l == "#" && r != "#" && r != "+") return detail::topic_filter_level_matches_wildcard(r, i);
+            if (r == "#" && l != "#" && l != "+") return detail::topic_filter_level_matches_wildcard(l, i);
+            return true;
+        }
+        if (l == "+" || r == "+") {
+            if (l != "+" && !detail::topic_filter_level_matches_wildcard(l, i)) return false;
+            if (r != "+" && !detail::topic_filter_level_matches_wildcard(r, i)) return false;
+            continue;
+        }
+        if (l != r) return false;
+    }
+    if (ls.size() == rs.size()) return true;
+    // "a/#" could match "a"
+    auto const& longer = ls.size() > rs.size() ? ls : rs;
+    return longer[std::min(ls.size(), rs.size())] == "#";
+}
+
+/**
+ * @brief get the narrowest topic filter that covers both topic filters
+ * The different levels are replaced with '+'. The levels from '#' are replaced with '#'.
+ * If the numbers of the levels are different, the last common level is replaced with '#'.
+ * e.g. "a/+/c" and "a/b/#" are covered by "a/+/#".
+ * @param lhs topic filter
+ * @param rhs topic filter
+ * @return topic filter that covers both `lhs` and `rhs`. std::nullopt if no wildcard
+ *         can cover them (e.g. the topic names beginning with $ at the first level)
+ */
+inline std::optional<std::string> topic_filter_common_cover(std::string_view lhs, std::string_view rhs) {
+    auto ls = detail::topic_filter_levels(lhs);
+    auto rs = detail::topic_filter_levels(rhs);
+    std::vector<std::string_view> cs;
+    bool multi = false;
+    for (std::size_t i = 0; i != std::min(ls.size(), rs.size()); ++i) {
+        auto l = ls[i];
+        auto r = rs[i];
+        if (l == "#" || r == "#") {
+            cs.push_back("#");
+            multi = true;
+            break;
+        }
+        cs.push_back(l == r ? l : "+");
+    }
+    if (!multi && ls.size() != rs.size()) {
+        // The broker doesn't match "a/#" with "a", so '#' starts from the last common level.
+        cs.back() = "#";
+    }
+    std::string cover;
+    for (auto c : cs) {
+        if (!cover.empty()) cover.push_back(topic_filter_separator);
+        cover.append(c);
+    }
+    if (!topic_filter_covers(cover, lhs) || !topic_filter_covers(cover, rhs)) return std::nullopt;
+    return cover;
+}
+
 } // namespace async_mqtt
 
 #endif // MQTT_BROKER_TOPIC_FILTER_HPP
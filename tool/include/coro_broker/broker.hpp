@@ -7,17 +7,25 @@
 #if !defined(ASYNC_MQTT_BROKER_BROKER_HPP)
 #define ASYNC_MQTT_BROKER_BROKER_HPP
 
+#include <cstdio>
+#include <fstream>
+#include <set>
+
 #include <boost/asio/experimental/parallel_group.hpp>
 
 #include <async_mqtt/all.hpp>
 #include <broker/endpoint_variant.hpp>
 #include <broker/security.hpp>
+#include <broker/auth_cache.hpp>
+#include <broker/bridge_topic.hpp>
 #include <broker/mutex.hpp>
 #include <coro_broker/session_state.hpp>
 #include <broker/sub_con_map.hpp>
 #include <broker/retained_messages.hpp>
 #include <broker/retained_topic_map.hpp>
 #include <broker/shared_target_impl.hpp>
+#include <broker/interned_topic.hpp>
+#include <broker/metrics.hpp>
 #include <broker/mutex.hpp>
 #include <broker/uuid.hpp>
 
@@ -54,9 +62,198 @@ public:
     void set_security(security&& sec) {
         std::unique_lock<mutex> g_sec{mtx_security_};
         security_ = force_move(sec);
+        auth_cache_.clear();
+    }
+
+    /**
+     * @brief set the TTL of the authentication cache
+     * A user name and password pair that is verified successfully is cached for the TTL,
+     * so that reconnecting clients skip looking up the authentication settings.
+     * The cache keeps a salted SHA-256 digest, so each login still calculates one digest
+     * while the cache is enabled. The cache is cleared when set_security() is called.
+     * @param ttl TTL. zero disables the cache. The default is zero
+     */
+    void set_auth_cache_ttl(std::chrono::steady_clock::duration ttl) {
+        auth_cache_.set_ttl(ttl);
+    }
+
+    /**
+     * @brief set the executor that verifies the passwords
+     * If set, the password of the CONNECT packet is verified on the executor, and then
+     * CONNACK is sent on the endpoint's strand.
+     * @param exe executor. std::nullopt means the password is verified on the endpoint's strand.
+     *            The default is std::nullopt
+     */
+    void set_auth_executor(std::optional<as::any_io_executor> exe) {
+        auth_exe_ = force_move(exe);
+    }
+
+    /**
+     * @brief set the load balancing strategy of shared subscriptions
+     * @param strategy strategy. The default is shared_strategy::round_robin
+     */
+    void set_shared_sub_strategy(shared_strategy strategy) {
+        shared_targets_.set_strategy(strategy);
+    }
+
+    /**
+     * @brief set the page size of the retained messages delivery
+     * When a client subscribes, the matched retained messages are found and sent page by page.
+     * @param size maximum number of the topics that are visited on one page. The default is 256
+     */
+    void set_retained_page_size(std::size_t size) {
+        BOOST_ASSERT(size != 0);
+        retained_page_size_ = size;
+    }
+
+    /**
+     * @brief set the limits of the outbound queues
+     * The outbound queue contains the PUBLISH messages that are passed to the endpoint
+     * but not written yet. 0 means unlimited. All limits are unlimited by default.
+     * @param session_max_bytes    maximum queued bytes of each session
+     * @param session_max_messages maximum number of the queued messages of each session
+     * @param global_max_bytes     maximum queued bytes of all sessions
+     * @param global_max_messages  maximum number of the queued messages of all sessions
+     */
+    void set_outbound_queue_limits(
+        std::size_t session_max_bytes,
+        std::size_t session_max_messages,
+        std::size_t global_max_bytes,
+        std::size_t global_max_messages
+    ) {
+        outbound_limits_.set_session_limits(session_max_bytes, session_max_messages);
+        outbound_limits_.set_global_limits(global_max_bytes, global_max_messages);
+    }
+
+    /**
+     * @brief set the limits of the offline messages of each session
+     * If a message exceeds the limits, it is dropped regardless of the QoS.
+     * 0 means unlimited. All limits are unlimited by default.
+     * @param max_bytes    maximum bytes (topic name + payload) of the offline messages of each session
+     * @param max_messages maximum number of the offline messages of each session
+     */
+    void set_offline_message_limits(std::size_t max_bytes, std::size_t max_messages) {
+        outbound_limits_.set_offline_limits(max_bytes, max_messages);
+    }
+
+    /**
+     * @brief set the policy when the outbound queue exceeds the limits
+     * @param policy policy. The default is slow_consumer_policy::drop_qos0
+     */
+    void set_slow_consumer_policy(slow_consumer_policy policy) {
+        outbound_limits_.set_policy(policy);
+    }
+
+    /**
+     * @brief set the users that are allowed to connect as the bridges of the other brokers
+     * A CONNECT packet that has the bridge property makes the session a bridge session only if
+     * the authenticated user is one of them. It should be called before the broker accepts clients.
+     * @param users user names. The default is empty, so no client becomes a bridge
+     */
+    void set_bridge_users(std::set<std::string> users) {
+        bridge_users_ = force_move(users);
+    }
+
+    /**
+     * @brief set the automatic topic alias mapping of the PUBLISH packets sent to the clients
+     * It is enabled for each v5 client that sends Topic Alias Maximum greater than 0 on CONNECT.
+     * @param policy policy. std::nullopt disables the mapping. The default is std::nullopt
+     */
+    void set_auto_map_topic_alias_send(std::optional<topic_alias_send_policy> policy) {
+        topic_alias_send_policy_ = policy;
+    }
+
+    /**
+     * @brief get the outbound queue limits
+     * It contains the total queue depth and the dropped message count of all sessions.
+     * @return outbound queue limits
+     */
+    outbound_queue_limits const& get_outbound_queue_limits() const {
+        return outbound_limits_;
+    }
+
+    /**
+     * @brief start the periodic metrics output
+     * The metrics are aggregated every interval. They are published on the $SYS/broker/...
+     * topics as retained QoS0 messages and/or written to the file in the Prometheus text format.
+     * @param exe             executor of the timer
+     * @param interval        aggregation interval
+     * @param sys_topics      if true, publish the metrics on the $SYS topics
+     * @param prometheus_file if set, the metrics are written to the file
+     */
+    void start_metrics(
+        as::any_io_executor exe,
+        std::chrono::steady_clock::duration interval,
+        bool sys_topics,
+        std::optional<std::string> prometheus_file = std::nullopt
+    ) {
+        BOOST_ASSERT(interval > std::chrono::steady_clock::duration::zero());
+        as::co_spawn(
+            exe,
+            metrics_loop(exe, interval, sys_topics, force_move(prometheus_file)),
+            as::detached
+        );
+    }
+
+    /**
+     * @brief get the current metrics
+     * @return aggregated metrics
+     */
+    broker_metrics_snapshot get_metrics() const {
+        return metrics_.aggregate();
     }
 
 private:
+    as::awaitable<void>
+    metrics_loop(
+        as::any_io_executor exe,
+        std::chrono::steady_clock::duration interval,
+        bool sys_topics,
+        std::optional<std::string> prometheus_file
+    ) {
+        as::steady_timer tim{exe};
+        while (true) {
+            tim.expires_after(interval);
+            auto [ec] = co_await tim.async_wait(as::as_tuple(as::use_awaitable));
+            if (ec) co_return;
+            auto ss = metrics_.aggregate();
+            if (sys_topics) {
+                for (auto& [topic, value] : async_mqtt::sys_topics(ss)) {
+                    co_await do_publish(
+                        no_session_id,
+                        protocol_version::v5,
+                        exe,
+                        force_move(topic),
+                        std::vector<buffer>{buffer{force_move(value)}},
+                        qos::at_most_once | pub::retain::yes,
+                        properties{}
+                    );
+                }
+            }
+            if (prometheus_file) {
+                write_metrics_file(*prometheus_file, ss);
+            }
+        }
+    }
+
+    static void write_metrics_file(std::string const& path, broker_metrics_snapshot const& ss) {
+        // write to the temporary file and rename it, so that the scraper never reads a partial file
+        auto tmp = path + ".tmp";
+        {
+            std::ofstream ofs{tmp};
+            write_prometheus(ofs, ss);
+            if (!ofs) {
+                ASYNC_MQTT_LOG("mqtt_broker", warning)
+                    << "failed to write metrics file:" << tmp;
+                return;
+            }
+        }
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+            ASYNC_MQTT_LOG("mqtt_broker", warning)
+                << "failed to rename metrics file:" << tmp << " to " << path;
+        }
+    }
+
     as::awaitable<void>
     recv_loop(epsp_type epsp) {
         bool cont = true;
@@ -317,22 +514,24 @@ private:
         co_return cont;
     }
 
-    as::awaitable<void>
-    connect_handler(
-        epsp_type& epsp,
-        std::string client_id,
-        std::optional<std::string> noauth_username,
-        std::optional<std::string> password,
-        std::optional<will> will,
-        bool clean_start,
-        std::uint16_t /*keep_alive*/,
-        properties props
+    /**
+     * @brief authenticate the user of the CONNECT packet
+     * The verified user name and password pair is cached if the auth cache is enabled.
+     * @param preauthed_user_name user name of the client certificate
+     * @param noauth_username     user name of the CONNECT packet
+     * @param password            password of the CONNECT packet
+     * @return authenticated user name. std::nullopt if login fails.
+     */
+    std::optional<std::string> authenticate(
+        std::optional<std::string> const& preauthed_user_name,
+        std::optional<std::string> const& noauth_username,
+        std::optional<std::string> const& password
     ) {
         std::optional<std::string> username;
-        if (auto paun_opt = epsp.get_preauthed_user_name()) {
+        if (preauthed_user_name) {
             std::shared_lock<mutex> g_sec{mtx_security_};
-            if (security_.login_cert(*paun_opt)) {
-                username = force_move(*paun_opt);
+            if (security_.login_cert(*preauthed_user_name)) {
+                username = *preauthed_user_name;
             }
         }
         else if (!noauth_username && !password) {
@@ -340,8 +539,19 @@ private:
             username = security_.login_anonymous();
         }
         else if (noauth_username && password) {
-            std::shared_lock<mutex> g_sec{mtx_security_};
-            username = security_.login(*noauth_username, *password);
+            // the digest is calculated once for both find and insert
+            std::optional<std::string> digest;
+            if (auth_cache_.enabled()) digest.emplace(auth_cache_.digest(*password));
+            if (digest && auth_cache_.find(*noauth_username, *digest)) {
+                username = *noauth_username;
+            }
+            else {
+                std::shared_lock<mutex> g_sec{mtx_security_};
+                username = security_.login(*noauth_username, *password);
+                // inserted under the lock. otherwise, the pair that is verified by the old
+                // settings could be inserted after set_security() clears the cache
+                if (username && digest) auth_cache_.insert(*noauth_username, force_move(*digest));
+            }
         }
 
         // If login fails, try the unauthenticated user
@@ -349,6 +559,35 @@ private:
             std::shared_lock<mutex> g_sec{mtx_security_};
             username = security_.login_unauthenticated();
         }
+        return username;
+    }
+
+    as::awaitable<void>
+    connect_handler(
+        epsp_type& epsp,
+        std::string client_id,
+        std::optional<std::string> noauth_username,
+        std::optional<std::string> password,
+        std::optional<will> will,
+        bool clean_start,
+        std::uint16_t /*keep_alive*/,
+        properties props
+    ) {
+        std::optional<std::string> username;
+        if (auth_exe_ && !epsp.get_preauthed_user_name() && noauth_username && password) {
+            // The password is verified on the auth executor, and then
+            // the coroutine resumes on the endpoint's strand.
+            username = co_await as::co_spawn(
+                *auth_exe_,
+                [&]() -> as::awaitable<std::optional<std::string>> {
+                    co_return authenticate(std::nullopt, noauth_username, password);
+                },
+                as::use_awaitable
+            );
+        }
+        else {
+            username = authenticate(epsp.get_preauthed_user_name(), noauth_username, password);
+        }
 
         std::optional<std::chrono::steady_clock::duration> session_expiry_interval;
         std::optional<std::chrono::steady_clock::duration> will_expiry_interval;
@@ -367,6 +606,11 @@ private:
                         [&](property::request_response_information const& v) {
                             response_topic_requested = v.val();
                         },
+                        [&](property::topic_alias_maximum const& v) {
+                            if (topic_alias_send_policy_ && v.val() != 0) {
+                                epsp.enable_auto_map_topic_alias_send(*topic_alias_send_policy_);
+                            }
+                        },
                         [&](auto const&) {}
                     }
                 );
@@ -384,6 +628,16 @@ private:
                 }
             }
 
+            // Only the authenticated bridge users become bridges.
+            // The bridge property of the other clients is removed, so that they can't spoof a bridge.
+            if (has_bridge_property(props) && username && is_bridge_user(*username)) {
+                epsp.set_bridge(true);
+            }
+            else {
+                remove_bridge_property(props);
+                if (will) remove_bridge_property(will->props());
+            }
+
             // for test
             if (h_connect_props_) {
                 h_connect_props_(props);
@@ -393,6 +647,7 @@ private:
         properties connack_props;
 
         if (!username) {
+            metrics_.add(broker_metric::auth_failures);
             ASYNC_MQTT_LOG("mqtt_broker", trace)
                 << ASYNC_MQTT_ADD_VALUE(address, epsp.get_address())
                 << "User failed to login: "
@@ -497,6 +752,9 @@ private:
                     mtx_subs_map_,
                     subs_map_,
                     shared_targets_,
+                    outbound_limits_,
+                    metrics_,
+                    session_ids_,
                     epsp,
                     client_id,
                     *username,
@@ -576,6 +834,9 @@ private:
                             mtx_subs_map_,
                             subs_map_,
                             shared_targets_,
+                            outbound_limits_,
+                            metrics_,
+                            session_ids_,
                             epsp,
                             client_id,
                             *username,
@@ -674,6 +935,20 @@ private:
         co_return;
     }
 
+    /**
+     * @brief check whether the user can connect as a bridge
+     * @param username user name that the client logged in as
+     * @return true if the user is one of the bridge users and is not the anonymous nor
+     *         the unauthenticated user
+     */
+    bool is_bridge_user(std::string const& username) {
+        if (!bridge_users_.count(username)) return false;
+        std::shared_lock<mutex> g_sec{mtx_security_};
+        return
+            username != security_.login_anonymous() &&
+            username != security_.login_unauthenticated();
+    }
+
     void set_response_topic(
         session_state<epsp_type>& s,
         properties& connack_props,
@@ -702,7 +977,10 @@ private:
         s.set_clean_handler(
             [this, response_topic, rule_nr]() {
                 std::unique_lock<mutex> g(mtx_retains_);
-                retains_.erase(response_topic);
+                metrics_.add(
+                    broker_metric::retained,
+                    -static_cast<std::int64_t>(retains_.erase(response_topic))
+                );
                 std::unique_lock<mutex> g_sec{mtx_security_};
                 security_.remove_auth(rule_nr);
             }
@@ -797,6 +1075,9 @@ private:
         ASYNC_MQTT_LOG("mqtt_broker", trace)
             << ASYNC_MQTT_ADD_VALUE(address, epsp.get_address())
             << "send_connack";
+        if (authenticated) {
+            if (auto* ss = epsp.get_session_state()) ss->set_bridge(epsp.is_bridge());
+        }
         switch (epsp.get_protocol_version()) {
         case protocol_version::v3_1_1: {
             if (connack_) {
@@ -870,6 +1151,11 @@ private:
         properties props
     ) {
         auto& ss = *epsp.get_session_state();
+        metrics_.add(broker_metric::messages_received);
+        metrics_.add(
+            broker_metric::bytes_received,
+            static_cast<std::int64_t>(outbound_bytes(topic, payload))
+        );
 
         auto send_pubres =
             [&] (bool authorized, bool matched) -> as::awaitable<void> {
@@ -1047,6 +1333,7 @@ private:
             } ()
         ) {
             // Publish not authorized
+            metrics_.add(broker_metric::auth_failures);
             co_await send_pubres(false, false);
             co_return;
         }
@@ -1067,6 +1354,15 @@ private:
                             << ASYNC_MQTT_ADD_VALUE(address, epsp.get_address())
                             << "Subscription Identifier from client not forwarded sid:" << p.val();
                     },
+                    [&](property::user_property&& p) {
+                        if (p.key() == bridge_property_key && !ss.is_bridge()) {
+                            ASYNC_MQTT_LOG("mqtt_broker", info)
+                                << ASYNC_MQTT_ADD_VALUE(address, epsp.get_address())
+                                << "bridge property from non bridge client not forwarded";
+                            return;
+                        }
+                        forward_props.push_back(force_move(p));
+                    },
                     [&](auto&& p) {
                         forward_props.push_back(force_move(p));
                     }
@@ -1102,8 +1398,42 @@ private:
         std::vector<buffer> payload,
         pub::opts opts,
         properties props
+    ) {
+        co_return co_await do_publish(
+            source_ss.session_id(),
+            source_ss.get_protocol_version(),
+            source_ss.get_executor(),
+            force_move(topic),
+            force_move(payload),
+            opts,
+            force_move(props)
+        );
+    }
+
+    /**
+     * @brief do_publish Publish a message to any subscribed clients.
+     *
+     * @param source_session_id - session id of the source. It is no_session_id if the broker is the source.
+     * @param source_version - protocol version of the source.
+     * @param source_exe - executor of the source.
+     * @param topic - The topic to publish the message on.
+     * @param payload - The payload of the message.
+     * @param pubopts - publish options
+     * @param props - properties
+     */
+    as::awaitable<bool>
+    do_publish(
+        session_id_type source_session_id,
+        protocol_version source_version,
+        as::any_io_executor source_exe,
+        std::string topic,
+        std::vector<buffer> payload,
+        pub::opts opts,
+        properties props
     ) {
         bool matched = false;
+        // deliveries run in parallel
+        std::atomic<std::size_t> fanout{0};
 
         // Get auth rights for this topic
         // auth_users prepared once here, and then referred multiple times in subs_map_.modify() for efficiency
@@ -1113,13 +1443,29 @@ private:
                 return security_.auth_sub(topic);
             } ();
 
+        // interned once here, and then shared by the sessions, the offline messages,
+        // and the retained message
+        interned_topic itopic{topic};
+
+        // A message that has been forwarded by a bridge never crosses a bridge again.
+        // The bridge property is removed from the delivered messages, and kept in the retained
+        // message so that it is not sent to the bridge sessions either.
+        bool bridged = has_bridge_property(props);
+        std::optional<properties> retain_props;
+        if (bridged) {
+            if (opts.get_retain() == pub::retain::yes) retain_props.emplace(props);
+            remove_bridge_property(props);
+        }
+
         // publish the message to subscribers.
         // retain is delivered as the original only if rap_value is rap::retain.
         // On MQTT v3.1.1, rap_value is always rap::dont.
         auto deliver =
             [&]
-            (session_state<epsp_type>& ss, subscription<epsp_type>& sub, auto const& auth_users)
+            (session_state<epsp_type>& ss, subscription<epsp_type> const& sub, auto const& auth_users)
             -> as::awaitable<bool> {
+                if (bridged && ss.is_bridge()) co_return false;
+
                 // See if this session is authorized to subscribe this topic
                 {
                     std::shared_lock<mutex> g_sec{mtx_security_};
@@ -1134,7 +1480,7 @@ private:
                 if (sub.sid) {
                     props.push_back(property::subscription_identifier(boost::numeric_cast<std::uint32_t>(*sub.sid)));
                     co_await ss.deliver(
-                        topic,
+                        itopic,
                         payload,
                         new_opts,
                         props
@@ -1143,17 +1489,16 @@ private:
                 }
                 else {
                     co_await ss.deliver(
-                        topic,
+                        itopic,
                         payload,
                         new_opts,
                         props
                     );
                 }
+                fanout.fetch_add(1, std::memory_order_relaxed);
                 co_return true;
             };
 
-        //                  share_name   topic_filter
-        std::set<std::tuple<std::string_view, std::string_view>> sent;
         std::vector<
             std::tuple<
                 as::any_io_executor,
@@ -1163,19 +1508,19 @@ private:
 
         {
             std::shared_lock<mutex> g{mtx_subs_map_};
-            subs_map_.modify(
+            subs_map_.find(
                 topic,
-                [&](std::string const& /*key*/, subscription<epsp_type>& sub) {
-                    if (sub.sharename.empty()) {
+                [&](sub_con_key<epsp_type> const& /*key*/, sub_con_value<epsp_type> const& value) {
+                    if (auto const* p = std::get_if<subscription<epsp_type>>(&value)) {
                         // Non shared subscriptions
 
                         // If NL (no local) subscription option is set and
                         // publisher is the same as subscriber, then skip it.
-                        if (sub.opts.get_nl() == sub::nl::yes &&
-                            sub.ss.get().client_id() ==  source_ss.client_id()) return;
+                        if (p->opts.get_nl() == sub::nl::yes &&
+                            p->ss.get().session_id() == source_session_id) return;
                         pub_deliver.emplace_back(
-                            source_ss.get_executor(),
-                            [sub, auth_users, &matched, &deliver] () mutable -> as::awaitable<void> {
+                            source_exe,
+                            [sub = *p, auth_users, &matched, &deliver] () mutable -> as::awaitable<void> {
                                 auto result = co_await deliver(sub.ss.get(), sub, auth_users);
                                 if (result) matched = true;
                                 co_return;
@@ -1184,20 +1529,17 @@ private:
                     }
                     else {
                         // Shared subscriptions
-                        bool inserted;
-                        std::tie(std::ignore, inserted) = sent.emplace(sub.sharename, sub.topic);
-                        if (inserted) {
-                            if (auto ssr_sub_opt = shared_targets_.get_target(sub.sharename, sub.topic)) {
-                                auto [ssr, sub] = *ssr_sub_opt;
-                                pub_deliver.emplace_back(
-                                    source_ss.get_executor(),
-                                    [ssr, sub, auth_users, &matched, &deliver] () mutable -> as::awaitable<void> {
-                                        auto result = co_await deliver(ssr.get(), sub, auth_users);
-                                        if (result) matched = true;
-                                        co_return;
-                                    }
-                                );
-                            }
+                        // Each group (share_name, topic_filter) is one entry, so it is visited once.
+                        auto const& gr = *std::get<shared_subscription_group<epsp_type> const*>(value);
+                        if (auto const* m = shared_targets_.select(gr, topic)) {
+                            pub_deliver.emplace_back(
+                                source_exe,
+                                [ssr = m->ssr, sub = m->sub, auth_users, &matched, &deliver] () mutable -> as::awaitable<void> {
+                                    auto result = co_await deliver(ssr.get(), sub, auth_users);
+                                    if (result) matched = true;
+                                    co_return;
+                                }
+                            );
                         }
                     }
                 }
@@ -1228,8 +1570,11 @@ private:
             );
         }
 
+        // messages_sent and bytes_sent are counted by session_state when the PUBLISH packet is sent
+        if (!is_sys_topic(topic)) metrics_.observe_fanout(fanout.load(std::memory_order_relaxed));
+
         std::optional<std::chrono::steady_clock::duration> message_expiry_interval;
-        if (source_ss.get_protocol_version() == protocol_version::v5) {
+        if (source_version == protocol_version::v5) {
             for (auto const& prop : props) {
                 prop.visit(
                     overload {
@@ -1266,13 +1611,13 @@ private:
         if (opts.get_retain() == pub::retain::yes) {
             if (payload.empty()) {
                 std::unique_lock<mutex> g(mtx_retains_);
-                retains_.erase(topic);
+                metrics_.add(broker_metric::retained, -static_cast<std::int64_t>(retains_.erase(topic)));
             }
             else {
                 std::shared_ptr<as::steady_timer> tim_message_expiry;
                 if (message_expiry_interval) {
                     tim_message_expiry = std::make_shared<as::steady_timer>(
-                        source_ss.get_executor(),
+                        source_exe,
                         *message_expiry_interval
                     );
                     tim_message_expiry->async_wait(
@@ -1281,7 +1626,10 @@ private:
                             if (auto sp = wp.lock()) {
                                 if (!ec) {
                                     std::lock_guard<mutex> g(mtx_retains_);
-                                    retains_.erase(topic);
+                                    metrics_.add(
+                                        broker_metric::retained,
+                                        -static_cast<std::int64_t>(retains_.erase(topic))
+                                    );
                                 }
                             }
                         }
@@ -1289,16 +1637,17 @@ private:
                 }
 
                 std::unique_lock<mutex> g(mtx_retains_);
-                retains_.insert_or_assign(
+                auto inserted = retains_.insert_or_assign(
                     topic,
                     retain_type {
-                        topic,
+                        itopic,
                         force_move(payload),
-                        force_move(props),
+                        retain_props ? force_move(*retain_props) : force_move(props),
                         opts.get_qos(),
                         tim_message_expiry
                     }
                 );
+                metrics_.add(broker_metric::retained, static_cast<std::int64_t>(inserted));
             }
         }
         co_return matched;
@@ -1313,6 +1662,7 @@ private:
     ) {
         auto& ss = *epsp.get_session_state();
         ss.erase_inflight_message_by_packet_id(packet_id);
+        ss.release_outstanding_publish();
         ss.send_offline_messages_by_packet_id_release();
         co_return;
     }
@@ -1326,7 +1676,11 @@ private:
     ) {
         auto& ss = *epsp.get_session_state();
 
-        if (make_error_code(reason_code)) co_return;
+        if (make_error_code(reason_code)) {
+            // the packet id is released by the endpoint
+            ss.release_outstanding_publish();
+            co_return;
+        }
         auto rc =
             [&] {
                 ss.erase_inflight_message_by_packet_id(packet_id);
@@ -1485,11 +1839,34 @@ private:
     ){
         auto& ss = *epsp.get_session_state();
         ss.erase_inflight_message_by_packet_id(packet_id);
+        ss.release_outstanding_publish();
         ss.send_offline_messages_by_packet_id_release();
 
         co_return;
     }
 
+    // retained messages delivery state for one subscription
+    struct retained_delivery {
+        retained_delivery(
+            session_state<epsp_type>& ss,
+            void const* address,
+            retained_messages::cursor cursor,
+            qos qos_value,
+            std::optional<std::size_t> sid
+        ):wp{ss.weak_from_this()},
+          address{address},
+          cursor{force_move(cursor)},
+          qos_value{qos_value},
+          sid{sid}
+        {}
+
+        std::weak_ptr<session_state<epsp_type>> wp;
+        void const* address; ///< endpoint that subscribed
+        retained_messages::cursor cursor;
+        qos qos_value;
+        std::optional<std::size_t> sid;
+    };
+
     as::awaitable<void>
     subscribe_handler(
         epsp_type& epsp,
@@ -1508,39 +1885,7 @@ private:
         BOOST_ASSERT(ssr_opt);
         session_state_ref<epsp_type> ssr {*ssr_opt};
 
-        auto publish_proc =
-            [&ssr, &epsp]
-            (retain_type const& r, qos qos_value, std::optional<std::size_t> sid) -> as::awaitable<void> {
-                auto props = r.props;
-                if (sid) {
-                    props.push_back(property::subscription_identifier(std::uint32_t(*sid)));
-                }
-                if (r.tim_message_expiry) {
-                    auto d =
-                        std::chrono::duration_cast<std::chrono::seconds>(
-                            r.tim_message_expiry->expiry() - std::chrono::steady_clock::now()
-                        ).count();
-                    for (auto& prop : props) {
-                        prop.visit(
-                            overload {
-                                [&](property::message_expiry_interval& v) {
-                                    v = property::message_expiry_interval(static_cast<uint32_t>(d));
-                                },
-                                [&](auto&) {}
-                            }
-                        );
-                    }
-                }
-                co_await ssr.get().publish(
-                    epsp,
-                    r.topic,
-                    r.payload,
-                    std::min(r.qos_value, qos_value) | pub::retain::yes,
-                    props
-                );
-            };
-
-        std::vector<std::function<as::awaitable<void>()>> retain_deliver;
+        std::vector<std::shared_ptr<retained_delivery>> retain_deliver;
         retain_deliver.reserve(entries.size());
 
         // subscription identifier
@@ -1568,24 +1913,21 @@ private:
                         e.topic(),
                         e.opts(),
                         [&] {
-                            std::shared_lock<mutex> g(mtx_retains_);
-                            retains_.find(
-                                e.topic(),
-                                [&](retain_type const& r) {
-                                    retain_deliver.emplace_back(
-                                        [&publish_proc, &r, qos_value = e.opts().get_qos(), sid]
-                                        () -> as::awaitable<void>{
-                                            co_await publish_proc(r, qos_value, sid);
-                                            co_return;
-                                        }
-                                    );
-                                }
+                            retain_deliver.push_back(
+                                std::make_shared<retained_delivery>(
+                                    ss,
+                                    epsp.get_address(),
+                                    retains_.make_cursor(e.topic()),
+                                    e.opts().get_qos(),
+                                    sid
+                                )
                             );
                         }
                     );
                 }
                 else {
                     // User not authorized to subscribe to topic filter
+                    metrics_.add(broker_metric::auth_failures);
                     res.emplace_back(suback_return_code::failure);
                 }
             }
@@ -1637,18 +1979,14 @@ private:
                             e.topic(),
                             e.opts(),
                             [&] {
-                                std::shared_lock<mutex> g(mtx_retains_);
-                                retains_.find(
-                                    e.topic(),
-                                    [&](retain_type const& r) {
-                                        retain_deliver.emplace_back(
-                                            [&publish_proc, &r, qos_value = e.opts().get_qos(), sid]
-                                            () -> as::awaitable<void>{
-                                                co_await publish_proc(r, qos_value, sid);
-                                                co_return;
-                                            }
-                                        );
-                                    }
+                                retain_deliver.push_back(
+                                    std::make_shared<retained_delivery>(
+                                        ss,
+                                        epsp.get_address(),
+                                        retains_.make_cursor(e.topic()),
+                                        e.opts().get_qos(),
+                                        sid
+                                    )
                                 );
                             },
                             sid
@@ -1656,6 +1994,7 @@ private:
                     }
                     else {
                         // User not authorized to subscribe to topic filter
+                        metrics_.add(broker_metric::auth_failures);
                         res.emplace_back(suback_reason_code::not_authorized);
                     }
                 }
@@ -1686,13 +2025,122 @@ private:
             break;
         }
 
-        for (auto const& f : retain_deliver) {
-            co_await f();
+        // The retained messages are delivered in the background.
+        // Waiting for the Receive Maximum vacancy here would block receiving PUBACK.
+        for (auto& rd : retain_deliver) {
+            as::co_spawn(
+                epsp.get_executor(),
+                deliver_retained(force_move(rd)),
+                as::detached
+            );
         }
 
         co_return;
     }
 
+    /**
+     * @brief deliver the retained messages page by page
+     * The retained messages are found incrementally by the cursor. The lock of the retained
+     * messages is held only while one page is found. The next page is delivered after all
+     * PUBLISH packets of the page are written, and QoS1/QoS2 messages are delivered
+     * within the client's Receive Maximum.
+     * @param rd retained delivery state
+     */
+    as::awaitable<void>
+    deliver_retained(std::shared_ptr<retained_delivery> rd) {
+        while (!rd->cursor.done()) {
+            std::shared_ptr<as::steady_timer> tim;
+            {
+                auto ssp = rd->wp.lock();
+                if (!ssp) co_return;
+                auto epsp = ssp->lock();
+                // the client is disconnected or reconnected
+                if (!epsp || epsp.get_address() != rd->address) co_return;
+
+                auto max_visits = retained_page_size_;
+                if (rd->qos_value != qos::at_most_once) {
+                    auto vacancy = epsp.get_receive_maximum_vacancy_for_send();
+                    if ((vacancy && *vacancy == 0) || !ssp->offline_messages_empty()) {
+                        // wait until the client acknowledges the PUBLISH packet or the
+                        // offline messages are sent
+                        tim = std::make_shared<as::steady_timer>(
+                            epsp.get_executor(),
+                            as::steady_timer::time_point::max()
+                        );
+                        ssp->add_publish_release_waiter(tim);
+                    }
+                    else if (vacancy) {
+                        max_visits = std::min(max_visits, *vacancy);
+                    }
+                }
+
+                if (!tim) {
+                    std::vector<retain_type> page;
+                    {
+                        std::shared_lock<mutex> g(mtx_retains_);
+                        retains_.find_some(
+                            rd->cursor,
+                            max_visits,
+                            [&](retain_type const& r) {
+                                page.push_back(r);
+                            }
+                        );
+                    }
+                    for (auto const& r : page) {
+                        co_await publish_retained(*ssp, epsp, r, rd->qos_value, rd->sid);
+                    }
+                    if (page.empty()) {
+                        // no message on this page
+                        co_await as::post(epsp.get_executor(), as::use_awaitable);
+                    }
+                }
+            }
+            // the session is not held while waiting
+            if (tim) {
+                co_await tim->async_wait(as::as_tuple(as::use_awaitable));
+            }
+        }
+    }
+
+    as::awaitable<void>
+    publish_retained(
+        session_state<epsp_type>& ss,
+        epsp_type& epsp,
+        retain_type const& r,
+        qos qos_value,
+        std::optional<std::size_t> sid
+    ) {
+        auto props = r.props;
+        // A retained message that has been forwarded by a bridge never crosses a bridge again
+        if (remove_bridge_property(props) && ss.is_bridge()) co_return;
+        if (sid) {
+            props.push_back(property::subscription_identifier(std::uint32_t(*sid)));
+        }
+        if (r.tim_message_expiry) {
+            auto d =
+                std::chrono::duration_cast<std::chrono::seconds>(
+                    r.tim_message_expiry->expiry() - std::chrono::steady_clock::now()
+                ).count();
+            for (auto& prop : props) {
+                prop.visit(
+                    overload {
+                        [&](property::message_expiry_interval& v) {
+                            v = property::message_expiry_interval(static_cast<uint32_t>(d));
+                        },
+                        [&](auto&) {}
+                    }
+                );
+            }
+        }
+        co_await ss.publish(
+            epsp,
+            r.topic,
+            r.payload,
+            std::min(r.qos_value, qos_value) | pub::retain::yes,
+            props
+        );
+    }
+
     as::awaitable<void>
     unsubscribe_handler(
         epsp_type& epsp,
@@ -2018,10 +2466,15 @@ private:
     // Authorization and authentication settings
     mutable mutex mtx_security_;
     security security_;
+    auth_cache auth_cache_; ///< verified user name and password pairs
+    std::optional<as::any_io_executor> auth_exe_;
 
     mutable mutex mtx_subs_map_;
     sub_con_map<epsp_type> subs_map_;   ///< subscription information
     shared_target<epsp_type> shared_targets_; ///< shared subscription targets
+    outbound_queue_limits outbound_limits_; ///< limits and total of the outbound queues
+    broker_metrics metrics_; ///< lock-free per-thread metrics
+    session_id_pool session_ids_; ///< dense integer ids of the sessions
 
     ///< Map of active client id and connections
     /// session_state has references of subs_map_ and shared_targets_.
@@ -2031,6 +2484,9 @@ private:
 
     mutable mutex mtx_retains_;
     retained_messages retains_; ///< A list of messages retained so they can be sent to newly subscribed clients.
+    std::size_t retained_page_size_ = 256;
+    std::optional<topic_alias_send_policy> topic_alias_send_policy_;
+    std::set<std::string> bridge_users_; ///< users that can connect as bridges
 
     // MQTTv5 members
     properties connack_props_;
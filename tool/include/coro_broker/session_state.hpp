@@ -11,6 +11,7 @@
 #include <set>
 
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/key.hpp>
@@ -21,7 +22,11 @@
 #include <broker/shared_target.hpp>
 #include <broker/tags.hpp>
 #include <broker/inflight_message.hpp>
+#include <broker/interned_topic.hpp>
 #include <broker/offline_message.hpp>
+#include <broker/outbound_queue.hpp>
+#include <broker/session_id.hpp>
+#include <broker/metrics.hpp>
 #include <broker/mutex.hpp>
 
 namespace async_mqtt {
@@ -68,6 +73,9 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
         mutex& mtx_subs_map,
         sub_con_map<epsp_type>& subs_map,
         shared_target<epsp_type>& shared_targets,
+        outbound_queue_limits& outbound_limits,
+        broker_metrics& metrics,
+        session_id_pool& session_ids,
         epsp_type epsp,
         std::string client_id,
         std::string const& username,
@@ -82,6 +90,9 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
                 mutex& mtx_subs_map,
                 sub_con_map<epsp_type>& subs_map,
                 shared_target<epsp_type>& shared_targets,
+                outbound_queue_limits& outbound_limits,
+                broker_metrics& metrics,
+                session_id_pool& session_ids,
                 epsp_type epsp,
                 std::string client_id,
                 std::string const& username,
@@ -93,6 +104,9 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
                     mtx_subs_map,
                     subs_map,
                     shared_targets,
+                    outbound_limits,
+                    metrics,
+                    session_ids,
                     force_move(epsp),
                     force_move(client_id),
                     username,
@@ -106,6 +120,9 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
             mtx_subs_map,
             subs_map,
             shared_targets,
+            outbound_limits,
+            metrics,
+            session_ids,
             force_move(epsp),
             force_move(client_id),
             username,
@@ -121,7 +138,10 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
         ASYNC_MQTT_LOG("mqtt_broker", trace)
             << ASYNC_MQTT_ADD_VALUE(address, this)
             << "session destroy";
+        metrics_.add(broker_metric::sessions, -1);
         clean();
+        // the subscriptions keyed by the id have been erased by clean()
+        session_ids_.deallocate(session_id_);
     }
 
     template <typename SessionExpireHandler>
@@ -212,6 +232,7 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
     ) {
         clean();
         epwp_ = epsp;
+        slow_consumer_disconnecting_ = false;
         exe_ = epsp.get_executor();
         auto version = epsp.get_protocol_version();
         if (version == protocol_version::v3_1_1) {
@@ -227,19 +248,35 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
         session_expiry_interval_ = force_move(session_expiry_interval);
     }
 
+    /**
+     * @brief publish the message to the client
+     * If the outbound queue of the session exceeds the limits, the message is handled
+     * by the slow_consumer_policy.
+     */
     as::awaitable<void>
     publish(
         epsp_type& epsp,
-        std::string pub_topic,
+        interned_topic pub_topic,
         std::vector<buffer> payload,
         pub::opts pubopts,
         properties props
     ) {
 
         auto send_publish =
-            [this, epsp, pub_topic, payload = payload, pubopts, props, wp = this->weak_from_this()]
+            [
+                this,
+                epsp,
+                pub_topic,
+                payload = payload,
+                pubopts,
+                props,
+                wp = this->weak_from_this(),
+                release = outbound_releaser(),
+                bytes = outbound_bytes(pub_topic, payload)
+            ]
             (packet_id_type pid) mutable -> as::awaitable<void> {
                 if (auto sp = wp.lock()) {
+                    count_sent(pid, pub_topic, bytes);
                     switch (version_) {
                     case protocol_version::v3_1_1: {
                         auto packet =
@@ -285,44 +322,54 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
                         break;
                     }
                 }
+                release(bytes);
                 co_return;
             };
 
         if (offline_messages_empty_) {
-            auto qos_value = pubopts.get_qos();
-            if (qos_value == qos::at_least_once ||
-                qos_value == qos::exactly_once) {
-                auto [ec, pid] = co_await epsp.async_acquire_unique_packet_id(
-                    as::as_tuple(as::use_awaitable)
-                );
-                if (!ec) {
-                    co_await send_publish(pid);
+            auto bytes = outbound_bytes(pub_topic, payload);
+            if (outbound_limits_.try_acquire(*outbound_queue_, bytes)) {
+                auto qos_value = pubopts.get_qos();
+                if (qos_value == qos::at_least_once ||
+                    qos_value == qos::exactly_once) {
+                    auto release = outbound_releaser();
+                    auto [ec, pid] = co_await epsp.async_acquire_unique_packet_id(
+                        as::as_tuple(as::use_awaitable)
+                    );
+                    if (!ec) {
+                        co_await send_publish(pid);
+                        co_return;
+                    }
+                    release(bytes);
+                    co_return;
+                }
+                else {
+                    co_await send_publish(0);
                     co_return;
                 }
-                co_return;
             }
-            else {
-                co_await send_publish(0);
+            if (!handle_slow_consumer(epsp, pubopts.get_qos())) {
                 co_return;
             }
         }
 
-        // offline_messages_ is not empty or packet_id_exhausted
-        std::unique_lock<mutex> g(mtx_offline_messages_);
-        offline_messages_.push_back(
-            exe_,
-            force_move(pub_topic),
-            force_move(payload),
-            pubopts,
-            force_move(props)
-        );
-        offline_messages_empty_ = false;
+        // offline_messages_ is not empty, packet_id_exhausted, or the outbound queue is full
+        if (store_offline_message(
+                force_move(pub_topic),
+                force_move(payload),
+                pubopts,
+                force_move(props)
+            ) &&
+            outbound_queue_->queued_messages() == 0) {
+            // the queue has been drained before the message is stored
+            post_send_offline_messages();
+        }
         co_return;
     }
 
     as::awaitable<void>
     deliver(
-        std::string pub_topic,
+        interned_topic pub_topic,
         std::vector<buffer> payload,
         pub::opts pubopts,
         properties props) {
@@ -337,9 +384,7 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
             );
         }
         else {
-            std::unique_lock<mutex> g(mtx_offline_messages_);
-            offline_messages_.push_back(
-                exe_,
+            store_offline_message(
                 force_move(pub_topic),
                 force_move(payload),
                 pubopts,
@@ -363,13 +408,14 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
             std::unique_lock<mutex> g(mtx_inflight_messages_);
             inflight_messages_.clear();
         }
+        outstanding_publish_count_ = 0;
+        notify_publish_release();
         {
             std::unique_lock<mutex> g(mtx_offline_messages_);
             offline_messages_.clear();
             offline_messages_empty_ = true;
         }
         unsubscribe_all();
-        shared_targets_.erase(*this);
         tim_will_delay_.cancel();
 
         session_expiry_interval_ = std::nullopt;
@@ -386,10 +432,7 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
         PublishRetainHandler&& h,
         std::optional<std::size_t> sid = std::nullopt
     ) {
-        subscription<epsp_type> sub {*this, share_name, topic_filter, subopts, sid };
-        if (!share_name.empty()) {
-            shared_targets_.insert(share_name, topic_filter, sub, *this);
-        }
+        subscription<epsp_type> sub {*this, share_name, interned_topic(topic_filter), subopts, sid };
         ASYNC_MQTT_LOG("mqtt_broker", trace)
             << ASYNC_MQTT_ADD_VALUE(address, this)
             << "subscribe"
@@ -397,24 +440,36 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
             << " topic_filter:" << topic_filter
             << " qos:" << subopts.get_qos();
 
-        auto handle_ret =
+        auto inserted =
             [&] {
                 std::unique_lock<mutex> g{mtx_subs_map_};
-                return subs_map_.insert_or_assign(
+                if (!share_name.empty()) {
+                    // the shared subscription group is the entry of subs_map_
+                    return shared_targets_.insert(
+                        subs_map_,
+                        force_move(share_name),
+                        force_move(topic_filter),
+                        force_move(sub),
+                        *this
+                    );
+                }
+                auto handle_ret = subs_map_.insert_or_assign(
                     force_move(topic_filter),
-                    client_id_,
-                    force_move(sub)
+                    sub_con_key<epsp_type>{session_id_},
+                    sub_con_value<epsp_type>{force_move(sub)}
                 );
+                if (handle_ret.second) handles_.insert(handle_ret.first);
+                return handle_ret.second;
             } ();
 
         auto rh = subopts.get_retain_handling();
 
-        if (handle_ret.second) { // insert
+        if (inserted) {
             ASYNC_MQTT_LOG("mqtt_broker", trace)
                 << ASYNC_MQTT_ADD_VALUE(address, this)
                 << "subscription inserted";
 
-            handles_.insert(handle_ret.first);
+            metrics_.add(broker_metric::subscriptions);
             if (rh == sub::retain_handling::send ||
                 rh == sub::retain_handling::send_only_new_subscription) {
                 std::forward<PublishRetainHandler>(h)();
@@ -432,23 +487,33 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
     }
 
     void unsubscribe(std::string const& share_name, std::string const& topic_filter) {
+        std::unique_lock<mutex> g{mtx_subs_map_};
         if (!share_name.empty()) {
-            shared_targets_.erase(share_name, topic_filter, *this);
+            metrics_.add(
+                broker_metric::subscriptions,
+                -static_cast<std::int64_t>(shared_targets_.erase(subs_map_, share_name, topic_filter, *this))
+            );
+            return;
         }
-        std::unique_lock<mutex> g{mtx_subs_map_};
         auto handle = subs_map_.lookup(topic_filter);
         if (handle) {
             handles_.erase(*handle);
-            subs_map_.erase(*handle, client_id_);
+            metrics_.add(
+                broker_metric::subscriptions,
+                -static_cast<std::int64_t>(subs_map_.erase(*handle, sub_con_key<epsp_type>{session_id_}))
+            );
         }
     }
 
     void unsubscribe_all() {
         {
             std::unique_lock<mutex> g{mtx_subs_map_};
+            std::size_t erased = 0;
             for (auto const& h : handles_) {
-                subs_map_.erase(h, client_id_);
+                erased += subs_map_.erase(h, sub_con_key<epsp_type>{session_id_});
             }
+            erased += shared_targets_.erase(subs_map_, *this);
+            metrics_.add(broker_metric::subscriptions, -static_cast<std::int64_t>(erased));
         }
         handles_.clear();
     }
@@ -538,6 +603,8 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
     void send_inflight_messages() {
         if (auto epsp = lock()) {
             std::unique_lock<mutex> g(mtx_inflight_messages_);
+            // the count of the previous connection is replaced by the resent PUBLISH and PUBREL packets
+            outstanding_publish_count_ = inflight_messages_.get<tag_seq>().size();
             inflight_messages_.send_all_messages(epsp);
         }
     }
@@ -553,6 +620,49 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
         }
     }
 
+    std::size_t get_outstanding_publish_count() const {
+        return outstanding_publish_count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief decrement the outstanding PUBLISH count
+     * It is called when the QoS1/QoS2 PUBLISH packet sent to the client is finished.
+     * The count doesn't underflow even if the PUBLISH packet is sent before the count is reset.
+     */
+    void release_outstanding_publish() {
+        auto count = outstanding_publish_count_.load(std::memory_order_relaxed);
+        while (count != 0 &&
+               !outstanding_publish_count_.compare_exchange_weak(
+                   count, count - 1, std::memory_order_relaxed
+               )
+        ) {}
+        notify_publish_release();
+    }
+
+    /**
+     * @brief wait until a QoS1/QoS2 PUBLISH packet sent to the client is finished
+     * The timer expires when the PUBLISH packet is finished, the offline messages are sent,
+     * or the session is cleaned.
+     * @param tim timer that is waiting
+     */
+    void add_publish_release_waiter(std::shared_ptr<as::steady_timer> tim) {
+        std::unique_lock<mutex> g(mtx_publish_release_waiters_);
+        publish_release_waiters_.push_back(force_move(tim));
+    }
+
+    bool offline_messages_empty() const {
+        return offline_messages_empty_;
+    }
+
+    /**
+     * @brief get the outbound queue
+     * It contains the queue depth and the dropped message count of the session.
+     * @return outbound queue
+     */
+    outbound_queue const& get_outbound_queue() const {
+        return *outbound_queue_;
+    }
+
     std::size_t erase_inflight_message_by_packet_id(packet_id_type packet_id) {
         std::unique_lock<mutex> g(mtx_inflight_messages_);
         auto& idx = inflight_messages_.get<tag_pid>();
@@ -562,16 +672,36 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
     void send_all_offline_messages() {
         if (auto epsp = lock()) {
             std::unique_lock<mutex> g(mtx_offline_messages_);
-            offline_messages_.send_until_fail(epsp, get_protocol_version());
+            offline_messages_.send_until_fail(
+                epsp,
+                get_protocol_version(),
+                [&limits = outbound_limits_, q = outbound_queue_](std::size_t bytes) {
+                    return limits.try_acquire(*q, bytes);
+                },
+                outbound_releaser(),
+                sent_counter()
+            );
             offline_messages_empty_ = offline_messages_.empty();
+            // the retained message delivery waiting for the offline messages is resumed
+            if (offline_messages_empty_) notify_publish_release();
         }
     }
 
     void send_offline_messages_by_packet_id_release() {
         if (auto epsp = lock()) {
             std::unique_lock<mutex> g(mtx_offline_messages_);
-            offline_messages_.send_until_fail(epsp, get_protocol_version());
+            offline_messages_.send_until_fail(
+                epsp,
+                get_protocol_version(),
+                [&limits = outbound_limits_, q = outbound_queue_](std::size_t bytes) {
+                    return limits.try_acquire(*q, bytes);
+                },
+                outbound_releaser(),
+                sent_counter()
+            );
             offline_messages_empty_ = offline_messages_.empty();
+            // the retained message delivery waiting for the offline messages is resumed
+            if (offline_messages_empty_) notify_publish_release();
         }
     }
 
@@ -579,6 +709,14 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
         return version_;
     }
 
+    /**
+     * @brief get the session id
+     * @return id that is unique while the session exists
+     */
+    session_id_type session_id() const {
+        return session_id_;
+    }
+
     std::string const& client_id() const {
         return client_id_;
     }
@@ -587,6 +725,19 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
         return username_;
     }
 
+    /**
+     * @brief set whether the client is a bridge of another broker
+     * The messages that have been forwarded by a bridge are not delivered to the bridge sessions.
+     * @param val true if the client is a bridge
+     */
+    void set_bridge(bool val) {
+        bridge_.store(val, std::memory_order_relaxed);
+    }
+
+    bool is_bridge() const {
+        return bridge_.load(std::memory_order_relaxed);
+    }
+
     void inherit(
         epsp_type epsp,
         std::optional<will> will,
@@ -598,6 +749,7 @@ struct session_state : std::enable_shared_from_this<session_state<Sp>> {
             << "inherit";
 
         epwp_ = epsp;
+        slow_consumer_disconnecting_ = false;
         exe_ = epsp.get_executor();
         auto version = epsp.get_protocol_version();
         if (version == protocol_version::v3_1_1) {
@@ -650,6 +802,9 @@ private:
         mutex& mtx_subs_map,
         sub_con_map<epsp_type>& subs_map,
         shared_target<epsp_type>& shared_targets,
+        outbound_queue_limits& outbound_limits,
+        broker_metrics& metrics,
+        session_id_pool& session_ids,
         epsp_type epsp,
         std::string client_id,
         std::string const& username,
@@ -660,6 +815,10 @@ private:
          mtx_subs_map_(mtx_subs_map),
          subs_map_(subs_map),
          shared_targets_(shared_targets),
+         outbound_limits_(outbound_limits),
+         metrics_(metrics),
+         session_ids_(session_ids),
+         session_id_(session_ids.allocate()),
          epwp_(epsp),
          version_(epsp.get_protocol_version()),
          client_id_(force_move(client_id)),
@@ -681,6 +840,7 @@ private:
             } ()
          )
     {
+        metrics_.add(broker_metric::sessions);
     }
 
     as::awaitable<void>
@@ -751,6 +911,160 @@ private:
 private:
     friend class session_states<epsp_type>;
 
+    /**
+     * @brief make the function that uncounts the message from the outbound queue
+     * It is called when the message is written. If offline messages are waiting for
+     * the queue, sending them is posted.
+     * The function can be called after the session is destroyed.
+     */
+    auto outbound_releaser() {
+        return
+            [&limits = outbound_limits_, q = outbound_queue_, wp = this->weak_from_this()]
+            (std::size_t bytes) {
+                limits.release(*q, bytes);
+                if (auto sp = wp.lock()) {
+                    if (!sp->offline_messages_empty_) {
+                        sp->post_send_offline_messages();
+                    }
+                }
+            };
+    }
+
+    /**
+     * @brief count the PUBLISH packet that is being sent to the client
+     * @param pid   packet id. 0 means QoS0
+     * @param topic topic name
+     * @param bytes outbound_bytes() of the message
+     */
+    void count_sent(packet_id_type pid, std::string_view topic, std::size_t bytes) {
+        if (pid != 0) ++outstanding_publish_count_;
+        metrics_.add_sent(topic, bytes);
+    }
+
+    /**
+     * @brief make the function that counts the PUBLISH packet sent from the offline messages
+     * The function can be called after the session is destroyed.
+     */
+    auto sent_counter() {
+        return
+            [wp = this->weak_from_this()]
+            (packet_id_type pid, std::string_view topic, std::size_t bytes) {
+                if (auto sp = wp.lock()) {
+                    sp->count_sent(pid, topic, bytes);
+                }
+            };
+    }
+
+    void post_send_offline_messages() {
+        // posted to avoid locking mtx_offline_messages_ recursively
+        as::post(
+            exe_,
+            [wp = this->weak_from_this()] {
+                if (auto sp = wp.lock()) {
+                    sp->send_offline_messages_by_packet_id_release();
+                }
+            }
+        );
+    }
+
+    /**
+     * @brief store the message as an offline message
+     * If the offline messages of the session exceed the limits, the message is dropped.
+     * @return true if the message is stored, otherwise false
+     */
+    bool store_offline_message(
+        interned_topic pub_topic,
+        std::vector<buffer> payload,
+        pub::opts pubopts,
+        properties props) {
+        std::unique_lock<mutex> g(mtx_offline_messages_);
+        if (!outbound_limits_.can_store_offline(
+                offline_messages_.size(),
+                offline_messages_.bytes(),
+                outbound_bytes(pub_topic, payload)
+            )
+        ) {
+            outbound_limits_.add_dropped(*outbound_queue_);
+            metrics_.add(broker_metric::dropped_messages);
+            ASYNC_MQTT_LOG("mqtt_broker", trace)
+                << ASYNC_MQTT_ADD_VALUE(address, this)
+                << "offline messages are full. message dropped. cid:" << client_id_
+                << " qos:" << pubopts.get_qos();
+            return false;
+        }
+        offline_messages_.push_back(
+            exe_,
+            force_move(pub_topic),
+            force_move(payload),
+            pubopts,
+            force_move(props)
+        );
+        offline_messages_empty_ = false;
+        return true;
+    }
+
+    /**
+     * @brief handle the message that exceeds the outbound queue limits
+     * @param epsp      endpoint
+     * @param qos_value QoS of the message
+     * @return true if the message should be stored as an offline message, false if it is dropped
+     */
+    bool handle_slow_consumer(epsp_type& epsp, qos qos_value) {
+        switch (outbound_limits_.get_policy()) {
+        case slow_consumer_policy::drop_qos0:
+            if (qos_value != qos::at_most_once) return true;
+            outbound_limits_.add_dropped(*outbound_queue_);
+            metrics_.add(broker_metric::dropped_messages);
+            ASYNC_MQTT_LOG("mqtt_broker", trace)
+                << ASYNC_MQTT_ADD_VALUE(address, this)
+                << "outbound queue is full. QoS0 message dropped. cid:" << client_id_;
+            return false;
+        case slow_consumer_policy::disconnect:
+            if (!slow_consumer_disconnecting_.exchange(true)) {
+                ASYNC_MQTT_LOG("mqtt_broker", warning)
+                    << ASYNC_MQTT_ADD_VALUE(address, this)
+                    << "outbound queue is full. disconnect cid:" << client_id_
+                    << " queued_messages:" << outbound_queue_->queued_messages()
+                    << " queued_bytes:" << outbound_queue_->queued_bytes();
+                if (version_ == protocol_version::v5) {
+                    epsp.async_send(
+                        v5::disconnect_packet{
+                            disconnect_reason_code::quota_exceeded,
+                            properties{}
+                        },
+                        [epsp](error_code const&) mutable {
+                            epsp.async_close([epsp] {});
+                        }
+                    );
+                }
+                else {
+                    epsp.async_close([epsp] {});
+                }
+            }
+            // QoS1/QoS2 messages are kept for the session
+            if (qos_value != qos::at_most_once) return true;
+            outbound_limits_.add_dropped(*outbound_queue_);
+            metrics_.add(broker_metric::dropped_messages);
+            return false;
+        case slow_consumer_policy::offline:
+        default:
+            return true;
+        }
+    }
+
+    void notify_publish_release() {
+        std::vector<std::shared_ptr<as::steady_timer>> waiters;
+        {
+            std::unique_lock<mutex> g(mtx_publish_release_waiters_);
+            if (publish_release_waiters_.empty()) return;
+            std::swap(waiters, publish_release_waiters_);
+        }
+        for (auto& tim : waiters) {
+            // the wait that starts after this call also finishes immediately
+            tim->expires_at(as::steady_timer::time_point::min());
+        }
+    }
+
     as::any_io_executor exe_;
     std::shared_ptr<as::steady_timer> tim_will_expiry_;
     std::optional<async_mqtt::will> will_value_;
@@ -758,11 +1072,19 @@ private:
     mutex& mtx_subs_map_;
     sub_con_map<epsp_type>& subs_map_;
     shared_target<epsp_type>& shared_targets_;
+    outbound_queue_limits& outbound_limits_;
+    broker_metrics& metrics_;
+    session_id_pool& session_ids_;
+    session_id_type session_id_;
+    // shared with the write completion handlers that can be called after the session is destroyed
+    std::shared_ptr<outbound_queue> outbound_queue_ = std::make_shared<outbound_queue>();
+    std::atomic<bool> slow_consumer_disconnecting_ = false;
     epwp_type epwp_;
     protocol_version version_;
     std::string client_id_;
 
     std::string username_;
+    std::atomic<bool> bridge_ = false;
 
     std::optional<std::chrono::steady_clock::duration> session_expiry_interval_;
     std::shared_ptr<as::steady_timer> tim_session_expiry_{std::make_shared<as::steady_timer>(exe_)};
@@ -773,9 +1095,13 @@ private:
     mutable mutex mtx_offline_messages_;
     offline_messages offline_messages_;
     std::atomic<bool> offline_messages_empty_ = true;
+    // QoS1/QoS2 PUBLISH packets sent to the client and not finished yet
+    std::atomic<std::size_t> outstanding_publish_count_ = 0;
+    mutable mutex mtx_publish_release_waiters_;
+    std::vector<std::shared_ptr<as::steady_timer>> publish_release_waiters_;
 
     using elem_type = typename sub_con_map<epsp_type>::handle;
-    std::set<elem_type> handles_; // to efficient remove
+    std::set<elem_type> handles_; // non shared subscriptions, to efficient remove
 
     as::steady_timer tim_will_delay_;
     will_sender_type will_sender_;
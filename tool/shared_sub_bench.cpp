@@ -0,0 +1,203 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Microbenchmark of the shared subscription target selection.
+// Publisher threads select the target of one shared subscription group concurrently.
+// It measures the selection cost and the distribution for each group size and strategy.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+
+#include <broker/shared_group.hpp>
+
+namespace am = async_mqtt;
+
+namespace {
+
+struct member {
+    // simulated outstanding QoS1/QoS2 PUBLISH packets
+    std::unique_ptr<std::atomic<std::size_t>> inflight = std::make_unique<std::atomic<std::size_t>>(0);
+    // selected count
+    std::unique_ptr<std::atomic<std::size_t>> selected = std::make_unique<std::atomic<std::size_t>>(0);
+};
+
+struct result {
+    double ns_per_select;
+    double stddev_percent;
+};
+
+result run(
+    am::shared_strategy strategy,
+    std::size_t group_size,
+    std::size_t threads,
+    std::size_t times,
+    std::size_t topics
+) {
+    am::shared_group<member> gr;
+    gr.members().resize(group_size);
+
+    std::vector<std::string> topic_names;
+    topic_names.reserve(topics);
+    for (std::size_t i = 0; i != topics; ++i) {
+        topic_names.push_back("bench/topic/" + std::to_string(i));
+    }
+
+    auto inflight =
+        [](member const& m) {
+            return m.inflight->load(std::memory_order_relaxed);
+        };
+
+    std::atomic<bool> start{false};
+    std::vector<std::thread> ths;
+    ths.reserve(threads);
+    for (std::size_t t = 0; t != threads; ++t) {
+        ths.emplace_back(
+            [&, t] {
+                while (!start.load(std::memory_order_acquire)) {}
+                for (std::size_t i = 0; i != times; ++i) {
+                    auto const& topic = topic_names[(t + i) % topic_names.size()];
+                    auto const* m = gr.select(strategy, topic, inflight);
+                    m->selected->fetch_add(1, std::memory_order_relaxed);
+                    // the subscriber acks the PUBLISH packet later
+                    m->inflight->fetch_add(1, std::memory_order_relaxed);
+                    if (i % 4 == 3) {
+                        auto& ms = gr.members();
+                        auto& done = *ms[i % ms.size()].inflight;
+                        auto count = done.load(std::memory_order_relaxed);
+                        while (count != 0 &&
+                               !done.compare_exchange_weak(count, count - 1, std::memory_order_relaxed)
+                        ) {}
+                    }
+                }
+            }
+        );
+    }
+
+    auto tp_start = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& th : ths) th.join();
+    auto dur_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - tp_start
+    ).count();
+
+    // distribution
+    double avg = double(threads * times) / double(group_size);
+    double sum = 0;
+    for (auto const& m : gr.members()) {
+        auto d = double(m.selected->load()) - avg;
+        sum += d * d;
+    }
+    double stddev = std::sqrt(sum / double(group_size));
+    return result{
+        double(dur_ns) / double(threads * times),
+        avg == 0 ? 0.0 : stddev * 100 / avg
+    };
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[]) {
+    try {
+        boost::program_options::options_description desc("options");
+        desc.add_options()
+            ("help", "produce help message")
+            (
+                "group_sizes",
+                boost::program_options::value<std::vector<std::size_t>>()->multitoken()
+                    ->default_value(std::vector<std::size_t>{2, 10, 100, 1000}, "2 10 100 1000"),
+                "Number of the members of the shared subscription group"
+            )
+            (
+                "strategies",
+                boost::program_options::value<std::vector<std::string>>()->multitoken()
+                    ->default_value(
+                        std::vector<std::string>{"round_robin", "least_inflight", "sticky"},
+                        "round_robin least_inflight sticky"
+                    ),
+                "Load balancing strategies"
+            )
+            (
+                "threads",
+                boost::program_options::value<std::size_t>()->default_value(4),
+                "Number of publisher threads that select the target concurrently"
+            )
+            (
+                "times",
+                boost::program_options::value<std::size_t>()->default_value(1000000),
+                "Number of selections for each thread"
+            )
+            (
+                "topics",
+                boost::program_options::value<std::size_t>()->default_value(1000),
+                "Number of the topic names that match the topic filter. It affects sticky."
+            )
+            ;
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+
+        if (vm.count("help")) {
+            std::cout << desc << std::endl;
+            return 1;
+        }
+
+        auto threads = vm["threads"].as<std::size_t>();
+        auto times = vm["times"].as<std::size_t>();
+        auto topics = vm["topics"].as<std::size_t>();
+        if (threads == 0 || times == 0 || topics == 0) {
+            std::cout << "threads, times, and topics must be greater than 0" << std::endl;
+            return -1;
+        }
+
+        std::vector<am::shared_strategy> strategies;
+        for (auto const& str : vm["strategies"].as<std::vector<std::string>>()) {
+            auto strategy = am::shared_strategy_from_str(str);
+            if (!strategy) {
+                std::cout << "invalid strategy:" << str << std::endl;
+                return -1;
+            }
+            strategies.push_back(*strategy);
+        }
+
+        std::cout
+            << "threads:" << threads
+            << " times:" << times
+            << " topics:" << topics
+            << std::endl;
+        std::cout
+            << boost::format("%-16s %10s %14s %14s %12s")
+            % "strategy" % "group_size" % "ns/select" % "Mselect/sec" % "stddev(%)"
+            << std::endl;
+        for (auto size : vm["group_sizes"].as<std::vector<std::size_t>>()) {
+            if (size == 0) continue;
+            for (auto strategy : strategies) {
+                auto r = run(strategy, size, threads, times, topics);
+                std::cout
+                    << boost::format("%-16s %10d %14.1f %14.2f %12.2f")
+                    % am::shared_strategy_to_str(strategy)
+                    % size
+                    % r.ns_per_select
+                    % (r.ns_per_select == 0 ? 0.0 : 1000.0 / r.ns_per_select)
+                    % r.stddev_percent
+                    << std::endl;
+            }
+        }
+    }
+    catch (std::exception const& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,180 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Bandwidth benchmark of the automatic topic alias mapping.
+// It sends the same stream of QoS0 PUBLISH packets to a subscriber that accepts
+// topic_alias_max topic aliases, with no mapping, the lru policy, and the frequency policy,
+// and reports the total size of the packets.
+//
+// The topics are picked by the Zipf distribution, so a few topics are hot and
+// most of the topics are sent rarely. The topic alias is decided by topic_alias_send::auto_map(),
+// the same as the endpoint that set_auto_map_topic_alias_send(true) is called.
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+
+#include <async_mqtt/protocol/packet/v5_publish.hpp>
+#include <async_mqtt/util/topic_alias_send.hpp>
+
+namespace am = async_mqtt;
+
+namespace {
+
+struct result {
+    std::uint64_t bytes = 0;
+    std::uint64_t mapped = 0;   // PUBLISH packets that register the alias with the topic
+    std::uint64_t replaced = 0; // PUBLISH packets that have only the alias
+};
+
+result run(
+    std::vector<std::string> const& topics,
+    std::vector<std::size_t> const& sequence,
+    std::string const& payload,
+    am::topic_alias_type topic_alias_max,
+    std::optional<am::topic_alias_send_policy> policy
+) {
+    result r;
+    std::optional<am::topic_alias_send> tas;
+    if (policy) tas.emplace(topic_alias_max, *policy);
+    for (auto i : sequence) {
+        am::v5::publish_packet p{topics[i], payload, am::qos::at_most_once};
+        if (tas) {
+            if (auto ta_opt = tas->auto_map(topics[i])) {
+                auto [ta, mapped] = *ta_opt;
+                if (mapped) {
+                    p.add_topic_alias(ta);
+                    ++r.mapped;
+                }
+                else {
+                    p.remove_topic_add_topic_alias(ta);
+                    ++r.replaced;
+                }
+            }
+        }
+        r.bytes += p.size();
+    }
+    return r;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[]) {
+    try {
+        boost::program_options::options_description desc("options");
+        desc.add_options()
+            ("help", "produce help message")
+            (
+                "topics",
+                boost::program_options::value<std::size_t>()->default_value(1000),
+                "Number of the topics"
+            )
+            (
+                "messages",
+                boost::program_options::value<std::size_t>()->default_value(1000000),
+                "Number of the PUBLISH packets"
+            )
+            (
+                "topic_alias_max",
+                boost::program_options::value<am::topic_alias_type>()->default_value(16),
+                "Topic Alias Maximum of the subscriber"
+            )
+            (
+                "topic_length",
+                boost::program_options::value<std::size_t>()->default_value(120),
+                "Length of the topic names"
+            )
+            (
+                "payload_size",
+                boost::program_options::value<std::size_t>()->default_value(32),
+                "Payload size"
+            )
+            (
+                "zipf",
+                boost::program_options::value<double>()->default_value(1.0),
+                "Exponent of the Zipf distribution of the topics. 0 means uniform."
+            )
+            ;
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+
+        if (vm.count("help")) {
+            std::cout << desc << std::endl;
+            return 1;
+        }
+
+        auto num_topics = vm["topics"].as<std::size_t>();
+        auto messages = vm["messages"].as<std::size_t>();
+        auto topic_alias_max = vm["topic_alias_max"].as<am::topic_alias_type>();
+        auto topic_length = vm["topic_length"].as<std::size_t>();
+        auto payload_size = vm["payload_size"].as<std::size_t>();
+        auto zipf = vm["zipf"].as<double>();
+        if (num_topics == 0 || topic_alias_max == 0) {
+            std::cout << "topics and topic_alias_max must be greater than 0" << std::endl;
+            return -1;
+        }
+
+        std::vector<std::string> topics;
+        topics.reserve(num_topics);
+        for (std::size_t i = 0; i != num_topics; ++i) {
+            auto t = "factory/line" + std::to_string(i % 10) + "/device" + std::to_string(i) + "/";
+            if (t.size() < topic_length) t.append(topic_length - t.size(), 'x');
+            topics.push_back(std::move(t));
+        }
+
+        std::vector<double> weights;
+        weights.reserve(num_topics);
+        for (std::size_t i = 0; i != num_topics; ++i) {
+            weights.push_back(1.0 / std::pow(double(i + 1), zipf));
+        }
+        std::mt19937 gen{0};
+        std::discrete_distribution<std::size_t> dist{weights.begin(), weights.end()};
+        std::vector<std::size_t> sequence;
+        sequence.reserve(messages);
+        for (std::size_t i = 0; i != messages; ++i) sequence.push_back(dist(gen));
+
+        std::string payload(payload_size, 'p');
+
+        std::cout
+            << "topics:" << num_topics
+            << " messages:" << messages
+            << " topic_alias_max:" << topic_alias_max
+            << " topic_length:" << topic_length
+            << " payload_size:" << payload_size
+            << " zipf:" << zipf
+            << std::endl;
+        std::cout
+            << boost::format("%-10s %16s %12s %12s %10s")
+            % "policy" % "bytes" % "mapped" % "alias only" % "saved"
+            << std::endl;
+
+        auto none = run(topics, sequence, payload, topic_alias_max, std::nullopt);
+        auto print =
+            [&](char const* name, result const& r) {
+                std::cout
+                    << boost::format("%-10s %16d %12d %12d %9.1f%%")
+                    % name % r.bytes % r.mapped % r.replaced
+                    % (100.0 - double(r.bytes) * 100 / double(none.bytes))
+                    << std::endl;
+            };
+        print("none", none);
+        print("lru", run(topics, sequence, payload, topic_alias_max, am::topic_alias_send_policy::lru));
+        print("frequency", run(topics, sequence, payload, topic_alias_max, am::topic_alias_send_policy::frequency));
+    }
+    catch (std::exception const& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
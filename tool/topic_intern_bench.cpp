@@ -0,0 +1,249 @@
+// Copyright Takatoshi Kondo 2025
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Memory benchmark of the topic interning.
+// It builds the topic holding parts of the broker for a synthetic workload twice,
+// once with std::string topics and once with interned_topic, and reports the heap usage.
+//
+// Each session subscribes to its own command topic devices/<session>/cmd and to
+// sensors/<n>/#. Each sensor topic sensors/<n>/temperature has a retained message,
+// and each session has offline messages on the sensor topics.
+// The subscription map and the retained map nodes are keyed by (parent id, topic level),
+// the same as subscription_map and retained_topic_map.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <broker/interned_topic.hpp>
+#include <broker/topic_filter.hpp>
+
+namespace {
+
+// requested heap bytes. The size is stored in front of each allocation.
+std::atomic<std::size_t> allocated{0};
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+} // anonymous namespace
+
+void* operator new(std::size_t size) {
+    auto* p = static_cast<char*>(std::malloc(size + header_size));
+    if (!p) throw std::bad_alloc();
+    *reinterpret_cast<std::size_t*>(p) = size;
+    allocated.fetch_add(size, std::memory_order_relaxed);
+    return p + header_size;
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    auto* h = static_cast<char*>(p) - header_size;
+    allocated.fetch_sub(*reinterpret_cast<std::size_t*>(h), std::memory_order_relaxed);
+    std::free(h);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+namespace am = async_mqtt;
+
+namespace {
+
+template <typename Topic>
+class topic_tree {
+public:
+    explicit topic_tree(std::size_t& next_id):next_id_{next_id} {}
+
+    void insert(std::string_view topic) {
+        std::size_t parent = 0;
+        am::topic_filter_tokenizer(
+            topic,
+            [&](std::string_view t) {
+                auto it = nodes_.find(
+                    std::pair<std::size_t, std::string_view>(parent, t),
+                    key_hash{},
+                    key_equal{}
+                );
+                if (it == nodes_.end()) {
+                    it = nodes_.emplace(key(parent, Topic(t)), node{++next_id_, 1}).first;
+                }
+                else {
+                    ++it->second.count;
+                }
+                parent = it->second.id;
+                return true;
+            }
+        );
+    }
+
+private:
+    struct node {
+        std::size_t id;
+        std::size_t count;
+    };
+    using key = std::pair<std::size_t, Topic>;
+    struct key_hash {
+        template <typename Key>
+        std::size_t operator()(Key const& k) const {
+            std::size_t seed = 0;
+            boost::hash_combine(seed, k.first);
+            boost::hash_combine(seed, std::hash<std::string_view>{}(std::string_view(k.second)));
+            return seed;
+        }
+    };
+    struct key_equal {
+        template <typename Lhs, typename Rhs>
+        bool operator()(Lhs const& lhs, Rhs const& rhs) const {
+            return lhs.first == rhs.first && std::string_view(lhs.second) == std::string_view(rhs.second);
+        }
+    };
+
+    std::size_t& next_id_;
+    boost::unordered_map<key, node, key_hash, key_equal> nodes_;
+};
+
+struct result {
+    std::size_t subscriptions;
+    std::size_t retained;
+    std::size_t offline;
+    std::size_t total() const {
+        return subscriptions + retained + offline;
+    }
+};
+
+template <typename Topic>
+result run(std::size_t sessions, std::size_t topics, std::size_t offline_messages) {
+    result r;
+    auto base = allocated.load();
+
+    std::size_t next_id = 0;
+    topic_tree<Topic> subs_map{next_id};
+    // subscription::topic
+    std::vector<Topic> subs;
+    subs.reserve(sessions * 2);
+    for (std::size_t i = 0; i != sessions; ++i) {
+        auto cmd = "devices/" + std::to_string(i) + "/cmd";
+        auto sensors = "sensors/" + std::to_string(i % topics) + "/#";
+        subs_map.insert(cmd);
+        subs_map.insert(sensors);
+        subs.emplace_back(cmd);
+        subs.emplace_back(sensors);
+    }
+    r.subscriptions = allocated.load() - base;
+    base = allocated.load();
+
+    // The broker makes the topic of the received PUBLISH once, and then passes it
+    // to the retained map and the sessions.
+    std::vector<Topic> published;
+    published.reserve(topics);
+    for (std::size_t i = 0; i != topics; ++i) {
+        published.emplace_back("sensors/" + std::to_string(i) + "/temperature");
+    }
+    topic_tree<Topic> retained_map{next_id};
+    // retain_type::topic
+    std::vector<Topic> retained;
+    retained.reserve(topics);
+    for (auto const& t : published) {
+        retained_map.insert(std::string_view(t));
+        retained.push_back(t);
+    }
+    r.retained = allocated.load() - base;
+    base = allocated.load();
+
+    // offline_message::topic_
+    std::vector<std::vector<Topic>> offline(sessions);
+    for (std::size_t i = 0; i != sessions; ++i) {
+        offline[i].reserve(offline_messages);
+        for (std::size_t j = 0; j != offline_messages; ++j) {
+            offline[i].push_back(published[(i + j) % topics]);
+        }
+    }
+    r.offline = allocated.load() - base;
+    return r;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[]) {
+    try {
+        boost::program_options::options_description desc("options");
+        desc.add_options()
+            ("help", "produce help message")
+            (
+                "sessions",
+                boost::program_options::value<std::size_t>()->default_value(1000000),
+                "Number of the sessions"
+            )
+            (
+                "topics",
+                boost::program_options::value<std::size_t>()->default_value(2000),
+                "Number of the sensor topics"
+            )
+            (
+                "offline_messages",
+                boost::program_options::value<std::size_t>()->default_value(10),
+                "Number of the offline messages for each session"
+            )
+            ;
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+
+        if (vm.count("help")) {
+            std::cout << desc << std::endl;
+            return 1;
+        }
+
+        auto sessions = vm["sessions"].as<std::size_t>();
+        auto topics = vm["topics"].as<std::size_t>();
+        auto offline_messages = vm["offline_messages"].as<std::size_t>();
+        if (sessions == 0 || topics == 0) {
+            std::cout << "sessions and topics must be greater than 0" << std::endl;
+            return -1;
+        }
+
+        std::cout
+            << "sessions:" << sessions
+            << " topics:" << topics
+            << " offline_messages:" << offline_messages
+            << std::endl;
+        std::cout
+            << boost::format("%-10s %16s %16s %16s %16s")
+            % "topic" % "subscriptions" % "retained" % "offline" % "total"
+            << std::endl;
+        auto print =
+            [](char const* name, result const& r) {
+                std::cout
+                    << boost::format("%-10s %16d %16d %16d %16d")
+                    % name % r.subscriptions % r.retained % r.offline % r.total()
+                    << std::endl;
+            };
+        auto str = run<std::string>(sessions, topics, offline_messages);
+        print("string", str);
+        auto interned = run<am::interned_topic>(sessions, topics, offline_messages);
+        print("interned", interned);
+        std::cout
+            << boost::format("reduction: %.1f%% (%d bytes)")
+            % (100.0 - double(interned.total()) * 100 / double(str.total()))
+            % (std::int64_t(str.total()) - std::int64_t(interned.total()))
+            << std::endl;
+    }
+    catch (std::exception const& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}